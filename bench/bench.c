@@ -0,0 +1,2973 @@
+#include <math.h>
+#include <time.h>
+
+#include "../include/eval.h"
+#include "../include/compile.h"
+#include "../include/simd.h"
+#include "../include/parallel.h"
+#include "../include/gray.h"
+#include "../include/classify.h"
+#include "../include/bdd.h"
+#include "../include/batch.h"
+#include "../include/jit.h"
+#include "../include/tablefile.h"
+#include "../include/cache.h"
+#include "../include/count.h"
+#include "../include/decompose.h"
+#include "../include/minimize.h"
+#include "../include/logic.h"
+#include "../include/session.h"
+#include "../include/equiv.h"
+#include "../include/stats.h"
+
+// expressões usadas nas medições
+static const char *bench_expressions[] = {
+    "(A & B) | ~C -> (D <-> E)",
+    "(A & B) | (C -> D) & ~(E <-> F) | (G & H) -> (I | J) & (K <-> ~L)",
+    "(A & B) | (C -> D) & ~(E <-> F) | (G & H) -> (I | J) & (K <-> ~L) | (M & N -> O | P)",
+    "(a|b|c|d) & (e|f|g|h) & (i|j|k|l) & (m|n|o|p) & (q|r|s|t) -> (A <-> B)",
+};
+
+// relógio de parede: clock() soma o tempo de CPU de todas as threads
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double elapsed_seconds(double start) {
+    return now_seconds() - start;
+}
+
+// lê e compila uma expressão de benchmark; retorna 0 (com mensagem) em caso de erro
+static int load_bench_expression(const char *expression, program *prog) {
+    error_status status;
+
+    if (!parse_expression(expression, prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return 0;
+    }
+    return 1;
+}
+
+// tokens da expressão para o avaliador antigo (evaluate_expression), tudo na arena
+typedef struct {
+    arena scratch;
+    symbol_table symbols;
+    token *elements;
+    int size;
+    int *slot_of_symbol; // slot do programa de cada símbolo
+    int *values;         // valores por símbolo
+} bench_tokens;
+
+static int load_bench_tokens(const char *expression, const program *prog, bench_tokens *t) {
+    error_status status;
+
+    init_error_status(&status);
+    arena_init(&t->scratch, 0);
+    symbols_init(&t->symbols, &t->scratch);
+    t->size = 0;
+    t->elements = arena_alloc(&t->scratch, sizeof(token) * (strlen(expression) + 1));
+    if (t->elements) read_expression(expression, t->elements, &t->size, &t->symbols, &status);
+
+    t->slot_of_symbol = arena_alloc(&t->scratch, sizeof(int) * (t->symbols.count + 1));
+    t->values = arena_alloc(&t->scratch, sizeof(int) * (t->symbols.count + 1));
+    if (!t->elements || status.code != SUCCESS || !t->slot_of_symbol || !t->values) {
+        arena_free(&t->scratch);
+        return 0;
+    }
+
+    for (int id = 0; id < t->symbols.count; id++) {
+        const symbol *sym = &t->symbols.symbols[id];
+        for (int j = 0; j < prog->num_vars; j++)
+            if ((int) strlen(prog->var_names[j]) == sym->length && memcmp(prog->var_names[j], sym->name, sym->length) == 0)
+                t->slot_of_symbol[id] = j;
+    }
+    return 1;
+}
+
+// valores por símbolo da linha 'row' (bits no formato do índice da linha)
+static void set_bench_row(bench_tokens *t, const program *prog, long long row) {
+    for (int id = 0; id < t->symbols.count; id++)
+        t->values[id] = (row >> (prog->num_vars - t->slot_of_symbol[id] - 1)) & 1;
+}
+
+// compara o caminho antigo (shunting yard por linha) com o programa compilado
+static int bench_compiled_vs_shunting_yard(const char *expression) {
+    bench_tokens tokens;
+    error_status status;
+    program prog;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    if (!load_bench_tokens(expression, &prog, &tokens)) {
+        free_program(&prog);
+        return 0;
+    }
+
+    long long rows = 1LL << prog.num_vars;
+    int slot_values[MAX_TABLE_VARS] = {0};
+    long long checksum_old = 0, checksum_new = 0;
+
+    // caminho antigo: evaluate_expression recebe os valores indexados por símbolo
+    double start = now_seconds();
+    for (long long row = 0; row < rows; row++) {
+        set_bench_row(&tokens, &prog, row);
+        init_error_status(&status);
+        checksum_old += evaluate_expression(tokens.elements, tokens.size, tokens.values, &tokens.scratch, &status);
+    }
+    double old_time = elapsed_seconds(start);
+
+    // caminho novo: programa pós-fixo com slots pré-resolvidos
+    start = now_seconds();
+    for (long long row = 0; row < rows; row++) {
+        for (int j = 0; j < prog.num_vars; j++)
+            slot_values[j] = (row >> (prog.num_vars - j - 1)) & 1;
+        checksum_new += run_program(&prog, slot_values);
+    }
+    double new_time = elapsed_seconds(start);
+
+    printf("%-2d vars %9lld linhas | shunting yard %8.2f ns/linha | compilado %8.2f ns/linha | %5.1fx %s\n",
+        prog.num_vars, rows,
+        old_time * 1e9 / rows, new_time * 1e9 / rows,
+        new_time > 0 ? old_time / new_time : 0.0,
+        checksum_old == checksum_new ? "" : "(DIVERGENCIA!)");
+
+    arena_free(&tokens.scratch);
+    free_program(&prog);
+    return checksum_old == checksum_new;
+}
+
+// avaliação empacotada (64 linhas por palavra), conferida linha a linha contra evaluate_expression
+static int bench_packed_words(const char *expression) {
+    bench_tokens tokens;
+    error_status status;
+    program prog;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    if (!load_bench_tokens(expression, &prog, &tokens)) {
+        free_program(&prog);
+        return 0;
+    }
+
+    long long rows = 1LL << prog.num_vars;
+    uint64_t blocks = ((uint64_t) rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    long long mismatches = 0;
+
+    // conferência: cada linha do bloco deve coincidir com a avaliação escalar original
+    for (uint64_t block = 0; block < blocks; block++) {
+        uint64_t bits = 0;
+        if (!evaluate_block(&prog, block, &bits)) mismatches++;
+        for (long long row = block * ROWS_PER_WORD; row < rows && row < (long long) (block + 1) * ROWS_PER_WORD; row++) {
+            set_bench_row(&tokens, &prog, row);
+            init_error_status(&status);
+            if (evaluate_expression(tokens.elements, tokens.size, tokens.values, &tokens.scratch, &status) !=
+                (int) ((bits >> (row % ROWS_PER_WORD)) & 1))
+                mismatches++;
+        }
+    }
+
+    // medição: apenas a avaliação dos blocos
+    uint64_t checksum = 0;
+    double start = now_seconds();
+    for (uint64_t block = 0; block < blocks; block++) {
+        uint64_t bits = 0;
+        evaluate_block(&prog, block, &bits);
+        checksum ^= bits;
+    }
+    double packed_time = elapsed_seconds(start);
+
+    printf("%-2d vars %9lld linhas | empacotado %8.3f ns/linha | %lld divergencias (checksum %016llx)\n",
+        prog.num_vars, rows, packed_time * 1e9 / rows, mismatches, (unsigned long long) checksum);
+
+    arena_free(&tokens.scratch);
+    free_program(&prog);
+    return mismatches == 0;
+}
+
+#define BENCH_WINDOW_WORDS 64
+
+// compara os núcleos disponíveis nesta CPU com o núcleo portável, janela por janela
+static int bench_simd_kernels(const char *expression) {
+    program prog;
+    const eval_kernel *kernels[3];
+    int kernel_count = supported_eval_kernels(kernels, 3);
+    uint64_t window[BENCH_WINDOW_WORDS];
+    int ok = 1;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+
+    long long rows = 1LL << prog.num_vars;
+    uint64_t blocks = ((uint64_t) rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+
+    for (int k = 0; k < kernel_count; k++) {
+        long long mismatches = 0;
+
+        // conferência contra a avaliação portável bloco a bloco
+        for (uint64_t first = 0; first < blocks; first += BENCH_WINDOW_WORDS) {
+            uint64_t count = blocks - first < BENCH_WINDOW_WORDS ? blocks - first : BENCH_WINDOW_WORDS;
+            if (!evaluate_blocks_with(kernels[k], &prog, first, count, window)) mismatches += (long long) count;
+            for (uint64_t w = 0; w < count; w++) {
+                uint64_t word;
+                if (!evaluate_block(&prog, first + w, &word) || window[w] != word) mismatches++;
+            }
+        }
+
+        // medição apenas do núcleo
+        double start = now_seconds();
+        for (uint64_t first = 0; first < blocks; first += BENCH_WINDOW_WORDS) {
+            uint64_t count = blocks - first < BENCH_WINDOW_WORDS ? blocks - first : BENCH_WINDOW_WORDS;
+            evaluate_blocks_with(kernels[k], &prog, first, count, window);
+        }
+        double kernel_time = elapsed_seconds(start);
+
+        printf("%-2d vars %9lld linhas | %-8s (%d palavras/passada) %8.3f ns/linha | %lld divergencias\n",
+            prog.num_vars, rows, kernels[k]->name, kernels[k]->words_per_pass,
+            kernel_time * 1e9 / rows, mismatches);
+        ok &= mismatches == 0;
+    }
+
+    free_program(&prog);
+    return ok;
+}
+
+#define GRAY_BENCH_BITS 12
+
+// enumeração em código Gray com reavaliação incremental, conferida contra os blocos empacotados
+static int bench_gray_code(const char *expression) {
+    program prog;
+    expr_tree tree;
+    uint64_t window[(1 << GRAY_BENCH_BITS) / 64];
+    long long mismatches = 0;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    if (!build_expr_tree(&prog, &tree)) {
+        free_program(&prog);
+        return 0;
+    }
+
+    long long rows = 1LL << prog.num_vars;
+    int bits = prog.num_vars < GRAY_BENCH_BITS ? prog.num_vars : GRAY_BENCH_BITS;
+    uint64_t window_rows = 1ULL << bits;
+
+    // conferência: cada janela reordenada deve coincidir com os blocos empacotados
+    for (uint64_t first = 0; first < (uint64_t) rows; first += window_rows) {
+        gray_evaluate_rows(&tree, first, bits, window);
+        for (uint64_t w = 0; w * 64 < window_rows; w++) {
+            uint64_t mask = window_rows < 64 ? (1ULL << window_rows) - 1 : ~0ULL;
+            uint64_t word;
+            if (!evaluate_block(&prog, first / 64 + w, &word) || ((window[w] ^ word) & mask)) mismatches++;
+        }
+    }
+
+    double start = now_seconds();
+    for (uint64_t first = 0; first < (uint64_t) rows; first += window_rows)
+        gray_evaluate_rows(&tree, first, bits, window);
+    double t = elapsed_seconds(start);
+
+    printf("%-2d vars %9lld linhas | gray %8.2f ns/linha | %lld divergencias\n",
+        prog.num_vars, rows, t * 1e9 / rows, mismatches);
+
+    free_expr_tree(&tree);
+    free_program(&prog);
+    return mismatches == 0;
+}
+
+// BDD nas duas ordens pré-definidas: tamanho, contagem de modelos e blocos conferidos contra os empacotados
+static int bench_bdd(const char *expression) {
+    static const char *orders[] = {"natural", "appearance"};
+    program prog;
+    int ok = 1;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+
+    long long rows = 1LL << prog.num_vars;
+    long long blocks = (rows + 63) / 64;
+    uint64_t mask = rows < 64 ? (1ULL << rows) - 1 : ~0ULL;
+
+    for (size_t k = 0; k < sizeof(orders) / sizeof(orders[0]); k++) {
+        int order[MAX_TABLE_VARS];
+        error_status status;
+        long long mismatches = 0;
+        uint64_t ones = 0;
+
+        init_error_status(&status);
+        bdd_parse_order(&prog, orders[k], order, &status);
+        bdd_manager *mgr = bdd_create(&prog, order, 0);
+        if (!mgr) {
+            free_program(&prog);
+            return 0;
+        }
+
+        double start = now_seconds();
+        int root = bdd_build(mgr, &prog, &status);
+        double build_time = elapsed_seconds(start);
+        if (root < 0) {
+            bdd_destroy(mgr);
+            free_program(&prog);
+            return 0;
+        }
+
+        for (long long b = 0; b < blocks; b++) {
+            uint64_t word = 0;
+            if (!evaluate_block(&prog, (uint64_t) b, &word)) mismatches++;
+            word &= mask;
+            if ((bdd_eval_block(mgr, root, (uint64_t) b) & mask) != word) mismatches++;
+            for (uint64_t w = word; w; w &= w - 1) ones++;
+        }
+        if (bdd_sat_count(mgr, root) != ones) mismatches++;
+
+        start = now_seconds();
+        for (long long b = 0; b < blocks; b++) bdd_eval_block(mgr, root, (uint64_t) b);
+        double eval_time = elapsed_seconds(start);
+
+        printf("%-2d vars %-10s | %6d nos | construcao %8.3f ms | %6.2f ns/linha | %lld divergencias\n",
+            prog.num_vars, orders[k], bdd_size(mgr, root), build_time * 1e3, eval_time * 1e9 / rows, mismatches);
+
+        ok &= mismatches == 0;
+        bdd_destroy(mgr);
+    }
+
+    free_program(&prog);
+    return ok;
+}
+
+#define BENCH_FORMULA_SIZE 100 // tamanho do buffer das fórmulas aleatórias pequenas
+
+// gerador pseudoaleatório determinístico (xorshift64) para as fórmulas de teste
+static uint64_t bench_rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_random(void) {
+    bench_rng_state ^= bench_rng_state << 13;
+    bench_rng_state ^= bench_rng_state >> 7;
+    bench_rng_state ^= bench_rng_state << 17;
+    return bench_rng_state;
+}
+
+// escreve em buf uma fórmula aleatória com até 'num_vars' variáveis; retorna 0 se não couber
+static int random_formula(char *buf, size_t cap, size_t *len, int num_vars, int depth) {
+    static const char *binary_ops[] = { " & ", " | ", " -> ", " <-> " };
+    uint64_t r = next_random();
+
+    if (depth == 0 || r % 5 == 0) {
+        if (*len + 2 > cap) return 0;
+        char v = (char) ('a' + next_random() % num_vars);
+        if (r % 3 == 0) buf[(*len)++] = '~';
+        buf[(*len)++] = v;
+        buf[*len] = '\0';
+        return 1;
+    }
+
+    if (r % 7 == 1) {
+        if (*len + 1 > cap) return 0;
+        buf[(*len)++] = '~';
+    }
+    if (*len + 1 > cap) return 0;
+    buf[(*len)++] = '(';
+    if (!random_formula(buf, cap, len, num_vars, depth - 1)) return 0;
+
+    const char *op = binary_ops[next_random() % 4];
+    size_t op_len = strlen(op);
+    if (*len + op_len > cap) return 0;
+    memcpy(buf + *len, op, op_len);
+    *len += op_len;
+
+    if (!random_formula(buf, cap, len, num_vars, depth - 1)) return 0;
+    if (*len + 2 > cap) return 0;
+    buf[(*len)++] = ')';
+    buf[*len] = '\0';
+    return 1;
+}
+
+#define CROSSCHECK_FORMULAS 3000
+
+// confere a classificação do CDCL contra a enumeração completa em fórmulas pequenas
+static int bench_sat_crosscheck(void) {
+    int checked = 0, failures = 0;
+    double sat_time = 0;
+
+    for (int f = 0; f < CROSSCHECK_FORMULAS; f++) {
+        char expression[BENCH_FORMULA_SIZE];
+        size_t len = 0;
+        int num_vars = 1 + (int) (next_random() % 8);
+        int depth = 1 + (int) (next_random() % 6);
+        program prog;
+        classification result;
+        error_status status;
+
+        if (!random_formula(expression, BENCH_FORMULA_SIZE - 1, &len, num_vars, depth)) continue;
+        if (!load_bench_expression(expression, &prog)) return 0;
+
+        double start = now_seconds();
+        init_error_status(&status);
+        int ok = classify_program(&prog, &result, &status);
+        sat_time += elapsed_seconds(start);
+
+        // força bruta: todas as linhas (até 2^8 = 4 palavras)
+        uint64_t rows = 1ULL << prog.num_vars;
+        uint64_t words[4];
+        int any_true = 0, any_false = 0;
+        evaluate_blocks(&prog, 0, (rows + 63) / 64, words);
+        for (uint64_t row = 0; row < rows; row++) {
+            if ((words[row / 64] >> (row % 64)) & 1) any_true = 1; else any_false = 1;
+        }
+        formula_class expected = !any_true ? CLASS_CONTRADICTION : (!any_false ? CLASS_TAUTOLOGY : CLASS_CONTINGENT);
+
+        // os exemplos devem de fato satisfazer/falsificar a fórmula
+        int values[MAX_TABLE_VARS];
+        int models_ok = 1;
+        if (ok && result.has_model) {
+            for (int j = 0; j < prog.num_vars; j++) values[j] = result.model[j];
+            models_ok &= run_program(&prog, values) == 1;
+        }
+        if (ok && result.has_countermodel) {
+            for (int j = 0; j < prog.num_vars; j++) values[j] = result.countermodel[j];
+            models_ok &= run_program(&prog, values) == 0;
+        }
+
+        if (!ok || result.kind != expected || !models_ok) {
+            failures++;
+            printf("  divergencia: %s (cdcl: %s, forca bruta: %s)\n", expression,
+                ok ? formula_class_name(result.kind) : "erro", formula_class_name(expected));
+        }
+        checked++;
+        if (ok) free_classification(&result);
+        free_program(&prog);
+    }
+
+    printf("%d formulas conferidas | %d divergencias | cdcl %.2f us/formula\n",
+        checked, failures, checked ? sat_time * 1e6 / checked : 0.0);
+    return failures == 0;
+}
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// escalabilidade da geração da tabela completa (avaliação + formatação + escrita) de 1 a N threads
+static int bench_thread_scaling(const char *expression) {
+    FILE *sink = fopen(NULL_DEVICE, "wb");
+    int max_threads = available_cores();
+    double base_time = 0;
+    program prog;
+
+    if (!sink) return 0;
+    if (!load_bench_expression(expression, &prog)) {
+        fclose(sink);
+        return 0;
+    }
+
+    // bytes das linhas da tabela (o cabeçalho é desprezível)
+    double megabytes = (double) truth_table_length(&prog, expression) / 1e6;
+    free_program(&prog);
+
+    for (int threads = 1; threads <= max_threads; threads++) {
+        table_options options;
+
+        init_table_options(&options);
+        options.threads = threads;
+        options.output = sink;
+
+        double start = now_seconds();
+        generate_truth_table_with(expression, &options);
+        double t = elapsed_seconds(start);
+        if (threads == 1) base_time = t;
+
+        printf("%2d threads | %8.3f s | %8.1f MB/s | aceleracao %5.2fx\n",
+            threads, t, t > 0 ? megabytes / t : 0.0, t > 0 ? base_time / t : 0.0);
+    }
+
+    fclose(sink);
+    return 1;
+}
+
+#define BATCH_BENCH_FORMULAS 20000
+
+// modo em lote: expressões por segundo para cada tipo de resultado
+static int bench_batch(void) {
+    static const char *names[] = {"tabela", "classificacao", "contagem"};
+    static const batch_result results[] = {BATCH_TABLE, BATCH_CLASSIFY, BATCH_COUNT};
+    FILE *in = tmpfile();
+    FILE *sink = fopen(NULL_DEVICE, "wb");
+    int ok = in && sink;
+
+    for (int f = 0; ok && f < BATCH_BENCH_FORMULAS; f++) {
+        char expression[BENCH_FORMULA_SIZE];
+        size_t len = 0;
+        int num_vars = 1 + (int) (next_random() % 10);
+        int depth = 1 + (int) (next_random() % 6);
+        if (random_formula(expression, BENCH_FORMULA_SIZE - 1, &len, num_vars, depth)) fprintf(in, "%s\n", expression);
+    }
+
+    int max_threads = available_cores();
+    for (int k = 0; ok && k < 3; k++) {
+        double base_time = 0;
+        for (int threads = 1; threads <= max_threads; threads++) {
+            batch_options options;
+            init_batch_options(&options);
+            options.result = results[k];
+            options.threads = threads;
+
+            rewind(in);
+            double start = now_seconds();
+            long long errors = run_batch(in, sink, &options);
+            double t = elapsed_seconds(start);
+            if (threads == 1) base_time = t;
+
+            printf("%-13s %2d threads | %8.3f s | %9.0f expressoes/s | aceleracao %.2fx | %lld erros\n",
+                names[k], threads, t, BATCH_BENCH_FORMULAS / t, t > 0 ? base_time / t : 0.0, errors);
+            ok &= errors == 0;
+        }
+    }
+
+    if (in) fclose(in);
+    if (sink) fclose(sink);
+    return ok;
+}
+
+#define LIBRARY_FORMULAS 24  // expressões compiladas uma vez e compartilhadas entre as threads
+#define LIBRARY_ROUNDS 16    // vezes que cada expressão é processada por rodada
+#define LIBRARY_FORMULA_SIZE 2048
+
+// resultados de uma expressão pela biblioteca: todos devem ser iguais em qualquer thread
+typedef struct {
+    uint64_t rows_checksum;  // logic_evaluate linha a linha (primeiras linhas)
+    uint64_t blocks_checksum; // logic_table_blocks
+    uint64_t count;          // logic_count
+    int kind;                // logic_classify
+    uint64_t text_hash;      // logic_table_text (FNV-1a)
+    uint64_t text_bytes;
+} library_result;
+
+typedef struct {
+    logic_expr **exprs;
+    const library_result *expected;
+    int *mismatches; // por trabalhador
+} library_job;
+
+static int hash_text(void *ctx, const char *data, size_t size) {
+    uint64_t *state = ctx; // [hash, bytes]
+    for (size_t i = 0; i < size; i++) state[0] = (state[0] ^ (unsigned char) data[i]) * 1099511628211ULL;
+    state[1] += size;
+    return 1;
+}
+
+static int checksum_blocks(void *ctx, uint64_t first_block, const uint64_t *words, uint64_t count) {
+    uint64_t *sum = ctx;
+    for (uint64_t w = 0; w < count; w++) *sum = (*sum ^ words[w]) * 31 + first_block + w;
+    return 1;
+}
+
+// calcula todos os resultados de uma expressão apenas com a interface de logic.h
+static int library_results(const logic_expr *expr, library_result *result) {
+    error_status status;
+    unsigned char values[26];
+    int n = logic_num_vars(expr);
+    uint64_t text[2] = { 1469598103934665603ULL, 0 };
+    bignum count;
+    classification kind;
+
+    memset(result, 0, sizeof(*result));
+    for (uint64_t row = 0; row < 1024 && row < (1ULL << n); row++) {
+        for (int j = 0; j < n; j++) values[j] = (unsigned char) ((row >> (n - 1 - j)) & 1);
+        result->rows_checksum = result->rows_checksum * 3 + (uint64_t) logic_evaluate(expr, values);
+    }
+
+    uint64_t blocks = ((1ULL << n) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    if (!logic_table_blocks(expr, 0, blocks, checksum_blocks, &result->blocks_checksum, &status)) return 0;
+
+    bignum_init(&count);
+    int ok = logic_count(expr, 1, &count, &status) && bignum_to_u64(&count, &result->count);
+    bignum_free(&count);
+    if (!ok || !logic_classify(expr, &kind, &status)) return 0;
+    result->kind = (int) kind.kind;
+    free_classification(&kind);
+
+    if (!logic_table_text(expr, 0, 1, hash_text, text, &status)) return 0;
+    result->text_hash = text[0];
+    result->text_bytes = text[1];
+    return 1;
+}
+
+static void library_task(void *ctx, int worker, uint64_t task) {
+    library_job *job = ctx;
+    int f = (int) (task % LIBRARY_FORMULAS);
+    library_result result;
+
+    if (!library_results(job->exprs[f], &result) || memcmp(&result, &job->expected[f], sizeof(result)) != 0)
+        job->mismatches[worker]++;
+}
+
+// liblogic: as mesmas expressões compiladas usadas por várias threads ao mesmo tempo
+static int bench_library(void) {
+    logic_expr *exprs[LIBRARY_FORMULAS] = {0};
+    library_result expected[LIBRARY_FORMULAS];
+    int max_threads = available_cores();
+    int ok = 1;
+
+    // mesmo com poucos núcleos, várias threads disputam as mesmas expressões
+    if (max_threads < 4) max_threads = 4;
+
+    for (int f = 0; ok && f < LIBRARY_FORMULAS; f++) {
+        char expression[LIBRARY_FORMULA_SIZE];
+        error_status status;
+
+        // fórmulas com as 12 a 16 primeiras letras, geradas até caber no buffer
+        do {
+            size_t len = 0;
+            if (!random_formula(expression, LIBRARY_FORMULA_SIZE - 1, &len, 12 + f % 5, 9)) continue;
+            logic_free(exprs[f]);
+            exprs[f] = logic_compile(expression, &status);
+        } while (!exprs[f] || logic_num_vars(exprs[f]) < 10);
+        ok = library_results(exprs[f], &expected[f]);
+    }
+
+    double base_time = 0;
+    for (int threads = 1; ok && threads <= max_threads; threads *= 2) {
+        thread_pool *pool = thread_pool_create(threads);
+        int *mismatches = calloc(threads, sizeof(int));
+        library_job job = { exprs, expected, mismatches };
+        int failures = 0;
+
+        if (!pool || !mismatches) {
+            thread_pool_destroy(pool);
+            free(mismatches);
+            ok = 0;
+            break;
+        }
+
+        double start = now_seconds();
+        thread_pool_run(pool, (uint64_t) LIBRARY_FORMULAS * LIBRARY_ROUNDS, library_task, &job);
+        double t = elapsed_seconds(start);
+        if (threads == 1) base_time = t;
+        for (int w = 0; w < threads; w++) failures += mismatches[w];
+
+        printf("%2d threads | %8.3f s | %8.0f expressoes/s | aceleracao %5.2fx | %d divergencias\n", threads, t,
+               LIBRARY_FORMULAS * LIBRARY_ROUNDS / t, t > 0 ? base_time / t : 0.0, failures);
+        ok &= failures == 0;
+
+        thread_pool_destroy(pool);
+        free(mismatches);
+    }
+
+    for (int f = 0; f < LIBRARY_FORMULAS; f++) logic_free(exprs[f]);
+    return ok;
+}
+
+#define SESSION_BENCH_EDITS 400       // edições aplicadas a cada fórmula
+#define SESSION_BENCH_FORMULA_SIZE 4096
+
+// confere a sessão contra a leitura e a avaliação completas do texto atual
+static int session_matches(const edit_session *s, int valid, const error_status *status) {
+    error_status expected_status;
+    program prog;
+    uint64_t words;
+
+    if (!parse_expression(session_text(s), &prog, &expected_status))
+        return !valid && status->code == expected_status.code && strcmp(status->message, expected_status.message) == 0;
+    if (!valid || session_num_vars(s) != prog.num_vars) {
+        free_program(&prog);
+        return 0;
+    }
+
+    int ok = 1;
+    for (int j = 0; ok && j < prog.num_vars; j++) ok = strcmp(session_var_name(s, j), prog.var_names[j]) == 0;
+
+    const uint64_t *table = session_table(s, &words);
+    uint64_t *expected = malloc(sizeof(uint64_t) * words);
+    if (!expected) ok = 0;
+    if (ok) {
+        evaluate_blocks(&prog, 0, words, expected);
+        if (prog.num_vars < 6) expected[0] &= (1ULL << (1 << prog.num_vars)) - 1;
+        ok = memcmp(table, expected, sizeof(uint64_t) * words) == 0;
+    }
+    free(expected);
+    free_program(&prog);
+    return ok;
+}
+
+// uma edição pequena típica de um editor: troca de operador, negação posta ou
+// tirada ou variável trocada
+static void random_edit(const char *text, size_t *offset, size_t *removed, char *inserted, int num_vars) {
+    size_t length = strlen(text);
+    size_t i = next_random() % length;
+    int kind = (int) (next_random() % 4);
+
+    while (text[i] == ' ' || text[i] == '(' || text[i] == ')') i = (i + 1) % length;
+    *offset = i;
+    *removed = 0;
+    inserted[0] = '\0';
+
+    if (text[i] == '&' || text[i] == '|') {
+        *removed = 1;
+        inserted[0] = text[i] == '&' ? '|' : '&';
+        inserted[1] = '\0';
+    } else if (text[i] == '~') {
+        *removed = 1;
+    } else if (text[i] >= 'a' && text[i] <= 'z') {
+        if (kind == 0) {
+            *removed = 1;
+            // de vez em quando uma variável nova, que muda as colunas da tabela
+            inserted[0] = (char) ('a' + next_random() % (num_vars + (next_random() % 16 == 0)));
+            inserted[1] = '\0';
+        } else {
+            strcpy(inserted, "~");
+        }
+    } else {
+        // '-', '<' ou '>' de um operador: um '~' antes do operando direito
+        while (text[*offset] != ' ') (*offset)++;
+        (*offset)++;
+        strcpy(inserted, "~");
+    }
+}
+
+// sessão de edição: cada edição pequena relê só o trecho afetado e recalcula
+// as subfórmulas dele e dos ancestrais, conferida contra o recálculo completo
+static int bench_session(void) {
+    static const int var_counts[] = { 16, 18, 20 };
+    int ok = 1;
+
+    for (size_t v = 0; ok && v < sizeof(var_counts) / sizeof(var_counts[0]); v++) {
+        int n = var_counts[v];
+        char expression[SESSION_BENCH_FORMULA_SIZE];
+        edit_session *s = session_create();
+        error_status status;
+        program prog;
+        int edits = 0, full = 0, failures = 0;
+        double edit_time = 0, rebuild_time = 0, full_time = 0, computed = 0, reused = 0;
+        size_t broken = 0; // posição do '&' que deixa o texto inválido
+
+        if (!s) return 0;
+        do {
+            size_t len = 0;
+            if (!random_formula(expression, sizeof(expression) - 1, &len, n, 12)) continue;
+            if (!session_set_text(s, expression, &status)) continue;
+        } while (session_num_vars(s) != n);
+
+        for (int e = 0; e < SESSION_BENCH_EDITS; e++) {
+            char inserted[4];
+            size_t offset, removed;
+            int valid;
+
+            // a cada dez edições um '&' solto deixa o texto inválido por mais uma
+            // edição, e só então é apagado
+            if (e % 10 == 7) {
+                random_edit(session_text(s), &offset, &removed, inserted, n);
+                broken = offset;
+                removed = 0;
+                strcpy(inserted, "& ");
+            } else if (e % 10 == 9) {
+                offset = broken;
+                removed = 2;
+                inserted[0] = '\0';
+            } else {
+                random_edit(session_text(s), &offset, &removed, inserted, n);
+                if (offset < broken) broken = broken + strlen(inserted) - removed;
+            }
+
+            double start = now_seconds();
+            valid = session_edit(s, offset, removed, inserted, &status);
+            double t = elapsed_seconds(start);
+
+            session_update update = session_last_update(s);
+            edits++;
+            full += update.full;
+            if (update.full) rebuild_time += t;
+            else edit_time += t;
+            computed += update.computed;
+            reused += update.reused;
+            if (!session_matches(s, valid, &status)) failures++;
+
+            // o mesmo texto do zero: leitura, compilação e tabela inteira
+            start = now_seconds();
+            if (parse_expression(session_text(s), &prog, &status)) {
+                uint64_t words = prog.num_vars >= 6 ? 1ULL << (prog.num_vars - 6) : 1;
+                uint64_t *table = malloc(sizeof(uint64_t) * words);
+                if (table) evaluate_blocks(&prog, 0, words, table);
+                free(table);
+                free_program(&prog);
+            }
+            full_time += elapsed_seconds(start);
+        }
+
+        printf("%2d variaveis | %4d edicoes | incremental %8.1f us | %3d completas %8.1f us | do zero %8.1f us | "
+               "%5.1f bitmaps calculados, %6.1f reaproveitados | %d divergencias\n", n, edits,
+               edit_time * 1e6 / (edits - full), full, full ? rebuild_time * 1e6 / full : 0.0,
+               full_time * 1e6 / edits, computed / edits, reused / edits, failures);
+        ok &= failures == 0;
+        session_destroy(s);
+    }
+    return ok;
+}
+
+#define RELATION_CROSSCHECK_PAIRS 2000
+#define RELATION_BENCH_VARS 24
+#define RELATION_SAT_TERMS 16 // termos de duas variáveis das fórmulas grandes demais para a tabela
+
+// slot, na tabela conjunta, de cada variável do programa; -1 se o nome não está lá
+static int relation_slots(const relation_result *result, const program *prog, int *slots) {
+    for (int j = 0; j < prog->num_vars; j++) {
+        slots[j] = -1;
+        for (int k = 0; k < result->num_vars; k++)
+            if (strcmp(result->var_names[k], prog->var_names[j]) == 0) slots[j] = k;
+        if (slots[j] < 0) return 0;
+    }
+    return 1;
+}
+
+// valores de A e B numa atribuição da tabela conjunta
+static void relation_values(const program *a, const program *b, const int *slots_a, const int *slots_b,
+                            const unsigned char *values, int *left, int *right) {
+    int local[26];
+
+    for (int j = 0; j < a->num_vars; j++) local[j] = values[slots_a[j]];
+    *left = run_program(a, local);
+    for (int j = 0; j < b->num_vars; j++) local[j] = values[slots_b[j]];
+    *right = run_program(b, local);
+}
+
+// confere o resultado contra a enumeração linha a linha da tabela conjunta: a
+// busca serial deve apontar a primeira linha que viola a relação
+static int relation_matches(const program *a, const program *b, relation_kind kind, const relation_result *result) {
+    int slots_a[26], slots_b[26];
+    unsigned char values[26];
+    int n = result->num_vars;
+
+    for (int k = 1; k < n; k++)
+        if (strcmp(result->var_names[k - 1], result->var_names[k]) >= 0) return 0;
+    if (n > a->num_vars + b->num_vars || !relation_slots(result, a, slots_a) || !relation_slots(result, b, slots_b))
+        return 0;
+
+    for (uint64_t row = 0; row < (1ULL << n); row++) {
+        int left, right;
+        for (int k = 0; k < n; k++) values[k] = (unsigned char) ((row >> (n - 1 - k)) & 1);
+        relation_values(a, b, slots_a, slots_b, values, &left, &right);
+        if (kind == RELATION_EQUIVALENT ? left == right : !left || right) continue;
+        return !result->holds && memcmp(values, result->counterexample, n) == 0 && result->left_value == left &&
+               result->right_value == right;
+    }
+    return result->holds;
+}
+
+// fórmula grande demais para a tabela: "(x01 & x02) | ... " ou a versão de De
+// Morgan "~(~(x01 & x02) & ...)"; 'broken' troca um '&' por '|' no último termo
+static char *relation_sat_formula(int de_morgan, int broken) {
+    char *text = malloc(RELATION_SAT_TERMS * 32 + 8);
+    size_t len = 0;
+
+    if (!text) return NULL;
+    if (de_morgan) len += sprintf(text + len, "~(");
+    for (int t = 0; t < RELATION_SAT_TERMS; t++) {
+        const char *op = broken && t == RELATION_SAT_TERMS - 1 ? "|" : "&";
+        len += sprintf(text + len, "%s%s(x%02d %s x%02d)", t ? (de_morgan ? " & " : " | ") : "", de_morgan ? "~" : "",
+                       2 * t, op, 2 * t + 1);
+    }
+    if (de_morgan) len += sprintf(text + len, ")");
+    return text;
+}
+
+// equivalência e implicação: busca empacotada com parada no primeiro
+// contraexemplo x comparação das duas tabelas inteiras
+static int bench_relation(void) {
+    char left[BENCH_FORMULA_SIZE], right[2 * BENCH_FORMULA_SIZE + 32];
+    int checked = 0, failures = 0, equivalent = 0;
+    int ok = 1;
+
+    // pares pequenos conferidos linha a linha; metade é equivalente por construção
+    for (int i = 0; i < RELATION_CROSSCHECK_PAIRS; i++) {
+        size_t len = 0;
+        program a, b;
+        relation_result result;
+        error_status status;
+
+        if (!random_formula(left, sizeof(left) - 1, &len, 2 + i % 6, 4)) continue;
+        if (i % 2 == 0) {
+            // absorção com uma variável que só a segunda tem: mesma função na tabela conjunta
+            snprintf(right, sizeof(right), "(%s) & ((%s) | z)", left, left);
+        } else {
+            len = 0;
+            if (!random_formula(right, BENCH_FORMULA_SIZE - 1, &len, 2 + (i / 2) % 6, 4)) continue;
+        }
+        if (!load_bench_expression(left, &a)) return 0;
+        if (!load_bench_expression(right, &b)) {
+            free_program(&a);
+            return 0;
+        }
+
+        for (int kind = RELATION_EQUIVALENT; kind <= RELATION_IMPLIES; kind++) {
+            if (!check_relation(&a, &b, (relation_kind) kind, 1, &result, &status)) {
+                fprintf(stderr, "Erro: %s\n", status.message);
+                failures++;
+                continue;
+            }
+            if (!relation_matches(&a, &b, (relation_kind) kind, &result)) failures++;
+            equivalent += kind == RELATION_EQUIVALENT && result.holds;
+            checked++;
+            free_relation_result(&result);
+        }
+        free_program(&a);
+        free_program(&b);
+    }
+    printf("conferencia: %d verificacoes (%d pares equivalentes), %d divergencias\n", checked, equivalent, failures);
+    ok &= failures == 0;
+
+    // par grande: a mesma fórmula com dupla negação (equivalente, varre a tabela
+    // inteira) e "A <-> ~C", que difere de A só onde C vale: C = última variável
+    // (contraexemplo na primeira palavra) ou C = as duas primeiras (no último quarto)
+    static const char *differences[2] = { "x", "a & b" };
+    char *big = malloc(LIBRARY_FORMULA_SIZE), *other = malloc(2 * LIBRARY_FORMULA_SIZE);
+    program a, same, changed[2];
+    int max_threads = available_cores() < 4 ? 4 : available_cores();
+
+    if (!big || !other) {
+        free(big);
+        free(other);
+        return 0;
+    }
+    do {
+        size_t len = 0;
+        if (!random_formula(big, LIBRARY_FORMULA_SIZE - 1, &len, RELATION_BENCH_VARS, 12)) continue;
+        if (!load_bench_expression(big, &a)) continue;
+        if (a.num_vars == RELATION_BENCH_VARS) break;
+        free_program(&a);
+    } while (1);
+    snprintf(other, 2 * LIBRARY_FORMULA_SIZE, "~~(%s)", big);
+    ok &= load_bench_expression(other, &same);
+    for (int d = 0; d < 2; d++) {
+        snprintf(other, 2 * LIBRARY_FORMULA_SIZE, "(%s) <-> ~(%s)", big, differences[d]);
+        ok &= load_bench_expression(other, &changed[d]);
+    }
+
+    // referência ingênua: as duas tabelas inteiras, comparadas palavra a palavra
+    uint64_t words = 1ULL << (RELATION_BENCH_VARS - 6);
+    uint64_t *table_a = malloc(sizeof(uint64_t) * words), *table_b = malloc(sizeof(uint64_t) * words);
+    double start = now_seconds();
+    if (table_a && table_b) {
+        evaluate_blocks(&a, 0, words, table_a);
+        evaluate_blocks(&same, 0, words, table_b);
+    }
+    double naive = elapsed_seconds(start);
+    int naive_equal = table_a && table_b && memcmp(table_a, table_b, sizeof(uint64_t) * words) == 0;
+    free(table_a);
+    free(table_b);
+    printf("%d variaveis: duas tabelas inteiras comparadas %10.1f us (%s)\n", RELATION_BENCH_VARS, naive * 1e6,
+           naive_equal ? "iguais" : "DIVERGENCIA");
+    ok &= naive_equal;
+
+    for (int threads = 1; ok && threads <= max_threads; threads *= 2) {
+        relation_result same_result, changed_result;
+        error_status status;
+        double times[3];
+        int valid = 1;
+
+        start = now_seconds();
+        ok &= check_relation(&a, &same, RELATION_EQUIVALENT, threads, &same_result, &status);
+        times[0] = elapsed_seconds(start);
+        if (!ok) break;
+        valid &= same_result.holds;
+        free_relation_result(&same_result);
+
+        for (int d = 0; ok && d < 2; d++) {
+            start = now_seconds();
+            ok &= check_relation(&a, &changed[d], RELATION_EQUIVALENT, threads, &changed_result, &status);
+            times[d + 1] = elapsed_seconds(start);
+            if (!ok) break;
+
+            // o contraexemplo de qualquer thread deve mesmo separar as duas fórmulas
+            int slots_a[26], slots_b[26], left, right;
+            valid &= !changed_result.holds && relation_slots(&changed_result, &a, slots_a) &&
+                     relation_slots(&changed_result, &changed[d], slots_b);
+            if (valid) {
+                relation_values(&a, &changed[d], slots_a, slots_b, changed_result.counterexample, &left, &right);
+                valid = left != right && left == changed_result.left_value && right == changed_result.right_value;
+            }
+            free_relation_result(&changed_result);
+        }
+        if (!ok) break;
+
+        printf("%2d threads | equivalentes %10.1f us | contraexemplo cedo %8.1f us | no ultimo quarto %10.1f us | %s\n",
+               threads, times[0] * 1e6, times[1] * 1e6, times[2] * 1e6, valid ? "ok" : "DIVERGENCIA");
+        ok &= valid;
+    }
+    free_program(&a);
+    free_program(&same);
+    free_program(&changed[0]);
+    free_program(&changed[1]);
+    free(big);
+    free(other);
+
+    // acima de EQUIV_PACKED_VARS o CDCL procura o contraexemplo
+    for (int broken = 0; ok && broken <= 1; broken++) {
+        char *sop = relation_sat_formula(0, 0), *dual = relation_sat_formula(1, broken);
+        program p, q;
+        relation_result result;
+        error_status status;
+
+        ok = sop && dual && load_bench_expression(sop, &p);
+        if (ok && !(ok = load_bench_expression(dual, &q))) free_program(&p);
+        if (ok) {
+            start = now_seconds();
+            ok = check_relation(&p, &q, RELATION_EQUIVALENT, 1, &result, &status);
+            double t = elapsed_seconds(start);
+            if (ok) {
+                int slots_p[2 * RELATION_SAT_TERMS], slots_q[2 * RELATION_SAT_TERMS], left = 0, right = 0;
+                int valid = relation_slots(&result, &p, slots_p) && relation_slots(&result, &q, slots_q);
+                if (valid && !result.holds) {
+                    // run_program direto: a atribuição tem mais slots que relation_values aceita
+                    int values[2 * RELATION_SAT_TERMS];
+                    for (int j = 0; j < p.num_vars; j++) values[j] = result.counterexample[slots_p[j]];
+                    left = run_program(&p, values);
+                    for (int j = 0; j < q.num_vars; j++) values[j] = result.counterexample[slots_q[j]];
+                    right = run_program(&q, values);
+                }
+                valid &= result.holds ? !broken : broken && left != right;
+                printf("%d variaveis (CDCL): %s em %8.1f us | %s\n", result.num_vars,
+                       result.holds ? "equivalentes" : "contraexemplo", t * 1e6, valid ? "ok" : "DIVERGENCIA");
+                ok = valid;
+                free_relation_result(&result);
+            }
+            free_program(&p);
+            free_program(&q);
+        }
+        free(sop);
+        free(dual);
+    }
+    return ok;
+}
+
+#define CURSOR_SEEKS 2000       // posições aleatórias conferidas por expressão
+#define CURSOR_BIG_VARS 40      // tabela grande demais para ser percorrida até a página
+#define CURSOR_PAGE_ROWS 100
+
+// linhas da página do cursor conferidas contra logic_evaluate
+static int cursor_page_matches(const logic_expr *expr, logic_cursor *cursor, int count) {
+    unsigned char values[CURSOR_BIG_VARS];
+    int result;
+
+    for (int i = 0; i < count; i++) {
+        if (!logic_cursor_next_row(cursor, values, &result)) return 0;
+        if (logic_evaluate(expr, values) != result) return 0;
+    }
+    return 1;
+}
+
+static int collect_blocks(void *ctx, uint64_t first_block, const uint64_t *words, uint64_t count) {
+    memcpy((uint64_t *) ctx + first_block, words, sizeof(uint64_t) * count);
+    return 1;
+}
+
+// cursor: busca em O(1), linhas e palavras sob demanda, posição gravada e retomada
+static int bench_cursor(void) {
+    char expression[LIBRARY_FORMULA_SIZE];
+    error_status status;
+    int failures = 0;
+
+    // tabelas pequenas: cada linha e cada palavra conferidas contra a tabela inteira
+    for (int vars = 3; vars <= 15; vars += 4) {
+        logic_expr *expr = NULL;
+        do {
+            size_t len = 0;
+            if (!random_formula(expression, LIBRARY_FORMULA_SIZE - 1, &len, vars, 8)) continue;
+            logic_free(expr);
+            expr = logic_compile(expression, &status);
+        } while (!expr || logic_num_vars(expr) != vars);
+
+        uint64_t rows = 1ULL << vars, words = (rows + 63) / 64;
+        uint64_t *table = malloc(sizeof(uint64_t) * words);
+        logic_cursor *cursor = logic_cursor_open(expr, &status);
+        if (!table || !cursor || !logic_table_blocks(expr, 0, words, collect_blocks, table, &status)) {
+            free(table);
+            logic_cursor_close(cursor);
+            logic_free(expr);
+            return 0;
+        }
+
+        for (int i = 0; i < CURSOR_SEEKS; i++) {
+            uint64_t row = next_random() % rows, first, word, valid;
+            int result;
+            logic_cursor_seek(cursor, row, &status);
+            if (i % 2 == 0) {
+                if (!logic_cursor_next_row(cursor, NULL, &result) || result != (int) ((table[row / 64] >> (row % 64)) & 1))
+                    failures++;
+            } else {
+                uint64_t expected = ((row / 64 + 1) * 64 <= rows ? ~0ULL : (1ULL << (rows - row / 64 * 64)) - 1) &
+                                    (~0ULL << (row % 64));
+                if (!logic_cursor_next_block(cursor, &first, &word, &valid) || first != row / 64 * 64 ||
+                    ((word ^ table[row / 64]) & valid) != 0 || valid != expected ||
+                    logic_cursor_tell(cursor) != (first + 64 < rows ? first + 64 : rows))
+                    failures++;
+            }
+        }
+
+        // percurso completo por palavras a partir de uma linha fora do alinhamento
+        uint64_t first, word, valid, seen = 0;
+        logic_cursor_seek(cursor, rows / 3, &status);
+        while (logic_cursor_next_block(cursor, &first, &word, &valid)) {
+            if (((word ^ table[first / 64]) & valid) != 0) failures++;
+            seen += (uint64_t) count_word_ones(valid);
+        }
+        if (seen != rows - rows / 3 || logic_cursor_next_row(cursor, NULL, &(int) {0})) failures++;
+
+        free(table);
+        logic_cursor_close(cursor);
+        logic_free(expr);
+    }
+    printf("conferencia: 3 tabelas pequenas, %d posicoes aleatorias cada e percurso por palavras, %d divergencias\n",
+           CURSOR_SEEKS, failures);
+
+    // tabela de 2^40 linhas: a página em 2^30 sai sem avaliar nada antes dela. a
+    // fórmula liga uma fórmula aleatória de 20 letras minúsculas à sua cópia em maiúsculas
+    logic_expr *big = NULL;
+    do {
+        char text[2 * LIBRARY_FORMULA_SIZE + 16];
+        size_t len = 0;
+        if (!random_formula(expression, LIBRARY_FORMULA_SIZE - 1, &len, CURSOR_BIG_VARS / 2, 10)) continue;
+        size_t half = (size_t) snprintf(text, sizeof(text), "(%s) <-> ", expression);
+        snprintf(text + half, sizeof(text) - half, "~(%s)", expression);
+        for (char *c = text + half; *c; c++) *c = (char) toupper((unsigned char) *c);
+        logic_free(big);
+        big = logic_compile(text, &status);
+    } while (!big || logic_num_vars(big) != CURSOR_BIG_VARS);
+
+    logic_cursor *cursor = logic_cursor_open(big, &status);
+    char saved[LOGIC_CURSOR_TEXT];
+    if (!cursor) {
+        logic_free(big);
+        return 0;
+    }
+
+    double start = now_seconds();
+    int page_ok = logic_cursor_seek(cursor, 1ULL << 30, &status) && cursor_page_matches(big, cursor, CURSOR_PAGE_ROWS);
+    double page = elapsed_seconds(start);
+
+    // referência: chegar à mesma linha pelas palavras desde o início (estimada por um trecho)
+    uint64_t prefix = 1ULL << 14, sink = 0;
+    start = now_seconds();
+    logic_table_blocks(big, 0, prefix, checksum_blocks, &sink, &status);
+    double sweep = elapsed_seconds(start) * (double) ((1ULL << 30) / 64 / prefix);
+
+    // posição gravada e retomada por outro cursor, como depois de reiniciar
+    int resume_ok = logic_cursor_save(cursor, saved, sizeof(saved));
+    logic_cursor *resumed = logic_cursor_open(big, &status);
+    resume_ok = resume_ok && resumed && logic_cursor_restore(resumed, saved, &status) &&
+                logic_cursor_tell(resumed) == (1ULL << 30) + CURSOR_PAGE_ROWS &&
+                cursor_page_matches(big, resumed, CURSOR_PAGE_ROWS);
+
+    // posições de outra expressão ou malformadas são recusadas
+    logic_expr *other = logic_compile("a & b", &status);
+    logic_cursor *wrong = other ? logic_cursor_open(other, &status) : NULL;
+    resume_ok = resume_ok && wrong && !logic_cursor_restore(wrong, saved, &status) &&
+                status.code == ERR_INVALID_ARGUMENT && !logic_cursor_restore(wrong, "logic-cursor 1 xyz", &status) &&
+                logic_cursor_tell(wrong) == 0;
+
+    printf("%d variaveis: linha 2^30 e mais %d linhas em %8.1f us (percorrer ate ela: ~%.1f s) | %s\n",
+           logic_num_vars(big), CURSOR_PAGE_ROWS - 1, page * 1e6, sweep, page_ok ? "ok" : "DIVERGENCIA");
+    printf("posicao gravada: \"%s\" | retomada %s\n", saved, resume_ok ? "ok" : "DIVERGENCIA");
+
+    logic_cursor_close(wrong);
+    logic_cursor_close(resumed);
+    logic_cursor_close(cursor);
+    logic_free(other);
+    logic_free(big);
+    return failures == 0 && page_ok && resume_ok;
+}
+
+#define SPEC_GUARDS 8      // guardas distintas da especificação gerada
+#define SPEC_CLAUSES 400   // cláusulas "guarda -> saída", repetindo as guardas
+#define SPEC_PASSES 5      // avaliações da tabela inteira por programa
+
+// especificação no estilo das geradas: poucas guardas repetidas centenas de vezes
+static char *shared_spec(void) {
+    char *spec = malloc(SPEC_CLAUSES * 64);
+    size_t len = 0;
+
+    if (!spec) return NULL;
+    for (int i = 0; i < SPEC_CLAUSES; i++) {
+        int g = i % SPEC_GUARDS;
+        len += sprintf(spec + len, "%s((m%d & ~reset | ready & v%d) -> o%d)",
+                       i ? " & " : "", g % 4, g / 2, i % 7);
+    }
+    return spec;
+}
+
+// programa da árvore sintática x programa do grafo com subexpressões compartilhadas
+static int bench_shared_subexpressions(void) {
+    char *spec = shared_spec();
+    program tree, shared;
+    bench_tokens tokens;
+    error_status status;
+    int ok = 1;
+
+    if (!spec || !load_bench_expression(spec, &shared)) {
+        free(spec);
+        return 0;
+    }
+    if (!load_bench_tokens(spec, &shared, &tokens)) {
+        free_program(&shared);
+        free(spec);
+        return 0;
+    }
+
+    // sem flags: tradução direta da árvore, como antes do grafo
+    ok = compile_expression_with(tokens.elements, tokens.size, &tokens.symbols, &tokens.scratch, 0, &tree, &status);
+    if (!ok) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+    } else {
+        uint64_t blocks = ((1ULL << shared.num_vars) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+        uint64_t *out_tree = malloc(sizeof(uint64_t) * blocks);
+        uint64_t *out_shared = malloc(sizeof(uint64_t) * blocks);
+        long long divergences = 0;
+
+        if (!out_tree || !out_shared) {
+            ok = 0;
+        } else {
+            double start = now_seconds();
+            for (int r = 0; r < SPEC_PASSES; r++) evaluate_blocks(&tree, 0, blocks, out_tree);
+            double tree_time = elapsed_seconds(start);
+
+            start = now_seconds();
+            for (int r = 0; r < SPEC_PASSES; r++) evaluate_blocks(&shared, 0, blocks, out_shared);
+            double shared_time = elapsed_seconds(start);
+
+            for (uint64_t b = 0; b < blocks; b++) divergences += out_tree[b] != out_shared[b];
+            double rows = (double) SPEC_PASSES * (double) (1ULL << shared.num_vars);
+
+            printf("%d tokens, %d vars | arvore %6d instrucoes %8.2f ns/linha | grafo %5d instrucoes (%d temporarios) %7.2f ns/linha | %lld divergencias\n",
+                   tokens.size, shared.num_vars, tree.length, tree_time * 1e9 / rows,
+                   shared.length, shared.num_temps, shared_time * 1e9 / rows, divergences);
+            ok = divergences == 0;
+        }
+        free(out_tree);
+        free(out_shared);
+        free_program(&tree);
+    }
+
+    arena_free(&tokens.scratch);
+    free_program(&shared);
+    free(spec);
+    return ok;
+}
+
+#define JIT_BENCH_MAX_BLOCKS (1ULL << 19) // 2^25 linhas: a carga de 25 variáveis inteira
+#define JIT_DEEP_LEVELS 40                 // aninhamento da expressão que não cabe nos registradores
+#define JIT_MIN_ROWS (1ULL << 22)          // tabelas pequenas repetem até somar isto: bem acima da resolução do relógio
+
+// expressões do código nativo: as de sempre, a carga de 25 variáveis, uma pilha
+// maior que os registradores e uma especificação com subexpressões compartilhadas
+static int bench_jit(void) {
+    char deep[JIT_DEEP_LEVELS * 16];
+    char *spec = shared_spec();
+    const char *expressions[8];
+    int count = 0, ok = 1;
+    size_t len = 0;
+
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        expressions[count++] = bench_expressions[i];
+    expressions[count++] = "(a|b|c|d|e) & (f|g|h|i|j) & (k|l|m|n|o) & (p|q|r|s|t) -> (u & ~v) | (w <-> x) & y";
+
+    // x0 & (x1 | (x2 & (x3 | ...))): profundidade de pilha JIT_DEEP_LEVELS
+    for (int i = 0; i < JIT_DEEP_LEVELS; i++)
+        len += sprintf(deep + len, "x%d %s (", i % 20, i % 2 ? "|" : "&");
+    len += sprintf(deep + len, "y");
+    for (int i = 0; i < JIT_DEEP_LEVELS; i++) deep[len++] = ')';
+    deep[len] = '\0';
+    expressions[count++] = deep;
+    if (spec) expressions[count++] = spec;
+
+    for (int k = 0; ok && k < count; k++) {
+        program prog;
+        jit_code jit;
+
+        if (!load_bench_expression(expressions[k], &prog)) return 0;
+        if (!jit_compile(&prog, &jit)) {
+            printf("codigo nativo indisponivel nesta plataforma: apenas o interpretador\n");
+            free_program(&prog);
+            break;
+        }
+
+        uint64_t blocks = ((1ULL << prog.num_vars) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+        if (blocks > JIT_BENCH_MAX_BLOCKS) blocks = JIT_BENCH_MAX_BLOCKS;
+        uint64_t table_rows = prog.num_vars < 6 ? 1ULL << prog.num_vars : blocks * ROWS_PER_WORD;
+        uint64_t passes = table_rows < JIT_MIN_ROWS ? JIT_MIN_ROWS / table_rows : 1;
+        double rows = (double) passes * (double) table_rows;
+
+        uint64_t *stack = malloc(sizeof(uint64_t) * (prog.max_depth + prog.num_temps));
+        uint64_t *frame = malloc(sizeof(uint64_t) * (jit.frame_words > 0 ? jit.frame_words : 1));
+        uint64_t *out = malloc(sizeof(uint64_t) * blocks);
+        uint64_t words[MAX_TABLE_VARS];
+        long long mismatches = 0;
+
+        if (!stack || !frame || !out) {
+            ok = 0;
+        } else {
+            // interpretador portável: uma palavra por vez, despacho por instrução
+            double start = now_seconds();
+            for (uint64_t r = 0; r < passes; r++) {
+                for (uint64_t b = 0; b < blocks; b++) {
+                    load_block_words(&prog, b, words);
+                    out[b] = run_program_word(&prog, words, stack);
+                }
+            }
+            double interp_time = elapsed_seconds(start);
+
+            // núcleo vetorial selecionado (também interpretado)
+            uint64_t *simd = malloc(sizeof(uint64_t) * blocks);
+            double simd_time = 0;
+            if (simd) {
+                start = now_seconds();
+                for (uint64_t r = 0; r < passes; r++) evaluate_blocks(&prog, 0, blocks, simd);
+                simd_time = elapsed_seconds(start);
+            }
+
+            // código nativo: mesmas palavras, sem despacho; compara só na primeira passada
+            start = now_seconds();
+            for (uint64_t r = 0; r < passes; r++) {
+                for (uint64_t b = 0; b < blocks; b++) {
+                    load_block_words(&prog, b, words);
+                    uint64_t bits = jit.run(words, frame);
+                    if (r == 0) mismatches += bits != out[b] || (simd && simd[b] != out[b]);
+                }
+            }
+            double jit_time = elapsed_seconds(start);
+            free(simd);
+
+            printf("%-2d vars %5d instr (pilha %2d) | interpretador %7.3f ns/linha | %-8s %7.3f ns/linha | nativo %7.3f ns/linha | %lld divergencias\n",
+                   prog.num_vars, prog.length, prog.max_depth, interp_time * 1e9 / rows,
+                   select_eval_kernel()->name, simd_time * 1e9 / rows, jit_time * 1e9 / rows, mismatches);
+            ok = mismatches == 0;
+        }
+
+        free(stack);
+        free(frame);
+        free(out);
+        jit_free(&jit);
+        free_program(&prog);
+    }
+
+    free(spec);
+    return ok;
+}
+
+#define TABLE_FILE_QUERIES 1000000 // consultas aleatórias de linha e de intervalo
+
+// grava a tabela binária em 'path'; 1 em caso de sucesso
+static int write_bench_table(const program *prog, const char *expression, const char *path, int threads, double *seconds) {
+    error_status status;
+    FILE *file = fopen(path, "wb");
+    if (!file) return 0;
+
+    double start = now_seconds();
+    int ok = write_table_file(prog, expression, file, threads, &status);
+    ok &= fclose(file) == 0;
+    *seconds = elapsed_seconds(start);
+    if (!ok) fprintf(stderr, "Erro: %s\n", status.message);
+    return ok;
+}
+
+// tabela binária: tamanho frente ao texto, gravação, consultas no arquivo mapeado e determinismo
+static int bench_table_file(void) {
+    static const char *paths[] = {"logic-eval-bench-1.ltt", "logic-eval-bench-2.ltt"};
+    const char *expressions[8];
+    int count = 0, ok = 1;
+
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        expressions[count++] = bench_expressions[i];
+    expressions[count++] = "(a|b|c|d|e) & (f|g|h|i|j) & (k|l|m|n|o) & (p|q|r|s|t) -> (u & ~v) | (w <-> x) & y";
+
+    for (int k = 0; ok && k < count; k++) {
+        program prog;
+        table_file tf, copy;
+        error_status status;
+        double write_time, write_time_2;
+
+        if (!load_bench_expression(expressions[k], &prog)) return 0;
+        uint64_t rows = 1ULL << prog.num_vars;
+        uint64_t blocks = (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+        uint64_t *words = malloc(sizeof(uint64_t) * blocks);
+        uint64_t *prefix = malloc(sizeof(uint64_t) * (blocks + 1)); // linhas verdadeiras antes de cada bloco
+
+        // a mesma tabela com 1 e com 2 threads deve gerar os mesmos bytes
+        if (!words || !prefix || !write_bench_table(&prog, expressions[k], paths[0], 1, &write_time) ||
+            !write_bench_table(&prog, expressions[k], paths[1], 2, &write_time_2)) {
+            free(words);
+            free(prefix);
+            free_program(&prog);
+            return 0;
+        }
+
+        double start = now_seconds();
+        int opened = table_file_open(&tf, paths[0], &status);
+        double open_time = elapsed_seconds(start);
+        if (!opened || !table_file_open(&copy, paths[1], &status)) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            if (opened) table_file_close(&tf);
+            free(words);
+            free(prefix);
+            free_program(&prog);
+            return 0;
+        }
+        int identical = tf.size == copy.size && memcmp(tf.data, copy.data, tf.size) == 0;
+        table_file_close(&copy);
+
+        // referência: palavras do núcleo vetorial e contagens acumuladas
+        uint64_t mask = rows < ROWS_PER_WORD ? (1ULL << rows) - 1 : ~0ULL;
+        evaluate_blocks(&prog, 0, blocks, words);
+        prefix[0] = 0;
+        for (uint64_t b = 0; b < blocks; b++) prefix[b + 1] = prefix[b] + (uint64_t) count_word_ones(words[b] & mask);
+
+        long long mismatches = tf.true_rows != prefix[blocks] || tf.num_vars != prog.num_vars ||
+                               strcmp(tf.expression, expressions[k]) != 0;
+        for (uint64_t r = 0; r < rows; r++)
+            mismatches += (uint64_t) table_file_value(&tf, r) != ((words[r / ROWS_PER_WORD] >> (r % ROWS_PER_WORD)) & 1);
+
+        // linhas aleatórias: consulta direta no mapeamento
+        volatile uint64_t hits = 0; // impede que as consultas sejam descartadas
+        start = now_seconds();
+        for (int q = 0; q < TABLE_FILE_QUERIES; q++) hits += (uint64_t) table_file_value(&tf, next_random() & (rows - 1));
+        double value_time = elapsed_seconds(start);
+
+        // intervalos aleatórios conferidos contra as contagens acumuladas
+        double range_time = 0;
+        for (int q = 0; q < TABLE_FILE_QUERIES; q++) {
+            uint64_t a = next_random() & (rows - 1), b = next_random() & (rows - 1);
+            if (a > b) { uint64_t t = a; a = b; b = t; }
+            b++;
+
+            start = now_seconds();
+            uint64_t got = table_file_count(&tf, a, b);
+            range_time += elapsed_seconds(start);
+
+            // referência: blocos inteiros pelo prefixo, pontas bit a bit
+            uint64_t want = 0;
+            if (a / ROWS_PER_WORD == (b - 1) / ROWS_PER_WORD) {
+                for (uint64_t r = a; r < b; r++) want += (words[r / ROWS_PER_WORD] >> (r % ROWS_PER_WORD)) & 1;
+            } else {
+                uint64_t wa = (a + ROWS_PER_WORD - 1) / ROWS_PER_WORD, wb = b / ROWS_PER_WORD;
+                want = prefix[wb] - prefix[wa];
+                for (uint64_t r = a; r < wa * ROWS_PER_WORD; r++) want += (words[r / ROWS_PER_WORD] >> (r % ROWS_PER_WORD)) & 1;
+                for (uint64_t r = wb * ROWS_PER_WORD; r < b; r++) want += (words[r / ROWS_PER_WORD] >> (r % ROWS_PER_WORD)) & 1;
+            }
+            mismatches += got != want;
+        }
+
+        printf("%-2d vars | binario %9zu B x texto %11zu B (%6.1fx) | gravacao %7.3f ms | abertura %6.1f us | "
+               "linha %5.1f ns | intervalo %6.1f ns | %s | %lld divergencias\n",
+               prog.num_vars, tf.size, truth_table_length(&prog, expressions[k]),
+               (double) truth_table_length(&prog, expressions[k]) / (double) tf.size, write_time * 1e3,
+               open_time * 1e6, value_time * 1e9 / TABLE_FILE_QUERIES, range_time * 1e9 / TABLE_FILE_QUERIES,
+               identical ? "deterministico" : "BYTES DIFERENTES", mismatches);
+        (void) hits;
+        ok = mismatches == 0 && identical;
+
+        table_file_close(&tf);
+        free(words);
+        free(prefix);
+        free_program(&prog);
+    }
+
+    remove(paths[0]);
+    remove(paths[1]);
+    return ok;
+}
+
+#define COUNT_CROSSCHECK_FORMULAS 200 // fórmulas aleatórias acima de COUNT_PACKED_VARS conferidas pelo BDD
+#define COUNT_FORMULA_SIZE 4096
+#define COUNT_NESTED_FORMULAS 40  // fórmulas aninhadas pouco acima de COUNT_PACKED_VARS
+#define COUNT_NESTED_SIZE 1400    // tamanho máximo do texto dessas fórmulas (cerca de 1 KB)
+
+// escreve em buf uma conjunção de cláusulas de 3 literais sobre x0 .. x(num_vars-1);
+// uma em cada quatro liga dois literais por '<->' em vez de '|'
+static void random_clauses(char *buf, int num_vars, int clauses) {
+    size_t len = 0;
+
+    for (int c = 0; c < clauses; c++) {
+        int a = (int) (next_random() % num_vars), b = (int) (next_random() % num_vars);
+        int d = (int) (next_random() % num_vars);
+        len += sprintf(buf + len, "%s(%sx%d %s %sx%d | %sx%d)", c ? " & " : "",
+                       next_random() % 2 ? "~" : "", a, next_random() % 4 ? "|" : "<->",
+                       next_random() % 2 ? "~" : "", b, next_random() % 2 ? "~" : "", d);
+    }
+}
+
+// fórmula aleatória aninhada sobre x0 .. x(num_vars-1), como as escritas à mão
+static int random_named_formula(char *buf, size_t cap, size_t *len, int num_vars, int depth) {
+    static const char *binary_ops[] = { " & ", " | ", " -> ", " <-> " };
+    uint64_t r = next_random();
+
+    if (depth == 0 || r % 7 == 0) {
+        if (*len + 16 > cap) return 0;
+        *len += (size_t) sprintf(buf + *len, "%sx%d", r % 3 == 0 ? "~" : "", (int) (next_random() % num_vars));
+        return 1;
+    }
+    if (*len + 8 > cap) return 0;
+    buf[(*len)++] = '(';
+    if (!random_named_formula(buf, cap, len, num_vars, depth - 1)) return 0;
+    *len += (size_t) sprintf(buf + *len, "%s", binary_ops[next_random() % 4]);
+    if (!random_named_formula(buf, cap, len, num_vars, depth - 1) || *len + 2 > cap) return 0;
+    buf[(*len)++] = ')';
+    buf[*len] = '\0';
+    return 1;
+}
+
+// contagem exata: BDD com limite e DPLL por componentes x BDD, e contagem empacotada x tabela impressa
+static int bench_count(void) {
+    char *expression = malloc(COUNT_FORMULA_SIZE);
+    double count_time = 0, bdd_time = 0;
+    int checked = 0, failures = 0;
+
+    if (!expression) return 0;
+
+    // acima de COUNT_PACKED_VARS: a contagem por componentes confere com a do BDD
+    for (int f = 0; f < COUNT_CROSSCHECK_FORMULAS; f++) {
+        int num_vars = COUNT_PACKED_VARS + 1 + (int) (next_random() % 14);
+        program prog;
+        error_status status;
+        bignum count, expected;
+
+        random_clauses(expression, num_vars, num_vars * (2 + (int) (next_random() % 3)) / 2);
+        if (!load_bench_expression(expression, &prog)) {
+            free(expression);
+            return 0;
+        }
+        if (prog.num_vars <= COUNT_PACKED_VARS) {
+            free_program(&prog);
+            continue;
+        }
+
+        bignum_init(&count);
+        bignum_init(&expected);
+        double start = now_seconds();
+        int ok = count_models(&prog, 1, &count, &status);
+        count_time += elapsed_seconds(start);
+
+        start = now_seconds();
+        bdd_manager *mgr = bdd_create(&prog, NULL, 0);
+        int root = mgr ? bdd_build(mgr, &prog, &status) : -1;
+        ok = ok && root >= 0 && bdd_sat_count_exact(mgr, root, &expected);
+        bdd_time += elapsed_seconds(start);
+        bdd_destroy(mgr);
+
+        if (!ok || bignum_compare(&count, &expected) != 0) {
+            failures++;
+            printf("  divergencia com %d variaveis: %s\n", prog.num_vars, expression);
+        }
+        checked++;
+        bignum_free(&count);
+        bignum_free(&expected);
+        free_program(&prog);
+    }
+    printf("%d formulas de %d a %d vars | %d divergencias | contagem %8.1f us/formula | bdd %8.1f us/formula\n",
+           checked, COUNT_PACKED_VARS + 1, COUNT_PACKED_VARS + 14, failures,
+           checked ? count_time * 1e6 / checked : 0.0, checked ? bdd_time * 1e6 / checked : 0.0);
+
+    // fórmulas aninhadas de 33 e 34 variáveis: sem o BDD, a busca por componentes levava minutos
+    double slowest = 0;
+    checked = 0;
+    for (int f = 0; f < COUNT_NESTED_FORMULAS; f++) {
+        int num_vars = COUNT_PACKED_VARS + 7 + f % 2;
+        size_t len = 0;
+        program prog;
+        error_status status;
+        bignum count, expected;
+
+        if (!random_named_formula(expression, COUNT_NESTED_SIZE, &len, num_vars, 9) || len < COUNT_NESTED_SIZE / 2 ||
+            !load_bench_expression(expression, &prog)) {
+            f--;
+            continue;
+        }
+        bignum_init(&count);
+        bignum_init(&expected);
+        double start = now_seconds();
+        int ok = count_models(&prog, 1, &count, &status);
+        double t = elapsed_seconds(start);
+        if (t > slowest) slowest = t;
+
+        bdd_manager *mgr = bdd_create(&prog, NULL, 0);
+        int root = mgr ? bdd_build(mgr, &prog, &status) : -1;
+        if (!ok || root < 0 || !bdd_sat_count_exact(mgr, root, &expected) || bignum_compare(&count, &expected) != 0)
+            failures++;
+        bdd_destroy(mgr);
+        checked++;
+        bignum_free(&count);
+        bignum_free(&expected);
+        free_program(&prog);
+    }
+    printf("%d formulas aninhadas de %d e %d vars | %d divergencias no total | mais lenta %8.1f ms\n", checked,
+           COUNT_PACKED_VARS + 7, COUNT_PACKED_VARS + 8, failures, slowest * 1e3);
+
+    // contar x imprimir a tabela inteira e filtrar as linhas verdadeiras
+    for (size_t k = 0; k < sizeof(bench_expressions) / sizeof(bench_expressions[0]); k++) {
+        FILE *sink = fopen(NULL_DEVICE, "wb");
+        table_options options;
+        program prog;
+        error_status status;
+        bignum count;
+
+        if (!sink || !load_bench_expression(bench_expressions[k], &prog)) {
+            if (sink) fclose(sink);
+            free(expression);
+            return 0;
+        }
+
+        init_table_options(&options);
+        options.output = sink;
+        double start = now_seconds();
+        generate_truth_table_with(bench_expressions[k], &options);
+        double table_time = elapsed_seconds(start);
+
+        bignum_init(&count);
+        start = now_seconds();
+        int ok = count_models(&prog, 1, &count, &status);
+        double serial_time = elapsed_seconds(start);
+        start = now_seconds();
+        ok = ok && count_models(&prog, available_cores(), &count, &status);
+        double parallel_time = elapsed_seconds(start);
+
+        char *text = ok ? format_model_count(&count, prog.num_vars) : NULL;
+        printf("%-2d vars | tabela %9.3f ms | contagem %8.3f ms | %2d threads %8.3f ms | %s\n",
+               prog.num_vars, table_time * 1e3, serial_time * 1e3, available_cores(),
+               parallel_time * 1e3, text ? text : "erro");
+        failures += text == NULL;
+
+        free(text);
+        bignum_free(&count);
+        free_program(&prog);
+        fclose(sink);
+    }
+
+    // acima de 64 bits: pares independentes (3^k linhas verdadeiras) e uma cadeia de implicações
+    static const int large_vars[] = {64, 200, 1000};
+    for (size_t k = 0; k < sizeof(large_vars) / sizeof(large_vars[0]); k++) {
+        for (int chain = 0; chain <= 1; chain++) {
+            char *formula = malloc((size_t) large_vars[k] * 24);
+            size_t len = 0;
+            program prog;
+            error_status status;
+            bignum count, expected;
+
+            if (!formula) {
+                free(expression);
+                return 0;
+            }
+            for (int v = 0; v + 1 < large_vars[k]; v += chain ? 1 : 2)
+                len += sprintf(formula + len, "%s(x%d %s x%d)", v ? " & " : "", v, chain ? "->" : "|", v + 1);
+            if (!load_bench_expression(formula, &prog)) {
+                free(formula);
+                free(expression);
+                return 0;
+            }
+
+            // esperado: 3^(n/2) para os pares e n + 1 para a cadeia
+            bignum_init(&count);
+            bignum_init(&expected);
+            bignum three;
+            bignum_init(&three);
+            int ok = bignum_set_u64(&expected, chain ? (uint64_t) large_vars[k] + 1 : 1) && bignum_set_u64(&three, 3);
+            for (int p = 0; ok && !chain && p < large_vars[k] / 2; p++) ok = bignum_mul(&expected, &three);
+
+            double start = now_seconds();
+            ok = ok && count_models(&prog, 1, &count, &status);
+            double t = elapsed_seconds(start);
+
+            char *digits = ok ? bignum_to_string(&count) : NULL;
+            int same = ok && bignum_compare(&count, &expected) == 0;
+            printf("%4d vars %-11s | %8.3f ms | %4zu digitos | %s\n", prog.num_vars,
+                   chain ? "cadeia" : "pares", t * 1e3, digits ? strlen(digits) : 0,
+                   same ? "contagem exata" : "CONTAGEM ERRADA");
+            failures += !same;
+
+            free(digits);
+            bignum_free(&three);
+            bignum_free(&count);
+            bignum_free(&expected);
+            free_program(&prog);
+            free(formula);
+        }
+    }
+
+    free(expression);
+    return failures == 0;
+}
+
+#define CACHE_BENCH_DIR "logic-eval-bench-cache"
+#define CACHE_CHECK_VARS 16 // tabelas até aqui são conferidas byte a byte (as maiores só são cronometradas)
+#define CACHE_WORD_VARS 20  // a partir daqui o acerto também é conferido palavra a palavra contra o recálculo
+
+// troca cada letra pela simétrica (a <-> z, A <-> Z): renomeia as variáveis invertendo a ordem alfabética
+static char *mirror_names(const char *expression) {
+    char *copy = malloc(strlen(expression) + 1);
+    if (!copy) return NULL;
+
+    for (size_t i = 0; ; i++) {
+        char c = expression[i];
+        if (c >= 'a' && c <= 'z') c = (char) ('z' - (c - 'a'));
+        else if (c >= 'A' && c <= 'Z') c = (char) ('Z' - (c - 'A'));
+        copy[i] = c;
+        if (!c) break;
+    }
+    return copy;
+}
+
+// gera a tabela em 'out' e devolve o tempo
+static double timed_table(const char *expression, result_cache *cache, FILE *out) {
+    table_options options;
+    init_table_options(&options);
+    options.cache = cache;
+    options.output = out;
+
+    double start = now_seconds();
+    generate_truth_table_with(expression, &options);
+    fflush(out);
+    return elapsed_seconds(start);
+}
+
+// 1 se os dois arquivos têm o mesmo conteúdo
+static int same_output(FILE *a, FILE *b) {
+    char block_a[4096], block_b[4096];
+
+    rewind(a);
+    rewind(b);
+    for (;;) {
+        size_t na = fread(block_a, 1, sizeof(block_a), a);
+        size_t nb = fread(block_b, 1, sizeof(block_b), b);
+        if (na != nb || memcmp(block_a, block_b, na) != 0) return 0;
+        if (na == 0) return 1;
+    }
+}
+
+// 1 se o programa vale 'expected' na atribuição (valores por slot)
+static int run_program_checked(const program *prog, const unsigned char *assignment, int expected) {
+    int *values = malloc(sizeof(int) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    if (!values) return 0;
+
+    for (int j = 0; j < prog->num_vars; j++) values[j] = assignment[j];
+    int ok = run_program(prog, values) == expected;
+    free(values);
+    return ok;
+}
+
+#define DECOMPOSE_BENCH_GUARDS 6     // partes independentes das fórmulas de contagem e classificação
+#define DECOMPOSE_BENCH_GUARD_VARS 7 // variáveis de cada parte
+#define DECOMPOSE_TABLE_GUARDS 3     // partes da fórmula tabelada
+#define DECOMPOSE_TABLE_GUARD_VARS 6
+
+// escreve em buf 'guards' partes sem variáveis em comum, ligadas por 'op'; a parte k
+// é uma conjunção de vars/2 + 1 cláusulas sobre x(k*vars) .. x(k*vars + vars - 1)
+static void random_guards(char *buf, int guards, int vars, const char *op) {
+    size_t len = 0;
+
+    for (int k = 0; k < guards; k++) {
+        int base = k * vars;
+        len += sprintf(buf + len, "%s(", k ? op : "");
+        for (int c = 0; c < vars / 2 + 1; c++) {
+            int a = base + (int) (next_random() % vars), b = base + (int) (next_random() % vars);
+            len += sprintf(buf + len, "%s(%sx%d %s %sx%d)", c ? " & " : "", next_random() % 2 ? "~" : "", a,
+                           next_random() % 3 ? "|" : "<->", next_random() % 2 ? "~" : "", b);
+        }
+        len += sprintf(buf + len, ")");
+    }
+}
+
+// gera a tabela da expressão em 'out', com ou sem a divisão em partes, e devolve o tempo
+static double timed_parts_table(const char *expression, int decompose, FILE *out) {
+    table_options options;
+    init_table_options(&options);
+    options.decompose = decompose;
+    options.output = out;
+
+    double start = now_seconds();
+    generate_truth_table_with(expression, &options);
+    fflush(out);
+    return elapsed_seconds(start);
+}
+
+// partes independentes: contagem conferida pelo BDD, atribuições da classificação
+// conferidas no programa e tabela montada das partes idêntica à avaliada inteira
+static int bench_decompose(void) {
+    static const char *ops[] = { " & ", " | " };
+    size_t cap = (size_t) DECOMPOSE_BENCH_GUARDS * DECOMPOSE_BENCH_GUARD_VARS * 32 + 16;
+    char *expression = malloc(cap);
+    int failures = 0;
+
+    if (!expression) return 0;
+
+    for (int o = 0; o < 2; o++) {
+        program prog;
+        error_status status;
+        decomposition d;
+        classification result;
+        bignum count, expected;
+
+        random_guards(expression, DECOMPOSE_BENCH_GUARDS, DECOMPOSE_BENCH_GUARD_VARS, ops[o]);
+        if (!load_bench_expression(expression, &prog)) {
+            free(expression);
+            return 0;
+        }
+
+        int parts = decompose_program(&prog, &d, &status);
+        if (parts > 1) free_decomposition(&d);
+
+        bignum_init(&count);
+        bignum_init(&expected);
+        double start = now_seconds();
+        int ok = count_models(&prog, 1, &count, &status);
+        double count_time = elapsed_seconds(start);
+
+        start = now_seconds();
+        bdd_manager *mgr = bdd_create(&prog, NULL, 0);
+        int root = mgr ? bdd_build(mgr, &prog, &status) : -1;
+        ok = ok && root >= 0 && bdd_sat_count_exact(mgr, root, &expected);
+        double bdd_time = elapsed_seconds(start);
+        bdd_destroy(mgr);
+        int same_count = ok && bignum_compare(&count, &expected) == 0;
+
+        start = now_seconds();
+        int classified = classify_program(&prog, &result, &status);
+        double classify_time = elapsed_seconds(start);
+        int valid = classified &&
+                    result.has_model == (count.size > 0) &&
+                    (!result.has_model || run_program_checked(&prog, result.model, 1)) &&
+                    (!result.has_countermodel || run_program_checked(&prog, result.countermodel, 0));
+        if (classified) free_classification(&result);
+
+        char *text = same_count ? format_model_count(&count, prog.num_vars) : NULL;
+        printf("%d vars, %d partes por '%c' | contagem %8.3f ms (bdd %8.3f ms) | classificacao %8.3f ms | %s%s\n",
+               prog.num_vars, parts, ops[o][1], count_time * 1e3, bdd_time * 1e3, classify_time * 1e3,
+               text ? text : "CONTAGEM ERRADA", valid ? "" : " | ATRIBUICAO ERRADA");
+        failures += !same_count || !valid || parts < 2;
+
+        free(text);
+        bignum_free(&count);
+        bignum_free(&expected);
+        free_program(&prog);
+    }
+
+    // tabela inteira: 2^n linhas combinadas de 2^n1 + 2^n2 + ... avaliações
+    for (int o = 0; o < 2; o++) {
+        FILE *with_parts = tmpfile(), *whole = tmpfile();
+        program prog;
+
+        random_guards(expression, DECOMPOSE_TABLE_GUARDS, DECOMPOSE_TABLE_GUARD_VARS, ops[o]);
+        if (!with_parts || !whole || !load_bench_expression(expression, &prog)) {
+            if (with_parts) fclose(with_parts);
+            if (whole) fclose(whole);
+            free(expression);
+            return 0;
+        }
+
+        double parts_time = timed_parts_table(expression, 1, with_parts);
+        double whole_time = timed_parts_table(expression, 0, whole);
+        int same = same_output(with_parts, whole);
+        printf("tabela de %d vars por '%c' | partes %9.3f ms | inteira %9.3f ms | %s\n",
+               prog.num_vars, ops[o][1], parts_time * 1e3, whole_time * 1e3,
+               same ? "saida identica" : "SAIDA DIFERENTE");
+        failures += !same;
+
+        free_program(&prog);
+        fclose(with_parts);
+        fclose(whole);
+    }
+
+    free(expression);
+    return failures == 0;
+}
+
+#define MINIMIZE_GUARD_VARS 6 // variáveis de cada parte das fórmulas minimizadas além das de referência
+
+// 1 se a expressão minimizada equivale à original: (original) <-> (minimizada) é tautologia
+static int same_function(const char *expression, const char *minimized) {
+    char *both = malloc(strlen(expression) + strlen(minimized) + 16);
+    program prog;
+    error_status status;
+    classification result;
+    int same = 0;
+
+    if (!both) return 0;
+    sprintf(both, "(%s) <-> (%s)", expression, minimized);
+    if (parse_expression(both, &prog, &status)) {
+        if (classify_program(&prog, &result, &status)) {
+            same = result.kind == CLASS_TAUTOLOGY;
+            free_classification(&result);
+        }
+        free_program(&prog);
+    }
+    free(both);
+    return same;
+}
+
+// minimização: tamanho e tempo da soma de produtos e do produto de somas, conferidos pelo SAT
+static int bench_minimize(void) {
+    // além das expressões de referência, partes independentes e uma fórmula de 20 variáveis (heurístico)
+    static const char *structured =
+        "((a & b) | (c & ~d)) & ((e <-> f) | g) | (h & i & ~j) | ((k | l) & (m -> n)) & ~(o & p) | (q & r & s & t)";
+    size_t count = sizeof(bench_expressions) / sizeof(bench_expressions[0]);
+    char *guards = malloc((size_t) 4 * MINIMIZE_GUARD_VARS * 32 + 16);
+    int failures = 0;
+
+    if (!guards) return 0;
+    random_guards(guards, 4, MINIMIZE_GUARD_VARS, " | ");
+
+    for (size_t k = 0; k < count + 2; k++) {
+        const char *expression = k < count ? bench_expressions[k] : k == count ? guards : structured;
+        program prog;
+
+        if (!load_bench_expression(expression, &prog)) {
+            failures++;
+            continue;
+        }
+
+        for (int form = MINIMIZE_SOP; form <= MINIMIZE_POS; form++) {
+            minimized_formula formula;
+            error_status status;
+
+            double start = now_seconds();
+            int ok = minimize_program(&prog, (minimize_form) form, 1, &formula, &status);
+            double t = elapsed_seconds(start);
+
+            char *text = ok ? format_minimized(&formula, prog.var_names) : NULL;
+            int same = text && same_function(expression, text);
+            printf("%-2d vars %s | %9.3f ms | %5d %s %6d literais | %-16s | %s\n", prog.num_vars,
+                   form == MINIMIZE_SOP ? "SOP" : "POS", t * 1e3, ok ? formula.num_terms : 0,
+                   form == MINIMIZE_SOP ? "termos   " : "clausulas", ok ? formula.literals : 0,
+                   ok && formula.exact ? "cobertura minima" : "heuristica",
+                   same ? "equivalente" : "NAO EQUIVALENTE");
+            failures += !same;
+
+            free(text);
+            if (ok) free_minimized(&formula);
+        }
+        free_program(&prog);
+    }
+
+    free(guards);
+    return failures == 0;
+}
+
+// remove as entradas do cache de teste (as chaves são conhecidas) e o diretório
+static void remove_bench_cache(const char **expressions, int count) {
+    char path[256];
+
+    for (int k = 0; k < count; k++) {
+        program prog;
+        char key[CACHE_KEY_CHARS + 1];
+        error_status status;
+
+        if (!parse_expression(expressions[k], &prog, &status)) continue;
+        if (cache_key(&prog, key)) {
+            snprintf(path, sizeof(path), "%s/%s.ltt", CACHE_BENCH_DIR, key);
+            remove(path);
+            snprintf(path, sizeof(path), "%s/%s.cls", CACHE_BENCH_DIR, key);
+            remove(path);
+        }
+        free_program(&prog);
+    }
+    remove(CACHE_BENCH_DIR "/lock");
+    remove(CACHE_BENCH_DIR "/stats");
+    remove(CACHE_BENCH_DIR);
+}
+
+// classificação com o cache e o tempo gasto; 1 em caso de sucesso
+static int timed_classify(const char *expression, result_cache *cache, classification *result, double *seconds) {
+    error_status status;
+    program prog;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    double start = now_seconds();
+    int ok = cache_classify(cache, &prog, result, &status);
+    *seconds = elapsed_seconds(start);
+
+    // os exemplos (convertidos da ordem canônica) precisam valer para este programa
+    if (ok && result->has_model) ok = run_program_checked(&prog, result->model, 1);
+    if (ok && result->has_countermodel) ok = run_program_checked(&prog, result->countermodel, 0);
+    free_program(&prog);
+    return ok;
+}
+
+// acerto lido palavra a palavra contra o recálculo com o núcleo empacotado; 1 se não houver divergências
+static int cache_words(result_cache *cache, const char *expression, double *hit_time, double *plain_time) {
+    program prog;
+    cached_table table;
+    int ok = 0;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    uint64_t blocks = ((1ULL << prog.num_vars) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    uint64_t *words = malloc(sizeof(uint64_t) * blocks);
+
+    double start = now_seconds();
+    if (words) evaluate_blocks(&prog, 0, blocks, words);
+    *plain_time = elapsed_seconds(start);
+
+    start = now_seconds();
+    if (words && cache_fetch_table(cache, &prog, expression, 1, &table)) {
+        uint64_t differ = 0;
+        for (uint64_t b = 0; b < blocks; b++) differ |= cached_table_word(&table, b) ^ words[b];
+        *hit_time = elapsed_seconds(start);
+        ok = differ == 0;
+        cached_table_close(&table);
+    }
+
+    free(words);
+    free_program(&prog);
+    return ok;
+}
+
+// cache persistente: tabela e classificação sem cache, com o cache vazio, com acerto e com nomes trocados
+static int bench_cache(void) {
+    const char *expressions[8];
+    char *mirrored[8] = {0};
+    char *spec = shared_spec();
+    error_status status;
+    int count = 0, ok = 1;
+
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        expressions[count++] = bench_expressions[i];
+    if (spec) expressions[count++] = spec;
+    for (int k = 0; k < count; k++) mirrored[k] = mirror_names(expressions[k]);
+    remove_bench_cache(expressions, count);
+
+    result_cache *cache = cache_open(CACHE_BENCH_DIR, 0, &status);
+    if (!cache) {
+        printf("cache indisponivel: %s\n", status.message);
+        free(spec);
+        return 1;
+    }
+
+    // tabelas: a renomeada (ordem alfabética invertida) passa pela conversão de linhas
+    for (int k = 0; ok && k < count - (spec != NULL); k++) {
+        program prog;
+        if (!mirrored[k] || !load_bench_expression(expressions[k], &prog)) {
+            ok = 0;
+            break;
+        }
+        int small = prog.num_vars <= CACHE_CHECK_VARS;
+        FILE *out[5];
+        for (int f = 0; f < 5; f++) out[f] = small ? tmpfile() : fopen(NULL_DEVICE, "wb");
+
+        if (out[0] && out[1] && out[2] && out[3] && out[4]) {
+            double plain_time = timed_table(expressions[k], NULL, out[0]);
+            double cold_time = timed_table(expressions[k], cache, out[1]);
+            double warm_time = timed_table(expressions[k], cache, out[2]);
+            double renamed_time = timed_table(mirrored[k], cache, out[3]);
+            timed_table(mirrored[k], NULL, out[4]);
+
+            int same = !small || (same_output(out[0], out[1]) && same_output(out[0], out[2]) && same_output(out[4], out[3]));
+            printf("%-2d vars | sem cache %8.3f ms | falha %8.3f ms | acerto %8.3f ms | renomeada %8.3f ms | %s\n",
+                   prog.num_vars, plain_time * 1e3, cold_time * 1e3, warm_time * 1e3, renamed_time * 1e3,
+                   small ? (same ? "saida identica" : "SAIDA DIFERENTE") : "saida nao conferida");
+            ok = same;
+
+            // tabelas grandes: só as palavras, sem o custo do texto
+            if (ok && prog.num_vars >= CACHE_WORD_VARS) {
+                double plain_words, hit_words, renamed_words;
+                ok = cache_words(cache, expressions[k], &hit_words, &plain_words) &&
+                     cache_words(cache, mirrored[k], &renamed_words, &plain_words);
+                printf("%-2d vars | palavras: recalculo %8.3f ms | acerto %8.3f ms | renomeada %8.3f ms | %s\n",
+                       prog.num_vars, plain_words * 1e3, hit_words * 1e3, renamed_words * 1e3,
+                       ok ? "0 divergencias" : "PALAVRAS DIFERENTES");
+            }
+        } else {
+            ok = 0;
+        }
+
+        for (int f = 0; f < 5; f++) if (out[f]) fclose(out[f]);
+        free_program(&prog);
+    }
+
+    // classificação: o acerto devolve as mesmas atribuições da falha
+    for (int k = 0; ok && k < count; k++) {
+        classification cold, warm, renamed;
+        double cold_time, warm_time, renamed_time;
+
+        if (!mirrored[k] || !timed_classify(expressions[k], cache, &cold, &cold_time)) {
+            ok = 0;
+            break;
+        }
+        ok = timed_classify(expressions[k], cache, &warm, &warm_time);
+        if (ok && !timed_classify(mirrored[k], cache, &renamed, &renamed_time)) {
+            free_classification(&warm);
+            ok = 0;
+        }
+        if (ok) {
+            int same = warm.kind == cold.kind && renamed.kind == cold.kind;
+            printf("classificacao %5zu bytes | falha %9.1f us | acerto %7.1f us | renomeada %7.1f us | %s\n",
+                   strlen(expressions[k]), cold_time * 1e6, warm_time * 1e6, renamed_time * 1e6,
+                   same ? "mesma classe" : "CLASSE DIFERENTE");
+            ok = same;
+            free_classification(&warm);
+            free_classification(&renamed);
+        }
+        free_classification(&cold);
+    }
+
+    cache_stats stats;
+    cache_get_stats(cache, &stats);
+    printf("%llu acertos, %llu falhas, %llu entradas, %llu bytes\n",
+           (unsigned long long) stats.hits, (unsigned long long) stats.misses,
+           (unsigned long long) stats.entries, (unsigned long long) stats.bytes);
+
+    cache_close(cache);
+    remove_bench_cache(expressions, count);
+    for (int k = 0; k < count; k++) free(mirrored[k]);
+    free(spec);
+    return ok;
+}
+
+#define LARGE_ATOMS 4096 // proposições distintas (x0 .. x4095) nas expressões grandes
+
+// escreve em buf uma expressão com cerca de 'tokens' tokens e no máximo 'max_bytes' caracteres:
+// grupos "(xi op ~xj)" ligados por operadores; 'written' recebe os tokens gerados (NULL = não informa)
+static size_t large_formula(char *buf, long tokens, size_t max_bytes, long *written) {
+    static const char *ops[] = {" & ", " | ", " -> ", " <-> "};
+    size_t len = 0;
+    long count = 0;
+
+    for (long t = 0; t < tokens && len + 32 <= max_bytes; t += 7) {
+        if (t) {
+            len += sprintf(buf + len, "%s", ops[next_random() % 4]);
+            count++;
+        }
+        len += sprintf(buf + len, "(x%d%s~x%d)", (int) (next_random() % LARGE_ATOMS),
+                       ops[next_random() % 4], (int) (next_random() % LARGE_ATOMS));
+        count += 6; // '(', xi, op, '~', xj, ')'
+    }
+    if (written) *written = count;
+    return len;
+}
+
+// leitura e compilação de expressões longas: ns/token e memória da arena e do programa
+static int bench_large_expressions(void) {
+    static const long sizes[] = {10000, 100000, 1000000};
+    arena scratch;
+    int ok = 1;
+
+    arena_init(&scratch, 0);
+    for (size_t k = 0; ok && k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        char *expression = malloc((size_t) sizes[k] * 4 + 64);
+        program prog;
+        error_status status;
+
+        if (!expression) {
+            ok = 0;
+            break;
+        }
+        long tokens;
+        large_formula(expression, sizes[k], (size_t) sizes[k] * 4, &tokens);
+
+        // a primeira leitura dimensiona a arena; as seguintes reutilizam a memória
+        double start = now_seconds();
+        ok = parse_expression_with(expression, &scratch, &prog, &status);
+        double first_time = elapsed_seconds(start);
+        size_t reserved = scratch.reserved;
+
+        double again_time = 0;
+        for (int r = 0; ok && r < 3; r++) {
+            free_program(&prog);
+            start = now_seconds();
+            ok = parse_expression_with(expression, &scratch, &prog, &status);
+            again_time += elapsed_seconds(start) / 3;
+        }
+        if (!ok) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            free(expression);
+            break;
+        }
+
+        size_t program_bytes = sizeof(instruction) * (size_t) prog.length;
+        for (int j = 0; j < prog.num_vars; j++) program_bytes += sizeof(char *) + strlen(prog.var_names[j]) + 1;
+
+        // ns/token sobre os tokens lidos: o programa compartilhado tem bem menos instruções que a entrada
+        printf("%8ld tokens %4d vars | 1a leitura %7.2f ns/token | reuso %7.2f ns/token | arena %6.2f MB%s | programa %6.2f MB\n",
+            tokens, prog.num_vars, first_time * 1e9 / tokens, again_time * 1e9 / tokens,
+            reserved / 1e6, scratch.reserved == reserved ? "" : " (cresceu!)", program_bytes / 1e6);
+
+        ok &= scratch.reserved == reserved;
+        free_program(&prog);
+        free(expression);
+    }
+
+    arena_free(&scratch);
+    return ok;
+}
+
+#define PARSER_BENCH_SECONDS 0.2 // tempo mínimo medido por tamanho de entrada
+
+// analisador léxico de uma passada: validação sozinha e leitura completa (tokens, símbolos, programa)
+static int bench_parser(void) {
+    static const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    arena scratch;
+    int ok = 1;
+
+    arena_init(&scratch, 0);
+    for (size_t k = 0; ok && k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        char *expression = malloc(sizes[k] + 1);
+        error_status status;
+        program prog;
+
+        if (!expression) {
+            ok = 0;
+            break;
+        }
+        size_t length = large_formula(expression, (long) sizes[k], sizes[k], NULL);
+
+        // repete as entradas pequenas até acumular tempo suficiente para medir
+        long validations = 0, parses = 0;
+        double start = now_seconds(), validate_time;
+        do {
+            ok &= validate_expression(expression, &status);
+            validations++;
+        } while ((validate_time = elapsed_seconds(start)) < PARSER_BENCH_SECONDS);
+
+        double parse_time;
+        start = now_seconds();
+        do {
+            if (!parse_expression_with(expression, &scratch, &prog, &status)) {
+                ok = 0;
+                break;
+            }
+            free_program(&prog);
+            parses++;
+        } while ((parse_time = elapsed_seconds(start)) < PARSER_BENCH_SECONDS);
+
+        if (!ok) fprintf(stderr, "Erro: %s\n", status.message);
+        else printf("%9zu bytes | validacao %7.3f ns/byte (%7.1f MB/s) | leitura + compilacao %7.3f ns/byte (%6.1f MB/s)\n",
+                    length, validate_time * 1e9 / ((double) validations * length), (double) validations * length / validate_time / 1e6,
+                    parse_time * 1e9 / ((double) parses * length), (double) parses * length / parse_time / 1e6);
+        free(expression);
+    }
+
+    arena_free(&scratch);
+    return ok;
+}
+
+// --- suíte com resultados em JSON e modo de regressão ---
+
+#define SUITE_MAX_VARS 28           // maior tabela avaliada pela suíte
+#define SUITE_MAX_DEPTH 16          // maior profundidade das fórmulas geradas
+#define SUITE_STAGE_SECONDS 0.05    // tempo mínimo medido por fórmula em cada estágio
+#define SUITE_OPERATORS 5           // &, |, ->, <-> e ~, nessa ordem
+
+static const char *suite_operator_text[SUITE_OPERATORS] = { " & ", " | ", " -> ", " <-> ", "~" };
+static const char *suite_operator_name[SUITE_OPERATORS] = { "&", "|", "->", "<->", "~" };
+
+// parâmetros da suíte (linha de comando)
+typedef struct {
+    int vars;                     // variáveis de cada fórmula
+    int depth;                    // profundidade da árvore (2^depth folhas)
+    int formulas;                 // fórmulas geradas
+    int repeat;                   // repetições de cada estágio (vale a melhor)
+    uint64_t seed;                // semente do gerador
+    int weights[SUITE_OPERATORS]; // peso de cada operador na mistura
+    const char *json_path;        // arquivo de resultados (NULL = não grava)
+    const char *baseline_path;    // resultados de referência (NULL = sem comparação)
+    double threshold;             // queda de vazão tolerada, em porcentagem
+} suite_config;
+
+// estágio medido: quantidade processada e o melhor tempo
+typedef struct {
+    const char *name;  // chave no JSON
+    const char *unit;  // o que 'amount' conta
+    double amount;     // tokens, linhas ou bytes por repetição
+    double seconds;    // melhor tempo entre as repetições
+} suite_stage;
+
+enum { STAGE_PARSE, STAGE_EVALUATE, STAGE_SCALAR, STAGE_OUTPUT, SUITE_STAGES };
+
+// gerador das fórmulas da suíte, independente do gerador das outras seções
+typedef struct {
+    const suite_config *config;
+    uint64_t state;
+    char *buf;
+    size_t len;
+    long tokens;
+    int leaf;
+    int *order; // ordem das variáveis nas primeiras folhas (todas aparecem se houver folhas)
+} suite_generator;
+
+static uint64_t suite_random(suite_generator *g) {
+    g->state ^= g->state << 13;
+    g->state ^= g->state >> 7;
+    g->state ^= g->state << 17;
+    return g->state;
+}
+
+// sorteia um índice de 'weights' proporcionalmente ao peso
+static int suite_pick(suite_generator *g, const int *weights, int count) {
+    int total = 0;
+    for (int i = 0; i < count; i++) total += weights[i];
+
+    int r = (int) (suite_random(g) % (uint64_t) total);
+    for (int i = 0; i < count; i++) {
+        if (r < weights[i]) return i;
+        r -= weights[i];
+    }
+    return count - 1;
+}
+
+// árvore completa de profundidade 'depth'; cada nó é negado com a chance do peso de '~'
+static void suite_formula(suite_generator *g, int depth) {
+    const int *weights = g->config->weights;
+    int total = 0;
+    for (int i = 0; i < SUITE_OPERATORS; i++) total += weights[i];
+
+    if ((int) (suite_random(g) % (uint64_t) total) < weights[SUITE_OPERATORS - 1]) {
+        g->buf[g->len++] = '~';
+        g->tokens++;
+    }
+
+    if (depth == 0) {
+        int var = g->leaf < g->config->vars ? g->order[g->leaf] : (int) (suite_random(g) % (uint64_t) g->config->vars);
+        g->leaf++;
+        g->len += sprintf(g->buf + g->len, "x%d", var);
+        g->tokens++;
+        return;
+    }
+
+    int op = suite_pick(g, weights, SUITE_OPERATORS - 1);
+    g->buf[g->len++] = '(';
+    suite_formula(g, depth - 1);
+    g->len += sprintf(g->buf + g->len, "%s", suite_operator_text[op]);
+    suite_formula(g, depth - 1);
+    g->buf[g->len++] = ')';
+    g->tokens += 3;
+}
+
+// gera a próxima fórmula; 'tokens' recebe o número de tokens do texto
+static char *suite_next_formula(suite_generator *g, long *tokens) {
+    // por folha: "~x" + até 10 dígitos; por nó interno: "~(" + " <-> " + ")"
+    size_t leaves = (size_t) 1 << g->config->depth;
+    g->buf = malloc(leaves * 13 + leaves * 8 + 1);
+    if (!g->buf) return NULL;
+
+    // embaralha a ordem das variáveis das primeiras folhas
+    for (int j = 0; j < g->config->vars; j++) g->order[j] = j;
+    for (int j = g->config->vars - 1; j > 0; j--) {
+        int k = (int) (suite_random(g) % (uint64_t) (j + 1));
+        int t = g->order[j];
+        g->order[j] = g->order[k];
+        g->order[k] = t;
+    }
+
+    g->len = 0;
+    g->tokens = 0;
+    g->leaf = 0;
+    suite_formula(g, g->config->depth);
+    g->buf[g->len] = '\0';
+    *tokens = g->tokens;
+    return g->buf;
+}
+
+// mede os estágios de uma fórmula, somando ao total da repetição
+static int suite_measure(const char *expression, long tokens, suite_stage *stages, double *times) {
+    program prog;
+    error_status status;
+    long repeats = 0;
+
+    // leitura e compilação, repetidas até acumular tempo suficiente; vale a mais rápida
+    double begin = now_seconds(), best = 0, start;
+    do {
+        start = now_seconds();
+        if (!parse_expression(expression, &prog, &status)) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            return 0;
+        }
+        free_program(&prog);
+        double t = elapsed_seconds(start);
+        if (repeats++ == 0 || t < best) best = t;
+    } while (elapsed_seconds(begin) < SUITE_STAGE_SECONDS);
+    stages[STAGE_PARSE].amount += (double) tokens;
+    times[STAGE_PARSE] += best;
+
+    if (!load_bench_expression(expression, &prog)) return 0;
+    uint64_t rows = 1ULL << prog.num_vars;
+    uint64_t blocks = (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    uint64_t window[BENCH_WINDOW_WORDS], checksum = 0;
+
+    // avaliação empacotada da tabela inteira
+    start = now_seconds();
+    for (uint64_t block = 0; block < blocks; block += BENCH_WINDOW_WORDS) {
+        uint64_t n = blocks - block < BENCH_WINDOW_WORDS ? blocks - block : BENCH_WINDOW_WORDS;
+        evaluate_blocks(&prog, block, n, window);
+        for (uint64_t w = 0; w < n; w++) checksum ^= window[w];
+    }
+    stages[STAGE_EVALUATE].amount += (double) rows;
+    times[STAGE_EVALUATE] += elapsed_seconds(start);
+
+    // avaliação linha a linha (o programa escalar), em uma amostra de até 2^12 linhas
+    uint64_t sample = rows < (1ULL << 12) ? rows : 1ULL << 12;
+    int values[SUITE_MAX_VARS];
+    long ones = 0;
+    start = now_seconds();
+    for (uint64_t row = 0; row < sample; row++) {
+        for (int j = 0; j < prog.num_vars; j++) values[j] = (int) ((row >> (prog.num_vars - j - 1)) & 1);
+        ones += run_program(&prog, values);
+    }
+    stages[STAGE_SCALAR].amount += (double) sample;
+    times[STAGE_SCALAR] += elapsed_seconds(start);
+
+    // tabela em texto, formatada e gravada no dispositivo nulo
+    FILE *sink = fopen(NULL_DEVICE, "wb");
+    table_options options;
+    if (!sink) {
+        free_program(&prog);
+        return 0;
+    }
+    init_table_options(&options);
+    options.output = sink;
+    start = now_seconds();
+    generate_truth_table_with(expression, &options);
+    fflush(sink);
+    times[STAGE_OUTPUT] += elapsed_seconds(start);
+    stages[STAGE_OUTPUT].amount += (double) truth_table_length(&prog, expression);
+    fclose(sink);
+
+    // o checksum e as linhas verdadeiras só impedem que o compilador descarte a avaliação
+    if (checksum == 1 && ones < 0) printf(" ");
+    free_program(&prog);
+    return 1;
+}
+
+// vazão do estágio (unidades por segundo)
+static double stage_throughput(const suite_stage *stage) {
+    return stage->seconds > 0 ? stage->amount / stage->seconds : 0.0;
+}
+
+static int write_suite_json(const char *path, const suite_config *config, const suite_stage *stages, int num_vars) {
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", path);
+        return 0;
+    }
+
+    fprintf(out, "{\n  \"config\": {\"vars\": %d, \"depth\": %d, \"formulas\": %d, \"repeat\": %d, "
+                 "\"seed\": %llu, \"mix\": {",
+            num_vars, config->depth, config->formulas, config->repeat, (unsigned long long) config->seed);
+    for (int i = 0; i < SUITE_OPERATORS; i++)
+        fprintf(out, "%s\"%s\": %d", i ? ", " : "", suite_operator_name[i], config->weights[i]);
+    fprintf(out, "}},\n  \"kernel\": \"%s\",\n  \"stages\": {\n", select_eval_kernel()->name);
+
+    for (int s = 0; s < SUITE_STAGES; s++) {
+        const suite_stage *stage = &stages[s];
+        fprintf(out, "    \"%s\": {\"%s\": %.0f, \"seconds\": %.6f, \"ns_per_unit\": %.4f, \"throughput\": %.1f}%s\n",
+                stage->name, stage->unit, stage->amount, stage->seconds,
+                stage->amount > 0 ? stage->seconds * 1e9 / stage->amount : 0.0, stage_throughput(stage),
+                s + 1 < SUITE_STAGES ? "," : "");
+    }
+    fprintf(out, "  }\n}\n");
+    return fclose(out) == 0;
+}
+
+// valor numérico que segue '"key":' a partir de 'from'; NAN se não houver
+static double json_number_after(const char *from, const char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *at = from ? strstr(from, pattern) : NULL;
+    return at ? strtod(at + strlen(pattern), NULL) : NAN;
+}
+
+// lê um arquivo inteiro para a memória, terminado em '\0'
+static char *read_text_file(const char *path) {
+    FILE *in = fopen(path, "rb");
+    char *text = NULL;
+    long size;
+
+    if (!in) return NULL;
+    if (fseek(in, 0, SEEK_END) == 0 && (size = ftell(in)) >= 0 && fseek(in, 0, SEEK_SET) == 0 &&
+        (text = malloc((size_t) size + 1))) {
+        size_t got = fread(text, 1, (size_t) size, in);
+        text[got] = '\0';
+    }
+    fclose(in);
+    return text;
+}
+
+// compara com a referência: falha se a vazão de algum estágio cair mais que o limite
+static int check_suite_baseline(const suite_config *config, const suite_stage *stages, int num_vars) {
+    char *baseline = read_text_file(config->baseline_path);
+    int ok = 1;
+
+    if (!baseline) {
+        fprintf(stderr, "Erro: nao foi possivel ler a referencia '%s'\n", config->baseline_path);
+        return 0;
+    }
+
+    // a comparação só faz sentido com a mesma carga
+    const char *setup = strstr(baseline, "\"config\"");
+    if (json_number_after(setup, "vars") != num_vars || json_number_after(setup, "depth") != config->depth ||
+        json_number_after(setup, "formulas") != config->formulas ||
+        json_number_after(setup, "seed") != (double) config->seed) {
+        fprintf(stderr, "Erro: a referencia '%s' foi gerada com outra configuracao\n", config->baseline_path);
+        free(baseline);
+        return 0;
+    }
+
+#if defined(__GNUC__) && !defined(__OPTIMIZE__)
+    // sem otimização todos os estágios cairiam muito abaixo da referência
+    fprintf(stderr, "Erro: benchmark compilado sem otimizacao; a referencia '%s' so vale para builds otimizados "
+                    "(-DCMAKE_BUILD_TYPE=Release)\n", config->baseline_path);
+    free(baseline);
+    return 0;
+#endif
+
+    printf("\nreferencia: %s (limite de queda %.1f%%)\n", config->baseline_path, config->threshold);
+    for (int s = 0; s < SUITE_STAGES; s++) {
+        char key[64];
+        snprintf(key, sizeof(key), "\"%s\": {", stages[s].name);
+        double before = json_number_after(strstr(baseline, key), "throughput");
+        double now = stage_throughput(&stages[s]);
+
+        if (isnan(before) || before <= 0) {
+            printf("%-9s | sem referencia\n", stages[s].name);
+            continue;
+        }
+        double change = (now - before) * 100.0 / before;
+        int regressed = change < -config->threshold;
+        printf("%-9s | referencia %14.1f | agora %14.1f %s/s | %+7.1f%% %s\n", stages[s].name, before, now,
+               stages[s].unit, change, regressed ? "REGRESSAO" : "ok");
+        ok &= !regressed;
+    }
+
+    free(baseline);
+    return ok;
+}
+
+static int run_suite(const suite_config *config) {
+    suite_stage stages[SUITE_STAGES] = {
+        { "parse", "tokens", 0, 0 },
+        { "evaluate", "rows", 0, 0 },
+        { "scalar", "rows", 0, 0 },
+        { "output", "bytes", 0, 0 },
+    };
+    int order[SUITE_MAX_VARS];
+    int num_vars = 0;
+
+    printf("== suite: %d formulas, %d variaveis, profundidade %d, semente %llu ==\n", config->formulas,
+           config->vars, config->depth, (unsigned long long) config->seed);
+
+    // cada repetição refaz as mesmas fórmulas; vale o melhor tempo de cada estágio
+    for (int r = 0; r < config->repeat; r++) {
+        suite_generator g = { config, config->seed ? config->seed : 1, NULL, 0, 0, 0, order };
+        double times[SUITE_STAGES] = {0};
+
+        for (int f = 0; f < config->formulas; f++) {
+            long tokens;
+            char *expression = suite_next_formula(&g, &tokens);
+            if (!expression) return 0;
+
+            if (r == 0 && f == 0) {
+                program prog;
+                if (!load_bench_expression(expression, &prog)) {
+                    free(expression);
+                    return 0;
+                }
+                num_vars = prog.num_vars;
+                free_program(&prog);
+            }
+
+            // só a primeira repetição soma as quantidades
+            suite_stage scratch[SUITE_STAGES];
+            memcpy(scratch, stages, sizeof(scratch));
+            int ok = suite_measure(expression, tokens, r == 0 ? stages : scratch, times);
+            free(expression);
+            if (!ok) return 0;
+        }
+
+        for (int s = 0; s < SUITE_STAGES; s++)
+            if (r == 0 || times[s] < stages[s].seconds) stages[s].seconds = times[s];
+    }
+
+    printf("leitura    %10.3f ns/token  | %8.2f Mtokens/s\n", stages[STAGE_PARSE].seconds * 1e9 / stages[STAGE_PARSE].amount,
+           stage_throughput(&stages[STAGE_PARSE]) / 1e6);
+    printf("avaliacao  %10.3f ns/linha  | %8.2f Mlinhas/s (empacotada, %s)\n",
+           stages[STAGE_EVALUATE].seconds * 1e9 / stages[STAGE_EVALUATE].amount,
+           stage_throughput(&stages[STAGE_EVALUATE]) / 1e6, select_eval_kernel()->name);
+    printf("escalar    %10.3f ns/linha  | %8.2f Mlinhas/s (programa escalar)\n",
+           stages[STAGE_SCALAR].seconds * 1e9 / stages[STAGE_SCALAR].amount, stage_throughput(&stages[STAGE_SCALAR]) / 1e6);
+    printf("saida      %10.3f ns/byte   | %8.2f MB/s\n", stages[STAGE_OUTPUT].seconds * 1e9 / stages[STAGE_OUTPUT].amount,
+           stage_throughput(&stages[STAGE_OUTPUT]) / 1e6);
+
+    int ok = 1;
+    if (config->json_path) {
+        ok = write_suite_json(config->json_path, config, stages, num_vars);
+        if (ok) printf("resultados gravados em %s\n", config->json_path);
+    }
+    if (ok && config->baseline_path) ok = check_suite_baseline(config, stages, num_vars);
+    return ok;
+}
+
+// "&=4,|=4,->=1,<->=1,~=2": pesos dos operadores; os ausentes ficam com 0
+static int parse_operator_mix(const char *text, int *weights) {
+    int binary = 0;
+
+    for (int i = 0; i < SUITE_OPERATORS; i++) weights[i] = 0;
+    while (*text) {
+        const char *eq = strchr(text, '=');
+        if (!eq) return 0;
+
+        int op = -1;
+        for (int i = 0; i < SUITE_OPERATORS; i++)
+            if (strlen(suite_operator_name[i]) == (size_t) (eq - text) &&
+                strncmp(text, suite_operator_name[i], (size_t) (eq - text)) == 0)
+                op = i;
+        if (op < 0) return 0;
+
+        char *end;
+        long weight = strtol(eq + 1, &end, 10);
+        if (end == eq + 1 || weight < 0 || weight > 1000) return 0;
+        weights[op] = (int) weight;
+        if (op < SUITE_OPERATORS - 1) binary += (int) weight;
+
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return 0;
+    }
+    return binary > 0;
+}
+
+static void print_bench_usage(const char *name) {
+    fprintf(stderr, "uso: %s                 todas as secoes\n"
+                    "       %s --suite [--vars N] [--depth D] [--formulas K] [--ops MISTURA] [--seed S]\n"
+                    "                  [--repeat R] [--json ARQUIVO] [--baseline ARQUIVO [--threshold PCT]]\n",
+            name, name);
+    fprintf(stderr, "  --vars N          variaveis de cada formula (1 a %d, padrao 18)\n", SUITE_MAX_VARS);
+    fprintf(stderr, "  --depth D         profundidade das formulas (1 a %d, padrao 10)\n", SUITE_MAX_DEPTH);
+    fprintf(stderr, "  --formulas K      formulas geradas (padrao 6)\n");
+    fprintf(stderr, "  --ops MISTURA     pesos dos operadores (padrao \"&=4,|=4,->=1,<->=1,~=2\")\n");
+    fprintf(stderr, "  --seed S          semente do gerador deterministico (padrao 1)\n");
+    fprintf(stderr, "  --repeat R        repeticoes; vale o melhor tempo (padrao 3)\n");
+    fprintf(stderr, "  --json ARQUIVO    grava os resultados em JSON\n");
+    fprintf(stderr, "  --baseline ARQ    falha se a vazao cair alem do limite em relacao a ARQ\n");
+    fprintf(stderr, "  --threshold PCT   queda tolerada em porcentagem (padrao 10)\n");
+}
+
+// lê as opções da suíte; 0 se alguma for inválida
+static int parse_suite_options(int argc, char *argv[], suite_config *config) {
+    config->vars = 18;
+    config->depth = 10;
+    config->formulas = 6;
+    config->repeat = 3;
+    config->seed = 1;
+    config->json_path = NULL;
+    config->baseline_path = NULL;
+    config->threshold = 10.0;
+    parse_operator_mix("&=4,|=4,->=1,<->=1,~=2", config->weights);
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--suite") == 0) continue;
+        if (!value) return 0;
+        i++;
+        if (strcmp(argv[i - 1], "--vars") == 0) config->vars = atoi(value);
+        else if (strcmp(argv[i - 1], "--depth") == 0) config->depth = atoi(value);
+        else if (strcmp(argv[i - 1], "--formulas") == 0) config->formulas = atoi(value);
+        else if (strcmp(argv[i - 1], "--repeat") == 0) config->repeat = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config->seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i - 1], "--json") == 0) config->json_path = value;
+        else if (strcmp(argv[i - 1], "--baseline") == 0) config->baseline_path = value;
+        else if (strcmp(argv[i - 1], "--threshold") == 0) config->threshold = atof(value);
+        else if (strcmp(argv[i - 1], "--ops") == 0) {
+            if (!parse_operator_mix(value, config->weights)) return 0;
+        } else {
+            return 0;
+        }
+    }
+
+    return config->vars >= 1 && config->vars <= SUITE_MAX_VARS && config->depth >= 1 &&
+           config->depth <= SUITE_MAX_DEPTH && config->formulas >= 1 && config->repeat >= 1 &&
+           config->threshold >= 0;
+}
+
+#define PARTIAL_FORMULAS 300   // fórmulas aleatórias com atribuições parciais conferidas linha a linha
+#define PARTIAL_BIG_HALF 13    // letras da fórmula grande; a cópia em maiúsculas dobra as variáveis
+#define PARTIAL_BIG_FIXED 16   // variáveis fixadas na fórmula grande ("dados estes fatos")
+#define PARTIAL_WIDE_VARS 70   // conjunção larga demais para a tabela inteira
+#define PARTIAL_WIDE_FREE 10
+
+// fixa 'fixed' variáveis sorteadas de 'expr' em valores sorteados; 'values' recebe 0, 1 ou -1 por slot
+static void random_assignment(const logic_expr *expr, int fixed, char *spec, size_t cap, signed char *values) {
+    int n = logic_num_vars(expr);
+    size_t len = 0;
+
+    for (int j = 0; j < n; j++) values[j] = -1;
+    for (int k = 0; k < fixed; k++) {
+        int slot;
+        do slot = (int) (next_random() % (uint64_t) n); while (values[slot] >= 0);
+        values[slot] = (signed char) (next_random() & 1);
+        len += (size_t) snprintf(spec + len, cap - len, "%s%s=%c", k ? "," : "", logic_var_name(expr, slot),
+                                 values[slot] ? 'V' : 'F');
+    }
+    spec[len] = '\0';
+}
+
+// cada linha da tabela restrita contra a linha correspondente da expressão inteira
+static int restricted_rows_match(const logic_expr *expr, const logic_expr *restricted, const signed char *values) {
+    unsigned char full[64], free_values[64];
+    int n = logic_num_vars(expr), m = logic_num_vars(restricted);
+
+    for (uint64_t row = 0; row < (1ULL << m); row++) {
+        for (int j = 0, k = 0; j < n; j++) {
+            if (values[j] >= 0) {
+                full[j] = (unsigned char) values[j];
+            } else {
+                if (strcmp(logic_var_name(expr, j), logic_var_name(restricted, k)) != 0) return 0;
+                full[j] = free_values[k] = (unsigned char) ((row >> (m - 1 - k)) & 1);
+                k++;
+            }
+        }
+        if (logic_evaluate(expr, full) != logic_evaluate(restricted, free_values)) return 0;
+    }
+    return 1;
+}
+
+// atribuição parcial: as fixadas viram constantes e a tabela enumera só as livres
+static int bench_partial(void) {
+    char expression[LIBRARY_FORMULA_SIZE], spec[1024];
+    signed char values[64];
+    error_status status;
+    int failures = 0;
+
+    for (int f = 0; f < PARTIAL_FORMULAS; f++) {
+        int vars = 2 + f % 13;
+        logic_expr *expr = NULL;
+        do {
+            size_t len = 0;
+            if (!random_formula(expression, LIBRARY_FORMULA_SIZE - 1, &len, vars, 7)) continue;
+            logic_free(expr);
+            expr = logic_compile(expression, &status);
+        } while (!expr);
+
+        int n = logic_num_vars(expr);
+        random_assignment(expr, (int) (next_random() % (uint64_t) (n + 1)), spec, sizeof(spec), values);
+        logic_expr *restricted = logic_restrict(expr, spec, &status);
+        if (!restricted || !restricted_rows_match(expr, restricted, values)) failures++;
+        logic_free(restricted);
+        logic_free(expr);
+    }
+
+    // nomes fora da expressão, repetidos ou valores inválidos são recusados
+    logic_expr *small = logic_compile("a & (b | c)", &status);
+    const char *rejected[] = { "z=1", "a=1,a=0", "a=2", "a", "b=V c=F x" };
+    for (int k = 0; small && k < (int) (sizeof(rejected) / sizeof(rejected[0])); k++) {
+        logic_expr *r = logic_restrict(small, rejected[k], &status);
+        if (r || status.code != ERR_INVALID_ARGUMENT) failures++;
+        logic_free(r);
+    }
+    logic_free(small);
+    printf("conferencia: %d formulas de 2 a 14 variaveis com atribuicoes parciais aleatorias, %d divergencias\n",
+           PARTIAL_FORMULAS, failures);
+
+    // 26 variáveis, 16 fixadas: a tabela restrita tem 2^10 linhas em vez de 2^26
+    logic_expr *big = NULL;
+    do {
+        char text[2 * LIBRARY_FORMULA_SIZE + 16];
+        size_t len = 0;
+        if (!random_formula(expression, LIBRARY_FORMULA_SIZE - 1, &len, PARTIAL_BIG_HALF, 9)) continue;
+        size_t half = (size_t) snprintf(text, sizeof(text), "(%s) | ", expression);
+        snprintf(text + half, sizeof(text) - half, "(%s)", expression);
+        for (char *c = text + half; *c; c++) *c = (char) toupper((unsigned char) *c);
+        logic_free(big);
+        big = logic_compile(text, &status);
+    } while (!big || logic_num_vars(big) != 2 * PARTIAL_BIG_HALF);
+
+    random_assignment(big, PARTIAL_BIG_FIXED, spec, sizeof(spec), values);
+    uint64_t sink = 0;
+    double start = now_seconds();
+    logic_expr *restricted = logic_restrict(big, spec, &status);
+    int big_ok = restricted && logic_table_blocks(restricted, 0, (1ULL << logic_num_vars(restricted)) / 64,
+                                                  checksum_blocks, &sink, &status);
+    double fixed_time = elapsed_seconds(start);
+    big_ok = big_ok && restricted_rows_match(big, restricted, values);
+
+    // referência: a tabela inteira, da qual sairiam as linhas com as fixadas nos valores dados
+    start = now_seconds();
+    logic_table_blocks(big, 0, (1ULL << (2 * PARTIAL_BIG_HALF)) / 64, checksum_blocks, &sink, &status);
+    double full_time = elapsed_seconds(start);
+
+    printf("%d variaveis, %d fixadas: tabela restrita em %8.1f us, tabela inteira em %8.1f ms (%.0fx) | %s\n",
+           2 * PARTIAL_BIG_HALF, PARTIAL_BIG_FIXED, fixed_time * 1e6, full_time * 1e3,
+           full_time / (fixed_time > 0 ? fixed_time : 1e-9), big_ok ? "ok" : "DIVERGENCIA");
+    logic_free(restricted);
+    logic_free(big);
+
+    // 70 variáveis: não cabem na tabela inteira, mas as 10 livres sim
+    char wide[PARTIAL_WIDE_VARS * 16];
+    size_t len = 0;
+    for (int j = 0; j < PARTIAL_WIDE_VARS; j += 2)
+        len += (size_t) snprintf(wide + len, sizeof(wide) - len, "%s(x%02d | ~x%02d)", j ? " & " : "", j, j + 1);
+    logic_expr *expr = logic_compile(wide, &status);
+    int wide_ok = expr && !logic_cursor_open(expr, &status) && status.code == ERR_TOO_MANY_VARIABLES;
+    len = 0;
+    for (int j = 0; j < PARTIAL_WIDE_VARS - PARTIAL_WIDE_FREE; j++)
+        len += (size_t) snprintf(spec + len, sizeof(spec) - len, "%sx%02d=1", j ? "," : "", j);
+    restricted = expr ? logic_restrict(expr, spec, &status) : NULL;
+    bignum count;
+    uint64_t models = 0;
+    bignum_init(&count);
+    // cada par livre (x | ~y) vale em 3 das 4 linhas: 3^5 linhas verdadeiras
+    wide_ok = wide_ok && restricted && logic_num_vars(restricted) == PARTIAL_WIDE_FREE &&
+              logic_count(restricted, 1, &count, &status) && bignum_to_u64(&count, &models) && models == 243;
+    printf("%d variaveis, %d livres: %s\n", PARTIAL_WIDE_VARS, PARTIAL_WIDE_FREE, wide_ok ? "ok" : "DIVERGENCIA");
+    bignum_free(&count);
+    logic_free(restricted);
+    logic_free(expr);
+
+    return failures == 0 && big_ok && wide_ok;
+}
+
+#define STATS_BENCH_REPEAT 7 // melhor de várias execuções: a diferença procurada é de poucos por cento
+
+// tabela em texto descartada, com a coleta no estado atual
+static double stats_table_time(const char *expression, FILE *sink) {
+    table_options options;
+    init_table_options(&options);
+    options.output = sink;
+
+    double start = now_seconds();
+    generate_truth_table_with(expression, &options);
+    fflush(sink);
+    return elapsed_seconds(start);
+}
+
+// uma chamada de evaluate_blocks por palavra: o pior caso, um teste da coleta a cada 64 linhas
+static double stats_word_time(const program *prog, uint64_t blocks, uint64_t *checksum) {
+    double start = now_seconds();
+    for (uint64_t b = 0; b < blocks; b++) {
+        uint64_t word = 0;
+        evaluate_blocks(prog, b, 1, &word);
+        *checksum ^= word;
+    }
+    return elapsed_seconds(start);
+}
+
+// custo da instrumentação: as mesmas medidas com a coleta desligada e ligada, alternadas
+static int bench_stats(void) {
+    const char *expression = bench_expressions[3];
+    double table_time[2] = { INFINITY, INFINITY }, word_time[2] = { INFINITY, INFINITY };
+    uint64_t checksum[2] = { 0, 0 };
+    FILE *sink = fopen(NULL_DEVICE, "wb");
+    program prog;
+
+    if (!sink) return 0;
+    if (!load_bench_expression(expression, &prog)) {
+        fclose(sink);
+        return 0;
+    }
+    uint64_t blocks = ((1ULL << prog.num_vars) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+
+    int compiled = stats_enable();
+    stats_disable();
+    for (int r = 0; r < STATS_BENCH_REPEAT; r++) {
+        for (int on = 0; on <= compiled; on++) {
+            if (on) stats_enable();
+            double t = stats_table_time(expression, sink);
+            if (t < table_time[on]) table_time[on] = t;
+            t = stats_word_time(&prog, blocks, &checksum[on]);
+            if (t < word_time[on]) word_time[on] = t;
+            if (on) stats_disable();
+        }
+    }
+
+    if (!compiled) {
+        printf("%-2d vars | tabela %8.3f ms | palavra a palavra %6.2f ns | instrumentacao removida (LOGIC_STATS=0)\n",
+               prog.num_vars, table_time[0] * 1e3, word_time[0] * 1e9 / blocks);
+    } else {
+        printf("%-2d vars | tabela: desligada %8.3f ms | ligada %8.3f ms | %+6.1f%%\n", prog.num_vars,
+               table_time[0] * 1e3, table_time[1] * 1e3, (table_time[1] / table_time[0] - 1) * 100);
+        printf("%-2d vars | palavra a palavra: desligada %6.2f ns | ligada %6.2f ns | %+6.1f%%\n", prog.num_vars,
+               word_time[0] * 1e9 / blocks, word_time[1] * 1e9 / blocks, (word_time[1] / word_time[0] - 1) * 100);
+    }
+
+    free_program(&prog);
+    fclose(sink);
+    return checksum[0] == checksum[compiled];
+}
+
+int main(int argc, char *argv[]) {
+    int ok = 1;
+
+    // com opções, roda apenas a suíte configurável
+    if (argc > 1) {
+        suite_config config;
+        if (strcmp(argv[1], "--suite") != 0 || !parse_suite_options(argc, argv, &config)) {
+            print_bench_usage(argv[0]);
+            return 2;
+        }
+        return run_suite(&config) ? 0 : 1;
+    }
+
+    printf("== avaliacao: shunting yard por linha x programa compilado ==\n");
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        ok &= bench_compiled_vs_shunting_yard(bench_expressions[i]);
+
+    printf("\n== avaliacao empacotada: 64 linhas por palavra ==\n");
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        ok &= bench_packed_words(bench_expressions[i]);
+
+    printf("\n== nucleos vetoriais (selecionado: %s) ==\n", select_eval_kernel()->name);
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        ok &= bench_simd_kernels(bench_expressions[i]);
+
+    printf("\n== codigo Gray com reavaliacao incremental ==\n");
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        ok &= bench_gray_code(bench_expressions[i]);
+
+    printf("\n== diagrama de decisao binaria (ROBDD) ==\n");
+    for (size_t i = 0; i < sizeof(bench_expressions) / sizeof(bench_expressions[0]); i++)
+        ok &= bench_bdd(bench_expressions[i]);
+
+    printf("\n== classificacao cdcl x forca bruta ==\n");
+    ok &= bench_sat_crosscheck();
+
+    printf("\n== escalabilidade por threads: %s ==\n", bench_expressions[3]);
+    ok &= bench_thread_scaling(bench_expressions[3]);
+
+    printf("\n== analisador lexico de uma passada: 1 KB a 10 MB ==\n");
+    ok &= bench_parser();
+
+    printf("\n== subexpressoes compartilhadas: arvore x grafo ==\n");
+    ok &= bench_shared_subexpressions();
+
+    printf("\n== codigo nativo x86-64 x interpretador ==\n");
+    ok &= bench_jit();
+
+    printf("\n== tabela binaria: bitmap em blocos e leitura mapeada ==\n");
+    ok &= bench_table_file();
+
+    printf("\n== cache persistente de resultados ==\n");
+    ok &= bench_cache();
+
+    printf("\n== contagem exata de modelos (#SAT) ==\n");
+    ok &= bench_count();
+
+    printf("\n== partes independentes: divisao da formula ==\n");
+    ok &= bench_decompose();
+
+    printf("\n== minimizacao: soma de produtos e produto de somas ==\n");
+    ok &= bench_minimize();
+
+    printf("\n== expressoes longas: leitura e compilacao na arena ==\n");
+    ok &= bench_large_expressions();
+
+    printf("\n== modo em lote: %d expressoes aleatorias ==\n", BATCH_BENCH_FORMULAS);
+    ok &= bench_batch();
+
+    printf("\n== liblogic: expressoes compiladas compartilhadas entre threads ==\n");
+    ok &= bench_library();
+
+    printf("\n== sessao de edicao: atualizacao incremental ==\n");
+    ok &= bench_session();
+
+    printf("\n== equivalencia e implicacao entre duas formulas ==\n");
+    ok &= bench_relation();
+
+    printf("\n== cursor: pagina no meio de uma tabela enorme ==\n");
+    ok &= bench_cursor();
+
+    printf("\n== atribuicao parcial: variaveis fixadas viram constantes ==\n");
+    ok &= bench_partial();
+
+    printf("\n== instrumentacao (--stats): coleta desligada x ligada ==\n");
+    ok &= bench_stats();
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+
+struct arena_block {
+    arena_block *prev; // bloco anterior (liberado junto com este)
+    size_t size;       // bytes disponíveis em 'data'
+    size_t used;       // bytes já entregues
+    unsigned char data[];
+};
+
+static arena_block *new_block(arena *a, size_t size) {
+    arena_block *block = malloc(sizeof(arena_block) + size);
+    if (!block) return NULL;
+
+    block->prev = a->current;
+    block->size = size;
+    block->used = 0;
+    a->current = block;
+    a->reserved += size;
+    return block;
+}
+
+void arena_init(arena *a, size_t block_size) {
+    a->current = NULL;
+    a->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+    a->reserved = 0;
+}
+
+void *arena_alloc(arena *a, size_t size) {
+    arena_block *block = a->current;
+    size_t pad = 0;
+
+    // alinha o endereço (e não só o deslocamento) do próximo trecho
+    if (block) pad = (size_t) (-(uintptr_t) (block->data + block->used)) & (ARENA_ALIGN - 1);
+
+    if (!block || block->size - block->used < pad + size) {
+        // blocos novos dobram o total reservado, limitando o número de blocos
+        size_t block_size = a->block_size > a->reserved ? a->block_size : a->reserved;
+        if (block_size < size + ARENA_ALIGN) block_size = size + ARENA_ALIGN;
+        block = new_block(a, block_size);
+        if (!block) return NULL;
+        pad = (size_t) (-(uintptr_t) block->data) & (ARENA_ALIGN - 1);
+    }
+
+    void *p = block->data + block->used + pad;
+    block->used += pad + size;
+    return p;
+}
+
+void arena_reset(arena *a) {
+    if (a->current && a->current->prev) {
+        // junta os blocos em um só com a capacidade total
+        size_t total = a->reserved;
+        arena_free(a);
+        new_block(a, total);
+    } else if (a->current) {
+        a->current->used = 0;
+    }
+}
+
+arena_mark arena_save(const arena *a) {
+    arena_mark mark;
+    mark.block = a->current;
+    mark.used = a->current ? a->current->used : 0;
+    return mark;
+}
+
+void arena_rewind(arena *a, arena_mark mark) {
+    while (a->current && a->current != mark.block) {
+        arena_block *prev = a->current->prev;
+        a->reserved -= a->current->size;
+        free(a->current);
+        a->current = prev;
+    }
+    if (a->current) a->current->used = mark.used;
+}
+
+void arena_free(arena *a) {
+    while (a->current) {
+        arena_block *prev = a->current->prev;
+        free(a->current);
+        a->current = prev;
+    }
+    a->reserved = 0;
+}
@@ -0,0 +1,76 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024) ///< tamanho padrão de cada bloco da arena (64 KiB)
+
+/// @brief bloco de memória da arena (encadeado ao bloco anterior)
+typedef struct arena_block arena_block;
+
+/// @brief alocador por deslocamento: muitas alocações, uma única liberação
+typedef struct {
+    arena_block *current; ///< bloco onde as próximas alocações são feitas
+    size_t block_size;    ///< tamanho mínimo dos blocos novos
+    size_t reserved;      ///< bytes obtidos do sistema em todos os blocos
+} arena;
+
+/// @brief posição da arena, para devolver de uma vez tudo o que foi alocado depois dela
+typedef struct {
+    arena_block *block;
+    size_t used;
+} arena_mark;
+
+/**
+ * @brief inicializa uma arena vazia (nenhuma memória é reservada até a primeira alocação)
+ *
+ * @param a arena a inicializar
+ * @param block_size tamanho mínimo de cada bloco (0 = ARENA_DEFAULT_BLOCK)
+ */
+void arena_init(arena *a, size_t block_size);
+
+/**
+ * @brief aloca 'size' bytes alinhados a 16 bytes
+ *
+ * a memória vale até o próximo arena_reset, arena_rewind ou arena_free
+ *
+ * @param a arena
+ * @param size número de bytes
+ * @return void* memória alocada ou NULL em caso de falha
+ */
+void *arena_alloc(arena *a, size_t size);
+
+/**
+ * @brief descarta todas as alocações mantendo a memória para reúso
+ *
+ * se a arena cresceu em vários blocos, eles são trocados por um único bloco
+ * do tamanho total, de modo que expressões de tamanho parecido não alocam mais
+ *
+ * @param a arena
+ */
+void arena_reset(arena *a);
+
+/**
+ * @brief posição corrente da arena
+ *
+ * @param a arena
+ * @return arena_mark marca a ser usada com arena_rewind
+ */
+arena_mark arena_save(const arena *a);
+
+/**
+ * @brief descarta as alocações feitas depois da marca
+ *
+ * @param a arena
+ * @param mark marca obtida com arena_save
+ */
+void arena_rewind(arena *a, arena_mark mark);
+
+/**
+ * @brief libera toda a memória da arena
+ *
+ * @param a arena
+ */
+void arena_free(arena *a);
+
+#endif // ARENA_H
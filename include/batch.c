@@ -0,0 +1,244 @@
+#include "batch.h"
+#include "compile.h"
+#include "parallel.h"
+#include "output.h"
+#include "classify.h"
+#include "count.h"
+#include "cache.h"
+
+#define BATCH_LINES 1024        // expressões lidas e avaliadas por rodada
+#define BATCH_TABLE_VARS 12     // tabelas até 2^12 linhas são formatadas em paralelo, uma por thread
+
+// texto que cresce sob demanda e é reaproveitado entre as rodadas
+typedef struct {
+    char *text;
+    size_t length;
+    size_t capacity;
+} batch_buffer;
+
+// uma expressão da rodada e o texto do seu resultado
+typedef struct {
+    size_t line_start;   // início da expressão no texto das linhas
+    batch_buffer out;    // resultado já formatado
+    int deferred;        // 1 = tabela grande, gerada depois com todas as threads
+    int failed;          // 1 = a expressão produziu erro
+} batch_slot;
+
+// estado compartilhado pelos trabalhadores durante uma rodada
+typedef struct {
+    const batch_options *options;
+    const char *lines;
+    batch_slot *slots;
+    arena *scratch;      // arena de leitura de cada trabalhador, reiniciada a cada expressão
+    int out_of_memory;
+} batch_job;
+
+// garante espaço para mais 'extra' bytes no buffer
+static int buffer_reserve(batch_buffer *buf, size_t extra) {
+    if (buf->length + extra <= buf->capacity) return 1;
+
+    size_t capacity = buf->capacity ? buf->capacity : 256;
+    while (capacity < buf->length + extra) capacity *= 2;
+
+    char *grown = realloc(buf->text, capacity);
+    if (!grown) return 0;
+    buf->text = grown;
+    buf->capacity = capacity;
+    return 1;
+}
+
+static int buffer_append(batch_buffer *buf, const char *data, size_t size) {
+    if (!buffer_reserve(buf, size)) return 0;
+    memcpy(buf->text + buf->length, data, size);
+    buf->length += size;
+    return 1;
+}
+
+// acrescenta "expressao: detalhe\n"
+static int append_result(batch_buffer *buf, const char *expression, const char *detail) {
+    return buffer_append(buf, expression, strlen(expression)) &&
+           buffer_append(buf, ": ", 2) &&
+           buffer_append(buf, detail, strlen(detail)) &&
+           buffer_append(buf, "\n", 1);
+}
+
+// lê uma linha inteira (de qualquer tamanho) para o fim de 'lines', terminada em '\0'
+// retorna 1 se leu uma linha, 0 no fim da entrada e -1 em falha de alocação
+static int read_line(FILE *in, batch_buffer *lines) {
+    size_t start = lines->length;
+    int got = 0;
+
+    for (;;) {
+        if (!buffer_reserve(lines, 256)) return -1;
+
+        char *dst = lines->text + lines->length;
+        if (!fgets(dst, (int) (lines->capacity - lines->length), in)) break;
+
+        size_t n = strlen(dst);
+        got = 1;
+        lines->length += n;
+        if (n > 0 && dst[n - 1] == '\n') break;
+    }
+    if (!got) return 0;
+
+    // remove o fim de linha (inclusive "\r\n")
+    while (lines->length > start && (lines->text[lines->length - 1] == '\n' || lines->text[lines->length - 1] == '\r'))
+        lines->length--;
+    lines->text[lines->length++] = '\0';
+    return 1;
+}
+
+static int is_blank(const char *line) {
+    while (*line && isspace((unsigned char) *line)) line++;
+    return *line == '\0';
+}
+
+// avalia a expressão do pedaço 'chunk' e formata o resultado no seu slot
+static void evaluate_batch_line(void *ctx, int worker, uint64_t chunk) {
+    batch_job *job = ctx;
+    batch_slot *slot = &job->slots[chunk];
+    const char *expression = job->lines + slot->line_start;
+    error_status status;
+    program prog;
+    char detail[MAX_ERROR_MSG + 16];
+    int ok = 1;
+
+    slot->out.length = 0;
+    slot->deferred = 0;
+    slot->failed = 0;
+
+    if (!parse_expression_with(expression, &job->scratch[worker], &prog, &status)) {
+        slot->failed = 1;
+        snprintf(detail, sizeof(detail), "Erro: %s", status.message);
+        if (!append_result(&slot->out, expression, detail)) job->out_of_memory = 1;
+        return;
+    }
+
+    switch (job->options->result) {
+        case BATCH_CLASSIFY: {
+            classification result;
+            ok = cache_classify(job->options->cache, &prog, &result, &status);
+            if (ok) {
+                ok = append_result(&slot->out, expression, formula_class_name(result.kind)) ? 1 : -1;
+                free_classification(&result);
+            }
+            break;
+        }
+        case BATCH_COUNT: {
+            bignum count;
+            bignum_init(&count);
+            ok = count_models(&prog, 1, &count, &status);
+            if (ok) {
+                char *text = format_model_count(&count, prog.num_vars);
+                ok = text && append_result(&slot->out, expression, text) ? 1 : -1;
+                free(text);
+            }
+            bignum_free(&count);
+            break;
+        }
+        default:
+            // tabelas pequenas são formatadas aqui; as grandes ficam para a thread principal
+            if (!check_table_size(&prog, &status)) {
+                ok = 0;
+            } else if (prog.num_vars > BATCH_TABLE_VARS) {
+                slot->deferred = 1;
+            } else {
+                size_t length = truth_table_length(&prog, expression);
+                ok = buffer_reserve(&slot->out, length) &&
+                     format_truth_table(&prog, expression, job->options->reverse_order, slot->out.text) ? 1 : -1;
+                if (ok > 0) slot->out.length = length;
+            }
+            break;
+    }
+
+    if (ok < 0) job->out_of_memory = 1;
+    if (ok == 0) {
+        slot->failed = 1;
+        snprintf(detail, sizeof(detail), "Erro: %s", status.message);
+        if (!append_result(&slot->out, expression, detail)) job->out_of_memory = 1;
+    }
+    free_program(&prog);
+}
+
+void init_batch_options(batch_options *options) {
+    options->result = BATCH_TABLE;
+    options->threads = 1;
+    options->reverse_order = 0;
+    options->cache = NULL;
+}
+
+long long run_batch(FILE *in, FILE *out, const batch_options *options) {
+    int threads = options->threads > 1 ? options->threads : 1;
+    batch_buffer lines = {0};
+    batch_slot *slots = calloc(BATCH_LINES, sizeof(batch_slot));
+    arena *scratch = malloc(sizeof(arena) * threads);
+    thread_pool *pool = thread_pool_create(threads);
+    output_writer writer;
+    long long errors = 0;
+    int writing = slots && scratch && pool && writer_init(&writer, out);
+    int ok = writing;
+    int more = 1;
+
+    for (int t = 0; scratch && t < threads; t++) arena_init(&scratch[t], 0);
+
+    while (ok && more) {
+        batch_job job = { options, NULL, slots, scratch, 0 };
+        int count = 0;
+
+        // lê a próxima rodada de expressões para o mesmo buffer
+        lines.length = 0;
+        while (count < BATCH_LINES) {
+            size_t start = lines.length;
+            int got = read_line(in, &lines);
+            if (got <= 0) {
+                if (got < 0) ok = 0;
+                more = 0;
+                break;
+            }
+            if (is_blank(lines.text + start)) {
+                lines.length = start;
+                continue;
+            }
+            slots[count++].line_start = start;
+        }
+        if (!ok || count == 0) break;
+
+        job.lines = lines.text;
+        thread_pool_run(pool, (uint64_t) count, evaluate_batch_line, &job);
+        if (job.out_of_memory) {
+            ok = 0;
+            break;
+        }
+
+        // grava os resultados na ordem da entrada
+        for (int i = 0; i < count; i++) {
+            errors += slots[i].failed;
+            if (!slots[i].deferred) {
+                writer_put(&writer, slots[i].out.text, slots[i].out.length);
+                continue;
+            }
+
+            // tabela grande: usa o gerador paralelo direto no mesmo arquivo
+            table_options table;
+            init_table_options(&table);
+            table.reverse_order = options->reverse_order;
+            table.threads = threads;
+            table.output = out;
+            table.cache = options->cache;
+
+            writer_flush(&writer);
+            if (!generate_truth_table_with(lines.text + slots[i].line_start, &table)) errors++;
+        }
+    }
+
+    if (ferror(in)) ok = 0;
+    if (writing && !writer_close(&writer)) ok = 0;
+
+    for (int i = 0; slots && i < BATCH_LINES; i++) free(slots[i].out.text);
+    for (int t = 0; scratch && t < threads; t++) arena_free(&scratch[t]);
+    free(scratch);
+    free(slots);
+    free(lines.text);
+    thread_pool_destroy(pool);
+    return ok ? errors : -1;
+}
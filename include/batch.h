@@ -0,0 +1,43 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "eval.h" // opções de tabela e tipos de erro
+
+/// @brief resultado emitido para cada expressão do lote
+typedef enum batch_result {
+    BATCH_TABLE,    ///< tabela verdade completa
+    BATCH_CLASSIFY, ///< tautologia, contradição ou contingente
+    BATCH_COUNT     ///< número exato de linhas verdadeiras (sem limite de variáveis)
+} batch_result;
+
+/// @brief opções do modo em lote
+typedef struct {
+    batch_result result; ///< o que imprimir para cada expressão
+    int threads;         ///< número de threads (1 = serial)
+    int reverse_order;   ///< ordem das linhas nas tabelas (0 = normal, 1 = invertida)
+    struct result_cache *cache; ///< classificações e tabelas grandes de execuções anteriores (NULL = sem cache)
+} batch_options;
+
+/**
+ * @brief inicializa as opções com os valores padrão (tabela, 1 thread, ordem normal, sem cache)
+ *
+ * @param options opções a inicializar
+ */
+void init_batch_options(batch_options *options);
+
+/**
+ * @brief avalia as expressões de 'in', uma por linha, e grava os resultados em 'out'
+ *
+ * as linhas são lidas em rodadas e avaliadas em paralelo; os resultados saem
+ * na ordem da entrada. linhas em branco são ignoradas e expressões inválidas
+ * geram "expressao: Erro: ..." na própria saída, sem interromper o lote.
+ * os buffers de leitura e de resultado são reaproveitados entre as rodadas
+ *
+ * @param in fonte das expressões (por exemplo stdin)
+ * @param out destino dos resultados
+ * @param options opções do lote
+ * @return long long número de expressões com erro, ou -1 em falha de leitura, escrita ou alocação
+ */
+long long run_batch(FILE *in, FILE *out, const batch_options *options);
+
+#endif // BATCH_H
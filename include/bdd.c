@@ -0,0 +1,540 @@
+#include "bdd.h"
+#include "bitslice.h"
+#include "classify.h"
+#include "count.h"
+
+#define BDD_PAGE_BITS 12                   // nós por página do pool: 2^12
+#define BDD_PAGE_SIZE (1 << BDD_PAGE_BITS)
+#define BDD_INITIAL_BUCKETS (1 << 12)      // baldes iniciais da tabela única
+#define BDD_CACHE_BITS 18                  // entradas da cache de operações: 2^18
+
+// nó do diagrama; 'next' encadeia os nós do mesmo balde da tabela única
+typedef struct {
+    int level;
+    int low;
+    int high;
+    int next;
+} bdd_node;
+
+// entrada da cache de operações (mapeamento direto, com perda)
+typedef struct {
+    int op; // -1 = vazia
+    int a;
+    int b;
+    int result;
+} cache_entry;
+
+struct bdd_manager {
+    bdd_node **pages;  // pool de nós em páginas de tamanho fixo (índices estáveis)
+    int num_pages;
+    int pages_cap;
+    int num_nodes;
+    int max_nodes;
+
+    int *buckets;      // tabela única: primeiro nó de cada balde (-1 = vazio)
+    int num_buckets;   // potência de 2
+
+    cache_entry *cache;
+
+    int num_levels;      // variáveis (nível dos terminais = num_levels)
+    int *level_of_slot;  // nível de cada slot
+    int *bit_of_level;   // bit do índice da linha controlado por cada nível
+};
+
+static bdd_node *node_at(const bdd_manager *mgr, int id) {
+    return &mgr->pages[id >> BDD_PAGE_BITS][id & (BDD_PAGE_SIZE - 1)];
+}
+
+static unsigned hash_node(int level, int low, int high) {
+    unsigned h = (unsigned) level * 12582917u;
+    h ^= (unsigned) low * 4256249u;
+    h ^= (unsigned) high * 741457u;
+    return h ^ (h >> 15);
+}
+
+// dobra a tabela única e redistribui os nós
+static int grow_buckets(bdd_manager *mgr) {
+    int count = mgr->num_buckets * 2;
+    int *buckets = malloc(sizeof(int) * count);
+    if (!buckets) return 0;
+
+    for (int i = 0; i < count; i++) buckets[i] = -1;
+    for (int id = 2; id < mgr->num_nodes; id++) {
+        bdd_node *n = node_at(mgr, id);
+        unsigned b = hash_node(n->level, n->low, n->high) & (count - 1);
+        n->next = buckets[b];
+        buckets[b] = id;
+    }
+
+    free(mgr->buckets);
+    mgr->buckets = buckets;
+    mgr->num_buckets = count;
+    return 1;
+}
+
+// reserva um nó novo no pool; -1 se o limite foi atingido
+static int alloc_node(bdd_manager *mgr) {
+    if (mgr->num_nodes >= mgr->max_nodes) return -1;
+
+    if ((mgr->num_nodes >> BDD_PAGE_BITS) >= mgr->num_pages) {
+        if (mgr->num_pages == mgr->pages_cap) {
+            int cap = mgr->pages_cap ? mgr->pages_cap * 2 : 8;
+            bdd_node **grown = realloc(mgr->pages, sizeof(bdd_node *) * cap);
+            if (!grown) return -1;
+            mgr->pages = grown;
+            mgr->pages_cap = cap;
+        }
+        mgr->pages[mgr->num_pages] = malloc(sizeof(bdd_node) * BDD_PAGE_SIZE);
+        if (!mgr->pages[mgr->num_pages]) return -1;
+        mgr->num_pages++;
+    }
+
+    return mgr->num_nodes++;
+}
+
+// nó (level, low, high) reduzido e único
+static int make_node(bdd_manager *mgr, int level, int low, int high) {
+    if (low < 0 || high < 0) return -1;
+    if (low == high) return low; // teste redundante
+
+    unsigned b = hash_node(level, low, high) & (mgr->num_buckets - 1);
+    for (int id = mgr->buckets[b]; id >= 0; id = node_at(mgr, id)->next) {
+        bdd_node *n = node_at(mgr, id);
+        if (n->level == level && n->low == low && n->high == high) return id;
+    }
+
+    int id = alloc_node(mgr);
+    if (id < 0) return -1;
+
+    bdd_node *n = node_at(mgr, id);
+    n->level = level;
+    n->low = low;
+    n->high = high;
+    n->next = mgr->buckets[b];
+    mgr->buckets[b] = id;
+
+    if (mgr->num_nodes > mgr->num_buckets * 2) grow_buckets(mgr);
+    return id;
+}
+
+// slot da variável com o nome dado (busca binária: os slots seguem a ordem dos nomes); -1 se não existir
+static int find_var(const program *prog, const char *name, int length) {
+    int lo = 0, hi = prog->num_vars - 1;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const char *var = prog->var_names[mid];
+        int c = strncmp(var, name, length);
+        if (c == 0) c = var[length] ? 1 : 0; // prefixo igual: o nome mais longo vem depois
+        if (c == 0) return mid;
+        if (c < 0) lo = mid + 1; else hi = mid - 1;
+    }
+    return -1;
+}
+
+static void take_slot(int slot, unsigned char *used, int *order, int *count) {
+    if (slot >= 0 && !used[slot]) {
+        used[slot] = 1;
+        order[(*count)++] = slot;
+    }
+}
+
+int bdd_parse_order(const program *prog, const char *spec, int *order, error_status *status) {
+    int count = 0;
+
+    if (!spec || strcmp(spec, "natural") == 0) {
+        for (int j = 0; j < prog->num_vars; j++) order[j] = j;
+        return 1;
+    }
+
+    unsigned char *used = calloc(prog->num_vars > 0 ? prog->num_vars : 1, 1);
+    if (!used) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    if (strcmp(spec, "appearance") == 0) {
+        // o programa pós-fixo preserva a ordem das proposições no texto
+        for (int i = 0; i < prog->length; i++)
+            if (prog->code[i].op == OP_LOAD) take_slot(prog->code[i].slot, used, order, &count);
+        // variáveis eliminadas pela simplificação vão para o fim
+        for (int j = 0; j < prog->num_vars; j++) take_slot(j, used, order, &count);
+        free(used);
+        return 1;
+    }
+
+    // lista explícita de variáveis
+    for (int i = 0; spec[i];) {
+        if (spec[i] == ',' || isspace((unsigned char) spec[i])) {
+            i++;
+            continue;
+        }
+        if (!isalpha((unsigned char) spec[i])) {
+            char detail[50];
+            sprintf(detail, "Encontrado '%c' na ordem de variaveis", spec[i]);
+            set_error(status, ERR_INVALID_SYMBOL, i, detail);
+            free(used);
+            return 0;
+        }
+
+        int start = i;
+        while (isalnum((unsigned char) spec[i]) || spec[i] == '_') i++;
+
+        // nomes ausentes da expressão são ignorados: a mesma ordem serve para várias fórmulas
+        int slot = find_var(prog, spec + start, i - start);
+        if (slot >= 0) {
+            take_slot(slot, used, order, &count);
+        } else {
+            for (int k = start; k < i; k++) take_slot(find_var(prog, spec + k, 1), used, order, &count);
+        }
+    }
+    for (int j = 0; j < prog->num_vars; j++)
+        if (!used[j]) order[count++] = j;
+
+    free(used);
+    return 1;
+}
+
+bdd_manager *bdd_create(const program *prog, const int *order, int max_nodes) {
+    bdd_manager *mgr = calloc(1, sizeof(bdd_manager));
+    if (!mgr) return NULL;
+
+    mgr->max_nodes = max_nodes > 0 ? max_nodes : BDD_DEFAULT_MAX_NODES;
+    mgr->num_levels = prog->num_vars;
+    mgr->level_of_slot = malloc(sizeof(int) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    mgr->bit_of_level = malloc(sizeof(int) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    if (!mgr->level_of_slot || !mgr->bit_of_level) {
+        bdd_destroy(mgr);
+        return NULL;
+    }
+    for (int level = 0; level < prog->num_vars; level++) {
+        int slot = order ? order[level] : level;
+        mgr->level_of_slot[slot] = level;
+        mgr->bit_of_level[level] = prog->num_vars - slot - 1;
+    }
+
+    mgr->num_buckets = BDD_INITIAL_BUCKETS;
+    mgr->buckets = malloc(sizeof(int) * mgr->num_buckets);
+    mgr->cache = malloc(sizeof(cache_entry) << BDD_CACHE_BITS);
+    if (!mgr->buckets || !mgr->cache) {
+        bdd_destroy(mgr);
+        return NULL;
+    }
+    for (int i = 0; i < mgr->num_buckets; i++) mgr->buckets[i] = -1;
+    for (int i = 0; i < (1 << BDD_CACHE_BITS); i++) mgr->cache[i].op = -1;
+
+    // terminais 0 e 1 ficam abaixo de todos os níveis
+    for (int t = 0; t < 2; t++) {
+        int id = alloc_node(mgr);
+        if (id < 0) {
+            bdd_destroy(mgr);
+            return NULL;
+        }
+        node_at(mgr, id)->level = mgr->num_levels;
+        node_at(mgr, id)->low = node_at(mgr, id)->high = id;
+        node_at(mgr, id)->next = -1;
+    }
+
+    return mgr;
+}
+
+void bdd_destroy(bdd_manager *mgr) {
+    if (!mgr) return;
+    for (int p = 0; p < mgr->num_pages; p++) free(mgr->pages[p]);
+    free(mgr->pages);
+    free(mgr->buckets);
+    free(mgr->cache);
+    free(mgr->level_of_slot);
+    free(mgr->bit_of_level);
+    free(mgr);
+}
+
+int bdd_var(bdd_manager *mgr, int slot) {
+    return make_node(mgr, mgr->level_of_slot[slot], BDD_FALSE, BDD_TRUE);
+}
+
+static cache_entry *cache_slot(bdd_manager *mgr, int op, int a, int b) {
+    unsigned h = (unsigned) op * 2654435761u ^ (unsigned) a * 40503u ^ (unsigned) b * 2246822519u;
+    return &mgr->cache[(h ^ (h >> 16)) & ((1u << BDD_CACHE_BITS) - 1)];
+}
+
+int bdd_not(bdd_manager *mgr, int a) {
+    if (a < 0) return -1;
+    if (a == BDD_FALSE) return BDD_TRUE;
+    if (a == BDD_TRUE) return BDD_FALSE;
+
+    cache_entry *e = cache_slot(mgr, OP_NOT, a, 0);
+    if (e->op == OP_NOT && e->a == a) return e->result;
+
+    bdd_node n = *node_at(mgr, a);
+    int result = make_node(mgr, n.level, bdd_not(mgr, n.low), bdd_not(mgr, n.high));
+
+    if (result >= 0) {
+        e = cache_slot(mgr, OP_NOT, a, 0);
+        e->op = OP_NOT; e->a = a; e->b = 0; e->result = result;
+    }
+    return result;
+}
+
+// casos terminais do apply; retorna -2 quando é preciso decompor
+static int apply_terminal(bdd_manager *mgr, op_code op, int a, int b) {
+    switch (op) {
+        case OP_AND:
+            if (a == BDD_FALSE || b == BDD_FALSE) return BDD_FALSE;
+            if (a == BDD_TRUE || a == b) return b;
+            if (b == BDD_TRUE) return a;
+            break;
+        case OP_OR:
+            if (a == BDD_TRUE || b == BDD_TRUE) return BDD_TRUE;
+            if (a == BDD_FALSE || a == b) return b;
+            if (b == BDD_FALSE) return a;
+            break;
+        case OP_IMPLIES:
+            if (a == BDD_FALSE || b == BDD_TRUE || a == b) return BDD_TRUE;
+            if (a == BDD_TRUE) return b;
+            if (b == BDD_FALSE) return bdd_not(mgr, a);
+            break;
+        default: // OP_IFF
+            if (a == b) return BDD_TRUE;
+            if (a == BDD_TRUE) return b;
+            if (b == BDD_TRUE) return a;
+            if (a == BDD_FALSE) return bdd_not(mgr, b);
+            if (b == BDD_FALSE) return bdd_not(mgr, a);
+            break;
+    }
+    return -2;
+}
+
+int bdd_apply(bdd_manager *mgr, op_code op, int a, int b) {
+    if (a < 0 || b < 0) return -1;
+
+    int result = apply_terminal(mgr, op, a, b);
+    if (result != -2) return result;
+
+    // operações comutativas compartilham a entrada da cache
+    if (op != OP_IMPLIES && a > b) {
+        int tmp = a; a = b; b = tmp;
+    }
+
+    cache_entry *e = cache_slot(mgr, op, a, b);
+    if (e->op == (int) op && e->a == a && e->b == b) return e->result;
+
+    bdd_node na = *node_at(mgr, a);
+    bdd_node nb = *node_at(mgr, b);
+    int level = na.level < nb.level ? na.level : nb.level;
+
+    // cofatores em relação à variável do menor nível
+    int a0 = na.level == level ? na.low : a, a1 = na.level == level ? na.high : a;
+    int b0 = nb.level == level ? nb.low : b, b1 = nb.level == level ? nb.high : b;
+
+    int low = bdd_apply(mgr, op, a0, b0);
+    int high = bdd_apply(mgr, op, a1, b1);
+    result = make_node(mgr, level, low, high);
+
+    if (result >= 0) {
+        e = cache_slot(mgr, op, a, b); // a entrada pode ter sido reutilizada na recursão
+        e->op = op; e->a = a; e->b = b; e->result = result;
+    }
+    return result;
+}
+
+int bdd_build(bdd_manager *mgr, const program *prog, error_status *status) {
+    int *stack = malloc(sizeof(int) * (prog->max_depth + prog->num_temps));
+    int top = -1;
+
+    if (!stack) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return -1;
+    }
+    int *temps = stack + prog->max_depth; // subexpressões compartilhadas viram o mesmo BDD
+
+    // a mesma máquina de pilha do programa, com BDDs no lugar de valores
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        switch (ins->op) {
+            case OP_LOAD: stack[++top] = bdd_var(mgr, ins->slot); break;
+            case OP_NOT:  stack[top] = bdd_not(mgr, stack[top]); break;
+            case OP_CONST: stack[++top] = ins->slot ? BDD_TRUE : BDD_FALSE; break;
+            case OP_STORE: temps[ins->slot] = stack[top]; break;
+            case OP_FETCH: stack[++top] = temps[ins->slot]; break;
+            default:      top--; stack[top] = bdd_apply(mgr, ins->op, stack[top], stack[top+1]); break;
+        }
+        if (stack[top] < 0) {
+            free(stack);
+            // limite de nós: a memória não acabou, a ordem das variáveis é que não serve
+            if (mgr->num_nodes >= mgr->max_nodes) {
+                char detail[24];
+                snprintf(detail, sizeof(detail), "%d", mgr->max_nodes);
+                set_error(status, ERR_NODE_LIMIT, -1, detail);
+            } else {
+                set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+            }
+            return -1;
+        }
+    }
+
+    int root = stack[0];
+    free(stack);
+    return root;
+}
+
+// linhas satisfeitas sobre os níveis [level(id), num_levels)
+static uint64_t count_from(bdd_manager *mgr, int id, uint64_t *memo, unsigned char *done) {
+    if (id == BDD_FALSE) return 0;
+    if (id == BDD_TRUE) return 1;
+    if (done[id]) return memo[id];
+
+    bdd_node n = *node_at(mgr, id);
+    int low_level = node_at(mgr, n.low)->level;
+    int high_level = node_at(mgr, n.high)->level;
+
+    // níveis pulados por uma aresta são livres: cada um dobra a contagem
+    uint64_t count = (count_from(mgr, n.low, memo, done) << (low_level - n.level - 1)) +
+                     (count_from(mgr, n.high, memo, done) << (high_level - n.level - 1));
+
+    memo[id] = count;
+    done[id] = 1;
+    return count;
+}
+
+uint64_t bdd_sat_count(bdd_manager *mgr, int root) {
+    uint64_t *memo = calloc(mgr->num_nodes, sizeof(uint64_t));
+    unsigned char *done = calloc(mgr->num_nodes, 1);
+    uint64_t count = 0;
+
+    if (memo && done)
+        count = count_from(mgr, root, memo, done) << node_at(mgr, root)->level;
+
+    free(memo);
+    free(done);
+    return count;
+}
+
+// como count_from, em precisão arbitrária; 0 em falha de alocação
+static int count_exact_from(bdd_manager *mgr, int id, bignum *memo, unsigned char *done) {
+    if (id <= BDD_TRUE || done[id]) return 1;
+
+    bdd_node n = *node_at(mgr, id);
+    if (!count_exact_from(mgr, n.low, memo, done) || !count_exact_from(mgr, n.high, memo, done)) return 0;
+
+    bignum high;
+    bignum_init(&high);
+    int ok = bignum_copy(&memo[id], &memo[n.low]) &&
+             bignum_shift_left(&memo[id], node_at(mgr, n.low)->level - n.level - 1) &&
+             bignum_copy(&high, &memo[n.high]) &&
+             bignum_shift_left(&high, node_at(mgr, n.high)->level - n.level - 1) &&
+             bignum_add(&memo[id], &high);
+    bignum_free(&high);
+
+    done[id] = 1;
+    return ok;
+}
+
+int bdd_sat_count_exact(bdd_manager *mgr, int root, bignum *count) {
+    bignum *memo = malloc(sizeof(bignum) * mgr->num_nodes);
+    unsigned char *done = calloc(mgr->num_nodes, 1);
+    int ok = memo && done;
+
+    if (ok) {
+        for (int i = 0; i < mgr->num_nodes; i++) bignum_init(&memo[i]);
+        ok = bignum_set_u64(&memo[BDD_FALSE], 0) && bignum_set_u64(&memo[BDD_TRUE], 1) &&
+             count_exact_from(mgr, root, memo, done) && bignum_copy(count, &memo[root]) &&
+             bignum_shift_left(count, node_at(mgr, root)->level);
+        for (int i = 0; i < mgr->num_nodes; i++) bignum_free(&memo[i]);
+    }
+
+    free(memo);
+    free(done);
+    return ok;
+}
+
+static int mark_reachable(const bdd_manager *mgr, int id, unsigned char *seen) {
+    if (seen[id]) return 0;
+    seen[id] = 1;
+    if (id <= BDD_TRUE) return 1;
+
+    const bdd_node *n = node_at(mgr, id);
+    return 1 + mark_reachable(mgr, n->low, seen) + mark_reachable(mgr, n->high, seen);
+}
+
+int bdd_size(bdd_manager *mgr, int root) {
+    unsigned char *seen = calloc(mgr->num_nodes, 1);
+    int size = 0;
+
+    if (seen) size = mark_reachable(mgr, root, seen);
+    free(seen);
+    return size;
+}
+
+// palavra de 64 resultados a partir do nó 'id' para as linhas base .. base + 63
+static uint64_t eval_word(const bdd_manager *mgr, int id, uint64_t base) {
+    while (id > BDD_TRUE) {
+        const bdd_node *n = node_at(mgr, id);
+        int bit = mgr->bit_of_level[n->level];
+
+        if (bit < 6) {
+            // variável que varia dentro da palavra: combina os dois ramos pela máscara
+            uint64_t mask = block_lane_masks[bit];
+            return (mask & eval_word(mgr, n->high, base)) | (~mask & eval_word(mgr, n->low, base));
+        }
+        id = ((base >> bit) & 1) ? n->high : n->low;
+    }
+    return id == BDD_TRUE ? ~0ULL : 0ULL;
+}
+
+uint64_t bdd_eval_block(const bdd_manager *mgr, int root, uint64_t block) {
+    return eval_word(mgr, root, block * ROWS_PER_WORD);
+}
+
+void print_bdd_summary(const char *expression, const char *order_spec, FILE *out) {
+    error_status status;
+    program prog;
+
+    if (!out) out = stdout;
+
+    if (!parse_expression(expression, &prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return;
+    }
+
+    int *order = malloc(sizeof(int) * prog.num_vars);
+    if (!order) set_error(&status, ERR_MEMORY_ALLOCATION, -1, "");
+    if (!order || !bdd_parse_order(&prog, order_spec, order, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        free(order);
+        free_program(&prog);
+        return;
+    }
+
+    bdd_manager *mgr = bdd_create(&prog, order, 0);
+    int root = mgr ? bdd_build(mgr, &prog, &status) : -1;
+    if (root < 0) {
+        fprintf(stderr, "Erro: %s\n", mgr ? status.message : "Falha de alocacao de memoria");
+        bdd_destroy(mgr);
+        free(order);
+        free_program(&prog);
+        return;
+    }
+
+    // raiz terminal: classificação em tempo constante
+    formula_class kind = root == BDD_TRUE ? CLASS_TAUTOLOGY :
+                         root == BDD_FALSE ? CLASS_CONTRADICTION : CLASS_CONTINGENT;
+
+    bignum count;
+    char *count_text = NULL;
+    bignum_init(&count);
+    if (bdd_sat_count_exact(mgr, root, &count)) count_text = format_model_count(&count, prog.num_vars);
+    bignum_free(&count);
+
+    fprintf(out, "%s: %s\n", expression, formula_class_name(kind));
+    fprintf(out, "  linhas verdadeiras: %s\n", count_text ? count_text : "sem memoria para a contagem");
+    free(count_text);
+    fprintf(out, "  nos no diagrama: %d (ordem:", bdd_size(mgr, root));
+    for (int level = 0; level < prog.num_vars; level++)
+        fprintf(out, " %s", prog.var_names[order[level]]);
+    fprintf(out, ")\n");
+
+    bdd_destroy(mgr);
+    free(order);
+    free_program(&prog);
+}
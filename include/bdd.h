@@ -0,0 +1,148 @@
+#ifndef BDD_H
+#define BDD_H
+
+#include <stdint.h>
+
+#include "bignum.h"  // contagem de precisão arbitrária
+#include "compile.h" // programa pós-fixo compilado
+
+#define BDD_FALSE 0 ///< nó terminal falso
+#define BDD_TRUE  1 ///< nó terminal verdadeiro
+
+#define BDD_DEFAULT_MAX_NODES (1 << 24) ///< limite padrão de nós por gerenciador
+
+/// @brief gerenciador de BDDs ordenados e reduzidos (ROBDD)
+///
+/// mantém a tabela única (hash-consing dos nós), a cache de operações de
+/// apply e o pool de nós; todo BDD construído no mesmo gerenciador é
+/// canônico, então igualdade de funções equivale a igualdade de índices
+typedef struct bdd_manager bdd_manager;
+
+/**
+ * @brief interpreta uma especificação de ordem de variáveis
+ *
+ * "natural" segue a ordem da tabela (ordem lexicográfica dos nomes),
+ * "appearance" segue a primeira ocorrência na expressão e qualquer outro
+ * texto é lido como a lista de variáveis na ordem desejada, separadas por
+ * vírgulas ou espaços (por exemplo "x2,x10,x1"); um nome que não existe na
+ * expressão é lido letra a letra, então "cab" continua valendo c, a, b.
+ * variáveis não listadas são acrescentadas na ordem natural e nomes que não
+ * aparecem na expressão são ignorados
+ *
+ * @param prog programa compilado
+ * @param spec especificação (NULL = "natural")
+ * @param order saída com prog->num_vars posições: order[nível] = slot da variável
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 se a especificação for inválida
+ */
+int bdd_parse_order(const program *prog, const char *spec, int *order, error_status *status);
+
+/**
+ * @brief cria um gerenciador para as variáveis do programa
+ *
+ * @param prog programa que define as variáveis (slots) e a ordem da tabela
+ * @param order order[nível] = slot (NULL = ordem natural)
+ * @param max_nodes limite de nós (0 = BDD_DEFAULT_MAX_NODES)
+ * @return bdd_manager* gerenciador ou NULL se faltar memória
+ */
+bdd_manager *bdd_create(const program *prog, const int *order, int max_nodes);
+
+/**
+ * @brief libera o gerenciador e todos os seus nós
+ *
+ * @param mgr gerenciador (pode ser NULL)
+ */
+void bdd_destroy(bdd_manager *mgr);
+
+/**
+ * @brief BDD da variável de um slot
+ *
+ * @param mgr gerenciador
+ * @param slot slot da variável no programa
+ * @return int nó da variável ou -1 se o limite de nós foi atingido
+ */
+int bdd_var(bdd_manager *mgr, int slot);
+
+/**
+ * @brief negação de um BDD
+ *
+ * @param mgr gerenciador
+ * @param a nó de entrada
+ * @return int nó resultante ou -1 se o limite de nós foi atingido
+ */
+int bdd_not(bdd_manager *mgr, int a);
+
+/**
+ * @brief aplica um operador binário (OP_AND, OP_OR, OP_IMPLIES, OP_IFF)
+ *
+ * @param mgr gerenciador
+ * @param op operador
+ * @param a operando esquerdo
+ * @param b operando direito
+ * @return int nó resultante ou -1 se o limite de nós foi atingido
+ */
+int bdd_apply(bdd_manager *mgr, op_code op, int a, int b);
+
+/**
+ * @brief constrói o BDD de um programa compilado sobre as mesmas variáveis
+ *
+ * @param mgr gerenciador criado para o programa
+ * @param prog programa compilado
+ * @param status recebe ERR_NODE_LIMIT quando o limite de nós do gerenciador é atingido
+ * @return int raiz do BDD ou -1 em caso de erro
+ */
+int bdd_build(bdd_manager *mgr, const program *prog, error_status *status);
+
+/**
+ * @brief número de atribuições (sobre todas as variáveis do gerenciador) que satisfazem o BDD
+ *
+ * a contagem só cabe em 64 bits com até MAX_TABLE_VARS variáveis
+ *
+ * @param mgr gerenciador
+ * @param root raiz
+ * @return uint64_t quantidade de linhas verdadeiras
+ */
+uint64_t bdd_sat_count(bdd_manager *mgr, int root);
+
+/**
+ * @brief bdd_sat_count em precisão arbitrária (qualquer número de variáveis)
+ *
+ * @param mgr gerenciador
+ * @param root raiz
+ * @param count recebe a quantidade de linhas verdadeiras (inicializado pelo chamador)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bdd_sat_count_exact(bdd_manager *mgr, int root, bignum *count);
+
+/**
+ * @brief número de nós alcançáveis a partir da raiz (terminais incluídos)
+ *
+ * @param mgr gerenciador
+ * @param root raiz
+ * @return int tamanho do diagrama
+ */
+int bdd_size(bdd_manager *mgr, int root);
+
+/**
+ * @brief avalia um bloco de 64 linhas da tabela diretamente no diagrama
+ *
+ * as variáveis dos 6 bits baixos do índice da linha combinam os dois ramos
+ * com as máscaras alternadas; as demais apenas escolhem o ramo
+ *
+ * @param mgr gerenciador
+ * @param root raiz
+ * @param block índice do bloco (linhas block*64 a block*64 + 63)
+ * @return uint64_t bit k = resultado da linha block*64 + k
+ */
+uint64_t bdd_eval_block(const bdd_manager *mgr, int root, uint64_t block);
+
+/**
+ * @brief constrói o BDD de uma expressão e imprime classificação, contagem e tamanho
+ *
+ * @param expression string contendo a expressão lógica
+ * @param order_spec especificação da ordem de variáveis (ver bdd_parse_order)
+ * @param out destino do relatório (NULL = stdout)
+ */
+void print_bdd_summary(const char *expression, const char *order_spec, FILE *out);
+
+#endif // BDD_H
@@ -0,0 +1,190 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bignum.h"
+
+#define DECIMAL_BASE 1000000000u // maior potência de 10 que cabe em uma palavra
+#define DECIMAL_DIGITS 9
+
+// garante espaço para 'size' palavras, preservando as atuais
+static int reserve(bignum *n, int size) {
+    if (size <= n->capacity) return 1;
+
+    int capacity = n->capacity ? n->capacity : 4;
+    while (capacity < size) capacity *= 2;
+
+    uint32_t *grown = realloc(n->limbs, sizeof(uint32_t) * capacity);
+    if (!grown) return 0;
+    n->limbs = grown;
+    n->capacity = capacity;
+    return 1;
+}
+
+// remove os zeros à esquerda
+static void trim(bignum *n) {
+    while (n->size > 0 && n->limbs[n->size - 1] == 0) n->size--;
+}
+
+void bignum_init(bignum *n) {
+    n->limbs = NULL;
+    n->size = 0;
+    n->capacity = 0;
+}
+
+void bignum_free(bignum *n) {
+    free(n->limbs);
+    bignum_init(n);
+}
+
+int bignum_set_u64(bignum *n, uint64_t value) {
+    if (!reserve(n, 2)) return 0;
+    n->limbs[0] = (uint32_t) value;
+    n->limbs[1] = (uint32_t) (value >> 32);
+    n->size = 2;
+    trim(n);
+    return 1;
+}
+
+int bignum_copy(bignum *dst, const bignum *src) {
+    if (dst == src) return 1;
+    if (!reserve(dst, src->size)) return 0;
+    if (src->size > 0) memcpy(dst->limbs, src->limbs, sizeof(uint32_t) * src->size);
+    dst->size = src->size;
+    return 1;
+}
+
+int bignum_add(bignum *dst, const bignum *src) {
+    int size = dst->size > src->size ? dst->size : src->size;
+    int src_size = src->size; // src pode ser o próprio dst
+    uint64_t carry = 0;
+
+    if (!reserve(dst, size + 1)) return 0;
+    for (int i = dst->size; i < size; i++) dst->limbs[i] = 0;
+
+    for (int i = 0; i < size; i++) {
+        carry += (uint64_t) dst->limbs[i] + (i < src_size ? src->limbs[i] : 0);
+        dst->limbs[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    dst->limbs[size] = (uint32_t) carry;
+    dst->size = size + 1;
+    trim(dst);
+    return 1;
+}
+
+void bignum_sub(bignum *dst, const bignum *src) {
+    int64_t borrow = 0;
+
+    for (int i = 0; i < dst->size; i++) {
+        int64_t diff = (int64_t) dst->limbs[i] - (i < src->size ? src->limbs[i] : 0) - borrow;
+        borrow = diff < 0;
+        dst->limbs[i] = (uint32_t) (diff + (borrow << 32));
+    }
+    trim(dst);
+}
+
+int bignum_mul(bignum *dst, const bignum *src) {
+    if (dst->size == 0 || src->size == 0) {
+        dst->size = 0;
+        return 1;
+    }
+
+    // multiplicação escolar em um vetor novo, que passa a ser o de dst
+    int size = dst->size + src->size;
+    uint32_t *product = calloc(size, sizeof(uint32_t));
+    if (!product) return 0;
+
+    for (int i = 0; i < dst->size; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; j < src->size; j++) {
+            carry += (uint64_t) dst->limbs[i] * src->limbs[j] + product[i + j];
+            product[i + j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+        product[i + src->size] = (uint32_t) carry;
+    }
+
+    free(dst->limbs);
+    dst->limbs = product;
+    dst->size = size;
+    dst->capacity = size;
+    trim(dst);
+    return 1;
+}
+
+int bignum_shift_left(bignum *n, int bits) {
+    if (n->size == 0 || bits == 0) return 1;
+
+    int words = bits / 32, shift = bits % 32;
+    if (!reserve(n, n->size + words + 1)) return 0;
+
+    // da palavra mais significativa para a menos, para não sobrescrever a origem
+    n->limbs[n->size + words] = 0;
+    for (int i = n->size - 1; i >= 0; i--) {
+        uint64_t moved = (uint64_t) n->limbs[i] << shift;
+        n->limbs[i + words + 1] |= (uint32_t) (moved >> 32);
+        n->limbs[i + words] = (uint32_t) moved;
+    }
+    for (int i = 0; i < words; i++) n->limbs[i] = 0;
+
+    n->size += words + 1;
+    trim(n);
+    return 1;
+}
+
+int bignum_compare(const bignum *a, const bignum *b) {
+    if (a->size != b->size) return a->size < b->size ? -1 : 1;
+    for (int i = a->size - 1; i >= 0; i--)
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    return 0;
+}
+
+int bignum_to_u64(const bignum *n, uint64_t *value) {
+    if (n->size > 2) return 0;
+    *value = 0;
+    for (int i = n->size - 1; i >= 0; i--) *value = *value << 32 | n->limbs[i];
+    return 1;
+}
+
+char *bignum_to_string(const bignum *n) {
+    // cada palavra tem menos de 10 dígitos decimais
+    size_t capacity = (size_t) n->size * 10 + 2;
+    char *text = malloc(capacity);
+    uint32_t *rest = malloc(sizeof(uint32_t) * (n->size > 0 ? n->size : 1));
+    int size = n->size;
+    size_t length = 0;
+
+    if (!text || !rest) {
+        free(text);
+        free(rest);
+        return NULL;
+    }
+    if (size > 0) memcpy(rest, n->limbs, sizeof(uint32_t) * size);
+
+    // divisões sucessivas por 10^9; os dígitos saem do menos significativo
+    do {
+        uint64_t remainder = 0;
+        for (int i = size - 1; i >= 0; i--) {
+            uint64_t current = remainder << 32 | rest[i];
+            rest[i] = (uint32_t) (current / DECIMAL_BASE);
+            remainder = current % DECIMAL_BASE;
+        }
+        while (size > 0 && rest[size - 1] == 0) size--;
+
+        for (int d = 0; d < DECIMAL_DIGITS && (size > 0 || remainder > 0 || d == 0); d++) {
+            text[length++] = (char) ('0' + remainder % 10);
+            remainder /= 10;
+        }
+    } while (size > 0);
+
+    // inverte para a ordem de leitura
+    for (size_t i = 0; i < length / 2; i++) {
+        char c = text[i];
+        text[i] = text[length - 1 - i];
+        text[length - 1 - i] = c;
+    }
+    text[length] = '\0';
+
+    free(rest);
+    return text;
+}
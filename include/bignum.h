@@ -0,0 +1,106 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <stdint.h>
+
+/// @brief inteiro sem sinal de precisão arbitrária (contagens acima de 64 bits)
+typedef struct {
+    uint32_t *limbs; ///< palavras de 32 bits, a menos significativa primeiro
+    int size;        ///< palavras em uso, sem zeros à esquerda (0 = o número zero)
+    int capacity;    ///< capacidade de 'limbs'
+} bignum;
+
+/**
+ * @brief inicializa o número com zero (sem alocar)
+ *
+ * @param n número a inicializar
+ */
+void bignum_init(bignum *n);
+
+/**
+ * @brief libera as palavras do número
+ *
+ * @param n número inicializado
+ */
+void bignum_free(bignum *n);
+
+/**
+ * @brief atribui um valor de 64 bits
+ *
+ * @param n número
+ * @param value valor
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bignum_set_u64(bignum *n, uint64_t value);
+
+/**
+ * @brief copia 'src' para 'dst'
+ *
+ * @param dst destino
+ * @param src origem
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bignum_copy(bignum *dst, const bignum *src);
+
+/**
+ * @brief dst += src
+ *
+ * @param dst acumulador
+ * @param src parcela (pode ser o próprio dst)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bignum_add(bignum *dst, const bignum *src);
+
+/**
+ * @brief dst -= src, com dst >= src
+ *
+ * @param dst minuendo
+ * @param src subtraendo (não maior que dst)
+ */
+void bignum_sub(bignum *dst, const bignum *src);
+
+/**
+ * @brief dst *= src
+ *
+ * @param dst acumulador
+ * @param src fator (pode ser o próprio dst)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bignum_mul(bignum *dst, const bignum *src);
+
+/**
+ * @brief n *= 2^bits
+ *
+ * @param n número
+ * @param bits expoente (>= 0)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int bignum_shift_left(bignum *n, int bits);
+
+/**
+ * @brief compara dois números
+ *
+ * @param a primeiro número
+ * @param b segundo número
+ * @return int negativo, zero ou positivo, como strcmp
+ */
+int bignum_compare(const bignum *a, const bignum *b);
+
+/**
+ * @brief converte para 64 bits quando o valor cabe
+ *
+ * @param n número
+ * @param value recebe o valor
+ * @return int 1 se o valor cabe em 64 bits, 0 caso contrário
+ */
+int bignum_to_u64(const bignum *n, uint64_t *value);
+
+/**
+ * @brief texto decimal do número
+ *
+ * @param n número
+ * @return char* string alocada (liberar com free) ou NULL em falha de alocação
+ */
+char *bignum_to_string(const bignum *n);
+
+#endif // BIGNUM_H
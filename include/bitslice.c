@@ -0,0 +1,82 @@
+#include "bitslice.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// máscara do bit b do índice da linha dentro de uma palavra: bit k = (k >> b) & 1
+const uint64_t block_lane_masks[6] = {
+    0xAAAAAAAAAAAAAAAAULL,
+    0xCCCCCCCCCCCCCCCCULL,
+    0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL,
+    0xFFFF0000FFFF0000ULL,
+    0xFFFFFFFF00000000ULL
+};
+
+void load_block_words(const program *prog, uint64_t block, uint64_t *words) {
+    uint64_t base = block * ROWS_PER_WORD;
+
+    for (int j = 0; j < prog->num_vars; j++) {
+        int bit = prog->num_vars - j - 1; // bit do índice da linha que controla o slot j
+        if (bit < 6) {
+            words[j] = block_lane_masks[bit];
+        } else {
+            words[j] = ((base >> bit) & 1) ? ~0ULL : 0ULL;
+        }
+    }
+}
+
+// mesma máquina de pilha de run_program, com operações bit a bit sobre palavras
+uint64_t run_program_word(const program *prog, const uint64_t *words, uint64_t *stack) {
+    uint64_t *temps = stack + prog->max_depth; // temporários logo depois da pilha
+    int top = -1;
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        switch (ins->op) {
+            case OP_LOAD:    stack[++top] = words[ins->slot]; break;
+            case OP_NOT:     stack[top] = ~stack[top]; break;
+            case OP_AND:     top--; stack[top] &= stack[top+1]; break;
+            case OP_OR:      top--; stack[top] |= stack[top+1]; break;
+            case OP_IMPLIES: top--; stack[top] = ~stack[top] | stack[top+1]; break;
+            case OP_IFF:     top--; stack[top] = ~(stack[top] ^ stack[top+1]); break;
+            case OP_CONST:   stack[++top] = ins->slot ? ~0ULL : 0ULL; break;
+            case OP_STORE:   temps[ins->slot] = stack[top]; break;
+            case OP_FETCH:   stack[++top] = temps[ins->slot]; break;
+        }
+    }
+
+    return stack[0];
+}
+
+int evaluate_block(const program *prog, uint64_t block, uint64_t *out) {
+    uint64_t words[MAX_TABLE_VARS];
+    uint64_t local[BLOCK_STACK_DEPTH];
+    int frame = prog->max_depth + prog->num_temps;
+    uint64_t *stack = frame <= BLOCK_STACK_DEPTH ? local : malloc(sizeof(uint64_t) * frame);
+
+    if (!stack) return 0;
+
+    load_block_words(prog, block, words);
+    *out = run_program_word(prog, words, stack);
+    if (stack != local) free(stack);
+    return 1;
+}
+
+int count_word_ones(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((x * 0x0101010101010101ULL) >> 56);
+}
+
+int lowest_set_bit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int) index;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
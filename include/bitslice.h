@@ -0,0 +1,68 @@
+#ifndef BITSLICE_H
+#define BITSLICE_H
+
+#include <stdint.h>
+
+#include "compile.h" // programa pós-fixo compilado
+
+#define ROWS_PER_WORD 64 ///< linhas da tabela avaliadas por palavra de 64 bits
+#define BLOCK_STACK_DEPTH 256 ///< pilha e temporários locais de evaluate_block; programas maiores usam o heap
+
+/// @brief máscaras alternadas dos 6 bits baixos do índice da linha (bit k = (k >> b) & 1)
+extern const uint64_t block_lane_masks[6];
+
+/**
+ * @brief preenche as palavras das variáveis para um bloco de 64 linhas
+ *
+ * o bit k da palavra do slot j é o valor da variável j na linha block*64 + k;
+ * as 6 variáveis menos significativas usam as máscaras alternadas padrão
+ * (0xAAAA..., 0xCCCC..., ...) e as demais são palavras constantes
+ *
+ * @param prog programa compilado (no máximo MAX_TABLE_VARS variáveis)
+ * @param block índice do bloco (linhas block*64 a block*64 + 63)
+ * @param words array de saída com prog->num_vars palavras
+ */
+void load_block_words(const program *prog, uint64_t block, uint64_t *words);
+
+/**
+ * @brief executa o programa compilado sobre 64 atribuições ao mesmo tempo
+ *
+ * @param prog programa compilado
+ * @param words palavras das variáveis indexadas por slot
+ * @param stack área de trabalho com prog->max_depth + prog->num_temps palavras
+ *              (a pilha seguida dos temporários)
+ * @return uint64_t palavra em que o bit k é o resultado da k-ésima atribuição
+ */
+uint64_t run_program_word(const program *prog, const uint64_t *words, uint64_t *stack);
+
+/**
+ * @brief avalia um bloco de 64 linhas consecutivas da tabela verdade
+ *
+ * programas com pilha e temporários acima de BLOCK_STACK_DEPTH usam uma área
+ * no heap; se ela não puder ser alocada, 'out' não é escrito
+ *
+ * @param prog programa compilado (no máximo MAX_TABLE_VARS variáveis)
+ * @param block índice do bloco
+ * @param out recebe a palavra em que o bit k é o resultado da linha block*64 + k
+ *            (bits além da última linha da tabela não têm significado)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int evaluate_block(const program *prog, uint64_t block, uint64_t *out);
+
+/**
+ * @brief quantidade de bits 1 de uma palavra (linhas verdadeiras do bloco)
+ *
+ * @param x palavra
+ * @return int número de bits 1
+ */
+int count_word_ones(uint64_t x);
+
+/**
+ * @brief posição do bit 1 menos significativo (primeira linha verdadeira do bloco)
+ *
+ * @param x palavra diferente de zero
+ * @return int índice do bit, de 0 a 63
+ */
+int lowest_set_bit(uint64_t x);
+
+#endif // BITSLICE_H
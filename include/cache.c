@@ -0,0 +1,634 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache.h"
+#include "bitslice.h"
+#include "eval.h"
+
+#define CACHE_FORMAT 1             // muda a chave de todas as entradas quando o formato muda
+#define CACHE_CLASS_MAGIC "LTCL"   // identificação dos arquivos de classificação
+#define CACHE_CLASS_HEADER 12      // bytes antes das atribuições de exemplo
+#define CACHE_STALE_SECONDS 3600   // temporários mais antigos que isso sobraram de processos interrompidos
+
+// FNV-1a de 64 bits seguido de uma mistura final (splitmix64)
+static uint64_t hash_bytes(uint64_t h, const unsigned char *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+static uint64_t hash_finish(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+// slot canônico de cada slot: ordem da primeira leitura no programa
+// (variáveis eliminadas pela simplificação vêm depois, na ordem original)
+static int *canonical_slots(const program *prog) {
+    int *canonical = malloc(sizeof(int) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    int next = 0;
+
+    if (!canonical) return NULL;
+    for (int j = 0; j < prog->num_vars; j++) canonical[j] = -1;
+    for (int k = 0; k < prog->length; k++) {
+        const instruction *ins = &prog->code[k];
+        if (ins->op == OP_LOAD && canonical[ins->slot] < 0) canonical[ins->slot] = next++;
+    }
+    for (int j = 0; j < prog->num_vars; j++)
+        if (canonical[j] < 0) canonical[j] = next++;
+    return canonical;
+}
+
+// forma canônica do programa: formato, número de variáveis e (operação, slot) de cada instrução
+static uint64_t hash_program(const program *prog, const int *canonical, uint64_t seed) {
+    unsigned char head[12];
+    uint64_t h = seed;
+
+    for (int i = 0; i < 4; i++) {
+        head[i] = (unsigned char) (CACHE_FORMAT >> (8 * i));
+        head[4 + i] = (unsigned char) ((unsigned) prog->num_vars >> (8 * i));
+        head[8 + i] = (unsigned char) ((unsigned) prog->length >> (8 * i));
+    }
+    h = hash_bytes(h, head, sizeof(head));
+
+    for (int k = 0; k < prog->length; k++) {
+        const instruction *in = &prog->code[k];
+        unsigned slot = (unsigned) (in->op == OP_LOAD ? canonical[in->slot] : in->slot);
+        unsigned char ins[5];
+
+        ins[0] = (unsigned char) in->op;
+        for (int i = 0; i < 4; i++) ins[1 + i] = (unsigned char) (slot >> (8 * i));
+        h = hash_bytes(h, ins, sizeof(ins));
+    }
+    return hash_finish(h);
+}
+
+static void format_key(const program *prog, const int *canonical, char key[CACHE_KEY_CHARS + 1]) {
+    // duas sementes independentes: 128 bits tornam colisões desprezíveis
+    snprintf(key, CACHE_KEY_CHARS + 1, "%016llx%016llx",
+             (unsigned long long) hash_program(prog, canonical, 0xCBF29CE484222325ULL),
+             (unsigned long long) hash_program(prog, canonical, 0x84222325CBF29CE4ULL));
+}
+
+int cache_key(const program *prog, char key[CACHE_KEY_CHARS + 1]) {
+    int *canonical = canonical_slots(prog);
+    if (!canonical) return 0;
+
+    format_key(prog, canonical, key);
+    free(canonical);
+    return 1;
+}
+
+// troca os papéis das posições p < q do índice da linha em toda a tabela:
+// as linhas com bit p = 1 e bit q = 0 trocam de lugar com as de bit p = 0 e bit q = 1
+static void swap_row_bits(uint64_t *words, uint64_t count, int p, int q) {
+    if (q < 6) {
+        // as duas posições dentro da palavra: troca de bits com deslocamento fixo
+        int shift = (1 << q) - (1 << p);
+        uint64_t mask = block_lane_masks[p] & ~block_lane_masks[q];
+        for (uint64_t w = 0; w < count; w++) {
+            uint64_t t = ((words[w] >> shift) ^ words[w]) & mask;
+            words[w] ^= t ^ (t << shift);
+        }
+    } else if (p < 6) {
+        // p dentro da palavra, q no índice da palavra: metade de cada par de palavras
+        uint64_t high = 1ULL << (q - 6), ones = block_lane_masks[p];
+        int shift = 1 << p;
+        for (uint64_t w = 0; w < count; w++) {
+            if (w & high) continue;
+            uint64_t a = words[w], b = words[w | high];
+            words[w] = (a & ~ones) | ((b & ~ones) << shift);
+            words[w | high] = (b & ones) | ((a & ones) >> shift);
+        }
+    } else {
+        // as duas posições no índice da palavra: palavras inteiras trocam de lugar
+        uint64_t low = 1ULL << (p - 6), high = 1ULL << (q - 6);
+        for (uint64_t w = 0; w < count; w++) {
+            if ((w & low) && !(w & high)) {
+                uint64_t t = words[w];
+                words[w] = words[w - low + high];
+                words[w - low + high] = t;
+            }
+        }
+    }
+}
+
+// copia a tabela canônica e a reordena para os slots do programa: no máximo
+// num_vars - 1 trocas de posições, cada uma uma passada pelas palavras
+static uint64_t *permuted_words(const table_file *file, const int *canonical, int num_vars) {
+    uint64_t count = (file->rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    uint64_t *words = count <= SIZE_MAX / sizeof(uint64_t) ? malloc(sizeof(uint64_t) * count) : NULL;
+    int var_at[MAX_TABLE_VARS]; // slot do programa que ocupa cada posição do índice
+
+    if (!words) return NULL;
+    for (uint64_t w = 0; w < count; w++) words[w] = table_file_word(file, w);
+    for (int j = 0; j < num_vars; j++) var_at[num_vars - 1 - canonical[j]] = j;
+
+    // a posição b recebe o slot num_vars - 1 - b, como em load_block_words
+    for (int b = 0; b < num_vars; b++) {
+        int want = num_vars - 1 - b, q = b;
+        while (var_at[q] != want) q++;
+        if (q == b) continue;
+        swap_row_bits(words, count, b, q);
+        var_at[q] = var_at[b];
+        var_at[b] = want;
+    }
+    return words;
+}
+
+uint64_t cached_table_word(const cached_table *table, uint64_t block) {
+    return table->words ? table->words[block] : table_file_word(&table->file, block);
+}
+
+void cached_table_close(cached_table *table) {
+    table_file_close(&table->file);
+    free(table->words);
+    table->words = NULL;
+}
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+struct result_cache {
+    char *dir;
+    uint64_t max_bytes;
+    pthread_mutex_t lock; // protege os campos abaixo entre as threads do processo
+    uint64_t hits;
+    uint64_t misses;
+    unsigned sequence;    // numeração dos temporários deste processo
+};
+
+// "<dir>/<name><ext>" alocado com malloc
+static char *cache_path(const result_cache *cache, const char *name, const char *ext) {
+    size_t length = strlen(cache->dir) + strlen(name) + strlen(ext) + 2;
+    char *path = malloc(length);
+    if (path) snprintf(path, length, "%s/%s%s", cache->dir, name, ext);
+    return path;
+}
+
+// trava exclusiva do diretório entre processos (e entre threads: cada chamada abre seu descritor)
+static int lock_cache(const result_cache *cache) {
+    char *path = cache_path(cache, "lock", "");
+    int fd = path ? open(path, O_RDWR | O_CREAT, 0644) : -1;
+    free(path);
+
+    if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+static void unlock_cache(int fd) {
+    if (fd >= 0) close(fd); // fechar o descritor libera a trava
+}
+
+static void count_lookup(result_cache *cache, int hit) {
+    pthread_mutex_lock(&cache->lock);
+    if (hit) cache->hits++;
+    else cache->misses++;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// caminho temporário único no diretório do cache
+static char *temp_path(result_cache *cache) {
+    char name[64];
+
+    pthread_mutex_lock(&cache->lock);
+    unsigned sequence = cache->sequence++;
+    pthread_mutex_unlock(&cache->lock);
+
+    snprintf(name, sizeof(name), "tmp-%ld-%u", (long) getpid(), sequence);
+    return cache_path(cache, name, "");
+}
+
+// acerto: a data de modificação serve de último acesso para a ordem LRU
+static void touch_entry(const char *path) {
+    utimensat(AT_FDCWD, path, NULL, 0);
+}
+
+// entrada do diretório considerada na remoção
+typedef struct {
+    char *name;
+    time_t mtime;
+    long mtime_ns;
+    uint64_t size;
+} cache_file;
+
+static int older_first(const void *a, const void *b) {
+    const cache_file *x = a, *y = b;
+    if (x->mtime != y->mtime) return x->mtime < y->mtime ? -1 : 1;
+    if (x->mtime_ns != y->mtime_ns) return x->mtime_ns < y->mtime_ns ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+static int is_entry_name(const char *name) {
+    size_t n = strlen(name);
+    return n == CACHE_KEY_CHARS + 4 && (strcmp(name + CACHE_KEY_CHARS, ".ltt") == 0 ||
+                                        strcmp(name + CACHE_KEY_CHARS, ".cls") == 0);
+}
+
+// percorre o diretório: lista as entradas e, com 'sweep', apaga temporários abandonados
+static cache_file *scan_cache(const result_cache *cache, int sweep, size_t *count, uint64_t *bytes) {
+    DIR *dir = opendir(cache->dir);
+    cache_file *files = NULL;
+    size_t capacity = 0;
+    struct dirent *ent;
+    time_t now = time(NULL);
+
+    *count = 0;
+    *bytes = 0;
+    if (!dir) return NULL;
+
+    while ((ent = readdir(dir)) != NULL) {
+        int entry = is_entry_name(ent->d_name);
+        int temp = strncmp(ent->d_name, "tmp-", 4) == 0;
+        if (!entry && !(temp && sweep)) continue;
+
+        char *path = cache_path(cache, ent->d_name, "");
+        struct stat info;
+        if (!path || stat(path, &info) != 0) {
+            free(path);
+            continue;
+        }
+
+        if (temp) {
+            if (now - info.st_mtime > CACHE_STALE_SECONDS) unlink(path);
+            free(path);
+            continue;
+        }
+        free(path);
+
+        if (*count == capacity) {
+            size_t grown_capacity = capacity ? capacity * 2 : 64;
+            cache_file *grown = realloc(files, sizeof(cache_file) * grown_capacity);
+            if (!grown) break;
+            files = grown;
+            capacity = grown_capacity;
+        }
+
+        cache_file *f = &files[(*count)++];
+        f->name = strdup(ent->d_name);
+        f->mtime = info.st_mtim.tv_sec;
+        f->mtime_ns = info.st_mtim.tv_nsec;
+        f->size = (uint64_t) info.st_size;
+        *bytes += f->size;
+        if (!f->name) (*count)--;
+    }
+
+    closedir(dir);
+    return files;
+}
+
+static void free_scan(cache_file *files, size_t count) {
+    for (size_t i = 0; i < count; i++) free(files[i].name);
+    free(files);
+}
+
+// remove as entradas usadas há mais tempo até o diretório caber no limite
+static void evict(result_cache *cache) {
+    int fd = lock_cache(cache);
+    size_t count;
+    uint64_t bytes;
+    cache_file *files = scan_cache(cache, 1, &count, &bytes);
+
+    if (bytes > cache->max_bytes) {
+        qsort(files, count, sizeof(cache_file), older_first);
+        for (size_t i = 0; i < count && bytes > cache->max_bytes; i++) {
+            char *path = cache_path(cache, files[i].name, "");
+            if (path && unlink(path) == 0) bytes -= files[i].size;
+            free(path);
+        }
+    }
+
+    free_scan(files, count);
+    unlock_cache(fd);
+}
+
+// publica o temporário como a entrada 'final_path' (substituição atômica)
+static int publish(result_cache *cache, char *temp, const char *final_path) {
+    int ok = rename(temp, final_path) == 0;
+    if (!ok) unlink(temp);
+    free(temp);
+    if (ok) evict(cache);
+    return ok;
+}
+
+result_cache *cache_open(const char *dir, uint64_t max_bytes, error_status *status) {
+    result_cache *cache = calloc(1, sizeof(result_cache));
+    if (!cache || !(cache->dir = strdup(dir))) {
+        free(cache);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return NULL;
+    }
+    cache->max_bytes = max_bytes ? max_bytes : CACHE_DEFAULT_BYTES;
+    pthread_mutex_init(&cache->lock, NULL);
+
+    // o diretório precisa existir e aceitar o arquivo de trava
+    int fd = mkdir(dir, 0755) == 0 || errno == EEXIST ? lock_cache(cache) : -1;
+    if (fd < 0) {
+        set_error(status, ERR_FILE_ACCESS, -1, dir);
+        pthread_mutex_destroy(&cache->lock);
+        free(cache->dir);
+        free(cache);
+        return NULL;
+    }
+    unlock_cache(fd);
+    return cache;
+}
+
+// lê os contadores acumulados do arquivo stats aberto em 'fd'
+static void read_stats(int fd, uint64_t *hits, uint64_t *misses) {
+    char text[128];
+    unsigned long long h = 0, m = 0;
+    ssize_t n = pread(fd, text, sizeof(text) - 1, 0);
+
+    text[n > 0 ? n : 0] = '\0';
+    if (sscanf(text, "acertos %llu\nfalhas %llu", &h, &m) != 2) h = m = 0;
+    *hits = h;
+    *misses = m;
+}
+
+// soma os contadores desta execução ao arquivo stats
+static void flush_stats(result_cache *cache) {
+    int lock = lock_cache(cache);
+    char *path = cache_path(cache, "stats", "");
+    int fd = path ? open(path, O_RDWR | O_CREAT, 0644) : -1;
+
+    if (fd >= 0) {
+        uint64_t hits, misses;
+        char text[128];
+        read_stats(fd, &hits, &misses);
+
+        int n = snprintf(text, sizeof(text), "acertos %llu\nfalhas %llu\n",
+                         (unsigned long long) (hits + cache->hits), (unsigned long long) (misses + cache->misses));
+        if (ftruncate(fd, 0) == 0 && pwrite(fd, text, (size_t) n, 0) == n) cache->hits = cache->misses = 0;
+        close(fd);
+    }
+
+    free(path);
+    unlock_cache(lock);
+}
+
+void cache_close(result_cache *cache) {
+    if (!cache) return;
+    if (cache->hits || cache->misses) flush_stats(cache);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->dir);
+    free(cache);
+}
+
+void cache_get_stats(result_cache *cache, cache_stats *stats) {
+    char *path = cache_path(cache, "stats", "");
+    int fd = path ? open(path, O_RDONLY) : -1;
+    size_t count;
+    cache_file *files;
+
+    memset(stats, 0, sizeof(*stats));
+    if (fd >= 0) {
+        read_stats(fd, &stats->total_hits, &stats->total_misses);
+        close(fd);
+    }
+    free(path);
+
+    pthread_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    pthread_mutex_unlock(&cache->lock);
+    stats->total_hits += stats->hits;
+    stats->total_misses += stats->misses;
+
+    files = scan_cache(cache, 0, &count, &stats->bytes);
+    stats->entries = count;
+    free_scan(files, count);
+}
+
+// abre a entrada da tabela se ela existir e for deste programa
+static int open_cached_table(const char *path, const program *prog, table_file *tf) {
+    error_status status;
+    if (!table_file_open(tf, path, &status)) return 0;
+    if (tf->num_vars == prog->num_vars) return 1;
+    table_file_close(tf);
+    return 0;
+}
+
+// cópia do programa com as variáveis na ordem canônica (código e nomes próprios, liberar com free)
+static int canonical_program(const program *prog, const int *canonical, program *copy) {
+    *copy = *prog;
+    copy->code = malloc(sizeof(instruction) * (prog->length > 0 ? prog->length : 1));
+    copy->var_names = malloc(sizeof(char *) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    if (!copy->code || !copy->var_names) {
+        free(copy->code);
+        free(copy->var_names);
+        return 0;
+    }
+
+    for (int k = 0; k < prog->length; k++) {
+        copy->code[k] = prog->code[k];
+        if (copy->code[k].op == OP_LOAD) copy->code[k].slot = canonical[prog->code[k].slot];
+    }
+    for (int j = 0; j < prog->num_vars; j++) copy->var_names[canonical[j]] = prog->var_names[j];
+    return 1;
+}
+
+// avalia a tabela na ordem canônica e a publica em 'path'
+static int store_table(result_cache *cache, const char *path, const program *prog, const int *canonical,
+                       const char *expression, int threads) {
+    error_status status;
+    program copy;
+    char *temp = temp_path(cache);
+    FILE *file = temp ? fopen(temp, "wb") : NULL;
+    int ok = file && canonical_program(prog, canonical, &copy);
+
+    if (ok) {
+        ok = write_table_file(&copy, expression, file, threads, &status);
+        free(copy.code);
+        free(copy.var_names);
+    }
+    if (file && fclose(file) != 0) ok = 0;
+
+    if (ok) return publish(cache, temp, path);
+    if (temp) unlink(temp);
+    free(temp);
+    return 0;
+}
+
+int cache_fetch_table(result_cache *cache, const program *prog, const char *expression, int threads,
+                      cached_table *table) {
+    char key[CACHE_KEY_CHARS + 1];
+    error_status status;
+
+    memset(table, 0, sizeof(*table));
+    if (!check_table_size(prog, &status)) return 0;
+
+    int *canonical = canonical_slots(prog);
+    char *path = NULL;
+    if (canonical) {
+        format_key(prog, canonical, key);
+        path = cache_path(cache, key, ".ltt");
+    }
+    if (!path) {
+        free(canonical);
+        return 0;
+    }
+
+    int ok = open_cached_table(path, prog, &table->file);
+    if (ok) touch_entry(path);
+    count_lookup(cache, ok);
+
+    // falha: calcula e guarda, exceto tabelas que não cabem no cache (bitmap + diretório)
+    uint64_t rows = 1ULL << prog->num_vars;
+    if (!ok && rows / 8 + rows / 256 <= cache->max_bytes)
+        ok = store_table(cache, path, prog, canonical, expression, threads) &&
+             open_cached_table(path, prog, &table->file);
+    free(path);
+
+    // ordem canônica diferente da do programa: a tabela é reordenada uma vez aqui
+    int identity = 1;
+    for (int j = 0; j < prog->num_vars; j++) identity &= canonical[j] == j;
+    if (ok && !identity && !(table->words = permuted_words(&table->file, canonical, prog->num_vars))) {
+        table_file_close(&table->file);
+        ok = 0;
+    }
+    free(canonical);
+    return ok;
+}
+
+// classificação guardada: identificação, variáveis, tipo e as duas atribuições na ordem canônica
+static int read_cached_class(const char *path, const program *prog, const int *canonical, classification *result) {
+    size_t n = (size_t) prog->num_vars;
+    size_t size = CACHE_CLASS_HEADER + 2 * n;
+    unsigned char *data = malloc(size + 1);
+    FILE *file = data ? fopen(path, "rb") : NULL;
+    int ok = file && fread(data, 1, size + 1, file) == size; // o arquivo precisa ter exatamente 'size' bytes
+
+    if (file) fclose(file);
+    ok = ok && memcmp(data, CACHE_CLASS_MAGIC, 4) == 0 &&
+         (data[4] | data[5] << 8 | data[6] << 16 | (unsigned) data[7] << 24) == (unsigned) prog->num_vars &&
+         data[8] <= CLASS_TAUTOLOGY && data[9] <= 1 && data[10] <= 1;
+
+    if (ok) {
+        memset(result, 0, sizeof(*result));
+        result->model = malloc(n > 0 ? n : 1);
+        result->countermodel = malloc(n > 0 ? n : 1);
+        ok = result->model && result->countermodel;
+        if (ok) {
+            result->kind = (formula_class) data[8];
+            result->has_model = data[9];
+            result->has_countermodel = data[10];
+            for (size_t j = 0; j < n; j++) {
+                result->model[j] = data[CACHE_CLASS_HEADER + canonical[j]];
+                result->countermodel[j] = data[CACHE_CLASS_HEADER + n + canonical[j]];
+            }
+        } else {
+            free_classification(result);
+        }
+    }
+
+    free(data);
+    return ok;
+}
+
+static void store_class(result_cache *cache, const char *path, const program *prog, const int *canonical,
+                        const classification *result) {
+    size_t n = (size_t) prog->num_vars;
+    size_t size = CACHE_CLASS_HEADER + 2 * n;
+    unsigned char *data = calloc(1, size);
+    char *temp = data ? temp_path(cache) : NULL;
+    FILE *file = temp ? fopen(temp, "wb") : NULL;
+
+    if (data) {
+        memcpy(data, CACHE_CLASS_MAGIC, 4);
+        for (int i = 0; i < 4; i++) data[4 + i] = (unsigned char) (n >> (8 * i));
+        data[8] = (unsigned char) result->kind;
+        data[9] = (unsigned char) result->has_model;
+        data[10] = (unsigned char) result->has_countermodel;
+        for (size_t j = 0; j < n; j++) {
+            data[CACHE_CLASS_HEADER + canonical[j]] = result->model[j];
+            data[CACHE_CLASS_HEADER + n + canonical[j]] = result->countermodel[j];
+        }
+    }
+
+    int ok = file && fwrite(data, 1, size, file) == size;
+    if (file && fclose(file) != 0) ok = 0;
+
+    if (ok) {
+        publish(cache, temp, path);
+    } else {
+        if (temp) unlink(temp);
+        free(temp);
+    }
+    free(data);
+}
+
+int cache_classify(result_cache *cache, const program *prog, classification *result, error_status *status) {
+    char key[CACHE_KEY_CHARS + 1];
+    int *canonical = cache ? canonical_slots(prog) : NULL;
+    char *path = NULL;
+
+    if (canonical) {
+        format_key(prog, canonical, key);
+        path = cache_path(cache, key, ".cls");
+    }
+    if (!path) {
+        free(canonical);
+        return classify_program(prog, result, status);
+    }
+
+    int ok = read_cached_class(path, prog, canonical, result);
+    if (ok) touch_entry(path);
+    count_lookup(cache, ok);
+
+    if (!ok) {
+        ok = classify_program(prog, result, status);
+        if (ok) store_class(cache, path, prog, canonical, result);
+    }
+
+    free(path);
+    free(canonical);
+    return ok;
+}
+
+#else
+
+// sem flock e rename atômico garantidos: o cache não é usado nesta plataforma
+result_cache *cache_open(const char *dir, uint64_t max_bytes, error_status *status) {
+    (void) max_bytes;
+    set_error(status, ERR_FILE_ACCESS, -1, dir);
+    return NULL;
+}
+
+void cache_close(result_cache *cache) {
+    (void) cache;
+}
+
+void cache_get_stats(result_cache *cache, cache_stats *stats) {
+    (void) cache;
+    memset(stats, 0, sizeof(*stats));
+}
+
+int cache_fetch_table(result_cache *cache, const program *prog, const char *expression, int threads,
+                      cached_table *table) {
+    (void) cache; (void) prog; (void) expression; (void) threads;
+    memset(table, 0, sizeof(*table));
+    return 0;
+}
+
+int cache_classify(result_cache *cache, const program *prog, classification *result, error_status *status) {
+    (void) cache;
+    return classify_program(prog, result, status);
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "classify.h"   // classificação guardada no cache
+#include "tablefile.h"  // formato das tabelas guardadas no cache
+#include "validation.h" // status de erro
+
+#define CACHE_KEY_CHARS 32                  ///< chave: hash de 128 bits em hexadecimal
+#define CACHE_DEFAULT_BYTES (256ULL << 20)  ///< limite padrão do diretório (256 MiB)
+
+/*
+ * cache persistente de resultados em um diretório:
+ *
+ *   <chave>.ltt   tabela no formato de tablefile.h
+ *   <chave>.cls   classificação com as atribuições de exemplo
+ *   stats         acertos e falhas acumulados por todos os processos
+ *   lock          trava (flock) das operações que alteram o diretório
+ *
+ * a chave é o hash do programa compilado com as variáveis renumeradas pela
+ * primeira ocorrência: expressões iguais a menos dos nomes das variáveis,
+ * dos espaços e de parênteses redundantes têm a mesma chave. as entradas
+ * guardam as variáveis nessa ordem canônica; ao abrir uma tabela em outra
+ * ordem, cache_fetch_table a reordena inteira para a ordem alfabética de quem
+ * consulta (palavras de 64 linhas, uma passada por troca de variáveis), e as
+ * atribuições da classificação são convertidas da mesma forma.
+ *
+ * as entradas são gravadas em um arquivo temporário e renomeadas, então
+ * outro processo nunca vê uma entrada pela metade; cada acerto atualiza a
+ * data de modificação, e as entradas mais antigas são removidas quando o
+ * diretório passa do limite
+ */
+
+/// @brief cache aberto (um por processo; pode ser usado por várias threads)
+typedef struct result_cache result_cache;
+
+/// @brief contadores do cache
+typedef struct {
+    uint64_t hits;         ///< acertos desta execução
+    uint64_t misses;       ///< falhas desta execução
+    uint64_t total_hits;   ///< acertos de todos os processos (arquivo stats)
+    uint64_t total_misses; ///< falhas de todos os processos
+    uint64_t entries;      ///< entradas no diretório
+    uint64_t bytes;        ///< bytes ocupados pelas entradas
+} cache_stats;
+
+/// @brief tabela do cache vista na ordem de variáveis de um programa
+typedef struct {
+    table_file file;  ///< entrada aberta (variáveis na ordem canônica)
+    uint64_t *words;  ///< tabela reordenada para os slots do programa (NULL se a ordem canônica já coincide)
+} cached_table;
+
+/**
+ * @brief abre (criando se preciso) o diretório do cache
+ *
+ * @param dir caminho do diretório
+ * @param max_bytes limite de bytes das entradas (0 = CACHE_DEFAULT_BYTES)
+ * @param status recebe ERR_FILE_ACCESS se o diretório não puder ser usado
+ * @return result_cache* cache aberto ou NULL
+ */
+result_cache *cache_open(const char *dir, uint64_t max_bytes, error_status *status);
+
+/**
+ * @brief grava os contadores desta execução em 'stats' e libera o cache
+ *
+ * @param cache cache aberto (NULL é aceito)
+ */
+void cache_close(result_cache *cache);
+
+/**
+ * @brief chave canônica do programa
+ *
+ * @param prog programa compilado
+ * @param key recebe CACHE_KEY_CHARS dígitos hexadecimais e '\0'
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int cache_key(const program *prog, char key[CACHE_KEY_CHARS + 1]);
+
+/**
+ * @brief tabela do programa, do cache ou recém-calculada e guardada nele
+ *
+ * em uma falha a tabela é avaliada com o núcleo empacotado e gravada no cache
+ * antes de ser aberta; tabelas maiores que o limite do cache não são guardadas
+ *
+ * @param cache cache aberto
+ * @param prog programa compilado
+ * @param expression texto guardado no cabeçalho de uma entrada nova
+ * @param threads threads usadas para calcular uma entrada nova
+ * @param table recebe a tabela aberta (fechar com cached_table_close)
+ * @return int 1 se 'table' foi aberta, 0 se o chamador deve avaliar por conta própria
+ */
+int cache_fetch_table(result_cache *cache, const program *prog, const char *expression, int threads,
+                      cached_table *table);
+
+/**
+ * @brief resultados do bloco 'block' na ordem de linhas do programa consultado
+ *
+ * @param table tabela aberta por cache_fetch_table
+ * @param block índice do bloco de 64 linhas
+ * @return uint64_t bit k = resultado da linha block*64 + k, como em evaluate_block
+ */
+uint64_t cached_table_word(const cached_table *table, uint64_t block);
+
+/**
+ * @brief fecha a entrada e libera a tabela reordenada
+ *
+ * @param table tabela aberta por cache_fetch_table
+ */
+void cached_table_close(cached_table *table);
+
+/**
+ * @brief classify_program passando pelo cache
+ *
+ * um acerto devolve a mesma classificação e as mesmas atribuições de exemplo
+ * da primeira execução
+ *
+ * @param cache cache aberto (NULL = apenas classify_program)
+ * @param prog programa compilado
+ * @param result classificação (liberar com free_classification)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int cache_classify(result_cache *cache, const program *prog, classification *result, error_status *status);
+
+/**
+ * @brief contadores desta execução, do arquivo stats e do tamanho do diretório
+ *
+ * @param cache cache aberto
+ * @param stats contadores de saída
+ */
+void cache_get_stats(result_cache *cache, cache_stats *stats);
+
+#endif // CACHE_H
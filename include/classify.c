@@ -0,0 +1,187 @@
+#include "classify.h"
+#include "sat.h"
+#include "cache.h"
+#include "decompose.h"
+
+// resolve a CNF da fórmula com a raiz afirmada (ou negada); 1 = existe atribuição
+static int solve_with_root(cnf_formula *cnf, int root_lit, int num_vars,
+                           unsigned char *assignment, error_status *status) {
+    unsigned char *model = malloc(cnf->num_vars > 0 ? cnf->num_vars : 1);
+    int result = -1;
+
+    if (model && cnf_add_clause(cnf, &root_lit, 1)) {
+        result = sat_solve(cnf, model);
+
+        // descarta a cláusula unitária da raiz para a próxima consulta
+        cnf->num_clauses--;
+        cnf->num_lits--;
+    }
+
+    if (result < 0) set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+    if (result == 1) memcpy(assignment, model, num_vars);
+
+    free(model);
+    return result;
+}
+
+// copia a atribuição da parte para os slots originais
+static void place_assignment(const formula_part *part, const unsigned char *values, unsigned char *assignment) {
+    for (int j = 0; j < part->prog.num_vars; j++) assignment[part->slots[j]] = values[j];
+}
+
+/*
+ * combina as classificações das partes. na conjunção, existe modelo se toda
+ * parte tem modelo (a união deles) e contramodelo se alguma parte tem (o
+ * dela, com as demais em qualquer atribuição); na disjunção, o contrário
+ */
+static int classify_parts(const program *prog, const decomposition *d, classification *result,
+                          error_status *status) {
+    int n = prog->num_vars > 0 ? prog->num_vars : 1;
+    int every = 1, some = 0; // na conjunção: modelo em todas / contramodelo em alguma
+    classification *parts = calloc(d->num_parts, sizeof(classification));
+    int ok = parts != NULL;
+
+    memset(result, 0, sizeof(*result));
+    result->model = calloc(n, 1);
+    result->countermodel = calloc(n, 1);
+    ok = ok && result->model && result->countermodel;
+    if (!ok) set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+
+    for (int p = 0; ok && p < d->num_parts; p++) ok = classify_program(&d->parts[p].prog, &parts[p], status);
+
+    if (ok) {
+        int disjunction = d->op == OP_OR;
+        int witness = -1; // parte que decide a atribuição "alguma"
+
+        for (int p = 0; p < d->num_parts; p++) {
+            int all_side = disjunction ? parts[p].has_countermodel : parts[p].has_model;
+            int some_side = disjunction ? parts[p].has_model : parts[p].has_countermodel;
+            every &= all_side;
+            if (some_side && witness < 0) witness = p;
+        }
+        some = witness >= 0;
+
+        // "todas": cada parte com o seu lado; "alguma": a testemunha com o seu, as outras com qualquer um
+        unsigned char *all_values = disjunction ? result->countermodel : result->model;
+        unsigned char *some_values = disjunction ? result->model : result->countermodel;
+        for (int p = 0; p < d->num_parts; p++) {
+            const classification *c = &parts[p];
+            const unsigned char *all_side = disjunction ? c->countermodel : c->model;
+            const unsigned char *some_side = disjunction ? c->model : c->countermodel;
+            int has_all = disjunction ? c->has_countermodel : c->has_model;
+
+            if (every) place_assignment(&d->parts[p], all_side, all_values);
+            if (some) place_assignment(&d->parts[p], p == witness ? some_side : has_all ? all_side : some_side,
+                                       some_values);
+        }
+
+        result->has_model = disjunction ? some : every;
+        result->has_countermodel = disjunction ? every : some;
+        result->kind = !result->has_model ? CLASS_CONTRADICTION :
+                       !result->has_countermodel ? CLASS_TAUTOLOGY : CLASS_CONTINGENT;
+    }
+
+    for (int p = 0; parts && p < d->num_parts; p++) free_classification(&parts[p]);
+    free(parts);
+    if (!ok) free_classification(result);
+    return ok;
+}
+
+int classify_program(const program *prog, classification *result, error_status *status) {
+    cnf_formula cnf;
+    int root;
+
+    // partes sem variáveis em comum são decididas separadamente
+    if (prog->num_vars > DECOMPOSE_MIN_VARS) {
+        decomposition d;
+        int parts = decompose_program(prog, &d, status);
+        if (parts == 0) return 0;
+        if (parts > 1) {
+            int ok = classify_parts(prog, &d, result, status);
+            free_decomposition(&d);
+            return ok;
+        }
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->model = malloc(prog->num_vars > 0 ? prog->num_vars : 1);
+    result->countermodel = malloc(prog->num_vars > 0 ? prog->num_vars : 1);
+    if (!result->model || !result->countermodel || !tseitin_encode(prog, &cnf, &root)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        free_classification(result);
+        return 0;
+    }
+
+    int sat = solve_with_root(&cnf, root, prog->num_vars, result->model, status);
+    int falsifiable = sat < 0 ? -1 : solve_with_root(&cnf, SAT_NEG(root), prog->num_vars, result->countermodel, status);
+    cnf_free(&cnf);
+
+    if (sat < 0 || falsifiable < 0) {
+        free_classification(result);
+        return 0;
+    }
+
+    result->has_model = sat;
+    result->has_countermodel = falsifiable;
+    if (!sat) {
+        result->kind = CLASS_CONTRADICTION;
+    } else if (!falsifiable) {
+        result->kind = CLASS_TAUTOLOGY;
+    } else {
+        result->kind = CLASS_CONTINGENT;
+    }
+    return 1;
+}
+
+void free_classification(classification *result) {
+    free(result->model);
+    free(result->countermodel);
+    result->model = NULL;
+    result->countermodel = NULL;
+}
+
+const char *formula_class_name(formula_class kind) {
+    switch (kind) {
+        case CLASS_TAUTOLOGY:     return "tautologia";
+        case CLASS_CONTRADICTION: return "contradicao";
+        default:                  return "contingente";
+    }
+}
+
+// imprime uma atribuição no formato "A=V b=F ..."
+static void print_assignment(FILE *out, const program *prog, const unsigned char *values) {
+    for (int j = 0; j < prog->num_vars; j++)
+        fprintf(out, "%s%s=%c", j ? " " : "", prog->var_names[j], values[j] ? 'V' : 'F');
+    fputc('\n', out);
+}
+
+void print_classification(const char *expression, struct result_cache *cache, FILE *out) {
+    error_status status;
+    program prog;
+    classification result;
+
+    if (!out) out = stdout;
+
+    if (!parse_expression(expression, &prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return;
+    }
+    if (!cache_classify(cache, &prog, &result, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        free_program(&prog);
+        return;
+    }
+
+    fprintf(out, "%s: %s\n", expression, formula_class_name(result.kind));
+    if (result.has_model) {
+        fprintf(out, "  satisfeita por:  ");
+        print_assignment(out, &prog, result.model);
+    }
+    if (result.has_countermodel) {
+        fprintf(out, "  falsificada por: ");
+        print_assignment(out, &prog, result.countermodel);
+    }
+
+    free_classification(&result);
+    free_program(&prog);
+}
@@ -0,0 +1,62 @@
+#ifndef CLASSIFY_H
+#define CLASSIFY_H
+
+#include "compile.h" // programa pós-fixo compilado
+
+/// @brief classificação semântica de uma fórmula
+typedef enum formula_class {
+    CLASS_CONTRADICTION, ///< nenhuma atribuição satisfaz a fórmula
+    CLASS_CONTINGENT,    ///< algumas atribuições satisfazem, outras não
+    CLASS_TAUTOLOGY      ///< todas as atribuições satisfazem a fórmula
+} formula_class;
+
+/// @brief resultado da classificação com atribuições de exemplo
+typedef struct {
+    formula_class kind;            ///< classificação da fórmula
+    int has_model;                 ///< 1 se 'model' contém uma atribuição que satisfaz
+    int has_countermodel;          ///< 1 se 'countermodel' contém uma atribuição que falsifica
+    unsigned char *model;          ///< valores por slot que tornam a fórmula verdadeira
+    unsigned char *countermodel;   ///< valores por slot que tornam a fórmula falsa
+} classification;
+
+/**
+ * @brief classifica a fórmula sem enumerar a tabela verdade
+ *
+ * a fórmula é convertida em CNF (Tseitin) e o resolvedor CDCL decide F
+ * (satisfazível?) e ~F (falsificável?). partes sem variáveis em comum
+ * (decompose.h) são classificadas separadamente e as respostas combinadas
+ *
+ * @param prog programa compilado
+ * @param result classificação e atribuições de exemplo (liberar com free_classification)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int classify_program(const program *prog, classification *result, error_status *status);
+
+/**
+ * @brief libera as atribuições de exemplo de uma classificação
+ *
+ * @param result classificação preenchida por classify_program
+ */
+void free_classification(classification *result);
+
+/**
+ * @brief nome da classificação em texto ("tautologia", "contradicao", "contingente")
+ *
+ * @param kind classificação
+ * @return const char* nome legível
+ */
+const char *formula_class_name(formula_class kind);
+
+struct result_cache; // cache persistente de resultados (cache.h)
+
+/**
+ * @brief classifica uma expressão e imprime o resultado com atribuições de exemplo
+ *
+ * @param expression string contendo a expressão lógica
+ * @param cache classificações de execuções anteriores (NULL = sem cache)
+ * @param out destino do relatório (NULL = stdout)
+ */
+void print_classification(const char *expression, struct result_cache *cache, FILE *out);
+
+#endif // CLASSIFY_H
@@ -0,0 +1,238 @@
+#include "compile.h"
+#include "dag.h"
+
+// mesma tabela de precedência usada por evaluate_expression
+static int precedence(char op) {
+    switch (op) {
+        case '~': return  4;
+        case '&': return  3;
+        case '|': return  2;
+        case '-': return  1;
+        case '<': return  0;
+        default:  return -1;
+    }
+}
+
+// converte o caractere interno do operador no código de operação
+static op_code operator_code(char op) {
+    switch (op) {
+        case '~': return OP_NOT;
+        case '&': return OP_AND;
+        case '|': return OP_OR;
+        case '-': return OP_IMPLIES;
+        default:  return OP_IFF;
+    }
+}
+
+#define RUN_STACK_DEPTH 256 // pilha local de run_program; programas mais profundos usam o heap
+
+// ordena os ids pelo nome do símbolo (merge sort de baixo para cima; 'tmp' tem 'count' posições)
+// qsort não recebe contexto, e a compilação roda em várias threads no modo em lote
+static void sort_ids_by_name(int *ids, int *tmp, int count, const symbol *symbols) {
+    for (int width = 1; width < count; width *= 2) {
+        for (int lo = 0; lo < count; lo += 2 * width) {
+            int mid = lo + width < count ? lo + width : count;
+            int hi = lo + 2 * width < count ? lo + 2 * width : count;
+            int i = lo, j = mid, k = lo;
+
+            while (i < mid && j < hi)
+                tmp[k++] = symbols_compare(&symbols[ids[j]], &symbols[ids[i]]) < 0 ? ids[j++] : ids[i++];
+            while (i < mid) tmp[k++] = ids[i++];
+            while (j < hi) tmp[k++] = ids[j++];
+        }
+        memcpy(ids, tmp, sizeof(int) * count);
+    }
+}
+
+// copia os nomes em ordem de slot para um único bloco: ponteiros seguidos dos textos
+static int store_var_names(program *prog, const symbol_table *symbols, const int *ids) {
+    size_t bytes = sizeof(char *) * (prog->num_vars > 0 ? prog->num_vars : 1);
+    for (int j = 0; j < prog->num_vars; j++) bytes += (size_t) symbols->symbols[ids[j]].length + 1;
+
+    prog->var_names = malloc(bytes);
+    if (!prog->var_names) return 0;
+
+    char *text = (char *) (prog->var_names + (prog->num_vars > 0 ? prog->num_vars : 1));
+    for (int j = 0; j < prog->num_vars; j++) {
+        const symbol *sym = &symbols->symbols[ids[j]];
+        memcpy(text, sym->name, sym->length);
+        text[sym->length] = '\0';
+        prog->var_names[j] = text;
+        text += sym->length + 1;
+    }
+    return 1;
+}
+
+// aplica o operador aos nós do topo da pilha de operandos, validando a quantidade disponível
+static int apply_operator(expr_dag *dag, char op, int *operands, int *top, int position, error_status *status) {
+    int needed = (op == '~') ? 1 : 2;
+    int node;
+
+    if (*top + 1 < needed) {
+        set_error(status, ERR_MISSING_OPERAND, position, "Faltam operandos para o operador");
+        return 0;
+    }
+
+    if (op == '~') {
+        node = dag_not(dag, operands[*top]);
+    } else {
+        int b = operands[(*top)--];
+        node = dag_binary(dag, operator_code(op), operands[*top], b);
+    }
+    if (node < 0) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    operands[*top] = node; // consome os operandos e empilha o resultado
+    return 1;
+}
+
+int compile_expression(const token *elements, int size, const symbol_table *symbols, arena *scratch,
+                       program *prog, error_status *status) {
+    return compile_expression_with(elements, size, symbols, scratch, COMPILE_DEFAULT, prog, status);
+}
+
+int compile_expression_with(const token *elements, int size, const symbol_table *symbols, arena *scratch,
+                            int flags, program *prog, error_status *status) {
+    int count = symbols->count;
+    int *slot_of = arena_alloc(scratch, sizeof(int) * (count + 1)); // slot atribuído a cada símbolo
+    int *ids = arena_alloc(scratch, sizeof(int) * (count + 1));     // símbolos na ordem dos slots
+    int *tmp = arena_alloc(scratch, sizeof(int) * (count + 1));
+    char *operators = arena_alloc(scratch, size + 1);                // pilha de operadores do shunting yard
+    int *operands = arena_alloc(scratch, sizeof(int) * (size + 1));  // pilha de nós do grafo
+    expr_dag dag;
+
+    prog->code = NULL;
+    prog->var_names = NULL;
+    prog->length = 0;
+    prog->max_depth = 0;
+    prog->num_temps = 0;
+    prog->num_vars = 0;
+
+    if (!slot_of || !ids || !tmp || !operators || !operands ||
+        !dag_init(&dag, size, (flags & COMPILE_SIMPLIFY) != 0, scratch)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    // atribui os slots na ordem da tabela: ordem lexicográfica dos nomes
+    for (int id = 0; id < count; id++) ids[id] = id;
+    sort_ids_by_name(ids, tmp, count, symbols->symbols);
+    for (int j = 0; j < count; j++) slot_of[ids[j]] = j;
+    prog->num_vars = count;
+
+    if (!store_var_names(prog, symbols, ids)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    int op_top = -1;
+    int top = -1; // topo da pilha de operandos (nós do grafo)
+
+    for (int i = 0; i < size; i++) {
+        if (elements[i].type == PROPOSITION) {
+            int node = dag_load(&dag, slot_of[elements[i].data.prop]);
+            if (node < 0) {
+                set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+                goto fail;
+            }
+            operands[++top] = node;
+        } else if (elements[i].type == OPERATOR) {
+            char op = elements[i].data.operator;
+
+            // negação é prefixa: apenas empilha
+            if (op == '~') {
+                operators[++op_top] = op;
+                continue;
+            }
+
+            // desempilha operadores com maior precedência (ou igual, exceto '->' que associa à direita)
+            while (op_top >= 0 && operators[op_top] != '(' &&
+            (precedence(operators[op_top]) > precedence(op) ||
+            (operators[op_top] != '-' && precedence(operators[op_top]) == precedence(op)))) {
+                if (!apply_operator(&dag, operators[op_top--], operands, &top, i, status)) goto fail;
+            }
+            operators[++op_top] = op;
+        } else if (elements[i].data.parentheses == '(') {
+            operators[++op_top] = '(';
+        } else {
+            while (op_top >= 0 && operators[op_top] != '(') {
+                if (!apply_operator(&dag, operators[op_top--], operands, &top, i, status)) goto fail;
+            }
+
+            if (op_top < 0) {
+                set_error(status, ERR_UNBALANCED_PARENTHESES, i, "Parentese de fechamento sem abertura correspondente");
+                goto fail;
+            }
+            op_top--; // remove o '('
+        }
+    }
+
+    // esvazia a pilha de operadores
+    while (op_top >= 0) {
+        if (operators[op_top] == '(') {
+            set_error(status, ERR_UNBALANCED_PARENTHESES, -1, "Parentese de abertura sem fechamento correspondente");
+            goto fail;
+        }
+        if (!apply_operator(&dag, operators[op_top--], operands, &top, -1, status)) goto fail;
+    }
+
+    // a expressão deve resultar em exatamente um valor
+    if (top != 0) {
+        set_error(status, ERR_INVALID_EXPRESSION, -1, "Expressao desbalanceada - multiplos resultados na pilha");
+        goto fail;
+    }
+
+    // gera o programa a partir do grafo: cada nó distinto é calculado uma vez
+    if (!dag_lower(&dag, operands[0], (flags & COMPILE_SHARE) != 0, scratch, prog)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        goto fail;
+    }
+
+    return 1;
+
+fail:
+    free_program(prog);
+    return 0;
+}
+
+// máquina de pilha: sem precedência nem parênteses, apenas despacho por instrução
+int run_program(const program *prog, const int *values) {
+    int local[RUN_STACK_DEPTH];
+    int frame = prog->max_depth + prog->num_temps;
+    int *stack = frame <= RUN_STACK_DEPTH ? local : malloc(sizeof(int) * frame);
+    int top = -1;
+
+    if (!stack) return -1;
+    int *temps = stack + prog->max_depth; // temporários logo depois da pilha
+    stack[0] = 0;
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        switch (ins->op) {
+            case OP_LOAD:    stack[++top] = values[ins->slot]; break;
+            case OP_NOT:     stack[top] = !stack[top]; break;
+            case OP_AND:     top--; stack[top] = stack[top] && stack[top+1]; break;
+            case OP_OR:      top--; stack[top] = stack[top] || stack[top+1]; break;
+            case OP_IMPLIES: top--; stack[top] = !stack[top] || stack[top+1]; break;
+            case OP_IFF:     top--; stack[top] = stack[top] == stack[top+1]; break;
+            case OP_CONST:   stack[++top] = ins->slot; break;
+            case OP_STORE:   temps[ins->slot] = stack[top]; break;
+            case OP_FETCH:   stack[++top] = temps[ins->slot]; break;
+        }
+    }
+
+    int result = stack[0];
+    if (stack != local) free(stack);
+    return result;
+}
+
+void free_program(program *prog) {
+    free(prog->code);
+    free(prog->var_names);
+    prog->code = NULL;
+    prog->var_names = NULL;
+    prog->length = 0;
+    prog->num_temps = 0;
+}
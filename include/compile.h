@@ -0,0 +1,98 @@
+#ifndef COMPILE_H
+#define COMPILE_H
+
+#include "eval.h" // tipos token, error_status, arena e tabela de símbolos
+
+/// @brief códigos de operação do programa pós-fixo (RPN)
+typedef enum op_code {
+    OP_LOAD,    ///< empilha o valor da variável no slot indicado
+    OP_NOT,     ///< negação do topo da pilha
+    OP_AND,     ///< conjunção dos dois valores do topo
+    OP_OR,      ///< disjunção dos dois valores do topo
+    OP_IMPLIES, ///< implicação (penúltimo -> topo)
+    OP_IFF,     ///< bicondicional (penúltimo <-> topo)
+    OP_CONST,   ///< empilha a constante 'slot' (0 ou 1); só sobra quando a expressão inteira se simplifica
+    OP_STORE,   ///< copia o topo da pilha para o temporário 'slot' (sem desempilhar)
+    OP_FETCH    ///< empilha o temporário 'slot': subexpressão repetida, calculada uma só vez
+} op_code;
+
+/// @brief uma instrução do programa compilado
+typedef struct {
+    op_code op; ///< operação a executar
+    int slot;   ///< slot da variável (OP_LOAD), constante (OP_CONST) ou temporário (OP_STORE/OP_FETCH)
+} instruction;
+
+/// @brief expressão compilada em notação pós-fixa com variáveis já resolvidas
+typedef struct program {
+    instruction *code;       ///< sequência de instruções em ordem pós-fixa
+    int length;              ///< número de instruções
+    int max_depth;           ///< profundidade máxima da pilha durante a execução
+    int num_temps;           ///< temporários das subexpressões compartilhadas (ficam após a pilha)
+    int num_vars;            ///< número de variáveis distintas
+    char **var_names;        ///< nomes das variáveis na ordem da tabela (slot i = var_names[i])
+} program;
+
+/// @brief otimizações de compile_expression_with
+enum compile_flags {
+    COMPILE_SHARE = 1,    ///< calcula cada subexpressão repetida uma só vez (OP_STORE/OP_FETCH)
+    COMPILE_SIMPLIFY = 2, ///< dupla negação, idempotência, absorção e constantes
+    COMPILE_DEFAULT = COMPILE_SHARE | COMPILE_SIMPLIFY
+};
+
+/**
+ * @brief compila os tokens de uma expressão em um programa pós-fixo
+ *
+ * executa o shunting yard uma única vez, com as mesmas regras de precedência
+ * e associatividade de evaluate_expression, e resolve cada proposição para
+ * um slot fixo, na ordem lexicográfica dos nomes (maiúsculas antes de minúsculas)
+ *
+ * a expressão passa por um grafo com compartilhamento de subexpressões
+ * (dag.h) antes de virar programa; equivale a compile_expression_with com
+ * COMPILE_DEFAULT
+ *
+ * @param elements array de tokens da expressão
+ * @param size número de tokens na expressão
+ * @param symbols tabela com os nomes das proposições dos tokens
+ * @param scratch arena para a pilha de operadores e a ordenação dos nomes
+ * @param prog programa de saída (liberar com free_program)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int compile_expression(const token *elements, int size, const symbol_table *symbols, arena *scratch,
+                       program *prog, error_status *status);
+
+/**
+ * @brief como compile_expression, escolhendo as otimizações do grafo
+ *
+ * sem flags o programa é a tradução direta da árvore sintática
+ *
+ * @param elements array de tokens da expressão
+ * @param size número de tokens na expressão
+ * @param symbols tabela com os nomes das proposições dos tokens
+ * @param scratch arena para a pilha de operadores, o grafo e a ordenação dos nomes
+ * @param flags combinação de compile_flags
+ * @param prog programa de saída (liberar com free_program)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int compile_expression_with(const token *elements, int size, const symbol_table *symbols, arena *scratch,
+                            int flags, program *prog, error_status *status);
+
+/**
+ * @brief executa o programa compilado para uma atribuição de valores
+ *
+ * @param prog programa compilado
+ * @param values valores booleanos indexados por slot (0 a num_vars-1)
+ * @return int resultado booleano da expressão (0 = falso, 1 = verdadeiro), ou -1 se
+ *         faltar memória para a pilha de um programa profundo
+ */
+int run_program(const program *prog, const int *values);
+
+/**
+ * @brief libera a memória associada a um programa compilado
+ *
+ * @param prog programa a ser liberado
+ */
+void free_program(program *prog);
+
+#endif // COMPILE_H
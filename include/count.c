@@ -0,0 +1,645 @@
+#include "count.h"
+#include "bitslice.h"
+#include "simd.h"
+#include "parallel.h"
+#include "sat.h"
+#include "decompose.h"
+#include "bdd.h"
+
+#define COUNT_WORDS 64           // palavras avaliadas de uma vez na contagem empacotada
+#define COUNT_CHUNK_WORDS 16384  // palavras por pedaço dividido entre as threads
+#define COUNT_CACHE_BYTES (256u << 20) // limite das contagens guardadas por componente
+#define COUNT_TABLE_MIN 1024     // posições iniciais da tabela de componentes
+#define COUNT_BDD_NODES (1 << 23)     // nós do BDD tentado entre as duas tentativas por componentes
+#define COUNT_QUICK_DECISIONS (1 << 12) // primeira tentativa por componentes, antes do BDD
+#define COUNT_MAX_DECISIONS (1 << 16)   // segunda tentativa, depois do BDD, antes de desistir
+
+// valores de atribuição
+#define VAL_FALSE 0
+#define VAL_TRUE 1
+#define VAL_UNDEF 2
+
+// estado de uma cláusula sob a atribuição atual
+#define CLAUSE_CONFLICT 0
+#define CLAUSE_SATISFIED 1
+#define CLAUSE_UNIT 2
+#define CLAUSE_OPEN 3
+
+// --- contagem empacotada ---
+
+typedef struct {
+    const program *prog;
+    uint64_t blocks;   // palavras de 64 linhas da tabela
+    uint64_t mask;     // linhas válidas de cada palavra (tabelas com menos de 64 linhas)
+    uint64_t *partial; // contagem de cada trabalhador
+    int *failed;       // por trabalhador: 1 = falha de alocação ao avaliar
+} packed_count;
+
+static void count_packed_chunk(void *ctx, int worker, uint64_t chunk) {
+    packed_count *job = ctx;
+    uint64_t first = chunk * COUNT_CHUNK_WORDS;
+    uint64_t end = first + COUNT_CHUNK_WORDS < job->blocks ? first + COUNT_CHUNK_WORDS : job->blocks;
+    uint64_t window[COUNT_WORDS];
+    uint64_t sum = 0;
+
+    for (uint64_t block = first; block < end; block += COUNT_WORDS) {
+        uint64_t n = end - block < COUNT_WORDS ? end - block : COUNT_WORDS;
+        if (!evaluate_blocks(job->prog, block, n, window)) {
+            job->failed[worker] = 1;
+            return;
+        }
+        for (uint64_t w = 0; w < n; w++) sum += (uint64_t) count_word_ones(window[w] & job->mask);
+    }
+    job->partial[worker] += sum;
+}
+
+static int count_packed(const program *prog, int threads, uint64_t *count) {
+    uint64_t rows = 1ULL << prog->num_vars;
+    packed_count job = { prog, (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD,
+                         rows < ROWS_PER_WORD ? (1ULL << rows) - 1 : ~0ULL, NULL, NULL };
+    uint64_t chunks = (job.blocks + COUNT_CHUNK_WORDS - 1) / COUNT_CHUNK_WORDS;
+    uint64_t single = 0;
+    int single_failed = 0, failed = 0;
+    thread_pool *pool = NULL;
+
+    if (threads > 1 && chunks > 1) {
+        pool = thread_pool_create(threads);
+        job.partial = pool ? calloc(thread_pool_size(pool), sizeof(uint64_t)) : NULL;
+        job.failed = job.partial ? calloc(thread_pool_size(pool), sizeof(int)) : NULL;
+        if (!job.failed) {
+            free(job.partial);
+            thread_pool_destroy(pool);
+            return 0;
+        }
+        thread_pool_run(pool, chunks, count_packed_chunk, &job);
+    } else {
+        job.partial = &single;
+        job.failed = &single_failed;
+        for (uint64_t c = 0; c < chunks && !single_failed; c++) count_packed_chunk(&job, 0, c);
+    }
+
+    *count = 0;
+    for (int w = 0; w < (pool ? thread_pool_size(pool) : 1); w++) {
+        *count += job.partial[w];
+        failed |= job.failed[w];
+    }
+
+    if (pool) {
+        free(job.partial);
+        free(job.failed);
+        thread_pool_destroy(pool);
+    }
+    return !failed;
+}
+
+// --- contagem por componentes ---
+
+/*
+ * uma componente é guardada em um vetor de inteiros:
+ *   [número de variáveis, número de cláusulas, variáveis..., cláusulas...]
+ * com as variáveis livres e as cláusulas ainda não satisfeitas que as ligam,
+ * ambas em ordem crescente. como toda cláusula não satisfeita tem apenas
+ * literais falsos fora da componente, esse vetor determina a subfórmula e
+ * serve de chave para a contagem guardada
+ */
+
+typedef struct {
+    uint64_t hash;
+    int *key;      // vetor da componente (NULL = posição vazia)
+    bignum value;  // modelos da componente sobre as suas variáveis
+} component_entry;
+
+typedef struct {
+    const cnf_formula *cnf;
+    int *occ_start;        // cláusulas com o literal l: occ[occ_start[l] .. occ_start[l+1]-1]
+    int *occ;
+    unsigned char *value;  // valor de cada variável (VAL_*)
+    int *trail;            // literais atribuídos, em ordem
+    int trail_size;
+    int *var_mark;         // marca da última busca de componentes que viu a variável
+    int *clause_mark;      // idem para as cláusulas
+    int mark;
+    int *queue;            // fila da busca em largura (variáveis da componente)
+    int *found;            // cláusulas da componente encontradas pela busca
+    int *score;            // ocorrências de cada variável na componente (escolha da decisão)
+
+    component_entry *table; // contagens já calculadas (endereçamento aberto)
+    size_t table_size;      // potência de 2
+    size_t table_used;
+    size_t cache_bytes;     // memória das chaves e contagens guardadas
+
+    long decisions;         // decisões feitas
+    long max_decisions;     // limite de decisões desta contagem
+    int exhausted;          // 1 = a busca parou no limite de decisões
+} counter;
+
+static int lit_value(const counter *c, int lit) {
+    unsigned char v = c->value[SAT_VAR(lit)];
+    if (v == VAL_UNDEF) return VAL_UNDEF;
+    return v ^ (lit & 1);
+}
+
+static const int *clause_lits(const counter *c, int clause, int *size) {
+    *size = c->cnf->starts[clause + 1] - c->cnf->starts[clause];
+    return c->cnf->lits + c->cnf->starts[clause];
+}
+
+// estado da cláusula; em CLAUSE_UNIT, 'unit' recebe o único literal livre
+static int clause_state(const counter *c, int clause, int *unit) {
+    int size, free_lits = 0;
+    const int *lits = clause_lits(c, clause, &size);
+
+    for (int k = 0; k < size; k++) {
+        int v = lit_value(c, lits[k]);
+        if (v == VAL_TRUE) return CLAUSE_SATISFIED;
+        if (v == VAL_UNDEF) {
+            *unit = lits[k];
+            free_lits++;
+        }
+    }
+    return free_lits == 0 ? CLAUSE_CONFLICT : free_lits == 1 ? CLAUSE_UNIT : CLAUSE_OPEN;
+}
+
+static void assign(counter *c, int lit) {
+    c->value[SAT_VAR(lit)] = (unsigned char) !(lit & 1);
+    c->trail[c->trail_size++] = lit;
+}
+
+// propaga as cláusulas unitárias a partir da posição 'head' da trilha; 0 = conflito
+static int propagate(counter *c, int head) {
+    while (head < c->trail_size) {
+        int falsified = SAT_NEG(c->trail[head++]);
+
+        for (int k = c->occ_start[falsified]; k < c->occ_start[falsified + 1]; k++) {
+            int unit;
+            int state = clause_state(c, c->occ[k], &unit);
+            if (state == CLAUSE_CONFLICT) return 0;
+            if (state == CLAUSE_UNIT) assign(c, unit);
+        }
+    }
+    return 1;
+}
+
+// desfaz as atribuições além de 'size'
+static void undo(counter *c, int size) {
+    while (c->trail_size > size) c->value[SAT_VAR(c->trail[--c->trail_size])] = VAL_UNDEF;
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * separa as variáveis ainda livres de 'vars' em componentes ligadas pelas
+ * cláusulas não satisfeitas, gravadas em sequência em 'out'; variáveis sem
+ * nenhuma cláusula não satisfeita não entram em componente e são contadas
+ * em 'free_vars'. retorna o número de componentes
+ */
+static int split_components(counter *c, const int *vars, int nv, int *out, int *free_vars) {
+    int components = 0;
+
+    c->mark++;
+    *free_vars = 0;
+
+    for (int i = 0; i < nv; i++) {
+        int seed = vars[i];
+        if (c->value[seed] != VAL_UNDEF || c->var_mark[seed] == c->mark) continue;
+
+        // busca em largura a partir da semente
+        int head = 0, tail = 0, num_clauses = 0;
+        c->queue[tail++] = seed;
+        c->var_mark[seed] = c->mark;
+
+        while (head < tail) {
+            int var = c->queue[head++];
+            for (int lit = SAT_LIT(var, 0); lit <= SAT_LIT(var, 1); lit++) {
+                for (int k = c->occ_start[lit]; k < c->occ_start[lit + 1]; k++) {
+                    int clause = c->occ[k], size, unit;
+                    if (c->clause_mark[clause] == c->mark) continue;
+                    if (clause_state(c, clause, &unit) == CLAUSE_SATISFIED) continue;
+
+                    c->clause_mark[clause] = c->mark;
+                    c->found[num_clauses++] = clause;
+
+                    const int *lits = clause_lits(c, clause, &size);
+                    for (int j = 0; j < size; j++) {
+                        int other = SAT_VAR(lits[j]);
+                        if (c->value[other] == VAL_UNDEF && c->var_mark[other] != c->mark) {
+                            c->var_mark[other] = c->mark;
+                            c->queue[tail++] = other;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (num_clauses == 0) {
+            (*free_vars)++;
+            continue;
+        }
+
+        out[0] = tail;
+        out[1] = num_clauses;
+        memcpy(out + 2, c->queue, sizeof(int) * tail);
+        memcpy(out + 2 + tail, c->found, sizeof(int) * num_clauses);
+        qsort(out + 2, tail, sizeof(int), compare_ints);
+        qsort(out + 2 + tail, num_clauses, sizeof(int), compare_ints);
+        out += 2 + tail + num_clauses;
+        components++;
+    }
+    return components;
+}
+
+static size_t component_size(const int *comp) {
+    return 2 + (size_t) comp[0] + (size_t) comp[1];
+}
+
+static uint64_t hash_component(const int *comp) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    size_t size = component_size(comp);
+
+    for (size_t i = 0; i < size; i++) {
+        h ^= (uint32_t) comp[i];
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+// posição da componente na tabela (ocupada por ela ou a vazia onde entraria)
+static component_entry *find_component(counter *c, const int *comp, uint64_t hash) {
+    size_t mask = c->table_size - 1;
+
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        component_entry *e = &c->table[i];
+        if (!e->key) return e;
+        if (e->hash == hash && memcmp(e->key, comp, sizeof(int) * component_size(comp)) == 0) return e;
+    }
+}
+
+static int grow_table(counter *c) {
+    size_t old_size = c->table_size;
+    component_entry *old = c->table;
+
+    c->table = calloc(old_size * 2, sizeof(component_entry));
+    if (!c->table) {
+        c->table = old;
+        return 0;
+    }
+    c->table_size = old_size * 2;
+
+    for (size_t i = 0; i < old_size; i++)
+        if (old[i].key) *find_component(c, old[i].key, old[i].hash) = old[i];
+    free(old);
+    return 1;
+}
+
+// guarda a contagem da componente; sem memória ou acima do limite, apenas não guarda
+static void store_component(counter *c, const int *comp, uint64_t hash, const bignum *count) {
+    size_t size = component_size(comp);
+    size_t bytes = sizeof(int) * size + sizeof(uint32_t) * count->size + sizeof(component_entry);
+
+    if (c->cache_bytes + bytes > COUNT_CACHE_BYTES) return;
+    if (2 * (c->table_used + 1) > c->table_size && !grow_table(c)) return;
+
+    component_entry *e = find_component(c, comp, hash);
+    if (e->key) return;
+
+    int *key = malloc(sizeof(int) * size);
+    bignum_init(&e->value);
+    if (!key || !bignum_copy(&e->value, count)) {
+        free(key);
+        bignum_free(&e->value);
+        return;
+    }
+    memcpy(key, comp, sizeof(int) * size);
+    e->key = key;
+    e->hash = hash;
+    c->table_used++;
+    c->cache_bytes += bytes;
+}
+
+// variável de decisão: a que mais aparece nas cláusulas da componente
+static int pick_branch(counter *c, const int *comp) {
+    const int *vars = comp + 2, *clauses = comp + 2 + comp[0];
+    int best = vars[0];
+
+    for (int i = 0; i < comp[1]; i++) {
+        int size;
+        const int *lits = clause_lits(c, clauses[i], &size);
+        for (int j = 0; j < size; j++)
+            if (c->value[SAT_VAR(lits[j])] == VAL_UNDEF) c->score[SAT_VAR(lits[j])]++;
+    }
+    for (int i = 0; i < comp[0]; i++) {
+        if (c->score[vars[i]] > c->score[best]) best = vars[i];
+    }
+    for (int i = 0; i < comp[0]; i++) c->score[vars[i]] = 0;
+    return best;
+}
+
+static int count_component(counter *c, const int *comp, bignum *result);
+
+// produto das contagens em que as variáveis livres de 'vars' se dividem
+static int count_split(counter *c, const int *vars, int nv, int num_clauses, bignum *product) {
+    int *parts = malloc(sizeof(int) * (3 * (size_t) nv + num_clauses + 1));
+    bignum part;
+    int free_vars, ok = parts != NULL;
+
+    bignum_init(&part);
+    if (ok) {
+        int components = split_components(c, vars, nv, parts, &free_vars);
+        ok = bignum_set_u64(product, 1) && bignum_shift_left(product, free_vars);
+
+        const int *comp = parts;
+        for (int k = 0; ok && k < components && product->size > 0; k++) {
+            ok = count_component(c, comp, &part) && bignum_mul(product, &part);
+            comp += component_size(comp);
+        }
+    }
+
+    bignum_free(&part);
+    free(parts);
+    return ok;
+}
+
+// modelos da componente sobre as suas variáveis; 0 em falha de alocação ou no limite de decisões
+static int count_component(counter *c, const int *comp, bignum *result) {
+    uint64_t hash = hash_component(comp);
+    component_entry *known = find_component(c, comp, hash);
+    if (known->key) return bignum_copy(result, &known->value);
+
+    if (++c->decisions > c->max_decisions) {
+        c->exhausted = 1;
+        return 0;
+    }
+
+    int var = pick_branch(c, comp);
+    bignum branch;
+    int ok = bignum_set_u64(result, 0);
+
+    bignum_init(&branch);
+    for (int negated = 0; ok && negated <= 1; negated++) {
+        int mark = c->trail_size;
+        assign(c, SAT_LIT(var, negated));
+        if (propagate(c, mark))
+            ok = count_split(c, comp + 2, comp[0], comp[1], &branch) && bignum_add(result, &branch);
+        undo(c, mark);
+    }
+    bignum_free(&branch);
+
+    if (ok) store_component(c, comp, hash, result);
+    return ok;
+}
+
+static void counter_free(counter *c) {
+    if (c->table) {
+        for (size_t i = 0; i < c->table_size; i++) {
+            if (!c->table[i].key) continue;
+            free(c->table[i].key);
+            bignum_free(&c->table[i].value);
+        }
+    }
+    free(c->table);
+    free(c->occ_start);
+    free(c->occ);
+    free(c->value);
+    free(c->trail);
+    free(c->var_mark);
+    free(c->clause_mark);
+    free(c->queue);
+    free(c->found);
+    free(c->score);
+}
+
+static int counter_init(counter *c, const cnf_formula *cnf) {
+    int n = cnf->num_vars > 0 ? cnf->num_vars : 1;
+
+    memset(c, 0, sizeof(*c));
+    c->cnf = cnf;
+    c->occ_start = calloc(2 * (size_t) n + 1, sizeof(int));
+    c->occ = malloc(sizeof(int) * (cnf->num_lits > 0 ? cnf->num_lits : 1));
+    c->value = malloc(n);
+    c->trail = malloc(sizeof(int) * n);
+    c->var_mark = calloc(n, sizeof(int));
+    c->clause_mark = calloc(cnf->num_clauses > 0 ? cnf->num_clauses : 1, sizeof(int));
+    c->queue = malloc(sizeof(int) * n);
+    c->found = malloc(sizeof(int) * (cnf->num_clauses > 0 ? cnf->num_clauses : 1));
+    c->score = calloc(n, sizeof(int));
+    c->table_size = COUNT_TABLE_MIN;
+    c->table = calloc(c->table_size, sizeof(component_entry));
+    if (!c->occ_start || !c->occ || !c->value || !c->trail || !c->var_mark || !c->clause_mark ||
+        !c->queue || !c->found || !c->score || !c->table) {
+        counter_free(c);
+        return 0;
+    }
+    memset(c->value, VAL_UNDEF, n);
+
+    // listas de ocorrência em um só vetor: conta, acumula e preenche
+    int *cursor = malloc(sizeof(int) * 2 * (size_t) n);
+    if (!cursor) {
+        counter_free(c);
+        return 0;
+    }
+    for (int i = 0; i < cnf->num_lits; i++) c->occ_start[cnf->lits[i] + 1]++;
+    for (int l = 0; l < 2 * n; l++) c->occ_start[l + 1] += c->occ_start[l];
+    memcpy(cursor, c->occ_start, sizeof(int) * 2 * (size_t) n);
+    for (int clause = 0; clause < cnf->num_clauses; clause++)
+        for (int k = cnf->starts[clause]; k < cnf->starts[clause + 1]; k++)
+            c->occ[cursor[cnf->lits[k]]++] = clause;
+    free(cursor);
+    return 1;
+}
+
+// modelos da CNF com a raiz afirmada, sobre todas as suas variáveis;
+// 1 = contada, 0 = falha de alocação, -1 = limite de decisões atingido
+static int count_cnf(const cnf_formula *cnf, int root_lit, long max_decisions, bignum *count) {
+    counter c;
+    int ok = 1, consistent = 1;
+
+    if (!counter_init(&c, cnf)) return 0;
+    c.max_decisions = max_decisions;
+
+    // raiz e constantes (cláusulas unitárias) antes da primeira decisão
+    if (lit_value(&c, root_lit) == VAL_UNDEF) assign(&c, root_lit);
+    for (int clause = 0; consistent && clause < cnf->num_clauses; clause++) {
+        int size;
+        const int *lits = clause_lits(&c, clause, &size);
+        if (size != 1) continue;
+        int v = lit_value(&c, lits[0]);
+        if (v == VAL_FALSE) consistent = 0;
+        else if (v == VAL_UNDEF) assign(&c, lits[0]);
+    }
+    if (lit_value(&c, root_lit) == VAL_FALSE) consistent = 0;
+
+    if (!consistent || !propagate(&c, 0)) {
+        ok = bignum_set_u64(count, 0);
+    } else {
+        int *vars = malloc(sizeof(int) * (cnf->num_vars > 0 ? cnf->num_vars : 1));
+        ok = vars != NULL;
+        if (ok) {
+            for (int v = 0; v < cnf->num_vars; v++) vars[v] = v;
+            ok = count_split(&c, vars, cnf->num_vars, cnf->num_clauses, count);
+        }
+        free(vars);
+    }
+
+    if (!ok && c.exhausted) ok = -1;
+    counter_free(&c);
+    return ok;
+}
+
+// contagem exata pelo BDD na ordem natural; 1 = contada, 0 = falha de alocação,
+// -1 = o diagrama passou de COUNT_BDD_NODES nós
+static int count_bdd(const program *prog, bignum *count) {
+    error_status status;
+    bdd_manager *mgr = bdd_create(prog, NULL, COUNT_BDD_NODES);
+    if (!mgr) return 0;
+
+    int root = bdd_build(mgr, prog, &status);
+    int ok = root >= 0 ? bdd_sat_count_exact(mgr, root, count) : status.code == ERR_NODE_LIMIT ? -1 : 0;
+    bdd_destroy(mgr);
+    return ok;
+}
+
+// combina as contagens das partes: o produto na conjunção; na disjunção,
+// 2^n menos o produto das linhas falsas de cada parte
+static int count_parts(const program *prog, const decomposition *d, int threads, bignum *count,
+                       error_status *status) {
+    bignum part, rows;
+    int ok = 1;
+
+    bignum_init(&part);
+    bignum_init(&rows);
+    ok = bignum_set_u64(count, 1);
+
+    for (int p = 0; ok && p < d->num_parts; p++) {
+        const program *sub = &d->parts[p].prog;
+        if (!count_models(sub, threads, &part, status)) {
+            ok = 0;
+            break;
+        }
+        if (d->op == OP_OR) {
+            ok = bignum_set_u64(&rows, 1) && bignum_shift_left(&rows, sub->num_vars);
+            if (!ok) break;
+            bignum_sub(&rows, &part);
+            ok = bignum_copy(&part, &rows);
+        }
+        ok = ok && bignum_mul(count, &part);
+    }
+    ok = ok && bignum_shift_left(count, d->free_vars);
+
+    if (ok && d->op == OP_OR) {
+        ok = bignum_set_u64(&rows, 1) && bignum_shift_left(&rows, prog->num_vars);
+        if (ok) {
+            bignum_sub(&rows, count);
+            ok = bignum_copy(count, &rows);
+        }
+    }
+    if (!ok && status->code == SUCCESS) set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+
+    bignum_free(&part);
+    bignum_free(&rows);
+    return ok;
+}
+
+int count_models(const program *prog, int threads, bignum *count, error_status *status) {
+    init_error_status(status);
+
+    // partes sem variáveis em comum são contadas separadamente (2^n1 + 2^n2 em vez de 2^(n1+n2))
+    if (prog->num_vars > DECOMPOSE_MIN_VARS) {
+        decomposition d;
+        int parts = decompose_program(prog, &d, status);
+        if (parts == 0) return 0;
+        if (parts > 1) {
+            int ok = count_parts(prog, &d, threads, count, status);
+            free_decomposition(&d);
+            return ok;
+        }
+    }
+
+    if (prog->num_vars <= COUNT_PACKED_VARS) {
+        uint64_t packed;
+        if (count_packed(prog, threads, &packed) && bignum_set_u64(count, packed)) return 1;
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    // as variáveis auxiliares de Tseitin são determinadas pelas originais,
+    // então os modelos da CNF correspondem um a um às linhas verdadeiras
+    cnf_formula cnf;
+    int root;
+    if (!tseitin_encode(prog, &cnf, &root)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    // componentes com poucas decisões (fórmulas em forma de cláusulas e cadeias),
+    // depois o BDD com limite de nós (fórmulas aninhadas), depois componentes de novo
+    int counted = count_cnf(&cnf, root, COUNT_QUICK_DECISIONS, count);
+    if (counted < 0) counted = count_bdd(prog, count);
+    if (counted < 0) counted = count_cnf(&cnf, root, COUNT_MAX_DECISIONS, count);
+    cnf_free(&cnf);
+    if (counted == 0) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+    if (counted > 0) return 1;
+
+    // nem o diagrama nem as componentes couberam nos limites: a tabela ainda
+    // pode ser somada palavra a palavra, em tempo previsível
+    if (prog->num_vars <= COUNT_ENUMERATE_VARS) {
+        uint64_t packed;
+        if (count_packed(prog, threads, &packed) && bignum_set_u64(count, packed)) return 1;
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    char detail[80];
+    snprintf(detail, sizeof(detail), "%d nos de BDD e %d decisoes em %d variaveis", COUNT_BDD_NODES,
+             COUNT_MAX_DECISIONS, prog->num_vars);
+    set_error(status, ERR_SEARCH_LIMIT, -1, detail);
+    return 0;
+}
+
+char *format_model_count(const bignum *count, int num_vars) {
+    bignum total;
+    char *text = NULL;
+
+    bignum_init(&total);
+    if (bignum_set_u64(&total, 1) && bignum_shift_left(&total, num_vars)) {
+        char *ones = bignum_to_string(count);
+        char *rows = bignum_to_string(&total);
+        if (ones && rows && (text = malloc(strlen(ones) + strlen(rows) + 5)))
+            sprintf(text, "%s de %s", ones, rows);
+        free(ones);
+        free(rows);
+    }
+    bignum_free(&total);
+    return text;
+}
+
+void print_model_count(const char *expression, int threads, FILE *out) {
+    error_status status;
+    program prog;
+    bignum count;
+
+    if (!out) out = stdout;
+
+    if (!parse_expression(expression, &prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return;
+    }
+
+    bignum_init(&count);
+    char *text = NULL;
+    if (count_models(&prog, threads, &count, &status) && !(text = format_model_count(&count, prog.num_vars)))
+        set_error(&status, ERR_MEMORY_ALLOCATION, -1, "");
+
+    if (text) fprintf(out, "%s: %s\n", expression, text);
+    else fprintf(stderr, "Erro: %s\n", status.message);
+
+    free(text);
+    bignum_free(&count);
+    free_program(&prog);
+}
@@ -0,0 +1,54 @@
+#ifndef COUNT_H
+#define COUNT_H
+
+#include <stdio.h>
+
+#include "bignum.h"     // contagem de precisão arbitrária
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+#define COUNT_PACKED_VARS 26 ///< até aqui a contagem soma as palavras empacotadas; acima, usa BDD e componentes
+#define COUNT_ENUMERATE_VARS 34 ///< acima de COUNT_PACKED_VARS, até aqui a enumeração ainda é a última saída
+
+/**
+ * @brief número exato de linhas verdadeiras da tabela, sem enumerar as linhas
+ *
+ * uma fórmula que se divide em partes sem variáveis em comum (decompose.h)
+ * tem cada parte contada separadamente. até COUNT_PACKED_VARS variáveis a
+ * tabela é avaliada em palavras de 64 linhas e as palavras são somadas com
+ * popcount, divididas entre 'threads' threads. acima disso a fórmula vai
+ * para CNF (Tseitin) e é contada por um DPLL que separa as variáveis livres
+ * em componentes independentes, multiplica as contagens das componentes e
+ * guarda a contagem de cada componente já vista (chave: variáveis e
+ * cláusulas restantes). o DPLL tem limite de decisões: uma tentativa curta,
+ * depois um BDD com limite de nós e depois uma tentativa longa. se todas
+ * desistirem, a tabela é somada em palavras até COUNT_ENUMERATE_VARS
+ * variáveis; acima disso a contagem falha com ERR_SEARCH_LIMIT
+ *
+ * @param prog programa compilado (qualquer número de variáveis)
+ * @param threads threads da contagem empacotada (1 = serial)
+ * @param count recebe a contagem (inicializado pelo chamador)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int count_models(const program *prog, int threads, bignum *count, error_status *status);
+
+/**
+ * @brief texto "verdadeiras de total" da contagem, com total = 2^num_vars
+ *
+ * @param count contagem de linhas verdadeiras
+ * @param num_vars número de variáveis
+ * @return char* string alocada (liberar com free) ou NULL em falha de alocação
+ */
+char *format_model_count(const bignum *count, int num_vars);
+
+/**
+ * @brief conta as linhas verdadeiras de uma expressão e imprime "expressao: N de M"
+ *
+ * @param expression string contendo a expressão lógica
+ * @param threads threads da contagem empacotada
+ * @param out destino (NULL = stdout)
+ */
+void print_model_count(const char *expression, int threads, FILE *out);
+
+#endif // COUNT_H
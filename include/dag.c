@@ -0,0 +1,237 @@
+#include "dag.h"
+
+#define DAG_CONSTANTS 2 // nós extras para as constantes 0 e 1
+
+// '&', '|' e '<->' não dependem da ordem dos operandos
+static int is_commutative(op_code op) {
+    return op == OP_AND || op == OP_OR || op == OP_IFF;
+}
+
+// hash de (op, a, b); em operações comutativas os operandos entram em ordem crescente
+static unsigned node_hash(op_code op, int a, int b) {
+    if (is_commutative(op) && a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+
+    unsigned h = (unsigned) op * 0x9E3779B1u;
+    h ^= (unsigned) a * 0x85EBCA77u;
+    h = (h << 13) | (h >> 19);
+    h ^= (unsigned) b * 0xC2B2AE3Du;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+static int same_node(const dag_node *n, op_code op, int a, int b) {
+    if (n->op != op) return 0;
+    if (n->a == a && n->b == b) return 1;
+    return is_commutative(op) && n->a == b && n->b == a;
+}
+
+// devolve o nó (op, a, b), criando-o se ainda não existir
+static int intern_node(expr_dag *dag, op_code op, int a, int b) {
+    unsigned h = node_hash(op, a, b);
+    unsigned mask = (unsigned) dag->num_buckets - 1;
+    unsigned i = h & mask;
+
+    for (; dag->buckets[i]; i = (i + 1) & mask) {
+        const dag_node *n = &dag->nodes[dag->buckets[i] - 1];
+        if (n->hash == h && same_node(n, op, a, b)) return dag->buckets[i] - 1;
+    }
+    if (dag->count == dag->capacity) return -1;
+
+    int id = dag->count++;
+    dag->nodes[id].op = op;
+    dag->nodes[id].a = a;
+    dag->nodes[id].b = b;
+    dag->nodes[id].hash = h;
+    dag->buckets[i] = id + 1;
+    return id;
+}
+
+// valor do nó se ele for constante, -1 caso contrário
+static int const_value(const expr_dag *dag, int n) {
+    return dag->nodes[n].op == OP_CONST ? dag->nodes[n].a : -1;
+}
+
+// 1 se um dos nós é a negação do outro
+static int complementary(const expr_dag *dag, int x, int y) {
+    return (dag->nodes[x].op == OP_NOT && dag->nodes[x].a == y) ||
+           (dag->nodes[y].op == OP_NOT && dag->nodes[y].a == x);
+}
+
+// 1 se 'y' é (x op z) ou (z op x)
+static int has_operand(const expr_dag *dag, int y, op_code op, int x) {
+    const dag_node *n = &dag->nodes[y];
+    return n->op == op && (n->a == x || n->b == x);
+}
+
+int dag_init(expr_dag *dag, int capacity, int simplify, arena *store) {
+    dag->capacity = capacity + DAG_CONSTANTS;
+    dag->count = 0;
+    dag->simplify = simplify;
+    dag->num_buckets = 16;
+    while (dag->num_buckets < 2 * dag->capacity) dag->num_buckets *= 2;
+
+    dag->nodes = arena_alloc(store, sizeof(dag_node) * dag->capacity);
+    dag->buckets = arena_alloc(store, sizeof(int) * dag->num_buckets);
+    if (!dag->nodes || !dag->buckets) return 0;
+
+    memset(dag->buckets, 0, sizeof(int) * dag->num_buckets);
+    return 1;
+}
+
+int dag_const(expr_dag *dag, int value) {
+    return intern_node(dag, OP_CONST, value, -1);
+}
+
+int dag_load(expr_dag *dag, int slot) {
+    return intern_node(dag, OP_LOAD, slot, -1);
+}
+
+int dag_not(expr_dag *dag, int a) {
+    if (dag->simplify) {
+        int c = const_value(dag, a);
+        if (c >= 0) return dag_const(dag, !c);
+        if (dag->nodes[a].op == OP_NOT) return dag->nodes[a].a; // ~~x = x
+    }
+    return intern_node(dag, OP_NOT, a, -1);
+}
+
+int dag_binary(expr_dag *dag, op_code op, int a, int b) {
+    if (dag->simplify) {
+        int ca = const_value(dag, a), cb = const_value(dag, b);
+
+        switch (op) {
+            case OP_AND:
+                if (ca == 0 || cb == 0 || complementary(dag, a, b)) return dag_const(dag, 0);
+                if (ca == 1) return b;
+                if (cb == 1 || a == b) return a;
+                if (has_operand(dag, b, OP_OR, a)) return a; // x & (x | y) = x
+                if (has_operand(dag, a, OP_OR, b)) return b;
+                break;
+            case OP_OR:
+                if (ca == 1 || cb == 1 || complementary(dag, a, b)) return dag_const(dag, 1);
+                if (ca == 0) return b;
+                if (cb == 0 || a == b) return a;
+                if (has_operand(dag, b, OP_AND, a)) return a; // x | (x & y) = x
+                if (has_operand(dag, a, OP_AND, b)) return b;
+                break;
+            case OP_IMPLIES:
+                if (ca == 0 || cb == 1 || a == b) return dag_const(dag, 1);
+                if (ca == 1) return b;
+                if (cb == 0) return dag_not(dag, a);
+                break;
+            default: // OP_IFF
+                if (a == b) return dag_const(dag, 1);
+                if (complementary(dag, a, b)) return dag_const(dag, 0);
+                if (ca >= 0) return ca ? b : dag_not(dag, b);
+                if (cb >= 0) return cb ? a : dag_not(dag, a);
+                break;
+        }
+    }
+    return intern_node(dag, op, a, b);
+}
+
+// código em construção: cresce dobrando a capacidade
+typedef struct {
+    program *prog;
+    int capacity;
+    int depth; // profundidade simulada da pilha
+} lower_state;
+
+static int emit(lower_state *st, op_code op, int slot, int depth_change) {
+    program *prog = st->prog;
+
+    if (prog->length == st->capacity) {
+        int capacity = st->capacity ? st->capacity * 2 : 16;
+        instruction *grown = realloc(prog->code, sizeof(instruction) * capacity);
+        if (!grown) return 0;
+        prog->code = grown;
+        st->capacity = capacity;
+    }
+
+    prog->code[prog->length].op = op;
+    prog->code[prog->length].slot = slot;
+    prog->length++;
+
+    st->depth += depth_change;
+    if (st->depth > prog->max_depth) prog->max_depth = st->depth;
+    return 1;
+}
+
+int dag_lower(const expr_dag *dag, int root, int share, arena *scratch, program *prog) {
+    int count = dag->count;
+    int *refs = arena_alloc(scratch, sizeof(int) * count);      // pais alcançáveis de cada nó
+    int *temp_of = arena_alloc(scratch, sizeof(int) * count);   // temporário com o valor do nó (-1 = nenhum)
+    int *free_temps = arena_alloc(scratch, sizeof(int) * count); // temporários liberados para reúso
+    int *frame_node = arena_alloc(scratch, sizeof(int) * (count + 1)); // pilha da travessia
+    int *frame_state = arena_alloc(scratch, sizeof(int) * (count + 1)); // operandos já visitados
+    lower_state st = { prog, 0, 0 };
+    int num_free = 0, sp = 0;
+
+    prog->code = NULL;
+    prog->length = 0;
+    prog->max_depth = 0;
+    prog->num_temps = 0;
+
+    if (!refs || !temp_of || !free_temps || !frame_node || !frame_state) return 0;
+
+    // conta os usos de cada nó a partir da raiz (os operandos têm ids menores)
+    memset(refs, 0, sizeof(int) * count);
+    refs[root] = 1;
+    for (int id = root; id >= 0; id--) {
+        if (!refs[id]) continue;
+        temp_of[id] = -1;
+        const dag_node *n = &dag->nodes[id];
+        if (n->op == OP_LOAD || n->op == OP_CONST) continue;
+        refs[n->a]++;
+        if (n->b >= 0) refs[n->b]++;
+    }
+
+    // travessia pós-ordem: operandos da esquerda para a direita
+    frame_node[sp] = root;
+    frame_state[sp++] = 0;
+    while (sp > 0) {
+        int id = frame_node[sp - 1];
+        const dag_node *n = &dag->nodes[id];
+
+        if (frame_state[sp - 1] == 0) {
+            // folhas são sempre repetidas: carregar custa o mesmo que buscar um temporário
+            if (n->op == OP_LOAD || n->op == OP_CONST) {
+                if (!emit(&st, n->op, n->a, 1)) return 0;
+                sp--;
+                continue;
+            }
+
+            // subexpressão já calculada: lê o temporário e o libera depois do último uso
+            if (share && temp_of[id] >= 0) {
+                if (!emit(&st, OP_FETCH, temp_of[id], 1)) return 0;
+                if (--refs[id] == 1) free_temps[num_free++] = temp_of[id];
+                sp--;
+                continue;
+            }
+        }
+
+        int arity = n->op == OP_NOT ? 1 : 2;
+        if (frame_state[sp - 1] < arity) {
+            int child = frame_state[sp - 1]++ == 0 ? n->a : n->b;
+            frame_node[sp] = child;
+            frame_state[sp++] = 0;
+            continue;
+        }
+
+        if (!emit(&st, n->op, -1, 1 - arity)) return 0;
+        if (share && refs[id] > 1) {
+            int temp = num_free > 0 ? free_temps[--num_free] : prog->num_temps++;
+            if (!emit(&st, OP_STORE, temp, 0)) return 0;
+            temp_of[id] = temp;
+        }
+        sp--;
+    }
+
+    return 1;
+}
@@ -0,0 +1,102 @@
+#ifndef DAG_H
+#define DAG_H
+
+#include "compile.h" // códigos de operação e programa pós-fixo
+
+/// @brief nó do grafo: operação e operandos (ids de nós anteriores)
+typedef struct {
+    op_code op;    ///< OP_LOAD, OP_CONST, OP_NOT ou operação binária
+    int a;         ///< primeiro operando (slot em OP_LOAD, valor 0/1 em OP_CONST)
+    int b;         ///< segundo operando (-1 em folhas e negações)
+    unsigned hash; ///< hash de (op, a, b)
+} dag_node;
+
+/**
+ * @brief expressão como grafo acíclico com compartilhamento total (hash-consing)
+ *
+ * cada subexpressão distinta existe uma única vez: construir de novo um nó
+ * igual (inclusive com os operandos trocados em '&', '|' e '<->') devolve o
+ * nó existente; os operandos têm sempre id menor que o nó que os usa
+ */
+typedef struct {
+    dag_node *nodes; ///< nós em ordem de criação
+    int count;       ///< número de nós
+    int capacity;    ///< capacidade de 'nodes'
+    int *buckets;    ///< id + 1 de cada balde (0 = vazio)
+    int num_buckets; ///< potência de 2, pelo menos o dobro de 'capacity'
+    int simplify;    ///< 1 = aplica as simplificações algébricas ao criar os nós
+} expr_dag;
+
+/**
+ * @brief inicializa um grafo vazio com memória da arena
+ *
+ * cada token da expressão cria no máximo um nó; 'capacity' = número de
+ * tokens basta (as duas constantes são reservadas à parte)
+ *
+ * @param dag grafo a inicializar
+ * @param capacity número máximo de nós
+ * @param simplify 1 para simplificar (dupla negação, idempotência, absorção, constantes)
+ * @param store arena de onde vêm os nós e os baldes
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int dag_init(expr_dag *dag, int capacity, int simplify, arena *store);
+
+/**
+ * @brief nó da constante 0 ou 1
+ *
+ * @param dag grafo
+ * @param value valor da constante
+ * @return int id do nó ou -1 se o grafo estiver cheio
+ */
+int dag_const(expr_dag *dag, int value);
+
+/**
+ * @brief nó da variável do slot
+ *
+ * @param dag grafo
+ * @param slot slot da variável
+ * @return int id do nó ou -1 se o grafo estiver cheio
+ */
+int dag_load(expr_dag *dag, int slot);
+
+/**
+ * @brief nó da negação de 'a' (~~x = x e constantes são resolvidas)
+ *
+ * @param dag grafo
+ * @param a operando
+ * @return int id do nó ou -1 se o grafo estiver cheio
+ */
+int dag_not(expr_dag *dag, int a);
+
+/**
+ * @brief nó de (a op b), já simplificado quando o grafo simplifica
+ *
+ * x & x = x, x & ~x = 0, x & (x | y) = x, x -> x = 1, x <-> ~x = 0 e os
+ * casos com constantes dos quatro operadores
+ *
+ * @param dag grafo
+ * @param op OP_AND, OP_OR, OP_IMPLIES ou OP_IFF
+ * @param a operando esquerdo
+ * @param b operando direito
+ * @return int id do nó ou -1 se o grafo estiver cheio
+ */
+int dag_binary(expr_dag *dag, op_code op, int a, int b);
+
+/**
+ * @brief gera o programa pós-fixo que calcula o nó 'root'
+ *
+ * com 'share', cada nó interno usado mais de uma vez é calculado uma só vez:
+ * o resultado é guardado com OP_STORE e as demais ocorrências viram OP_FETCH;
+ * os temporários são reaproveitados depois da última leitura. sem 'share', a
+ * árvore é expandida como no texto. preenche code, length, max_depth e num_temps
+ *
+ * @param dag grafo
+ * @param root nó a calcular
+ * @param share 1 para compartilhar subexpressões repetidas
+ * @param scratch arena para a pilha da travessia
+ * @param prog programa de saída (o código é alocado com malloc)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int dag_lower(const expr_dag *dag, int root, int share, arena *scratch, program *prog);
+
+#endif // DAG_H
@@ -0,0 +1,379 @@
+#include "decompose.h"
+#include "dag.h"
+#include "simd.h"
+
+// operando da cadeia do topo: nó do grafo e se ele entra negado
+typedef struct {
+    int node;
+    int negated;
+} chain_operand;
+
+// refaz o grafo a partir do programa; -1 se houver constantes ou faltar memória
+static int program_to_dag(const program *prog, expr_dag *dag, arena *scratch) {
+    int *stack = arena_alloc(scratch, sizeof(int) * (prog->max_depth + prog->num_temps + 1));
+    int top = -1;
+
+    if (!stack) return -1;
+    int *temps = stack + prog->max_depth;
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+
+        switch (ins->op) {
+            case OP_LOAD:  stack[++top] = dag_load(dag, ins->slot); break;
+            case OP_NOT:   stack[top] = dag_not(dag, stack[top]); break;
+            case OP_STORE: temps[ins->slot] = stack[top]; continue;
+            case OP_FETCH: stack[++top] = temps[ins->slot]; break;
+            case OP_CONST: return -1; // a fórmula inteira virou constante
+            default: {
+                int b = stack[top--];
+                stack[top] = dag_binary(dag, ins->op, stack[top], b);
+                break;
+            }
+        }
+        if (stack[top] < 0) return -1;
+    }
+    return stack[0];
+}
+
+/*
+ * achata a cadeia de 'chain' (OP_AND ou OP_OR) a partir da raiz. para a
+ * conjunção, a & b, ~(a | b) e ~(a -> b) = a & ~b se abrem em dois operandos;
+ * a disjunção usa as mesmas regras sobre a negação. operandos repetidos
+ * aparecem uma só vez (x & x = x). retorna o número de operandos
+ */
+static int flatten_chain(const expr_dag *dag, int root, op_code chain, chain_operand *work,
+                         unsigned char *seen, chain_operand *out) {
+    int top = 0, count = 0;
+    int flip = chain == OP_OR;
+
+    memset(seen, 0, (size_t) dag->count);
+    work[0].node = root;
+    work[0].negated = 0;
+
+    while (top >= 0) {
+        chain_operand item = work[top--];
+        while (dag->nodes[item.node].op == OP_NOT) {
+            item.node = dag->nodes[item.node].a;
+            item.negated ^= 1;
+        }
+
+        // bit 0: visto sem negação, bit 1: visto negado
+        unsigned char bit = (unsigned char) (1 << item.negated);
+        if (seen[item.node] & bit) continue;
+        seen[item.node] |= bit;
+
+        const dag_node *n = &dag->nodes[item.node];
+        int h = item.negated ^ flip; // negação vista pela regra da conjunção
+        int left = -1, right = -1;   // negação de cada filho, se o nó se abre
+
+        if (!h && n->op == OP_AND) {
+            left = 0; right = 0;
+        } else if (h && n->op == OP_OR) {
+            left = 1; right = 1;
+        } else if (h && n->op == OP_IMPLIES) {
+            left = 0; right = 1;
+        }
+
+        if (left < 0) {
+            out[count++] = item;
+            continue;
+        }
+        // o filho direito entra primeiro na pilha para o esquerdo sair antes
+        work[++top].node = n->b;
+        work[top].negated = right ^ flip;
+        work[++top].node = n->a;
+        work[top].negated = left ^ flip;
+    }
+    return count;
+}
+
+static int find_root(int *parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void join(int *parent, int a, int b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a != b) parent[a < b ? b : a] = a < b ? a : b;
+}
+
+// une os operandos que alcançam o mesmo nó ou a mesma variável
+static int group_operands(const expr_dag *dag, const chain_operand *operands, int count, int num_vars,
+                          int *parent, arena *scratch) {
+    int *owner = arena_alloc(scratch, sizeof(int) * dag->count);
+    int *var_owner = arena_alloc(scratch, sizeof(int) * (num_vars > 0 ? num_vars : 1));
+    int *stack = arena_alloc(scratch, sizeof(int) * (2 * (size_t) dag->count + 1)); // uma entrada por aresta
+
+    if (!owner || !var_owner || !stack) return 0;
+    for (int i = 0; i < dag->count; i++) owner[i] = -1;
+    for (int j = 0; j < num_vars; j++) var_owner[j] = -1;
+    for (int i = 0; i < count; i++) parent[i] = i;
+
+    for (int i = 0; i < count; i++) {
+        int top = -1;
+        stack[++top] = operands[i].node;
+
+        while (top >= 0) {
+            int id = stack[top--];
+
+            // nó já visto: por este operando não há o que fazer; por outro, os dois se unem
+            if (owner[id] >= 0) {
+                join(parent, i, owner[id]);
+                continue;
+            }
+            owner[id] = i;
+
+            const dag_node *n = &dag->nodes[id];
+            if (n->op == OP_LOAD) {
+                if (var_owner[n->a] >= 0) join(parent, i, var_owner[n->a]);
+                else var_owner[n->a] = i;
+            } else if (n->op != OP_CONST) {
+                stack[++top] = n->a;
+                if (n->b >= 0) stack[++top] = n->b;
+            }
+        }
+    }
+    return 1;
+}
+
+// programa da parte: o grafo de 'root' com as variáveis renumeradas em ordem crescente
+static int lower_part(const expr_dag *dag, int root, const program *prog, arena *scratch, formula_part *part) {
+    memset(part, 0, sizeof(*part));
+    if (!dag_lower(dag, root, 1, scratch, &part->prog)) return 0;
+
+    int *local = arena_alloc(scratch, sizeof(int) * (prog->num_vars > 0 ? prog->num_vars : 1));
+    if (!local) return 0;
+    for (int j = 0; j < prog->num_vars; j++) local[j] = -1;
+    for (int k = 0; k < part->prog.length; k++)
+        if (part->prog.code[k].op == OP_LOAD) local[part->prog.code[k].slot] = 0;
+
+    int n = 0;
+    for (int j = 0; j < prog->num_vars; j++) if (local[j] == 0) local[j] = n++;
+
+    part->slots = malloc(sizeof(int) * (n > 0 ? n : 1));
+    part->prog.var_names = malloc(sizeof(char *) * (n > 0 ? n : 1));
+    part->prog.num_vars = n;
+    if (!part->slots || !part->prog.var_names) return 0;
+
+    for (int j = 0; j < prog->num_vars; j++) {
+        if (local[j] < 0) continue;
+        part->slots[local[j]] = j;
+        part->prog.var_names[local[j]] = prog->var_names[j];
+    }
+    for (int k = 0; k < part->prog.length; k++)
+        if (part->prog.code[k].op == OP_LOAD) part->prog.code[k].slot = local[part->prog.code[k].slot];
+    return 1;
+}
+
+int decompose_program(const program *prog, decomposition *d, error_status *status) {
+    arena scratch;
+    expr_dag dag;
+    int result = 0;
+
+    memset(d, 0, sizeof(*d));
+    arena_init(&scratch, 0);
+
+    // nós do programa, negações de De Morgan e as conjunções que remontam as partes
+    int capacity = 4 * prog->length + 4;
+    if (!dag_init(&dag, capacity, 1, &scratch)) goto done;
+
+    // constante (ou sem memória para o grafo): a fórmula fica inteira
+    int root = program_to_dag(prog, &dag, &scratch);
+    if (root < 0) {
+        result = 1;
+        goto done;
+    }
+
+    chain_operand *work = arena_alloc(&scratch, sizeof(chain_operand) * (4 * (size_t) dag.count + 2));
+    chain_operand *operands = arena_alloc(&scratch, sizeof(chain_operand) * (2 * (size_t) dag.count + 1));
+    unsigned char *seen = arena_alloc(&scratch, (size_t) dag.count);
+    int *parent = arena_alloc(&scratch, sizeof(int) * (2 * (size_t) dag.count + 1));
+    if (!work || !operands || !seen || !parent) goto done;
+
+    // cadeia de '&'; se o topo não for uma conjunção, cadeia de '|'
+    d->op = OP_AND;
+    int count = flatten_chain(&dag, root, OP_AND, work, seen, operands);
+    if (count < 2) {
+        d->op = OP_OR;
+        count = flatten_chain(&dag, root, OP_OR, work, seen, operands);
+    }
+    if (count < 2 || !group_operands(&dag, operands, count, prog->num_vars, parent, &scratch)) {
+        result = count < 2 ? 1 : 0;
+        goto done;
+    }
+
+    // cada raiz da união vira uma parte, na ordem do seu primeiro operando
+    int *group = arena_alloc(&scratch, sizeof(int) * count);
+    int *group_root = arena_alloc(&scratch, sizeof(int) * count);
+    if (!group || !group_root) goto done;
+
+    for (int i = 0; i < count; i++) {
+        int r = find_root(parent, i);
+        if (r == i) group[i] = d->num_parts++;
+        else group[i] = group[r];
+    }
+    if (d->num_parts < 2) {
+        d->num_parts = 0;
+        result = 1;
+        goto done;
+    }
+
+    for (int p = 0; p < d->num_parts; p++) group_root[p] = -1;
+    for (int i = 0; i < count; i++) {
+        int node = operands[i].negated ? dag_not(&dag, operands[i].node) : operands[i].node;
+        int *r = &group_root[group[i]];
+        *r = node < 0 ? -1 : *r < 0 ? node : dag_binary(&dag, d->op, *r, node);
+        if (*r < 0) goto done;
+    }
+
+    d->parts = calloc(d->num_parts, sizeof(formula_part));
+    if (!d->parts) goto done;
+
+    int used_vars = 0;
+    for (int p = 0; p < d->num_parts; p++) {
+        if (!lower_part(&dag, group_root[p], prog, &scratch, &d->parts[p])) goto done;
+        used_vars += d->parts[p].prog.num_vars;
+    }
+    d->free_vars = prog->num_vars - used_vars;
+    result = d->num_parts;
+
+done:
+    arena_free(&scratch);
+    if (result == 0) {
+        free_decomposition(d);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+    } else if (result == 1) {
+        free_decomposition(d);
+    }
+    return result;
+}
+
+void free_decomposition(decomposition *d) {
+    for (int p = 0; d->parts && p < d->num_parts; p++) {
+        free_program(&d->parts[p].prog);
+        free(d->parts[p].slots);
+    }
+    free(d->parts);
+    memset(d, 0, sizeof(*d));
+}
+
+// variáveis da parte nos 6 bits baixos do índice da linha: as de maior slot, as últimas da parte
+static int part_low_vars(const program *prog, const formula_part *part) {
+    int n = part->prog.num_vars, low = 0;
+    while (low < n && prog->num_vars - 1 - part->slots[n - 1 - low] < 6) low++;
+    return low;
+}
+
+// tabela da parte 'p' indexada pelas suas variáveis altas
+static int build_part_words(const program *prog, const formula_part *part, part_tables *tables, int p) {
+    int n = part->prog.num_vars, low = part_low_vars(prog, part);
+    int high = n - low;
+    uint64_t bitmap_words = (((uint64_t) 1 << n) + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+
+    tables->num_high[p] = high;
+    tables->num_low[p] = low;
+    tables->high_bits[p] = malloc(sizeof(int) * (high > 0 ? high : 1));
+    uint64_t *bitmap = malloc(sizeof(uint64_t) * bitmap_words);
+    if (!tables->high_bits[p] || !bitmap) {
+        free(bitmap);
+        return 0;
+    }
+    for (int j = 0; j < high; j++) tables->high_bits[p][j] = prog->num_vars - 1 - part->slots[j] - 6;
+
+    // a tabela da parte: bit r = valor na linha r, com as variáveis baixas nos bits baixos de r
+    if (!evaluate_blocks(&part->prog, 0, bitmap_words, bitmap)) {
+        free(bitmap);
+        return 0;
+    }
+
+    // sem variáveis baixas o valor é o mesmo nas 64 linhas do bloco: basta o bitmap
+    if (low == 0) {
+        tables->words[p] = bitmap;
+        return 1;
+    }
+
+    // lanes[c]: linhas do bloco em que as variáveis baixas da parte valem c
+    uint64_t lanes[ROWS_PER_WORD] = {0};
+    for (int k = 0; k < ROWS_PER_WORD; k++) {
+        int c = 0;
+        for (int j = high; j < n; j++)
+            c = c << 1 | ((k >> (prog->num_vars - 1 - part->slots[j])) & 1);
+        lanes[c] |= 1ULL << k;
+    }
+
+    tables->words[p] = malloc(sizeof(uint64_t) * ((size_t) 1 << high));
+    if (!tables->words[p]) {
+        free(bitmap);
+        return 0;
+    }
+
+    int combos = 1 << low;
+    for (uint64_t h = 0; h < ((uint64_t) 1 << high); h++) {
+        uint64_t first = h << low, word = 0;
+        for (int c = 0; c < combos; c++)
+            if ((bitmap[(first + c) / ROWS_PER_WORD] >> ((first + c) % ROWS_PER_WORD)) & 1) word |= lanes[c];
+        tables->words[p][h] = word;
+    }
+
+    free(bitmap);
+    return 1;
+}
+
+int build_part_tables(const program *prog, const decomposition *d, part_tables *tables) {
+    uint64_t bytes = 0;
+
+    memset(tables, 0, sizeof(*tables));
+    for (int p = 0; p < d->num_parts; p++) {
+        int n = d->parts[p].prog.num_vars, low = part_low_vars(prog, &d->parts[p]);
+        if (n > DECOMPOSE_TABLE_VARS) return 0;
+        bytes += (((uint64_t) 1 << n) + 7) / 8;
+        if (low > 0) bytes += sizeof(uint64_t) << (n - low);
+    }
+    if (bytes > DECOMPOSE_TABLE_BYTES) return 0;
+
+    tables->op = d->op;
+    tables->num_parts = d->num_parts;
+    tables->num_high = calloc(d->num_parts, sizeof(int));
+    tables->num_low = calloc(d->num_parts, sizeof(int));
+    tables->high_bits = calloc(d->num_parts, sizeof(int *));
+    tables->words = calloc(d->num_parts, sizeof(uint64_t *));
+    int ok = tables->num_high && tables->num_low && tables->high_bits && tables->words;
+
+    for (int p = 0; ok && p < d->num_parts; p++) ok = build_part_words(prog, &d->parts[p], tables, p);
+    if (!ok) free_part_tables(tables);
+    return ok;
+}
+
+uint64_t part_tables_word(const part_tables *tables, uint64_t block) {
+    uint64_t word = tables->op == OP_AND ? ~0ULL : 0;
+
+    for (int p = 0; p < tables->num_parts; p++) {
+        const int *bits = tables->high_bits[p];
+        uint64_t h = 0;
+        for (int j = 0; j < tables->num_high[p]; j++) h = h << 1 | ((block >> bits[j]) & 1);
+
+        // sem variáveis baixas, words[p] é o bitmap da parte e o bit vale para o bloco inteiro
+        uint64_t part = tables->num_low[p] ? tables->words[p][h] :
+                        0 - ((tables->words[p][h / ROWS_PER_WORD] >> (h % ROWS_PER_WORD)) & 1);
+        if (tables->op == OP_AND) word &= part;
+        else word |= part;
+    }
+    return word;
+}
+
+void free_part_tables(part_tables *tables) {
+    for (int p = 0; p < tables->num_parts; p++) {
+        if (tables->high_bits) free(tables->high_bits[p]);
+        if (tables->words) free(tables->words[p]);
+    }
+    free(tables->num_high);
+    free(tables->num_low);
+    free(tables->high_bits);
+    free(tables->words);
+    memset(tables, 0, sizeof(*tables));
+}
@@ -0,0 +1,90 @@
+#ifndef DECOMPOSE_H
+#define DECOMPOSE_H
+
+#include <stdint.h>
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+#define DECOMPOSE_MIN_VARS 12   ///< abaixo disso a fórmula inteira é mais barata que a divisão
+#define DECOMPOSE_TABLE_VARS 24 ///< maior parte tabelada para gerar a tabela inteira
+#define DECOMPOSE_TABLE_BYTES (64u << 20) ///< limite de memória das tabelas das partes
+
+/// @brief parte da fórmula com variáveis próprias
+typedef struct {
+    program prog; ///< programa da parte: as suas variáveis nos slots 0..prog.num_vars-1, na ordem original
+    int *slots;   ///< slot, no programa original, de cada variável da parte (crescente)
+} formula_part;
+
+/**
+ * @brief fórmula como conjunção ou disjunção de partes sem variáveis em comum
+ *
+ * os nomes das variáveis das partes apontam para os do programa original,
+ * que precisa continuar vivo enquanto a divisão for usada
+ */
+typedef struct {
+    op_code op;          ///< OP_AND ou OP_OR: como os resultados das partes se combinam
+    int num_parts;       ///< número de partes (pelo menos 2)
+    formula_part *parts; ///< partes, em ordem de aparição
+    int free_vars;       ///< variáveis do programa que não aparecem em nenhuma parte
+} decomposition;
+
+/**
+ * @brief procura partes independentes no topo da fórmula
+ *
+ * a fórmula é refeita como grafo e a cadeia de '&' do topo (ou de '|', com
+ * a -> b lido como ~a | b e as negações empurradas por De Morgan) é achatada
+ * em operandos; operandos que compartilham variáveis ou subexpressões ficam
+ * na mesma parte
+ *
+ * @param prog programa compilado
+ * @param d divisão de saída (liberar com free_decomposition quando houver 2 partes ou mais)
+ * @param status recebe o erro de memória
+ * @return int número de partes: 1 = não se divide (nada é alocado), 0 = erro
+ */
+int decompose_program(const program *prog, decomposition *d, error_status *status);
+
+/**
+ * @brief libera os programas e os slots das partes
+ *
+ * @param d divisão preenchida por decompose_program
+ */
+void free_decomposition(decomposition *d);
+
+/// @brief tabela da fórmula montada a partir das tabelas das partes
+typedef struct {
+    op_code op;             ///< combinação das partes
+    int num_parts;          ///< número de partes
+    int *num_high;          ///< variáveis de cada parte fora dos 6 bits baixos do índice da linha
+    int *num_low;           ///< variáveis de cada parte nos 6 bits baixos
+    int **high_bits;        ///< bit do índice do bloco de cada variável alta, da mais significativa à menos
+    uint64_t **words;       ///< por combinação das variáveis altas: palavra de 64 linhas (ou 1 bit, sem variáveis baixas)
+} part_tables;
+
+/**
+ * @brief avalia cada parte uma vez (2^n1 + 2^n2 + ... linhas) para gerar a tabela inteira
+ *
+ * @param prog programa original
+ * @param d divisão do programa
+ * @param tables tabelas de saída (liberar com free_part_tables)
+ * @return int 1 em caso de sucesso, 0 se faltar memória ou alguma parte passar de DECOMPOSE_TABLE_VARS
+ */
+int build_part_tables(const program *prog, const decomposition *d, part_tables *tables);
+
+/**
+ * @brief resultados das linhas block*64 a block*64 + 63, como em evaluate_block
+ *
+ * @param tables tabelas das partes
+ * @param block índice do bloco de 64 linhas
+ * @return uint64_t bit k = resultado da linha block*64 + k
+ */
+uint64_t part_tables_word(const part_tables *tables, uint64_t block);
+
+/**
+ * @brief libera as tabelas das partes
+ *
+ * @param tables tabelas montadas por build_part_tables
+ */
+void free_part_tables(part_tables *tables);
+
+#endif // DECOMPOSE_H
@@ -0,0 +1,259 @@
+#include "equiv.h"
+#include "eval.h"
+#include "bitslice.h"
+#include "simd.h"
+#include "parallel.h"
+#include "classify.h"
+
+#define EQUIV_WORDS 64          // palavras avaliadas de uma vez na busca
+#define EQUIV_CHUNK_WORDS 1024  // palavras por pedaço: pedaços pequenos param logo depois do contraexemplo
+#define EQUIV_NO_ROW UINT64_MAX // nenhum contraexemplo encontrado
+
+// une as variáveis das duas fórmulas (listas já em ordem lexicográfica);
+// map_a e map_b recebem o slot conjunto de cada variável
+static int merge_names(const program *a, const program *b, int *map_a, int *map_b, relation_result *result) {
+    int i = 0, j = 0, n = 0;
+
+    result->var_names = malloc(sizeof(char *) * (a->num_vars + b->num_vars > 0 ? a->num_vars + b->num_vars : 1));
+    if (!result->var_names) return 0;
+
+    while (i < a->num_vars || j < b->num_vars) {
+        int order = i == a->num_vars ? 1 : j == b->num_vars ? -1 : strcmp(a->var_names[i], b->var_names[j]);
+        if (order <= 0) map_a[i] = n;
+        if (order >= 0) map_b[j] = n;
+        result->var_names[n++] = order <= 0 ? a->var_names[i] : b->var_names[j];
+        if (order <= 0) i++;
+        if (order >= 0) j++;
+    }
+    result->num_vars = n;
+    return 1;
+}
+
+// copia o código com as variáveis nos slots conjuntos e os temporários deslocados
+static void append_code(instruction *code, int *length, const program *p, const int *map, int temp_offset) {
+    for (int k = 0; k < p->length; k++) {
+        instruction ins = p->code[k];
+        if (ins.op == OP_LOAD) ins.slot = map[ins.slot];
+        else if (ins.op == OP_STORE || ins.op == OP_FETCH) ins.slot += temp_offset;
+        code[(*length)++] = ins;
+    }
+}
+
+// programa "A <-> B" ou "A -> B" sobre as variáveis conjuntas: falso
+// exatamente nas atribuições que violam a relação
+static int build_joint_program(const program *a, const program *b, relation_kind kind, const int *map_a,
+                               const int *map_b, const relation_result *result, program *joint) {
+    memset(joint, 0, sizeof(*joint));
+    joint->code = malloc(sizeof(instruction) * (a->length + b->length + 1));
+    joint->var_names = malloc(sizeof(char *) * (result->num_vars > 0 ? result->num_vars : 1));
+    if (!joint->code || !joint->var_names) {
+        free_program(joint);
+        return 0;
+    }
+
+    append_code(joint->code, &joint->length, a, map_a, 0);
+    append_code(joint->code, &joint->length, b, map_b, a->num_temps);
+    joint->code[joint->length++] = (instruction) { kind == RELATION_EQUIVALENT ? OP_IFF : OP_IMPLIES, 0 };
+
+    // B é avaliada com o resultado de A ainda na pilha
+    joint->max_depth = a->max_depth > b->max_depth + 1 ? a->max_depth : b->max_depth + 1;
+    joint->num_temps = a->num_temps + b->num_temps;
+    joint->num_vars = result->num_vars;
+    memcpy(joint->var_names, result->var_names, sizeof(char *) * result->num_vars);
+    return 1;
+}
+
+// --- busca empacotada ---
+
+typedef struct {
+    const program *prog;
+    uint64_t blocks;   // palavras de 64 linhas da tabela conjunta
+    uint64_t mask;     // linhas válidas de cada palavra (tabelas com menos de 64 linhas)
+    thread_pool *pool; // NULL = busca serial
+    uint64_t *found;   // por trabalhador: primeira linha falsa encontrada (EQUIV_NO_ROW = nenhuma)
+    int *failed;       // por trabalhador: 1 = falha de alocação ao avaliar
+} relation_search;
+
+static void search_chunk(void *ctx, int worker, uint64_t chunk) {
+    relation_search *job = ctx;
+    uint64_t first = chunk * EQUIV_CHUNK_WORDS;
+    uint64_t end = first + EQUIV_CHUNK_WORDS < job->blocks ? first + EQUIV_CHUNK_WORDS : job->blocks;
+    uint64_t window[EQUIV_WORDS];
+
+    for (uint64_t block = first; block < end; block += EQUIV_WORDS) {
+        uint64_t n = end - block < EQUIV_WORDS ? end - block : EQUIV_WORDS;
+        if (!evaluate_blocks(job->prog, block, n, window)) {
+            // sem resultados não há contraexemplo a relatar: a busca inteira falha
+            job->failed[worker] = 1;
+            if (job->pool) thread_pool_stop(job->pool);
+            return;
+        }
+        for (uint64_t w = 0; w < n; w++) {
+            uint64_t violated = ~window[w] & job->mask;
+            if (!violated) continue;
+
+            uint64_t row = (block + w) * ROWS_PER_WORD + (uint64_t) lowest_set_bit(violated);
+            if (row < job->found[worker]) job->found[worker] = row;
+            if (job->pool) thread_pool_stop(job->pool);
+            return;
+        }
+    }
+}
+
+// primeira linha falsa do programa conjunto, ou EQUIV_NO_ROW
+static int search_packed(const program *joint, int threads, uint64_t *row) {
+    uint64_t rows = 1ULL << joint->num_vars;
+    relation_search job = { joint, (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD,
+                            rows < ROWS_PER_WORD ? (1ULL << rows) - 1 : ~0ULL, NULL, NULL, NULL };
+    uint64_t chunks = (job.blocks + EQUIV_CHUNK_WORDS - 1) / EQUIV_CHUNK_WORDS;
+    uint64_t single = EQUIV_NO_ROW;
+    int single_failed = 0, failed = 0;
+
+    if (threads > 1 && chunks > 1) {
+        job.pool = thread_pool_create(threads);
+        job.found = job.pool ? malloc(sizeof(uint64_t) * thread_pool_size(job.pool)) : NULL;
+        job.failed = job.found ? calloc(thread_pool_size(job.pool), sizeof(int)) : NULL;
+        if (!job.failed) {
+            free(job.found);
+            thread_pool_destroy(job.pool);
+            return 0;
+        }
+        for (int w = 0; w < thread_pool_size(job.pool); w++) job.found[w] = EQUIV_NO_ROW;
+        thread_pool_run(job.pool, chunks, search_chunk, &job);
+    } else {
+        job.found = &single;
+        job.failed = &single_failed;
+        for (uint64_t c = 0; c < chunks && single == EQUIV_NO_ROW && !single_failed; c++) search_chunk(&job, 0, c);
+    }
+
+    *row = EQUIV_NO_ROW;
+    for (int w = 0; w < (job.pool ? thread_pool_size(job.pool) : 1); w++) {
+        if (job.found[w] < *row) *row = job.found[w];
+        failed |= job.failed[w];
+    }
+
+    if (job.pool) {
+        free(job.found);
+        free(job.failed);
+        thread_pool_destroy(job.pool);
+    }
+    return !failed;
+}
+
+int check_relation(const program *a, const program *b, relation_kind kind, int threads, relation_result *result,
+                   error_status *status) {
+    int *map_a = malloc(sizeof(int) * (a->num_vars > 0 ? a->num_vars : 1));
+    int *map_b = malloc(sizeof(int) * (b->num_vars > 0 ? b->num_vars : 1));
+    program joint;
+    int ok = 0;
+
+    init_error_status(status);
+    memset(result, 0, sizeof(*result));
+    if (!map_a || !map_b || !merge_names(a, b, map_a, map_b, result) ||
+        !build_joint_program(a, b, kind, map_a, map_b, result, &joint)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        free(map_a);
+        free(map_b);
+        free_relation_result(result);
+        return 0;
+    }
+
+    int n = result->num_vars;
+    result->counterexample = malloc(n > 0 ? n : 1);
+    if (!result->counterexample) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+    } else if (n <= EQUIV_PACKED_VARS) {
+        uint64_t row;
+        if (!search_packed(&joint, threads, &row)) {
+            set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        } else {
+            result->holds = row == EQUIV_NO_ROW;
+            for (int j = 0; !result->holds && j < n; j++)
+                result->counterexample[j] = (unsigned char) ((row >> (n - 1 - j)) & 1);
+            ok = 1;
+        }
+    } else {
+        classification joint_class;
+        if (classify_program(&joint, &joint_class, status)) {
+            result->holds = !joint_class.has_countermodel;
+            if (!result->holds) memcpy(result->counterexample, joint_class.countermodel, n);
+            free_classification(&joint_class);
+            ok = 1;
+        }
+    }
+
+    // valores de A e B no contraexemplo, cada uma com as suas variáveis
+    if (ok && !result->holds) {
+        int *values = malloc(sizeof(int) * (n > 0 ? n : 1));
+        if (!values) {
+            set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+            ok = 0;
+        } else {
+            for (int j = 0; j < a->num_vars; j++) values[j] = result->counterexample[map_a[j]];
+            result->left_value = run_program(a, values);
+            for (int j = 0; j < b->num_vars; j++) values[j] = result->counterexample[map_b[j]];
+            result->right_value = run_program(b, values);
+            free(values);
+            if (result->left_value < 0 || result->right_value < 0) {
+                set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+                ok = 0;
+            }
+        }
+    }
+
+    if (ok && result->holds) {
+        free(result->counterexample);
+        result->counterexample = NULL;
+    }
+    if (!ok) free_relation_result(result);
+    free_program(&joint);
+    free(map_a);
+    free(map_b);
+    return ok;
+}
+
+void free_relation_result(relation_result *result) {
+    free(result->var_names);
+    free(result->counterexample);
+    memset(result, 0, sizeof(*result));
+}
+
+int print_relation(const char *left, const char *right, relation_kind kind, int threads, FILE *out) {
+    error_status status;
+    program a, b;
+    relation_result result;
+
+    if (!out) out = stdout;
+
+    if (!parse_expression(left, &a, &status)) {
+        fprintf(stderr, "Erro na primeira expressao: %s\n", status.message);
+        return -1;
+    }
+    if (!parse_expression(right, &b, &status)) {
+        fprintf(stderr, "Erro na segunda expressao: %s\n", status.message);
+        free_program(&a);
+        return -1;
+    }
+    if (!check_relation(&a, &b, kind, threads, &result, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        free_program(&a);
+        free_program(&b);
+        return -1;
+    }
+
+    if (kind == RELATION_EQUIVALENT) fprintf(out, "%s\n", result.holds ? "equivalentes" : "nao equivalentes");
+    else fprintf(out, "%s\n", result.holds ? "a primeira implica a segunda" : "a primeira nao implica a segunda");
+
+    if (!result.holds) {
+        fprintf(out, "  contraexemplo: ");
+        for (int j = 0; j < result.num_vars; j++)
+            fprintf(out, "%s%s=%c", j ? " " : "", result.var_names[j], result.counterexample[j] ? 'V' : 'F');
+        fprintf(out, "\n  primeira: %c, segunda: %c\n", result.left_value ? 'V' : 'F', result.right_value ? 'V' : 'F');
+    }
+
+    int holds = result.holds;
+    free_relation_result(&result);
+    free_program(&a);
+    free_program(&b);
+    return holds;
+}
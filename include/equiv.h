@@ -0,0 +1,71 @@
+#ifndef EQUIV_H
+#define EQUIV_H
+
+#include <stdio.h>
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+#define EQUIV_PACKED_VARS 26 ///< até aqui a busca avalia a tabela conjunta em palavras; acima, usa o CDCL
+
+/// @brief relação verificada entre duas fórmulas
+typedef enum relation_kind {
+    RELATION_EQUIVALENT, ///< A e B têm o mesmo valor em toda atribuição
+    RELATION_IMPLIES     ///< B é verdadeira em toda atribuição que torna A verdadeira
+} relation_kind;
+
+/// @brief resultado da verificação, com o contraexemplo quando a relação não vale
+typedef struct {
+    int holds;                     ///< 1 se a relação vale em todas as atribuições
+    int num_vars;                  ///< variáveis das duas fórmulas juntas
+    char **var_names;              ///< nomes na ordem da tabela conjunta (apontam para os nomes dos programas)
+    unsigned char *counterexample; ///< valores por slot que violam a relação (NULL se 'holds')
+    int left_value;                ///< valor de A no contraexemplo
+    int right_value;               ///< valor de B no contraexemplo
+} relation_result;
+
+/**
+ * @brief verifica se A e B são equivalentes, ou se A implica B
+ *
+ * as variáveis das duas fórmulas são unidas (ordem lexicográfica, como na
+ * tabela) e as duas entram num só programa, "A <-> B" ou "A -> B", falso
+ * exatamente nas atribuições que violam a relação. até EQUIV_PACKED_VARS
+ * variáveis esse programa é avaliado em palavras de 64 linhas, em pedaços
+ * divididos entre 'threads' threads, e o primeiro contraexemplo encontrado
+ * descarta os pedaços restantes. acima disso o CDCL procura a atribuição que
+ * falsifica o programa (classify_program)
+ *
+ * com uma thread o contraexemplo é o da primeira linha da tabela conjunta;
+ * com várias, o da primeira linha dentre os pedaços já avaliados
+ *
+ * @param a programa da primeira fórmula
+ * @param b programa da segunda fórmula
+ * @param kind relação a verificar
+ * @param threads threads da busca empacotada (1 = serial)
+ * @param result resultado (liberar com free_relation_result; os nomes valem enquanto 'a' e 'b' existirem)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int check_relation(const program *a, const program *b, relation_kind kind, int threads, relation_result *result,
+                   error_status *status);
+
+/**
+ * @brief libera os nomes e o contraexemplo de um resultado
+ *
+ * @param result resultado preenchido por check_relation
+ */
+void free_relation_result(relation_result *result);
+
+/**
+ * @brief verifica a relação entre duas expressões e imprime o resultado com o contraexemplo
+ *
+ * @param left primeira expressão
+ * @param right segunda expressão
+ * @param kind relação a verificar
+ * @param threads threads da busca empacotada
+ * @param out destino do relatório (NULL = stdout)
+ * @return int 1 se a relação vale, 0 se não vale, -1 em caso de erro (impresso em stderr)
+ */
+int print_relation(const char *left, const char *right, relation_kind kind, int threads, FILE *out);
+
+#endif // EQUIV_H
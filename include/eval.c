@@ -1,4 +1,21 @@
 #include "eval.h"
+#include "compile.h"
+#include "simd.h"
+#include "parallel.h"
+#include "output.h"
+#include "gray.h"
+#include "bdd.h"
+#include "jit.h"
+#include "tablefile.h"
+#include "cache.h"
+#include "decompose.h"
+#include "partial.h"
+#include "stats.h"
+
+#define TABLE_WINDOW_BITS 12  // bits baixos do índice da linha percorridos por janela
+#define TABLE_WINDOW_WORDS 64 // blocos de 64 linhas avaliados de uma vez (2^12 = 4096 linhas)
+#define TABLE_CHUNK_ROWS (TABLE_WINDOW_WORDS * ROWS_PER_WORD) // linhas por pedaço paralelo
+#define TABLE_CHUNKS_PER_THREAD 4 // pedaços por thread em cada rodada (margem para roubo)
 
 // função que determina a precedência dos operadores lógicos
 // retorna um valor numérico que representa a prioridade do operador
@@ -27,93 +44,181 @@ static int apply_operator(int a, int b, char op) {
     }
 }
 
+// classes de caractere do analisador léxico
+enum {
+    CX, // caractere inválido
+    CE, // fim da expressão ('\0')
+    CS, // espaço em branco
+    CL, // letra: começa um identificador
+    CD, // dígito ou '_': só continua um identificador
+    CN, // '~'
+    CB, // '&' ou '|'
+    CO, // '('
+    CC, // ')'
+    CM, // '-' (início de '->')
+    CT  // '<' (início de '<->')
+};
+
+// classe de cada byte; uma consulta por caractere substitui isspace/isalpha/strchr
+static const unsigned char char_class[256] = {
+    CE, CX, CX, CX, CX, CX, CX, CX, CX, CS, CS, CS, CS, CS, CX, CX, // 0x00
+    CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, CX, // 0x10
+    CS, CX, CX, CX, CX, CX, CB, CX, CO, CC, CX, CX, CX, CM, CX, CX, // 0x20
+    CD, CD, CD, CD, CD, CD, CD, CD, CD, CD, CX, CX, CT, CX, CX, CX, // 0x30
+    CX, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, // 0x40
+    CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CX, CX, CX, CX, CD, // 0x50
+    CX, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, // 0x60
+    CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CL, CX, CB, CX, CN, CX, // 0x70
+    // 0x80 a 0xff: inválidos (zero)
+};
+
 // função que lê uma expressão lógica e a converte em tokens
-// armazena os tokens no array 'elements' e atualiza o tamanho em 'size'
-// verifica sintaxe básica e reporta erros via 'status'
-void read_expression(const char *expression, token *elements, int *size, error_status *status) {
-    int index = 0, len = strlen(expression);
+// uma única passada faz a análise léxica e todas as verificações de validate_expression;
+// os erros são registrados pela ordem de prioridade original:
+//   1. parênteses desbalanceados, 2. operadores '&'/'|' mal posicionados, 3. erros léxicos
+void read_expression(const char *expression, token *elements, int *size, symbol_table *symbols, error_status *status) {
+    const unsigned char *s = (const unsigned char *) expression;
+    int index = 0, depth = 0, i;
     char prev_type = 0; // rastreia o tipo do elemento anterior para verificação de sintaxe
-    
-    for (int i = 0; i < len; i++) {
-        if (isspace(expression[i])) continue; // ignora espaços em branco
-        
-        token elem; // token atual sendo processado
-        
-        if (isalpha(expression[i])) {
-            // letras são interpretadas como proposições
-            elem.type = PROPOSITION;
-            elem.data.prop = expression[i];
-            prev_type = 'p'; // marca que o último elemento foi uma proposição
-        } else if (expression[i] == '~') {
-            // operador de negação
-            elem.type = OPERATOR;
-            elem.data.operator = expression[i];
-            prev_type = 'o'; // marca que o último elemento foi um operador
-        } else if (strchr("&|", expression[i])) {
-            // operadores AND e OR
-
-            // verificação de sintaxe: operador binário precisa de operando à esquerda
-            if (prev_type != 'p' && prev_type != ')') {
-                set_error(status, ERR_MISSING_OPERAND, i, "Operador binario sem operando a esquerda");
-                return;
-            }
-            elem.type = OPERATOR;
-            elem.data.operator = expression[i];
-            prev_type = 'o'; // marca que o último elemento foi um operador
-        } else if (expression[i] == '(') {
-            // parêntese de abertura
-            elem.type = PARENTHESES;
-            elem.data.parentheses = expression[i];
-            prev_type = '('; // marca que o último elemento foi um parêntese de abertura
-        } else if (expression[i] == ')') {
-            // parêntese de fechamento
-            elem.type = PARENTHESES;
-            elem.data.parentheses = expression[i];
-            prev_type = ')'; // marca que o último elemento foi um parêntese de fechamento
-        } else if (expression[i] == '-' && i+1 < len && expression[i+1] == '>') {
-            // operador de implicação (->)
-
-            // verificação de sintaxe: operador binário precisa de operando à esquerda
-            if (prev_type != 'p' && prev_type != ')') {
-                set_error(status, ERR_MISSING_OPERAND, i, "Operador '->' sem operando a esquerda");
-                return;
-            }
-            elem.type = OPERATOR;
-            elem.data.operator = '-'; // usa '-' como representação interna de '->'
-            i++; // avança um caractere adicional para pular o '>'
-            prev_type = 'o'; // marca que o último elemento foi um operador
-        } else if (expression[i] == '<' && i+2 < len && expression[i+1] == '-' && expression[i+2] == '>') {
-            // operador de bicondicional (<->)
-
-            // verificação de sintaxe: operador binário precisa de operando à esquerda
-            if (prev_type != 'p' && prev_type != ')') {
-                set_error(status, ERR_MISSING_OPERAND, i, "Operador '<->' sem operando a esquerda");
-                return;
-            }
-            elem.type = OPERATOR;
-            elem.data.operator = '<'; // usa '<' como representação interna de '<->'
-            i += 2; // avança dois caracteres adicionais para pular o '->'
-            prev_type = 'o'; // marca que o último elemento foi um operador
-        } else {
-            // caractere inválido encontrado
-            char err_detail[50];
-            sprintf(err_detail, "Encontrado '%c'", expression[i]);
-            set_error(status, ERR_INVALID_SYMBOL, i, err_detail);
+    error_status operator_error; // primeiro operador binário sem vizinho válido
+    error_status lexical_error;  // primeiro erro léxico (interrompe a geração de tokens)
+    int has_operator_error = 0, has_lexical_error = 0;
+
+    if (!expression || !*expression) {
+        set_error(status, ERR_EMPTY_EXPRESSION, 0, "");
+        return;
+    }
+
+    for (i = 0; ; i++) {
+        int cls = char_class[s[i]];
+        if (cls == CE) break;
+        if (cls == CS) continue; // ignora espaços em branco
+
+        // verificações puramente de caractere, feitas mesmo depois de um erro léxico
+        if (cls == CO) {
+            depth++;
+        } else if (cls == CC && --depth < 0) {
+            // prioridade máxima: nenhum erro anterior pode prevalecer
+            set_error(status, ERR_UNBALANCED_PARENTHESES, i, "Parentese de fechamento sem abertura correspondente");
             return;
+        } else if (cls == CB && !has_operator_error) {
+            if (i == 0 || s[i+1] == '\0') {
+                // operador binário no início ou fim da expressão
+                set_error(&operator_error, ERR_MISSING_OPERAND, i, "Operador binario sem operandos suficientes");
+                has_operator_error = 1;
+            } else if (char_class[s[i-1]] == CB || char_class[s[i+1]] == CB) {
+                // operadores binários consecutivos
+                char err_msg[50];
+                sprintf(err_msg, "Operadores '%c' e '%c' consecutivos", s[i-1], s[i+1]);
+                set_error(&operator_error, ERR_CONSECUTIVE_OPERATORS, i, err_msg);
+                has_operator_error = 1;
+            }
         }
-        
-        elements[index++] = elem; // adiciona o token ao array
-        
-        // verifica se a expressão não é muito longa
-        if (index >= MAX_EXPR) {
-            set_error(status, ERR_EXPRESSION_TOO_LONG, i, "");
-            return;
+
+        // depois do primeiro erro os tokens não importam mais: só os parênteses são acompanhados
+        if (has_lexical_error || has_operator_error) continue;
+
+        token elem; // token atual sendo processado
+
+        switch (cls) {
+            case CL: {
+                // identificadores (letra seguida de letras, dígitos ou '_') são proposições
+                int start = i;
+                while (char_class[s[i+1]] == CL || char_class[s[i+1]] == CD) i++;
+
+                elem.type = PROPOSITION;
+                elem.data.prop = 0;
+                if (elements) {
+                    elem.data.prop = symbols_intern(symbols, expression + start, i - start + 1);
+                    if (elem.data.prop < 0) {
+                        set_error(status, ERR_MEMORY_ALLOCATION, start, "");
+                        return;
+                    }
+                }
+                prev_type = 'p'; // marca que o último elemento foi uma proposição
+                break;
+            }
+            case CN:
+                // operador de negação
+                elem.type = OPERATOR;
+                elem.data.operator = '~';
+                prev_type = '~'; // marca que o último elemento foi uma negação
+                break;
+            case CB:
+                // operadores AND e OR
+
+                // verificação de sintaxe: operador binário precisa de operando à esquerda
+                if (prev_type != 'p' && prev_type != ')') {
+                    set_error(&lexical_error, ERR_MISSING_OPERAND, i, "Operador binario sem operando a esquerda");
+                    has_lexical_error = 1;
+                    continue;
+                }
+                elem.type = OPERATOR;
+                elem.data.operator = (char) s[i];
+                prev_type = 'o'; // marca que o último elemento foi um operador binário
+                break;
+            case CO:
+            case CC:
+                // parênteses de abertura e fechamento
+                elem.type = PARENTHESES;
+                elem.data.parentheses = (char) s[i];
+                prev_type = (char) s[i];
+                break;
+            default:
+                if (cls == CM && s[i+1] == '>') {
+                    // operador de implicação (->)
+
+                    // verificação de sintaxe: operador binário precisa de operando à esquerda
+                    if (prev_type != 'p' && prev_type != ')') {
+                        set_error(&lexical_error, ERR_MISSING_OPERAND, i, "Operador '->' sem operando a esquerda");
+                        has_lexical_error = 1;
+                        continue;
+                    }
+                    elem.type = OPERATOR;
+                    elem.data.operator = '-'; // usa '-' como representação interna de '->'
+                    i++; // avança um caractere adicional para pular o '>'
+                    prev_type = 'o';
+                } else if (cls == CT && s[i+1] == '-' && s[i+2] == '>') {
+                    // operador de bicondicional (<->)
+
+                    // verificação de sintaxe: operador binário precisa de operando à esquerda
+                    if (prev_type != 'p' && prev_type != ')') {
+                        set_error(&lexical_error, ERR_MISSING_OPERAND, i, "Operador '<->' sem operando a esquerda");
+                        has_lexical_error = 1;
+                        continue;
+                    }
+                    elem.type = OPERATOR;
+                    elem.data.operator = '<'; // usa '<' como representação interna de '<->'
+                    i += 2; // avança dois caracteres adicionais para pular o '->'
+                    prev_type = 'o';
+                } else {
+                    // caractere inválido encontrado
+                    char err_detail[50];
+                    sprintf(err_detail, "Encontrado '%c'", s[i]);
+                    set_error(&lexical_error, ERR_INVALID_SYMBOL, i, err_detail);
+                    has_lexical_error = 1;
+                    continue;
+                }
+                break;
         }
+
+        if (elements) elements[index] = elem; // adiciona o token ao array
+        index++;
     }
-    
+
+    // i é o comprimento da expressão: os erros são emitidos pela ordem de prioridade
+    if (depth > 0) {
+        set_error(status, ERR_UNBALANCED_PARENTHESES, i-1, "Parentese de abertura sem fechamento correspondente");
+        return;
+    }
+    if (has_operator_error || has_lexical_error) {
+        *status = has_operator_error ? operator_error : lexical_error;
+        return;
+    }
+
     // verificação final: expressão não pode terminar com operador binário
-    if (index > 0 && elements[index-1].type == OPERATOR && elements[index-1].data.operator != '~') {
-        set_error(status, ERR_MISSING_OPERAND, len-1, "Operador binario sem operando a direita");
+    if (prev_type == 'o') {
+        set_error(status, ERR_MISSING_OPERAND, i-1, "Operador binario sem operando a direita");
         return;
     }
     
@@ -122,29 +227,23 @@ void read_expression(const char *expression, token *elements, int *size, error_s
 
 // função que avalia uma expressão lógica usando o algoritmo shunting yard
 // recebe tokens, valores das proposições e retorna o resultado da avaliação
-int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_status *status) {
-    int stack[MAX_EXPR], top = -1; // pilha de valores e seu topo
-    char operators[MAX_EXPR]; // pilha de operadores
+int evaluate_expression(const token *elements, int size, const int *values, arena *scratch, error_status *status) {
+    arena_mark mark = arena_save(scratch); // as pilhas são devolvidas à arena no final
+    int *stack = arena_alloc(scratch, sizeof(int) * (size > 0 ? size : 1)); // pilha de valores
+    char *operators = arena_alloc(scratch, size > 0 ? size : 1); // pilha de operadores
+    int top = -1; // topo da pilha de valores
     int op_top = -1; // topo da pilha de operadores
+    int result = 0;
+
+    if (!stack || !operators) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        goto done;
+    }
 
     for (int i = 0; i < size; i++) {
         if (elements[i].type == PROPOSITION) {
-            // se for uma proposição, empilha seu valor
-            int idx;
-
-            // calcula o índice no array de valores
-            if (isupper(elements[i].data.prop)) {
-                idx = elements[i].data.prop - 'A'; // letras maiúsculas: A=0, B=1, ...
-            } else {
-                idx = elements[i].data.prop - 'a' + 26; // letras minúsculas: a=26, b=27, ...
-            }
-
-            // verifica se o índice é válido
-            if (idx < 0 || idx >= MAX_VARS) {
-                set_error(status, ERR_INVALID_SYMBOL, i, "Proposicao fora do intervalo valido");
-                return 0;
-            }
-            stack[++top] = values[idx]; // empilha o valor da proposição
+            // se for uma proposição, empilha seu valor (indexado pelo id do símbolo)
+            stack[++top] = values[elements[i].data.prop];
         } else if (elements[i].type == OPERATOR) {
             char op = elements[i].data.operator;
             
@@ -166,7 +265,7 @@ int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_s
                     // operador binário
                     if (top < 0) {
                         set_error(status, ERR_MISSING_OPERAND, i, "Faltam operandos para o operador");
-                        return 0;
+                        goto done;
                     }
                     int a = stack[top--]; // operando esquerdo
                     stack[++top] = apply_operator(a, b, operators[op_top]); // aplica o operador e empilha resultado
@@ -188,7 +287,7 @@ int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_s
                     // operador binário
                     if (top < 0) {
                         set_error(status, ERR_MISSING_OPERAND, i, "Faltam operandos para o operador");
-                        return 0;
+                        goto done;
                     }
                     int a = stack[top--]; // operando esquerdo
                     stack[++top] = apply_operator(a, b, operators[op_top]); // aplica o operador e empilha resultado
@@ -199,7 +298,7 @@ int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_s
             // verifica se foi encontrado o parêntese de abertura correspondente
             if (op_top < 0 || operators[op_top] != '(') {
                 set_error(status, ERR_UNBALANCED_PARENTHESES, i, "Parentese de fechamento sem abertura correspondente");
-                return 0;
+                goto done;
             }
             
             op_top--; // remove o parêntese de abertura da pilha
@@ -216,7 +315,7 @@ int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_s
             // operador binário
             if (top < 0) {
                 set_error(status, ERR_MISSING_OPERAND, -1, "Faltam operandos para o operador");
-                return 0;
+                goto done;
             }
             int a = stack[top--]; // operando esquerdo
             stack[++top] = apply_operator(a, b, operators[op_top]); // aplica o operador e empilha resultado
@@ -227,127 +326,506 @@ int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_s
     // verifica se há exatamente um valor na pilha (resultado final)
     if (top != 0) {
         set_error(status, ERR_INVALID_EXPRESSION, -1, "Expressao desbalanceada - multiplos resultados na pilha");
-        return 0;
+        goto done;
     }
 
-    return stack[top]; // retorna o resultado final
+    result = stack[top]; // resultado final
+
+done:
+    arena_rewind(scratch, mark);
+    return result;
 }
 
-// função que gera uma tabela verdade para uma expressão lógica
-// reverse_order controla se a tabela é gerada em ordem normal ou invertida
-void generate_truth_table(const char *expression, int reverse_order) {
-    token elements[MAX_EXPR]; // array para armazenar os tokens
+int parse_expression_with(const char *expression, arena *scratch, program *prog, error_status *status) {
+    symbol_table symbols; // nomes das proposições, internados na arena
     int size = 0; // tamanho da expressão em tokens
-    error_status status; // status de erro
-    
-    init_error_status(&status); // inicializa o status de erro
-    
-    // valida a expressão antes de processar
-    if (!validate_expression(expression, &status)) {
-        fprintf(stderr, "Erro: %s\n", status.message);
-        return;
-    }
-    
-    // converte a expressão em tokens
-    read_expression(expression, elements, &size, &status);
-    if (status.code != SUCCESS) {
-        fprintf(stderr, "Erro: %s\n", status.message);
-        return;
+
+    init_error_status(status);
+    arena_reset(scratch);
+
+    // cada token ocupa ao menos um caractere: strlen(expression) tokens bastam
+    token *elements = arena_alloc(scratch, sizeof(token) * (expression ? strlen(expression) + 1 : 1));
+    if (!elements) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
     }
-    
+
+    // valida e converte a expressão em tokens em uma só passada
+    STATS_BEGIN(reading);
+    symbols_init(&symbols, scratch);
+    read_expression(expression, elements, &size, &symbols, status);
+    STATS_END(STATS_READ, reading);
+    if (status->code != SUCCESS) return 0;
+
     // verifica se a expressão não está vazia
     if (size == 0) {
-        fprintf(stderr, "Erro: Expressao vazia apos processamento\n");
+        set_error(status, ERR_EMPTY_EXPRESSION, 0, "");
+        return 0;
+    }
+
+    // compila a expressão uma única vez em um programa pós-fixo
+    STATS_BEGIN(compiling);
+    int compiled = compile_expression(elements, size, &symbols, scratch, prog, status);
+    STATS_END(STATS_COMPILE, compiling);
+    if (!compiled) return 0;
+
+    // verifica se existem proposições na expressão
+    if (prog->num_vars == 0) {
+        set_error(status, ERR_INVALID_EXPRESSION, -1, "Nenhuma proposicao valida encontrada na expressao");
+        free_program(prog);
+        return 0;
+    }
+
+    return 1;
+}
+
+int parse_expression(const char *expression, program *prog, error_status *status) {
+    arena scratch;
+
+    arena_init(&scratch, 0);
+    int ok = parse_expression_with(expression, &scratch, prog, status);
+    arena_free(&scratch);
+    return ok;
+}
+
+// largura das colunas de variáveis: " nome |" por variável
+static size_t table_columns_width(const program *prog) {
+    size_t width = 0;
+    for (int j = 0; j < prog->num_vars; j++) width += strlen(prog->var_names[j]) + 3;
+    return width;
+}
+
+// tamanho em bytes de uma linha da tabela (colunas e resultado " V\n")
+static size_t table_row_length(const program *prog) {
+    return table_columns_width(prog) + 3;
+}
+
+// tamanho em bytes do cabeçalho da tabela (nomes, expressão e separador)
+static size_t table_header_length(const program *prog, const char *expression) {
+    size_t expr_len = strlen(expression);
+    return (table_columns_width(prog) + expr_len + 2) * 2 + 1;
+}
+
+// estado privado de cada trabalhador durante a geração das linhas
+typedef struct {
+    row_template tmpl; // modelo de linha reutilizado entre as linhas
+    table_engine engine;    // como as janelas de resultados são calculadas
+    expr_tree tree;         // árvore com valores por nó (TABLE_ENGINE_GRAY)
+    const bdd_manager *bdd; // diagrama compartilhado, apenas leitura (TABLE_ENGINE_BDD)
+    int bdd_root;
+    const jit_code *jit;    // código nativo compartilhado (TABLE_ENGINE_JIT)
+    uint64_t *jit_frame;    // área de trabalho própria do código nativo
+    const cached_table *cached; // resultados lidos do cache (substitui o motor)
+    const part_tables *parts;   // tabelas das partes independentes (substitui o motor)
+    int failed;                 // 1 = uma janela não pôde ser avaliada (falha de alocação)
+} table_worker;
+
+// avalia a janela de índice 'window_index' (TABLE_WINDOW_WORDS blocos alinhados)
+static void evaluate_window(const program *prog, table_worker *worker, long long rows,
+                            uint64_t window_index, uint64_t *window) {
+    uint64_t total_blocks = ((uint64_t) rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    uint64_t first = window_index * TABLE_WINDOW_WORDS;
+    uint64_t count = total_blocks - first < TABLE_WINDOW_WORDS ? total_blocks - first : TABLE_WINDOW_WORDS;
+
+    // o motor empacotado mede a si mesmo em evaluate_blocks
+    if (!worker->cached && !worker->parts && worker->engine == TABLE_ENGINE_PACKED) {
+        if (!evaluate_blocks(prog, first, count, window)) worker->failed = 1;
         return;
     }
-    
-    // identifica quais variáveis (proposições) são usadas na expressão
-    int used_vars[52] = {0}; // rastreia quais proposições são usadas
-    int num_vars = 0; // número total de proposições usadas
-    for (int i = 0; i < size; i++) {
-        if (elements[i].type == PROPOSITION) {
-            int idx;
-            if (isupper(elements[i].data.prop)) {
-                idx = elements[i].data.prop - 'A'; // letras maiúsculas: A=0, B=1, ...
-            } else {
-                idx = elements[i].data.prop - 'a' + 26; // letras minúsculas: a=26, b=27, ...
+    STATS_BEGIN(start);
+
+    if (worker->cached) {
+        // tabela do cache: as palavras já estão no arquivo mapeado
+        for (uint64_t w = 0; w < count; w++) window[w] = cached_table_word(worker->cached, first + w);
+    } else if (worker->parts) {
+        // partes independentes: cada palavra combina as palavras já calculadas das partes
+        for (uint64_t w = 0; w < count; w++) window[w] = part_tables_word(worker->parts, first + w);
+    } else {
+        switch (worker->engine) {
+            case TABLE_ENGINE_GRAY: {
+                // percorre a janela em código Gray e reordena para a ordem binária
+                int bits = prog->num_vars < TABLE_WINDOW_BITS ? prog->num_vars : TABLE_WINDOW_BITS;
+                gray_evaluate_rows(&worker->tree, window_index * TABLE_CHUNK_ROWS, bits, window);
+                break;
             }
-            
-            // marca a proposição como usada se ainda não foi contada
-            if (idx >= 0 && idx < 52 && !used_vars[idx]) {
-                used_vars[idx] = 1;
-                num_vars++;
+            case TABLE_ENGINE_BDD:
+                // cada bloco é lido direto do diagrama
+                for (uint64_t w = 0; w < count; w++)
+                    window[w] = bdd_eval_block(worker->bdd, worker->bdd_root, first + w);
+                break;
+            case TABLE_ENGINE_JIT: {
+                // uma chamada da função nativa por bloco, sem despacho por instrução
+                uint64_t words[MAX_TABLE_VARS];
+                for (uint64_t w = 0; w < count; w++) {
+                    load_block_words(prog, first + w, words);
+                    window[w] = worker->jit->run(words, worker->jit_frame);
+                }
+                STATS_PROGRAM(prog, count);
+                break;
             }
+            default:
+                break; // empacotado: tratado acima
         }
     }
 
-    // verifica se existem proposições na expressão
-    if (num_vars == 0) {
-        fprintf(stderr, "Erro: Nenhuma proposicao valida encontrada na expressao\n");
-        return;
+    STATS_END(STATS_EVALUATE, start);
+    if (worker->engine == TABLE_ENGINE_GRAY || worker->engine == TABLE_ENGINE_BDD)
+        STATS_ADD(STATS_ROWS, (uint64_t) rows < count * ROWS_PER_WORD ? (uint64_t) rows : count * ROWS_PER_WORD);
+}
+
+// escreve as linhas nas posições [first_pos, first_pos + count) da saída em 'dst'
+// (a posição p corresponde à linha p, ou rows - 1 - p na ordem invertida)
+static void format_table_rows(const program *prog, long long rows, int reverse_order,
+                              long long first_pos, long long count, table_worker *worker, char *dst) {
+    row_template *tmpl = &worker->tmpl;
+    uint64_t window[TABLE_WINDOW_WORDS];
+    uint64_t window_index = UINT64_MAX;
+    STATS_BEGIN(start);
+    STATS_TOTAL(evaluating); // tempo das janelas, descontado da formatação
+
+    for (long long pos = first_pos; pos < first_pos + count; pos++) {
+        long long i = reverse_order ? rows - 1 - pos : pos;
+        uint64_t block = (uint64_t) i / ROWS_PER_WORD;
+
+        // avalia a próxima janela quando a linha sai da janela corrente
+        if (block / TABLE_WINDOW_WORDS != window_index) {
+            STATS_BEGIN(window_start);
+            window_index = block / TABLE_WINDOW_WORDS;
+            evaluate_window(prog, worker, rows, window_index, window);
+            STATS_LAP(window_start, evaluating);
+        }
+
+        // o modelo só reescreve os bytes V/F que mudaram desde a linha anterior
+        row_template_set(tmpl, i, (window[block % TABLE_WINDOW_WORDS] >> (i % ROWS_PER_WORD)) & 1);
+        memcpy(dst, tmpl->text, tmpl->length);
+        dst += tmpl->length;
     }
 
-    // cria uma lista ordenada das proposições usadas
-    char var_list[MAX_VARS];
-    int index = 0;
+    STATS_END_EXCEPT(STATS_FORMAT, start, evaluating);
+}
+
+// estado compartilhado entre os trabalhadores durante uma rodada de pedaços
+typedef struct {
+    const program *prog;
+    long long rows;
+    int reverse_order;
+    uint64_t first_chunk;     // primeiro pedaço da rodada corrente
+    table_worker *workers;    // estado privado de cada trabalhador
+    char *dst;                // área de saída da rodada (buffer do escritor ou arquivo mapeado)
+} table_job;
+
+static void format_table_chunk(void *ctx, int worker, uint64_t chunk) {
+    table_job *job = ctx;
+    long long round_pos = (long long) chunk * TABLE_CHUNK_ROWS;
+    long long first_pos = (long long) job->first_chunk * TABLE_CHUNK_ROWS + round_pos;
+    long long count = job->rows - first_pos < TABLE_CHUNK_ROWS ? job->rows - first_pos : TABLE_CHUNK_ROWS;
+    table_worker *state = &job->workers[worker];
+
+    format_table_rows(job->prog, job->rows, job->reverse_order, first_pos, count,
+                      state, job->dst + (size_t) round_pos * state->tmpl.length);
+}
+
+// gera as linhas da tabela no escritor: cada rodada reserva uma área contígua da
+// saída e distribui seus pedaços entre as threads, que formatam direto na posição final
+static int write_table_rows(output_writer *writer, const program *prog, long long rows,
+                            const table_options *options, const bdd_manager *bdd, int bdd_root,
+                            const cached_table *cached, const part_tables *parts) {
+    int reverse_order = options->reverse_order;
+    int threads = options->threads > 1 ? options->threads : 1;
+    size_t row_len = table_row_length(prog);
+    uint64_t chunks = ((uint64_t) rows + TABLE_CHUNK_ROWS - 1) / TABLE_CHUNK_ROWS;
+    uint64_t round = (uint64_t) threads * TABLE_CHUNKS_PER_THREAD;
+    if (round > chunks) round = chunks;
 
-    // adiciona letras maiúsculas primeiro
-    for (int i = 0; i < 26; i++) {
-        if (used_vars[i]) var_list[index++] = 'A' + i;
+    // no arquivo mapeado a tabela inteira é uma única rodada, sem cópia intermediária
+    if (writer->map) round = chunks;
+
+    thread_pool *pool = thread_pool_create(threads);
+    table_worker *workers = calloc(threads, sizeof(table_worker));
+    table_engine engine = options->engine;
+    jit_code jit;
+    int ok = pool && workers;
+
+    // com a tabela do cache ou das partes nenhum motor é preparado
+    if (cached || parts) engine = TABLE_ENGINE_PACKED;
+
+    // o código nativo é gerado uma vez; sem ele, o interpretador empacotado assume
+    if (engine == TABLE_ENGINE_JIT && !jit_compile(prog, &jit)) engine = TABLE_ENGINE_PACKED;
+
+    for (int t = 0; ok && t < threads; t++) {
+        ok = row_template_init(&workers[t].tmpl, prog->num_vars, prog->var_names);
+        workers[t].engine = engine;
+        workers[t].bdd = bdd;
+        workers[t].bdd_root = bdd_root;
+        workers[t].cached = cached;
+        workers[t].parts = parts;
+        if (ok && engine == TABLE_ENGINE_GRAY) ok = build_expr_tree(prog, &workers[t].tree);
+        if (ok && engine == TABLE_ENGINE_JIT) {
+            workers[t].jit = &jit;
+            workers[t].jit_frame = malloc(sizeof(uint64_t) * (jit.frame_words > 0 ? jit.frame_words : 1));
+            ok = workers[t].jit_frame != NULL;
+        }
     }
-    // depois adiciona letras minúsculas
-    for (int i = 0; i < 26; i++) {
-        if (used_vars[i+26]) var_list[index++] = 'a' + i;
+
+    table_job job = { prog, rows, reverse_order, 0, workers, NULL };
+
+    // depois de uma escrita com falha (ou de um destino que pediu para parar) nada mais é formatado
+    for (uint64_t first = 0; ok && !writer->failed && first < chunks; first += round) {
+        uint64_t count = chunks - first < round ? chunks - first : round;
+        long long round_rows = (long long) count * TABLE_CHUNK_ROWS;
+        if (round_rows > rows - (long long) first * TABLE_CHUNK_ROWS)
+            round_rows = rows - (long long) first * TABLE_CHUNK_ROWS;
+
+        job.first_chunk = first;
+        job.dst = writer_reserve(writer, (size_t) round_rows * row_len);
+        if (!job.dst) {
+            ok = 0;
+            break;
+        }
+
+        thread_pool_run(pool, count, format_table_chunk, &job);
+        writer_commit(writer, (size_t) round_rows * row_len);
+
+        // linhas de uma janela que falhou já foram formatadas: a tabela inteira é um erro
+        for (int t = 0; t < threads; t++)
+            if (workers[t].failed) ok = 0;
     }
-    
-    int rows = (int) pow(2, num_vars); // número de linhas na tabela (2^num_vars)
-    int values[MAX_VARS] = {0}; // array para armazenar os valores das proposições
-    
-    // imprime o cabeçalho da tabela
-    for (int i = 0; i < num_vars; i++)
-        printf(" %c |", var_list[i]);
-    printf(" %s\n", expression);
-    
-    // imprime uma linha separadora
-    for (int i = 0; i < num_vars * 4 + strlen(expression) + 2; i++) 
-        printf("-");
-    printf("\n");
-    
-    // determina a direção de iteração
-    int step = reverse_order ? -1 : 1;
-    int start = reverse_order ? rows - 1 : 0;
-    int end = reverse_order ? -1 : rows;
-
-    // gera cada linha da tabela verdade
-    for (int i = start; i != end; i += step) {
-        // calcula valores das proposições para esta linha
-        for (int j = 0; j < num_vars; j++)
-            if (isupper(var_list[j])) {
-                values[var_list[j] - 'A'] = (i >> (num_vars - j - 1)) & 1;
-            } else {
-                values[var_list[j] - 'a' + 26] = (i >> (num_vars - j - 1)) & 1;
-            }
-        
-        // imprime os valores das proposições
-        for (int j = 0; j < num_vars; j++) {
-            int idx;
-            if (isupper(var_list[j])) {
-                idx = var_list[j] - 'A';
-            } else {
-                idx = var_list[j] - 'a' + 26;
-            }
-            printf(" %c |", values[idx] ? 'V' : 'F'); // V para verdadeiro, F para falso
+
+    for (int t = 0; workers && t < threads; t++) {
+        row_template_free(&workers[t].tmpl);
+        if (workers[t].engine == TABLE_ENGINE_GRAY) free_expr_tree(&workers[t].tree);
+        free(workers[t].jit_frame);
+    }
+    free(workers);
+    thread_pool_destroy(pool);
+    if (engine == TABLE_ENGINE_JIT) jit_free(&jit);
+    return ok;
+}
+
+// formata o cabeçalho em 'p': nomes das variáveis, a expressão e a linha separadora
+static void format_table_header(const program *prog, const char *expression, char *p) {
+    size_t expr_len = strlen(expression);
+    size_t columns = table_columns_width(prog);
+
+    for (int i = 0; i < prog->num_vars; i++) {
+        size_t name_len = strlen(prog->var_names[i]);
+        *p++ = ' ';
+        memcpy(p, prog->var_names[i], name_len);
+        p += name_len;
+        *p++ = ' ';
+        *p++ = '|';
+    }
+    *p++ = ' ';
+    memcpy(p, expression, expr_len);
+    p += expr_len;
+    *p++ = '\n';
+
+    memset(p, '-', columns + expr_len + 2);
+    p += columns + expr_len + 2;
+    *p = '\n';
+}
+
+static void write_table_header(output_writer *writer, const program *prog, const char *expression) {
+    size_t header_len = table_header_length(prog, expression);
+    char *p = writer_reserve(writer, header_len);
+    if (!p) return;
+
+    format_table_header(prog, expression, p);
+    writer_commit(writer, header_len);
+}
+
+size_t truth_table_length(const program *prog, const char *expression) {
+    long long rows = 1LL << prog->num_vars;
+    return table_header_length(prog, expression) + (size_t) rows * table_row_length(prog);
+}
+
+int format_truth_table(const program *prog, const char *expression, int reverse_order, char *dst) {
+    table_worker worker = {0};
+    long long rows = 1LL << prog->num_vars;
+
+    if (!row_template_init(&worker.tmpl, prog->num_vars, prog->var_names)) return 0;
+    worker.engine = TABLE_ENGINE_PACKED;
+
+    format_table_header(prog, expression, dst);
+    format_table_rows(prog, rows, reverse_order, 0, rows, &worker,
+                      dst + table_header_length(prog, expression));
+
+    row_template_free(&worker.tmpl);
+    return 1;
+}
+
+int write_truth_table(output_writer *writer, const program *prog, const char *expression,
+                      int reverse_order, int threads) {
+    table_options options;
+
+    init_table_options(&options);
+    options.reverse_order = reverse_order;
+    options.threads = threads;
+
+    write_table_header(writer, prog, expression);
+    return write_table_rows(writer, prog, 1LL << prog->num_vars, &options, NULL, -1, NULL, NULL) && !writer->failed;
+}
+
+int check_table_size(const program *prog, error_status *status) {
+    if (prog->num_vars <= MAX_TABLE_VARS) return 1;
+
+    char detail[64];
+    sprintf(detail, "%d (maximo de %d)", prog->num_vars, MAX_TABLE_VARS);
+    set_error(status, ERR_TOO_MANY_VARIABLES, -1, detail);
+    return 0;
+}
+
+void init_table_options(table_options *options) {
+    options->reverse_order = 0;
+    options->threads = 1;
+    options->output = NULL;
+    options->output_path = NULL;
+    options->use_mmap = 0;
+    options->engine = TABLE_ENGINE_PACKED;
+    options->bdd_order = NULL;
+    options->binary = 0;
+    options->cache = NULL;
+    options->decompose = 1;
+    options->fixed = NULL;
+}
+
+// função que gera uma tabela verdade para uma expressão lógica
+// as opções controlam a ordem das linhas, o destino e o número de threads
+int generate_truth_table_with(const char *expression, const table_options *options) {
+    error_status status; // status de erro
+    program prog;
+    output_writer writer;
+    FILE *file = NULL; // arquivo aberto aqui quando output_path é usado sem mapeamento
+    int opened = 0;
+    int ok = 1;
+
+    if (!parse_expression(expression, &prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return 0;
+    }
+
+    // variáveis fixadas viram constantes antes de tudo: só as livres contam para o tamanho da tabela
+    if (options->fixed) {
+        program restricted;
+        int restricted_ok = restrict_program(&prog, options->fixed, &restricted, &status);
+        free_program(&prog);
+        if (!restricted_ok) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            return 0;
         }
-        
-        // avalia a expressão com os valores atuais
-        init_error_status(&status);
-        int result = evaluate_expression(elements, size, values, &status);
-        
-        // imprime o resultado ou uma mensagem de erro
-        if (status.code != SUCCESS) {
-            printf(" ERRO: %s\n", status.message);
-        } else {
-            printf(" %c\n", result ? 'V' : 'F'); // V para verdadeiro, F para falso
+        prog = restricted;
+    }
+    if (!check_table_size(&prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        free_program(&prog);
+        return 0;
+    }
+
+    // formato binário: bitmap compacto em vez do texto
+    if (options->binary) {
+        file = options->output_path ? fopen(options->output_path, "wb") : NULL;
+        if (options->output_path && !file) {
+            fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", options->output_path);
+            ok = 0;
+        } else if (!write_table_file(&prog, expression, file ? file : (options->output ? options->output : stdout),
+                                     options->threads, &status)) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            ok = 0;
+        }
+        if (file && fclose(file) != 0 && ok) {
+            fprintf(stderr, "Erro: falha ao gravar a tabela\n");
+            ok = 0;
         }
+        free_program(&prog);
+        return ok;
     }
+
+    // com cache, a tabela vem de uma execução anterior ou é calculada e guardada agora
+    cached_table cached;
+    int have_cached = options->cache && cache_fetch_table(options->cache, &prog, expression, options->threads, &cached);
+
+    // no motor BDD o diagrama é construído uma vez e compartilhado pelas threads
+    bdd_manager *bdd = NULL;
+    int bdd_root = -1;
+    if (options->engine == TABLE_ENGINE_BDD && !have_cached) {
+        int order[MAX_TABLE_VARS];
+        if (bdd_parse_order(&prog, options->bdd_order, order, &status)) {
+            bdd = bdd_create(&prog, order, 0);
+            if (!bdd) set_error(&status, ERR_MEMORY_ALLOCATION, -1, "");
+            else bdd_root = bdd_build(bdd, &prog, &status);
+        }
+        if (bdd_root < 0) {
+            fprintf(stderr, "Erro: %s\n", status.message);
+            bdd_destroy(bdd);
+            free_program(&prog);
+            return 0;
+        }
+    }
+
+    // fórmula com partes independentes: cada parte é avaliada uma vez e as linhas
+    // da tabela inteira combinam os resultados das partes
+    part_tables parts;
+    int have_parts = 0;
+    if (options->decompose && !have_cached && options->engine == TABLE_ENGINE_PACKED &&
+        prog.num_vars > DECOMPOSE_MIN_VARS) {
+        decomposition d;
+        if (decompose_program(&prog, &d, &status) > 1) {
+            have_parts = build_part_tables(&prog, &d, &parts);
+            free_decomposition(&d);
+        }
+    }
+
+    long long rows = 1LL << prog.num_vars; // número de linhas na tabela (2^num_vars)
+    size_t total = truth_table_length(&prog, expression);
+
+    // escolhe o destino: arquivo mapeado, arquivo bufferizado ou o FILE indicado
+    if (options->output_path && options->use_mmap)
+        opened = writer_init_mapped(&writer, options->output_path, total);
+    if (!opened && options->output_path) {
+        file = fopen(options->output_path, "wb");
+        if (!file) {
+            fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", options->output_path);
+            bdd_destroy(bdd);
+            if (have_cached) cached_table_close(&cached);
+            if (have_parts) free_part_tables(&parts);
+            free_program(&prog);
+            return 0;
+        }
+    }
+    if (!opened) opened = writer_init(&writer, file ? file : (options->output ? options->output : stdout));
+
+    if (!opened) {
+        fprintf(stderr, "Erro: Falha de alocacao de memoria\n");
+        ok = 0;
+    } else {
+        write_table_header(&writer, &prog, expression);
+        if (!write_table_rows(&writer, &prog, rows, options, bdd, bdd_root, have_cached ? &cached : NULL,
+                              have_parts ? &parts : NULL)) {
+            fprintf(stderr, "Erro: Falha de alocacao de memoria\n");
+            ok = 0;
+        }
+        if (!writer_close(&writer)) {
+            fprintf(stderr, "Erro: falha ao gravar a tabela\n");
+            ok = 0;
+        }
+    }
+
+    if (file && fclose(file) != 0 && ok) {
+        fprintf(stderr, "Erro: falha ao gravar a tabela\n");
+        ok = 0;
+    }
+    bdd_destroy(bdd);
+    if (have_cached) cached_table_close(&cached);
+    if (have_parts) free_part_tables(&parts);
+    free_program(&prog);
+    return ok;
+}
+
+// reverse_order controla se a tabela é gerada em ordem normal ou invertida
+void generate_truth_table(const char *expression, int reverse_order) {
+    table_options options;
+
+    init_table_options(&options);
+    options.reverse_order = reverse_order;
+    generate_truth_table_with(expression, &options);
 }
\ No newline at end of file
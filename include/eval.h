@@ -8,10 +8,12 @@
 #include <math.h>
 
 #include "validation.h" // inclui funções de validação de expressões
+#include "arena.h"      // memória temporária da leitura e da compilação
+#include "symbols.h"    // nomes das proposições
+#include "output.h"     // escritor bufferizado da tabela
 
-// constantes para limites do programa
-#define MAX_VARS 52  ///< número máximo de variáveis (a-z, A-Z = 52)
-#define MAX_EXPR 100 ///< tamanho máximo da expressão em tokens
+// a expressão e o número de proposições não têm limite; apenas a enumeração da tabela tem
+#define MAX_TABLE_VARS 62 ///< máximo de variáveis para enumerar linhas (2^62 linhas)
 
 /// @brief tipos de dados que podem aparecer na expressão
 typedef enum data_type{ 
@@ -24,7 +26,7 @@ typedef enum data_type{
 typedef struct {
     data_type type;  ///< tipo do token (proposição, operador ou parêntese)
     union data{
-        char prop;        ///< para proposições (a-z, A-Z)
+        int prop;         ///< para proposições: id na tabela de símbolos
         char operator;    ///< para operadores (~, &, |, -, <)
         char parentheses; ///< para parênteses ('(' ou ')')
     } data;  ///< dados específicos do token
@@ -32,24 +34,155 @@ typedef struct {
 
 /**
  * @brief lê uma expressão lógica e a converte em tokens
+ *
+ * proposições são identificadores (uma letra seguida de letras, dígitos ou
+ * '_', como p, x123 ou chuva_hoje) internados em 'symbols'
+ *
+ * a leitura é uma única passada linear que também faz todas as verificações
+ * de validate_expression (parênteses, operadores consecutivos, expressão vazia)
  * 
  * @param expression string contendo a expressão lógica
- * @param elements array onde os tokens serão armazenados
+ * @param elements array onde os tokens serão armazenados (capacidade de strlen(expression) tokens;
+ *                 NULL = apenas valida, sem gerar tokens nem usar 'symbols')
  * @param size ponteiro para armazenar o número de tokens
+ * @param symbols tabela onde os nomes das proposições são internados
  * @param status ponteiro para estrutura de status de erro
  */
-void read_expression(const char *expression, token *elements, int *size, error_status *status);
+void read_expression(const char *expression, token *elements, int *size, symbol_table *symbols, error_status *status);
 
 /**
  * @brief avalia uma expressão lógica convertida em tokens
  * 
  * @param elements array de tokens da expressão
  * @param size número de tokens na expressão
- * @param values array com os valores booleanos das proposições
+ * @param values valores booleanos das proposições, indexados pelo id do símbolo
+ * @param scratch arena para as pilhas (devolvidas ao final)
  * @param status ponteiro para estrutura de status de erro
  * @return int resultado booleano da expressão (0 = falso, 1 = verdadeiro)
  */
-int evaluate_expression(token *elements, int size, int values[MAX_VARS], error_status *status);
+int evaluate_expression(const token *elements, int size, const int *values, arena *scratch, error_status *status);
+
+/// @brief motor usado para calcular os resultados das linhas
+typedef enum table_engine {
+    TABLE_ENGINE_PACKED, ///< programa compilado sobre palavras empacotadas (SIMD quando disponível)
+    TABLE_ENGINE_GRAY,   ///< código Gray com reavaliação incremental da árvore
+    TABLE_ENGINE_BDD,    ///< leitura direta de um BDD ordenado e reduzido
+    TABLE_ENGINE_JIT     ///< código x86-64 gerado em tempo de execução (interpretador empacotado se indisponível)
+} table_engine;
+
+struct result_cache; // cache persistente de resultados (cache.h)
+
+/// @brief opções de geração da tabela verdade
+typedef struct {
+    int reverse_order; ///< ordem das linhas (0 = normal, 1 = invertida)
+    int threads;       ///< número de threads (1 = serial)
+    FILE *output;      ///< destino da tabela (NULL = stdout)
+    const char *output_path; ///< arquivo de saída (NULL = usa 'output')
+    int use_mmap;      ///< grava output_path via mapeamento em memória quando possível
+    table_engine engine;     ///< motor de avaliação das linhas
+    const char *bdd_order;   ///< ordem de variáveis do BDD (ver bdd_parse_order; NULL = natural)
+    int binary;        ///< grava o formato binário de tablefile.h (ordem normal, motor empacotado)
+    struct result_cache *cache; ///< resultados já calculados por outras execuções (NULL = sem cache)
+    int decompose;     ///< monta a tabela a partir de partes sem variáveis em comum (decompose.h) quando houver
+    const char *fixed; ///< atribuição parcial "a=1,b=0": a tabela enumera só as outras variáveis (NULL = nenhuma)
+} table_options;
+
+/**
+ * @brief inicializa as opções com os valores padrão (ordem normal, 1 thread, stdout)
+ *
+ * @param options opções a inicializar
+ */
+void init_table_options(table_options *options);
+
+struct program; // programa compilado (compile.h)
+
+/**
+ * @brief valida, lê e compila uma expressão em um programa pós-fixo
+ *
+ * @param expression string contendo a expressão lógica
+ * @param prog programa de saída (liberar com free_program)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int parse_expression(const char *expression, struct program *prog, error_status *status);
+
+/**
+ * @brief como parse_expression, com tokens, símbolos e pilhas na arena 'scratch'
+ *
+ * a arena é reiniciada no começo de cada chamada; reutilizá-la entre
+ * expressões evita qualquer alocação depois que ela atinge o tamanho necessário
+ *
+ * @param expression string contendo a expressão lógica
+ * @param scratch arena de trabalho
+ * @param prog programa de saída (liberar com free_program)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int parse_expression_with(const char *expression, arena *scratch, struct program *prog, error_status *status);
+
+/**
+ * @brief verifica se as linhas do programa podem ser enumeradas (até MAX_TABLE_VARS variáveis)
+ *
+ * @param prog programa compilado
+ * @param status recebe ERR_TOO_MANY_VARIABLES quando há variáveis demais
+ * @return int 1 se a tabela pode ser enumerada, 0 caso contrário
+ */
+int check_table_size(const struct program *prog, error_status *status);
+
+/**
+ * @brief tamanho em bytes da tabela verdade completa (cabeçalho e linhas)
+ *
+ * @param prog programa compilado da expressão
+ * @param expression texto da expressão, repetido no cabeçalho
+ * @return size_t número de bytes escritos por format_truth_table
+ */
+size_t truth_table_length(const struct program *prog, const char *expression);
+
+/**
+ * @brief formata a tabela verdade inteira em memória, na thread chamadora
+ *
+ * o texto é idêntico ao de generate_truth_table_with; usado quando várias
+ * tabelas pequenas são geradas em paralelo (modo em lote)
+ *
+ * @param prog programa compilado da expressão
+ * @param expression texto da expressão, repetido no cabeçalho
+ * @param reverse_order ordem das linhas (0 = normal, 1 = invertida)
+ * @param dst destino com pelo menos truth_table_length bytes
+ * @return int 1 em caso de sucesso, 0 em falha de alocação
+ */
+int format_truth_table(const struct program *prog, const char *expression, int reverse_order, char *dst);
+
+/**
+ * @brief grava a tabela verdade de um programa já compilado no escritor
+ *
+ * o texto é idêntico ao de generate_truth_table_with com o motor empacotado;
+ * nada é impresso e o escritor não é fechado
+ *
+ * @param writer escritor de destino
+ * @param prog programa compilado (até MAX_TABLE_VARS variáveis)
+ * @param expression texto da expressão, repetido no cabeçalho
+ * @param reverse_order ordem das linhas (0 = normal, 1 = invertida)
+ * @param threads threads da formatação (1 = serial)
+ * @return int 1 em caso de sucesso, 0 em falha de alocação ou de escrita
+ */
+int write_truth_table(output_writer *writer, const struct program *prog, const char *expression,
+                      int reverse_order, int threads);
+
+/**
+ * @brief gera uma tabela verdade com as opções fornecidas
+ *
+ * com mais de uma thread, as linhas são divididas em pedaços avaliados em
+ * paralelo e gravados na ordem original; a saída é idêntica à execução serial.
+ * as linhas são formatadas a partir de um modelo em um buffer grande e
+ * gravadas em blocos (ou direto no arquivo mapeado, com use_mmap)
+ *
+ * os erros são escritos em stderr, como na linha de comando
+ *
+ * @param expression string contendo a expressão lógica
+ * @param options opções de geração
+ * @return int 1 se a tabela inteira foi gravada, 0 em erro de leitura, de memória ou de gravação
+ */
+int generate_truth_table_with(const char *expression, const table_options *options);
 
 /**
  * @brief gera uma tabela verdade para uma expressão lógica
@@ -0,0 +1,239 @@
+#include "gray.h"
+
+// recalcula o valor de um nó a partir dos filhos
+static int node_value(const expr_tree *tree, const tree_node *node) {
+    int a = node->left >= 0 ? tree->nodes[node->left].value : 0;
+    int b = node->right >= 0 ? tree->nodes[node->right].value : 0;
+
+    switch (node->op) {
+        case OP_NOT:     return !b;
+        case OP_AND:     return a && b;
+        case OP_OR:      return a || b;
+        case OP_IMPLIES: return !a || b;
+        case OP_IFF:     return a == b;
+        default:         return node->value; // folhas mantêm o valor atribuído
+    }
+}
+
+// agrupa os pais de cada nó (contagem seguida de soma prefixa)
+static int link_parents(expr_tree *tree) {
+    int edges = 0;
+
+    tree->parent_start = calloc(tree->count + 1, sizeof(int));
+    if (!tree->parent_start) return 0;
+
+    for (int i = 0; i < tree->count; i++) {
+        const tree_node *node = &tree->nodes[i];
+        if (node->left >= 0) { tree->parent_start[node->left + 1]++; edges++; }
+        if (node->right >= 0) { tree->parent_start[node->right + 1]++; edges++; }
+    }
+    for (int i = 0; i < tree->count; i++)
+        tree->parent_start[i + 1] += tree->parent_start[i];
+
+    int *fill = calloc(tree->count, sizeof(int));
+    tree->parents = malloc(sizeof(int) * (edges > 0 ? edges : 1));
+    if (!fill || !tree->parents) {
+        free(fill);
+        return 0;
+    }
+    for (int i = 0; i < tree->count; i++) {
+        const tree_node *node = &tree->nodes[i];
+        if (node->left >= 0) tree->parents[tree->parent_start[node->left] + fill[node->left]++] = i;
+        if (node->right >= 0) tree->parents[tree->parent_start[node->right] + fill[node->right]++] = i;
+    }
+    free(fill);
+    return 1;
+}
+
+int build_expr_tree(const program *prog, expr_tree *tree) {
+    int *stack = malloc(sizeof(int) * (prog->max_depth + prog->num_temps));
+    int top = -1;
+
+    tree->count = 0;
+    tree->num_vars = prog->num_vars;
+    tree->row = 0;
+    tree->nodes = malloc(sizeof(tree_node) * prog->length);
+    tree->leaves = malloc(sizeof(int) * prog->length);
+    tree->leaf_start = calloc(prog->num_vars + 1, sizeof(int));
+    tree->parents = NULL;
+    tree->parent_start = NULL;
+    tree->pending = malloc(sizeof(int) * prog->length);
+    tree->queued = calloc(prog->length, 1);
+
+    if (!stack || !tree->nodes || !tree->leaves || !tree->leaf_start || !tree->pending || !tree->queued) {
+        free(stack);
+        free_expr_tree(tree);
+        return 0;
+    }
+    int *temps = stack + prog->max_depth; // nós das subexpressões compartilhadas
+
+    // o programa pós-fixo já é uma travessia pós-ordem: cada instrução de cálculo vira um nó
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+
+        if (ins->op == OP_STORE) {
+            temps[ins->slot] = stack[top];
+            continue;
+        }
+        if (ins->op == OP_FETCH) {
+            stack[++top] = temps[ins->slot]; // o mesmo nó ganha mais um pai
+            continue;
+        }
+
+        tree_node *node = &tree->nodes[tree->count];
+        node->op = ins->op;
+        node->slot = ins->slot;
+        node->left = node->right = -1;
+        node->value = ins->op == OP_CONST ? ins->slot : 0;
+
+        if (node->op == OP_LOAD) {
+            tree->leaf_start[node->slot + 1]++;
+        } else if (node->op == OP_NOT) {
+            node->right = stack[top--];
+        } else if (node->op != OP_CONST) {
+            node->right = stack[top--];
+            node->left = stack[top--];
+        }
+
+        node->value = node_value(tree, node);
+        stack[++top] = tree->count++;
+    }
+    tree->root = stack[0];
+    free(stack);
+
+    if (!link_parents(tree)) {
+        free_expr_tree(tree);
+        return 0;
+    }
+
+    // agrupa as folhas por slot (contagem seguida de soma prefixa)
+    for (int j = 0; j < prog->num_vars; j++)
+        tree->leaf_start[j + 1] += tree->leaf_start[j];
+    int *fill = calloc(prog->num_vars > 0 ? prog->num_vars : 1, sizeof(int));
+    if (!fill) {
+        free_expr_tree(tree);
+        return 0;
+    }
+    for (int i = 0; i < tree->count; i++) {
+        if (tree->nodes[i].op != OP_LOAD) continue;
+        int slot = tree->nodes[i].slot;
+        tree->leaves[tree->leaf_start[slot] + fill[slot]++] = i;
+    }
+    free(fill);
+
+    return 1;
+}
+
+// coloca os pais de 'n' no heap de pendentes (uma vez cada)
+static void queue_parents(expr_tree *tree, int n, int *size) {
+    for (int k = tree->parent_start[n]; k < tree->parent_start[n + 1]; k++) {
+        int p = tree->parents[k];
+        if (tree->queued[p]) continue;
+        tree->queued[p] = 1;
+
+        int i = (*size)++;
+        while (i > 0 && tree->pending[(i - 1) / 2] > p) {
+            tree->pending[i] = tree->pending[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        tree->pending[i] = p;
+    }
+}
+
+// retira o menor índice do heap de pendentes
+static int pop_pending(expr_tree *tree, int *size) {
+    int *heap = tree->pending;
+    int top = heap[0];
+    int last = heap[--(*size)];
+    int i = 0;
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= last) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0) heap[i] = last;
+    tree->queued[top] = 0;
+    return top;
+}
+
+int tree_flip(expr_tree *tree, int slot) {
+    tree->row ^= 1ULL << (tree->num_vars - slot - 1);
+
+    for (int k = tree->leaf_start[slot]; k < tree->leaf_start[slot + 1]; k++) {
+        int n = tree->leaves[k];
+        int size = 0;
+        tree->nodes[n].value = !tree->nodes[n].value;
+
+        // trecho de árvore (um único pai): sobe direto enquanto o valor do ancestral mudar
+        while (tree->parent_start[n + 1] - tree->parent_start[n] == 1) {
+            int p = tree->parents[tree->parent_start[n]];
+            int value = node_value(tree, &tree->nodes[p]);
+            if (value == tree->nodes[p].value) break;
+            tree->nodes[p].value = value;
+            n = p;
+        }
+        if (tree->parent_start[n + 1] - tree->parent_start[n] > 1) queue_parents(tree, n, &size);
+
+        // nó compartilhado: os pais saem do heap em ordem pós-fixa, depois de todos os filhos alterados
+        while (size > 0) {
+            int p = pop_pending(tree, &size);
+            int value = node_value(tree, &tree->nodes[p]);
+            if (value == tree->nodes[p].value) continue;
+            tree->nodes[p].value = value;
+            queue_parents(tree, p, &size);
+        }
+    }
+
+    return tree->nodes[tree->root].value;
+}
+
+// leva a atribuição corrente até 'row' invertendo as variáveis que diferem
+static void tree_seek(expr_tree *tree, uint64_t row) {
+    uint64_t diff = tree->row ^ row;
+
+    for (int bit = 0; diff; bit++, diff >>= 1)
+        if (diff & 1) tree_flip(tree, tree->num_vars - bit - 1);
+}
+
+void gray_evaluate_rows(expr_tree *tree, uint64_t first_row, int bits, uint64_t *out) {
+    uint64_t count = 1ULL << bits;
+    uint64_t words = count < 64 ? 1 : count / 64;
+
+    for (uint64_t w = 0; w < words; w++) out[w] = 0;
+
+    tree_seek(tree, first_row);
+
+    // passo t inverte o bit menos significativo ligado de t: a linha visitada é gray(t)
+    for (uint64_t t = 0; t < count; t++) {
+        if (t > 0) {
+            int bit = 0;
+            while (!((t >> bit) & 1)) bit++;
+            tree_flip(tree, tree->num_vars - bit - 1);
+        }
+
+        uint64_t gray = t ^ (t >> 1);
+        if (tree->nodes[tree->root].value)
+            out[gray / 64] |= 1ULL << (gray % 64);
+    }
+}
+
+void free_expr_tree(expr_tree *tree) {
+    free(tree->nodes);
+    free(tree->leaves);
+    free(tree->leaf_start);
+    free(tree->parents);
+    free(tree->parent_start);
+    free(tree->pending);
+    free(tree->queued);
+    tree->nodes = NULL;
+    tree->leaves = NULL;
+    tree->leaf_start = NULL;
+    tree->parents = NULL;
+    tree->parent_start = NULL;
+    tree->pending = NULL;
+    tree->queued = NULL;
+}
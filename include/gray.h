@@ -0,0 +1,78 @@
+#ifndef GRAY_H
+#define GRAY_H
+
+#include <stdint.h>
+
+#include "compile.h" // programa pós-fixo compilado
+
+/// @brief nó da árvore sintática com o valor calculado na atribuição corrente
+typedef struct {
+    op_code op;  ///< operação do nó (OP_LOAD ou OP_CONST nas folhas)
+    int left;    ///< filho esquerdo (-1 se não houver; a negação usa apenas 'right')
+    int right;   ///< filho direito (-1 se não houver)
+    int slot;    ///< slot da variável (apenas folhas)
+    int value;   ///< valor do nó na atribuição corrente
+} tree_node;
+
+/**
+ * @brief árvore sintática com valores por nó, para reavaliação incremental
+ *
+ * subexpressões compartilhadas do programa (OP_STORE/OP_FETCH) viram um único
+ * nó com vários pais, de modo que a estrutura é um grafo acíclico
+ */
+typedef struct {
+    tree_node *nodes;    ///< nós em ordem pós-fixa (filhos antes dos pais)
+    int count;           ///< número de nós
+    int root;            ///< índice da raiz
+    int num_vars;        ///< número de variáveis
+    int *leaves;         ///< folhas agrupadas por slot
+    int *leaf_start;     ///< folhas do slot j: leaves[leaf_start[j] .. leaf_start[j+1]-1]
+    int *parents;        ///< pais agrupados por nó
+    int *parent_start;   ///< pais do nó i: parents[parent_start[i] .. parent_start[i+1]-1]
+    int *pending;        ///< heap mínimo dos nós a reavaliar (índice menor = calculado antes)
+    unsigned char *queued; ///< 1 se o nó está em 'pending'
+    uint64_t row;        ///< atribuição corrente (bits no formato do índice da linha)
+} expr_tree;
+
+/**
+ * @brief constrói a árvore a partir do programa e a avalia na linha 0
+ *
+ * @param prog programa compilado
+ * @param tree árvore de saída (liberar com free_expr_tree)
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int build_expr_tree(const program *prog, expr_tree *tree);
+
+/**
+ * @brief inverte o valor de uma variável e reavalia apenas os ancestrais afetados
+ *
+ * a propagação para no primeiro ancestral cujo valor não muda; abaixo de um
+ * nó compartilhado, os ancestrais são reavaliados em ordem pós-fixa
+ *
+ * @param tree árvore
+ * @param slot slot da variável
+ * @return int novo valor da raiz
+ */
+int tree_flip(expr_tree *tree, int slot);
+
+/**
+ * @brief avalia 2^bits linhas a partir de first_row percorrendo-as em código Gray
+ *
+ * cada passo inverte uma única variável; os resultados são reordenados para a
+ * ordem binária: o bit k de out[w] é o resultado da linha first_row + 64*w + k
+ *
+ * @param tree árvore
+ * @param first_row primeira linha (múltiplo de 2^bits)
+ * @param bits número de variáveis menos significativas percorridas
+ * @param out bitmap de saída com max(1, 2^bits / 64) palavras
+ */
+void gray_evaluate_rows(expr_tree *tree, uint64_t first_row, int bits, uint64_t *out);
+
+/**
+ * @brief libera a memória da árvore
+ *
+ * @param tree árvore
+ */
+void free_expr_tree(expr_tree *tree);
+
+#endif // GRAY_H
@@ -0,0 +1,239 @@
+#include <string.h>
+
+#include "jit.h"
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+
+// números dos registradores na codificação x86-64
+enum {
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSI = 6, RDI = 7,
+    R8 = 8, R9 = 9, R10 = 10, R11 = 11, R12 = 12, R13 = 13, R14 = 14, R15 = 15
+};
+
+#define JIT_SCRATCH R11      // auxiliar para operandos em memória
+#define JIT_MAX_INSN_BYTES 32 // limite de bytes gerados por instrução do programa
+
+// posições da pilha mantidas em registradores: primeiro os voláteis, depois os
+// preservados (salvos no prólogo); rdi e rsi trazem os argumentos
+static const int stack_regs[] = { RAX, RCX, RDX, R8, R9, R10, RBX, R12, R13, R14, R15 };
+#define JIT_REGS ((int) (sizeof(stack_regs) / sizeof(stack_regs[0])))
+#define JIT_VOLATILE_REGS 6 // stack_regs[0..5] não precisam ser salvos
+
+// opcodes (forma "r/m64, r64" e forma "r64, r/m64")
+#define X86_AND_RM 0x21
+#define X86_OR_RM  0x09
+#define X86_XOR_RM 0x31
+#define X86_AND_R  0x23
+#define X86_OR_R   0x0B
+#define X86_XOR_R  0x33
+#define X86_MOV_STORE 0x89
+#define X86_MOV_LOAD  0x8B
+
+typedef struct {
+    unsigned char *p; // próximo byte
+    int spill_base;   // deslocamento (em palavras) das posições da pilha fora dos registradores
+    int temp_base;    // deslocamento (em palavras) dos temporários em 'frame'
+} emitter;
+
+static void byte(emitter *e, unsigned b) {
+    *e->p++ = (unsigned char) b;
+}
+
+static void dword(emitter *e, int32_t v) {
+    uint32_t u = (uint32_t) v;
+    for (int i = 0; i < 4; i++) byte(e, (u >> (8 * i)) & 0xFF);
+}
+
+// prefixo REX.W com as extensões dos campos reg e rm
+static void rex(emitter *e, int reg, int rm) {
+    byte(e, 0x48 | ((reg >> 3) & 1) << 2 | ((rm >> 3) & 1));
+}
+
+// op reg, rm (ambos registradores)
+static void op_reg_reg(emitter *e, unsigned opcode, int reg, int rm) {
+    rex(e, reg, rm);
+    byte(e, opcode);
+    byte(e, 0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+// op reg, [base + disp32]
+static void op_reg_mem(emitter *e, unsigned opcode, int reg, int base, int32_t disp) {
+    rex(e, reg, base);
+    byte(e, opcode);
+    byte(e, 0x80 | (reg & 7) << 3 | (base & 7));
+    dword(e, disp);
+}
+
+// registrador da posição 'i' da pilha ou -1 se ela estiver em 'frame'
+static int slot_reg(int i) {
+    return i < JIT_REGS ? stack_regs[i] : -1;
+}
+
+static int32_t spill_disp(const emitter *e, int i) {
+    return 8 * (e->spill_base + i - JIT_REGS);
+}
+
+static int32_t temp_disp(const emitter *e, int t) {
+    return 8 * (e->temp_base + t);
+}
+
+// valor da posição 'i' em um registrador (o próprio ou o auxiliar)
+static int fetch_slot(emitter *e, int i) {
+    int reg = slot_reg(i);
+    if (reg >= 0) return reg;
+    op_reg_mem(e, X86_MOV_LOAD, JIT_SCRATCH, RSI, spill_disp(e, i));
+    return JIT_SCRATCH;
+}
+
+// grava 'reg' na posição 'i' quando ela fica em memória
+static void store_slot(emitter *e, int i, int reg) {
+    if (slot_reg(i) < 0) op_reg_mem(e, X86_MOV_STORE, reg, RSI, spill_disp(e, i));
+}
+
+// registrador que recebe o valor novo da posição 'i'
+static int target_reg(int i) {
+    int reg = slot_reg(i);
+    return reg >= 0 ? reg : JIT_SCRATCH;
+}
+
+static void not_reg(emitter *e, int reg) {
+    rex(e, 0, reg);
+    byte(e, 0xF7);
+    byte(e, 0xC0 | 2 << 3 | (reg & 7));
+}
+
+static void mov_imm(emitter *e, int reg, int32_t imm) {
+    rex(e, 0, reg);
+    byte(e, 0xC7);
+    byte(e, 0xC0 | (reg & 7));
+    dword(e, imm);
+}
+
+static void push_reg(emitter *e, int reg) {
+    if (reg >= 8) byte(e, 0x41);
+    byte(e, 0x50 + (reg & 7));
+}
+
+static void pop_reg(emitter *e, int reg) {
+    if (reg >= 8) byte(e, 0x41);
+    byte(e, 0x58 + (reg & 7));
+}
+
+// a = a op b, com 'a' na posição top-1 e 'b' no topo
+static void emit_binary(emitter *e, op_code op, int top) {
+    int a = top - 1;
+    int dst = fetch_slot(e, a);
+    int rb = slot_reg(top);
+    unsigned rm_form, r_form;
+
+    switch (op) {
+        case OP_AND: rm_form = X86_AND_RM; r_form = X86_AND_R; break;
+        case OP_OR:  rm_form = X86_OR_RM;  r_form = X86_OR_R;  break;
+        case OP_IMPLIES:
+            not_reg(e, dst); // ~a | b
+            rm_form = X86_OR_RM; r_form = X86_OR_R;
+            break;
+        default: // OP_IFF: ~(a ^ b)
+            rm_form = X86_XOR_RM; r_form = X86_XOR_R;
+            break;
+    }
+
+    if (rb >= 0) op_reg_reg(e, rm_form, rb, dst);
+    else op_reg_mem(e, r_form, dst, RSI, spill_disp(e, top));
+
+    if (op == OP_IFF) not_reg(e, dst);
+    store_slot(e, a, dst);
+}
+
+int jit_compile(const program *prog, jit_code *code) {
+    int saved = prog->max_depth < JIT_REGS ? prog->max_depth : JIT_REGS;
+    int spills = prog->max_depth > JIT_REGS ? prog->max_depth - JIT_REGS : 0;
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t bytes = (size_t) prog->length * JIT_MAX_INSN_BYTES + 64;
+    int top = -1;
+
+    memset(code, 0, sizeof(*code));
+    code->size = (bytes + page - 1) / page * page;
+    code->frame_words = spills + prog->num_temps;
+
+    void *memory = mmap(NULL, code->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return 0;
+
+    emitter e = { memory, 0, spills };
+
+    // prólogo: salva os registradores preservados que serão usados
+    for (int i = JIT_VOLATILE_REGS; i < saved; i++) push_reg(&e, stack_regs[i]);
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        int dst;
+
+        switch (ins->op) {
+            case OP_LOAD:
+                dst = target_reg(++top);
+                op_reg_mem(&e, X86_MOV_LOAD, dst, RDI, 8 * ins->slot);
+                store_slot(&e, top, dst);
+                break;
+            case OP_CONST:
+                dst = target_reg(++top);
+                mov_imm(&e, dst, ins->slot ? -1 : 0);
+                store_slot(&e, top, dst);
+                break;
+            case OP_FETCH:
+                dst = target_reg(++top);
+                op_reg_mem(&e, X86_MOV_LOAD, dst, RSI, temp_disp(&e, ins->slot));
+                store_slot(&e, top, dst);
+                break;
+            case OP_STORE:
+                op_reg_mem(&e, X86_MOV_STORE, fetch_slot(&e, top), RSI, temp_disp(&e, ins->slot));
+                break;
+            case OP_NOT:
+                dst = fetch_slot(&e, top);
+                not_reg(&e, dst);
+                store_slot(&e, top, dst);
+                break;
+            default:
+                emit_binary(&e, ins->op, top);
+                top--;
+                break;
+        }
+    }
+
+    // epílogo: o resultado já está em rax (posição 0 da pilha)
+    for (int i = saved - 1; i >= JIT_VOLATILE_REGS; i--) pop_reg(&e, stack_regs[i]);
+    byte(&e, 0xC3);
+
+    // W^X: a página deixa de ser gravável antes de ser executada
+    if (mprotect(memory, code->size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, code->size);
+        return 0;
+    }
+
+    code->memory = memory;
+    *(void **) &code->run = memory; // conversão de objeto para função aceita pelo POSIX
+    return 1;
+}
+
+void jit_free(jit_code *code) {
+    if (code->memory) munmap(code->memory, code->size);
+    code->memory = NULL;
+    code->run = NULL;
+}
+
+#else
+
+// sem x86-64 (ou sem mmap): sempre usa o interpretador
+int jit_compile(const program *prog, jit_code *code) {
+    (void) prog;
+    memset(code, 0, sizeof(*code));
+    return 0;
+}
+
+void jit_free(jit_code *code) {
+    code->memory = NULL;
+    code->run = NULL;
+}
+
+#endif
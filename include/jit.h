@@ -0,0 +1,40 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+
+#include "compile.h" // programa pós-fixo compilado
+
+/// @brief função nativa gerada: recebe as palavras das variáveis (por slot) e devolve a palavra resultado
+typedef uint64_t (*jit_fn)(const uint64_t *words, uint64_t *frame);
+
+/// @brief código de máquina gerado para um programa
+typedef struct {
+    jit_fn run;      ///< função a chamar com as palavras de um bloco e uma área 'frame'
+    void *memory;    ///< páginas executáveis (mmap)
+    size_t size;     ///< tamanho das páginas
+    int frame_words; ///< palavras exigidas em 'frame' (pilha além dos registradores e temporários)
+} jit_code;
+
+/**
+ * @brief gera código x86-64 equivalente a run_program_word
+ *
+ * os valores da pilha ficam em registradores (os mais profundos e os
+ * temporários vão para 'frame'); não há despacho por instrução. o código é
+ * escrito em páginas anônimas que depois viram somente leitura e execução
+ *
+ * @param prog programa compilado
+ * @param code código de saída (liberar com jit_free)
+ * @return int 1 em caso de sucesso, 0 se a plataforma não suportar ou o
+ *         sistema negar páginas executáveis (o chamador usa o interpretador)
+ */
+int jit_compile(const program *prog, jit_code *code);
+
+/**
+ * @brief libera as páginas do código gerado
+ *
+ * @param code código gerado por jit_compile
+ */
+void jit_free(jit_code *code);
+
+#endif // JIT_H
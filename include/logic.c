@@ -0,0 +1,289 @@
+#include "logic.h"
+#include "eval.h"
+#include "simd.h"
+#include "count.h"
+#include "partial.h"
+
+#define LOGIC_WINDOW_WORDS 64 // palavras entregues por chamada de logic_table_blocks
+#define LOGIC_LOCAL_VARS 64   // atribuições até esse tamanho não alocam em logic_evaluate
+
+// o programa e o texto não mudam depois de logic_compile
+struct logic_expr {
+    program prog;
+    char *expression; // cópia do texto, repetida no cabeçalho da tabela
+};
+
+logic_expr *logic_compile(const char *expression, error_status *status) {
+    logic_expr *expr = malloc(sizeof(logic_expr));
+    char *copy = expression ? malloc(strlen(expression) + 1) : NULL;
+
+    init_error_status(status);
+    if (!expr || (expression && !copy)) {
+        free(expr);
+        free(copy);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return NULL;
+    }
+
+    if (!parse_expression(expression, &expr->prog, status)) {
+        free(expr);
+        free(copy);
+        return NULL;
+    }
+    strcpy(copy, expression);
+    expr->expression = copy;
+    return expr;
+}
+
+void logic_free(logic_expr *expr) {
+    if (!expr) return;
+    free_program(&expr->prog);
+    free(expr->expression);
+    free(expr);
+}
+
+logic_expr *logic_restrict(const logic_expr *expr, const char *assignment, error_status *status) {
+    logic_expr *restricted = malloc(sizeof(logic_expr));
+    char *copy = malloc(strlen(expr->expression) + 1);
+
+    init_error_status(status);
+    if (!restricted || !copy) {
+        free(restricted);
+        free(copy);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return NULL;
+    }
+
+    if (!restrict_program(&expr->prog, assignment, &restricted->prog, status)) {
+        free(restricted);
+        free(copy);
+        return NULL;
+    }
+    strcpy(copy, expr->expression);
+    restricted->expression = copy;
+    return restricted;
+}
+
+int logic_num_vars(const logic_expr *expr) {
+    return expr->prog.num_vars;
+}
+
+const char *logic_var_name(const logic_expr *expr, int slot) {
+    if (slot < 0 || slot >= expr->prog.num_vars) return NULL;
+    return expr->prog.var_names[slot];
+}
+
+int logic_evaluate(const logic_expr *expr, const unsigned char *values) {
+    int local[LOGIC_LOCAL_VARS] = {0};
+    int n = expr->prog.num_vars;
+    int *slots = n <= LOGIC_LOCAL_VARS ? local : malloc(sizeof(int) * n);
+
+    if (!slots) return -1;
+    for (int j = 0; j < n; j++) slots[j] = values[j] != 0;
+
+    int result = run_program(&expr->prog, slots);
+    if (slots != local) free(slots);
+    return result;
+}
+
+int logic_classify(const logic_expr *expr, classification *result, error_status *status) {
+    return classify_program(&expr->prog, result, status);
+}
+
+int logic_count(const logic_expr *expr, int threads, bignum *count, error_status *status) {
+    return count_models(&expr->prog, threads, count, status);
+}
+
+int logic_table_blocks(const logic_expr *expr, uint64_t first_block, uint64_t count, logic_block_sink sink,
+                       void *ctx, error_status *status) {
+    uint64_t window[LOGIC_WINDOW_WORDS];
+
+    init_error_status(status);
+    if (!check_table_size(&expr->prog, status)) return 0;
+
+    uint64_t rows = 1ULL << expr->prog.num_vars;
+    uint64_t blocks = (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    if (first_block > blocks || count > blocks - first_block) {
+        set_error(status, ERR_INVALID_ARGUMENT, -1, "palavras alem do fim da tabela");
+        return 0;
+    }
+
+    for (uint64_t done = 0; done < count; done += LOGIC_WINDOW_WORDS) {
+        uint64_t n = count - done < LOGIC_WINDOW_WORDS ? count - done : LOGIC_WINDOW_WORDS;
+        if (!evaluate_blocks(&expr->prog, first_block + done, n, window)) {
+            set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+            return 0;
+        }
+        if (!sink(ctx, first_block + done, window, n)) {
+            set_error(status, ERR_INTERRUPTED, -1, "o destino parou a tabela");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// repassa os trechos ao destino do chamador, lembrando se ele pediu para parar
+typedef struct {
+    logic_text_sink sink;
+    void *ctx;
+    int stopped;
+} text_relay;
+
+static int relay_text(void *ctx, const char *data, size_t size) {
+    text_relay *relay = ctx;
+    if (relay->sink(relay->ctx, data, size)) return 1;
+    relay->stopped = 1;
+    return 0;
+}
+
+int logic_table_text(const logic_expr *expr, int reverse_order, int threads, logic_text_sink sink, void *ctx,
+                     error_status *status) {
+    text_relay relay = { sink, ctx, 0 };
+    output_writer writer;
+
+    init_error_status(status);
+    if (!check_table_size(&expr->prog, status)) return 0;
+    if (!writer_init_sink(&writer, relay_text, &relay)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    int ok = write_truth_table(&writer, &expr->prog, expr->expression, reverse_order, threads);
+    ok = writer_close(&writer) && ok;
+    if (!ok) {
+        if (relay.stopped) set_error(status, ERR_INTERRUPTED, -1, "o destino parou a tabela");
+        else set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+    }
+    return ok;
+}
+
+// --- cursor ---
+
+// posição e a palavra já avaliada: a memória não depende do tamanho da tabela
+struct logic_cursor {
+    const logic_expr *expr;
+    uint64_t rows;       // 2^n
+    uint64_t signature;  // assinatura do programa, gravada com a posição
+    uint64_t row;        // próxima linha entregue
+    uint64_t block;      // palavra em 'word' (UINT64_MAX = nenhuma)
+    uint64_t word;
+    uint64_t stack[];    // pilha e temporários do programa, alocados com o cursor
+};
+
+// FNV-1a sobre nomes e instruções: a mesma expressão compilada dá a mesma assinatura
+static uint64_t program_signature(const program *prog) {
+    uint64_t hash = 1469598103934665603ULL;
+
+    for (int j = 0; j < prog->num_vars; j++)
+        for (const char *c = prog->var_names[j]; ; c++) {
+            hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+            if (!*c) break;
+        }
+    for (int k = 0; k < prog->length; k++) {
+        hash = (hash ^ (uint64_t) prog->code[k].op) * 1099511628211ULL;
+        hash = (hash ^ (uint64_t) (uint32_t) prog->code[k].slot) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// resultados da palavra 'block', avaliada só quando o cursor entra nela
+// (a área de trabalho já existe: avançar nunca falha)
+static uint64_t cursor_word(logic_cursor *cursor, uint64_t block) {
+    if (cursor->block != block) {
+        uint64_t words[MAX_TABLE_VARS];
+        load_block_words(&cursor->expr->prog, block, words);
+        cursor->word = run_program_word(&cursor->expr->prog, words, cursor->stack);
+        cursor->block = block;
+    }
+    return cursor->word;
+}
+
+logic_cursor *logic_cursor_open(const logic_expr *expr, error_status *status) {
+    init_error_status(status);
+    if (!check_table_size(&expr->prog, status)) return NULL;
+
+    int frame = expr->prog.max_depth + expr->prog.num_temps;
+    logic_cursor *cursor = malloc(sizeof(logic_cursor) + sizeof(uint64_t) * (frame > 0 ? frame : 1));
+    if (!cursor) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return NULL;
+    }
+    cursor->expr = expr;
+    cursor->rows = 1ULL << expr->prog.num_vars;
+    cursor->signature = program_signature(&expr->prog);
+    cursor->row = 0;
+    cursor->block = UINT64_MAX;
+    cursor->word = 0;
+    return cursor;
+}
+
+void logic_cursor_close(logic_cursor *cursor) {
+    free(cursor);
+}
+
+uint64_t logic_cursor_rows(const logic_cursor *cursor) {
+    return cursor->rows;
+}
+
+uint64_t logic_cursor_tell(const logic_cursor *cursor) {
+    return cursor->row;
+}
+
+int logic_cursor_seek(logic_cursor *cursor, uint64_t row, error_status *status) {
+    init_error_status(status);
+    if (row > cursor->rows) {
+        set_error(status, ERR_INVALID_ARGUMENT, -1, "linha alem do fim da tabela");
+        return 0;
+    }
+    cursor->row = row;
+    return 1;
+}
+
+int logic_cursor_next_row(logic_cursor *cursor, unsigned char *values, int *result) {
+    uint64_t row = cursor->row;
+    int n = cursor->expr->prog.num_vars;
+
+    if (row >= cursor->rows) return 0;
+    *result = (int) ((cursor_word(cursor, row / ROWS_PER_WORD) >> (row % ROWS_PER_WORD)) & 1);
+    for (int j = 0; values && j < n; j++) values[j] = (unsigned char) ((row >> (n - 1 - j)) & 1);
+    cursor->row = row + 1;
+    return 1;
+}
+
+int logic_cursor_next_block(logic_cursor *cursor, uint64_t *first_row, uint64_t *word, uint64_t *valid) {
+    uint64_t row = cursor->row;
+
+    if (row >= cursor->rows) return 0;
+    uint64_t block = row / ROWS_PER_WORD;
+    uint64_t end = (block + 1) * ROWS_PER_WORD < cursor->rows ? (block + 1) * ROWS_PER_WORD : cursor->rows;
+
+    *first_row = block * ROWS_PER_WORD;
+    *word = cursor_word(cursor, block);
+    *valid = (end - *first_row == ROWS_PER_WORD ? ~0ULL : (1ULL << (end - *first_row)) - 1) &
+             (~0ULL << (row - *first_row));
+    cursor->row = end;
+    return 1;
+}
+
+int logic_cursor_save(const logic_cursor *cursor, char *text, size_t size) {
+    int length = snprintf(text, size, "logic-cursor 1 %016llx %llu", (unsigned long long) cursor->signature,
+                          (unsigned long long) cursor->row);
+    return length > 0 && (size_t) length < size;
+}
+
+int logic_cursor_restore(logic_cursor *cursor, const char *text, error_status *status) {
+    unsigned long long signature, row;
+    int used = 0;
+
+    init_error_status(status);
+    if (sscanf(text, "logic-cursor 1 %16llx %llu%n", &signature, &row, &used) != 2 ||
+        (text[used] != '\0' && text[used] != '\n')) {
+        set_error(status, ERR_INVALID_ARGUMENT, -1, "posicao de cursor malformada");
+        return 0;
+    }
+    if (signature != cursor->signature) {
+        set_error(status, ERR_INVALID_ARGUMENT, -1, "posicao gravada para outra expressao");
+        return 0;
+    }
+    return logic_cursor_seek(cursor, row, status);
+}
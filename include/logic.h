@@ -0,0 +1,236 @@
+#ifndef LOGIC_H
+#define LOGIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bignum.h"     // contagem de precisão arbitrária
+#include "classify.h"   // classificação e atribuições de exemplo
+#include "validation.h" // status de erro
+
+// interface da biblioteca liblogic: nenhuma função imprime nada nem usa estado
+// global mutável, e uma expressão compilada é somente leitura, podendo ser
+// usada por várias threads ao mesmo tempo sem sincronização
+
+/// @brief expressão compilada (opaca); criada por logic_compile e liberada por logic_free
+typedef struct logic_expr logic_expr;
+
+/// @brief recebe 'count' palavras de resultados a partir do bloco 'first_block'; 0 = parar
+typedef int (*logic_block_sink)(void *ctx, uint64_t first_block, const uint64_t *words, uint64_t count);
+
+/// @brief recebe o próximo trecho do texto da tabela; 0 = parar
+typedef int (*logic_text_sink)(void *ctx, const char *data, size_t size);
+
+/**
+ * @brief lê, valida e compila uma expressão
+ *
+ * @param expression string contendo a expressão lógica
+ * @param status ponteiro para estrutura de status de erro
+ * @return logic_expr* expressão compilada ou NULL em caso de erro
+ */
+logic_expr *logic_compile(const char *expression, error_status *status);
+
+/**
+ * @brief libera uma expressão compilada (nenhuma outra thread pode estar usando-a)
+ *
+ * @param expr expressão (NULL é aceito)
+ */
+void logic_free(logic_expr *expr);
+
+/**
+ * @brief expressão só sobre as variáveis livres, com as de 'assignment' fixadas
+ *
+ * as fixadas viram constantes e as subexpressões já decididas por elas somem
+ * (ver fix_variables); tabela, contagem, classificação e cursor da nova
+ * expressão percorrem apenas as variáveis livres. o texto repetido no
+ * cabeçalho da tabela é o da expressão original
+ *
+ * @param expr expressão compilada
+ * @param assignment atribuição parcial, ex: "a=1,b=0" (0, 1, V ou F)
+ * @param status ponteiro para estrutura de status de erro
+ * @return logic_expr* nova expressão (liberar com logic_free) ou NULL em caso de erro
+ */
+logic_expr *logic_restrict(const logic_expr *expr, const char *assignment, error_status *status);
+
+/**
+ * @brief número de variáveis da expressão
+ *
+ * @param expr expressão compilada
+ * @return int número de variáveis (slots 0 a n-1)
+ */
+int logic_num_vars(const logic_expr *expr);
+
+/**
+ * @brief nome da variável de um slot, na ordem das colunas da tabela
+ *
+ * @param expr expressão compilada
+ * @param slot slot da variável
+ * @return const char* nome (válido enquanto a expressão existir) ou NULL fora do intervalo
+ */
+const char *logic_var_name(const logic_expr *expr, int slot);
+
+/**
+ * @brief avalia a expressão para uma atribuição
+ *
+ * @param expr expressão compilada
+ * @param values valor de cada slot (0 ou diferente de 0)
+ * @return int 0 ou 1, ou -1 em falha de alocação
+ */
+int logic_evaluate(const logic_expr *expr, const unsigned char *values);
+
+/**
+ * @brief classifica a expressão sem enumerar a tabela (ver classify_program)
+ *
+ * @param expr expressão compilada
+ * @param result classificação (liberar com free_classification)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int logic_classify(const logic_expr *expr, classification *result, error_status *status);
+
+/**
+ * @brief conta as linhas verdadeiras (ver count_models)
+ *
+ * @param expr expressão compilada
+ * @param threads threads da contagem empacotada (1 = serial)
+ * @param count recebe a contagem (inicializado pelo chamador)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int logic_count(const logic_expr *expr, int threads, bignum *count, error_status *status);
+
+/**
+ * @brief entrega os resultados das linhas em palavras de 64 linhas
+ *
+ * o bit r da palavra b é o resultado da linha b * 64 + r; a função é chamada
+ * com janelas consecutivas, na thread chamadora
+ *
+ * @param expr expressão compilada (até MAX_TABLE_VARS variáveis)
+ * @param first_block primeira palavra
+ * @param count palavras a entregar (first_block + count no máximo o total da tabela)
+ * @param sink destino das palavras
+ * @param ctx contexto repassado a 'sink'
+ * @param status recebe ERR_INTERRUPTED se 'sink' pedir para parar
+ * @return int 1 se todas as palavras foram entregues, 0 caso contrário
+ */
+int logic_table_blocks(const logic_expr *expr, uint64_t first_block, uint64_t count, logic_block_sink sink,
+                       void *ctx, error_status *status);
+
+/**
+ * @brief entrega o texto da tabela verdade, idêntico ao da linha de comando
+ *
+ * o texto chega em trechos de até OUTPUT_BUFFER_SIZE bytes, na ordem, sempre
+ * na thread chamadora; 'threads' só divide a formatação
+ *
+ * @param expr expressão compilada (até MAX_TABLE_VARS variáveis)
+ * @param reverse_order ordem das linhas (0 = normal, 1 = invertida)
+ * @param threads threads da formatação (1 = serial)
+ * @param sink destino do texto
+ * @param ctx contexto repassado a 'sink'
+ * @param status recebe ERR_INTERRUPTED se 'sink' pedir para parar
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int logic_table_text(const logic_expr *expr, int reverse_order, int threads, logic_text_sink sink, void *ctx,
+                     error_status *status);
+
+/// @brief cursor sobre as linhas de uma expressão compilada (opaco)
+///
+/// guarda só a posição e a palavra de 64 linhas da posição atual: a memória
+/// não depende do número de variáveis e qualquer linha é alcançada em O(1).
+/// um cursor pertence a uma thread; vários cursores podem percorrer a mesma
+/// expressão ao mesmo tempo
+typedef struct logic_cursor logic_cursor;
+
+#define LOGIC_CURSOR_TEXT 64 ///< bytes suficientes para o texto de logic_cursor_save, com o '\0'
+
+/**
+ * @brief cria um cursor na linha 0 da tabela
+ *
+ * @param expr expressão compilada (até MAX_TABLE_VARS variáveis); deve existir enquanto o cursor existir
+ * @param status ponteiro para estrutura de status de erro
+ * @return logic_cursor* cursor ou NULL em caso de erro
+ */
+logic_cursor *logic_cursor_open(const logic_expr *expr, error_status *status);
+
+/**
+ * @brief libera o cursor
+ *
+ * @param cursor cursor (NULL é aceito)
+ */
+void logic_cursor_close(logic_cursor *cursor);
+
+/**
+ * @brief número de linhas da tabela (2^n)
+ *
+ * @param cursor cursor
+ * @return uint64_t linhas
+ */
+uint64_t logic_cursor_rows(const logic_cursor *cursor);
+
+/**
+ * @brief posição atual: a próxima linha entregue
+ *
+ * @param cursor cursor
+ * @return uint64_t índice da linha (igual a logic_cursor_rows no fim da tabela)
+ */
+uint64_t logic_cursor_tell(const logic_cursor *cursor);
+
+/**
+ * @brief move o cursor para uma linha, sem avaliar nada antes dela
+ *
+ * @param cursor cursor
+ * @param row índice da linha (logic_cursor_rows = fim da tabela)
+ * @param status recebe ERR_INVALID_ARGUMENT além do fim
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int logic_cursor_seek(logic_cursor *cursor, uint64_t row, error_status *status);
+
+/**
+ * @brief entrega a linha da posição atual e avança uma linha
+ *
+ * @param cursor cursor
+ * @param values recebe o valor de cada slot na linha (NULL = não recebe)
+ * @param result recebe o resultado da linha (0 ou 1)
+ * @return int 1 se entregou uma linha, 0 no fim da tabela
+ */
+int logic_cursor_next_row(logic_cursor *cursor, unsigned char *values, int *result);
+
+/**
+ * @brief entrega a palavra de 64 linhas da posição atual e avança até o fim dela
+ *
+ * o bit r de 'word' é o resultado da linha first_row + r; 'valid' marca as
+ * linhas entregues agora: a partir da posição atual (a primeira palavra de um
+ * cursor fora do alinhamento vem parcial) e antes do fim da tabela
+ *
+ * @param cursor cursor
+ * @param first_row recebe a primeira linha da palavra (múltiplo de 64)
+ * @param word recebe os resultados
+ * @param valid recebe a máscara das linhas entregues
+ * @return int 1 se entregou uma palavra, 0 no fim da tabela
+ */
+int logic_cursor_next_block(logic_cursor *cursor, uint64_t *first_row, uint64_t *word, uint64_t *valid);
+
+/**
+ * @brief grava a posição em texto, para retomar o percurso em outra execução
+ *
+ * o texto leva uma assinatura do programa compilado; logic_cursor_restore
+ * recusa a posição de outra expressão
+ *
+ * @param cursor cursor
+ * @param text destino com pelo menos LOGIC_CURSOR_TEXT bytes
+ * @param size tamanho de 'text'
+ * @return int 1 em caso de sucesso, 0 se 'size' não basta
+ */
+int logic_cursor_save(const logic_cursor *cursor, char *text, size_t size);
+
+/**
+ * @brief retoma uma posição gravada por logic_cursor_save
+ *
+ * @param cursor cursor da mesma expressão
+ * @param text texto gravado
+ * @param status recebe ERR_INVALID_ARGUMENT para texto malformado, de outra expressão ou além do fim
+ * @return int 1 em caso de sucesso, 0 caso contrário (a posição não muda)
+ */
+int logic_cursor_restore(logic_cursor *cursor, const char *text, error_status *status);
+
+#endif // LOGIC_H
@@ -0,0 +1,883 @@
+#include "minimize.h"
+#include "bitslice.h"
+#include "simd.h"
+#include "parallel.h"
+#include "eval.h"
+
+#define MINIMIZE_CHUNK_WORDS 16384    // palavras da tabela por pedaço dividido entre as threads
+#define MINIMIZE_SEARCH_ROWS 4096     // busca exata da cobertura só com até tantas linhas sem primo essencial
+#define MINIMIZE_SEARCH_WORK 20000000 // limite de linhas visitadas pela busca exata
+#define MINIMIZE_PASSES 4             // rodadas reduzir/expandir/remover do heurístico
+#define COUNT_SATURATED UINT16_MAX    // contagem de cobertura que deixou de ser exata
+
+// linhas com o bit p do índice em zero, dentro de uma palavra
+static const uint64_t zero_bit_mask[6] = {
+    0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+    0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL
+};
+
+// passos da compressão: sequências de 2^t bits em posições 0 e 2*2^t de cada bloco de 4*2^t
+static const uint64_t run_low[5] = {
+    0x1111111111111111ULL, 0x0303030303030303ULL, 0x000F000F000F000FULL,
+    0x000000FF000000FFULL, 0x000000000000FFFFULL
+};
+static const uint64_t run_second[5] = {
+    0x2222222222222222ULL, 0x0C0C0C0C0C0C0C0CULL, 0x00F000F000F000F0ULL,
+    0x0000FF000000FF00ULL, 0x00000000FFFF0000ULL
+};
+
+static int literal_count(implicant c) {
+    return count_word_ones(c.care);
+}
+
+// custo de um termo na cobertura: primeiro o número de termos, depois o de literais
+static long term_cost(implicant c, int num_vars) {
+    return (long) num_vars + 1 + literal_count(c);
+}
+
+// espalha os bits de 'c' sobre as posições de 'mask', do menos significativo para o mais
+static uint32_t deposit_bits(uint32_t c, uint32_t mask) {
+    uint32_t result = 0;
+
+    for (uint32_t bit = 1; mask; bit <<= 1) {
+        uint32_t low = mask & (~mask + 1);
+        if (c & bit) result |= low;
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+// junta as posições com o bit p do índice em zero (válidas em 'x') nos 32 bits baixos
+static uint64_t squeeze_word(uint64_t x, int p) {
+    for (int t = p; t < 5; t++) x = (x & run_low[t]) | ((x >> (1 << t)) & run_second[t]);
+    return x;
+}
+
+// lista de cubos que cresce sob demanda
+typedef struct {
+    implicant *items;
+    int count;
+    int capacity;
+} cube_list;
+
+static int cube_list_push(cube_list *list, implicant c) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        implicant *grown = realloc(list->items, sizeof(implicant) * capacity);
+        if (!grown) return 0;
+        list->items = grown;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = c;
+    return 1;
+}
+
+// --- implicantes primos (Quine-McCluskey sobre conjuntos de bits) ---
+
+/*
+ * junta os implicantes com os traços 'dashes' (conjunto 'set', indexado pelos
+ * bits livres comprimidos) aos pares que diferem só no bit livre de posição p.
+ * 'covered' recebe os implicantes que entraram em algum par; 'merged', se não
+ * for NULL, recebe os implicantes resultantes, com o bit p removido do índice
+ */
+static void merge_pairs(const uint64_t *set, int free_bits, int p, uint64_t *covered, uint64_t *merged) {
+    if (free_bits <= 6) {
+        uint64_t j = set[0] & (set[0] >> (1 << p)) & zero_bit_mask[p];
+        covered[0] |= j | (j << (1 << p));
+        if (merged) merged[0] = squeeze_word(j, p);
+        return;
+    }
+
+    uint64_t words = 1ULL << (free_bits - 6);
+    if (p >= 6) {
+        // o par está em outra palavra, 2^(p-6) adiante
+        uint64_t stride = 1ULL << (p - 6);
+        for (uint64_t w = 0; w < words; w++) {
+            if (w & stride) continue;
+            uint64_t j = set[w] & set[w | stride];
+            covered[w] |= j;
+            covered[w | stride] |= j;
+            if (merged) merged[(w & (stride - 1)) | ((w >> 1) & ~(stride - 1))] = j;
+        }
+    } else {
+        for (uint64_t w = 0; w < words; w++) {
+            uint64_t j = set[w] & (set[w] >> (1 << p)) & zero_bit_mask[p];
+            covered[w] |= j | (j << (1 << p));
+            if (merged) {
+                uint64_t half = squeeze_word(j, p);
+                if (w & 1) merged[w >> 1] |= half << 32;
+                else merged[w >> 1] = half;
+            }
+        }
+    }
+}
+
+/*
+ * gera todos os implicantes primos. o nível k guarda, para cada conjunto d de
+ * k variáveis ausentes, um bit por atribuição das outras n - k: o cubo é
+ * implicante se as suas 2^k linhas são verdadeiras. o nível k + 1 sai do
+ * nível k em operações de palavra inteira, e o que não se junta a nada é primo
+ */
+static int prime_implicants(const uint64_t *table, int n, cube_list *primes) {
+    uint32_t full = (1u << n) - 1;
+    uint64_t masks = 1ULL << n;
+    uint64_t table_words = n > 6 ? 1ULL << (n - 6) : 1;
+    uint64_t **level = calloc(masks, sizeof(uint64_t *));
+    uint64_t *covered = malloc(sizeof(uint64_t) * table_words);
+    uint64_t *merged = malloc(sizeof(uint64_t) * table_words);
+    int ok = level && covered && merged;
+
+    // nível 0: os mintermos, o próprio bitmap
+    if (ok && (level[0] = malloc(sizeof(uint64_t) * table_words))) {
+        memcpy(level[0], table, sizeof(uint64_t) * table_words);
+        if (n < 6) level[0][0] &= (1ULL << (1u << n)) - 1;
+    } else {
+        ok = 0;
+    }
+
+    for (int k = 0; ok && k <= n; k++) {
+        int free_bits = n - k;
+        uint64_t words = free_bits > 6 ? 1ULL << (free_bits - 6) : 1;
+        uint64_t next_words = free_bits - 1 > 6 ? 1ULL << (free_bits - 7) : 1;
+
+        for (uint64_t d = 0; ok && d < masks; d++) {
+            uint64_t *set = level[d];
+            if (!set || count_word_ones(d) != k) continue;
+
+            uint32_t free_mask = full & ~(uint32_t) d;
+            memset(covered, 0, sizeof(uint64_t) * words);
+
+            for (int v = 0; ok && v < n; v++) {
+                if (d & (1ULL << v)) continue;
+                int p = count_word_ones(free_mask & ((1u << v) - 1));
+
+                // o conjunto d + v é gerado uma vez, a partir do d sem o seu menor bit
+                int canonical = (d & ((2ULL << v) - 1)) == 0;
+                merge_pairs(set, free_bits, p, covered, canonical ? merged : NULL);
+                if (!canonical) continue;
+
+                int any = 0;
+                for (uint64_t w = 0; w < next_words; w++) any |= merged[w] != 0;
+                if (!any) continue;
+                level[d | (1ULL << v)] = malloc(sizeof(uint64_t) * next_words);
+                if (!level[d | (1ULL << v)]) ok = 0;
+                else memcpy(level[d | (1ULL << v)], merged, sizeof(uint64_t) * next_words);
+            }
+
+            // o que sobrou sem par é primo
+            for (uint64_t w = 0; ok && w < words; w++) {
+                uint64_t prime = set[w] & ~covered[w];
+                while (prime) {
+                    uint32_t c = (uint32_t) (w * 64 + (uint64_t) lowest_set_bit(prime));
+                    implicant cube = { free_mask, deposit_bits(c, free_mask) };
+                    if (!cube_list_push(primes, cube)) ok = 0;
+                    prime &= prime - 1;
+                }
+            }
+
+            free(set);
+            level[d] = NULL;
+        }
+    }
+
+    for (uint64_t d = 0; level && d < masks; d++) free(level[d]);
+    free(level);
+    free(covered);
+    free(merged);
+    return ok;
+}
+
+// --- cobertura exata ---
+
+// matriz de cobertura: linhas verdadeiras x primos, nos dois sentidos
+typedef struct {
+    int num_rows, num_primes;
+    int *row_start, *row_primes;   // primos que cobrem cada linha
+    int *prime_start, *prime_rows; // linhas cobertas por cada primo
+    long *cost;                    // custo de cada primo
+    int *cover;                    // primos escolhidos que cobrem cada linha
+} cover_matrix;
+
+// estado da busca exata sobre as linhas que sobraram depois dos essenciais
+typedef struct {
+    cover_matrix *m;
+    const int *rest;  // linhas a cobrir
+    int num_rest;
+    int *mark;        // último nó em que cada primo apareceu no limite inferior
+    int stamp;
+    int *chosen, depth;
+    int *best, best_len;
+    long best_cost;
+    long work;        // linhas visitadas até agora
+    int aborted;
+} cover_search;
+
+static void select_prime(cover_matrix *m, int p, int delta) {
+    for (int i = m->prime_start[p]; i < m->prime_start[p + 1]; i++) m->cover[m->prime_rows[i]] += delta;
+}
+
+/*
+ * ramifica pela linha descoberta com menos primos. o limite inferior soma o
+ * primo mais barato de linhas descobertas que não compartilham primos entre
+ * si: cada uma delas exige um termo diferente
+ */
+static void search_cover(cover_search *s, long cost) {
+    cover_matrix *m = s->m;
+    int pick = -1, fewest = 0;
+    long bound = 0;
+
+    if (s->aborted) return;
+    s->work += s->num_rest;
+    if (s->work > MINIMIZE_SEARCH_WORK) {
+        s->aborted = 1;
+        return;
+    }
+
+    s->stamp++;
+    for (int i = 0; i < s->num_rest; i++) {
+        int r = s->rest[i];
+        if (m->cover[r] != 0) continue;
+
+        int degree = m->row_start[r + 1] - m->row_start[r];
+        if (pick < 0 || degree < fewest) {
+            pick = r;
+            fewest = degree;
+        }
+
+        int independent = 1;
+        for (int j = m->row_start[r]; j < m->row_start[r + 1] && independent; j++)
+            independent = s->mark[m->row_primes[j]] != s->stamp;
+        if (!independent) continue;
+        for (int j = m->row_start[r]; j < m->row_start[r + 1]; j++) s->mark[m->row_primes[j]] = s->stamp;
+        bound += m->cost[m->row_primes[m->row_start[r]]];
+    }
+
+    if (pick < 0) {
+        if (cost < s->best_cost) {
+            s->best_cost = cost;
+            s->best_len = s->depth;
+            memcpy(s->best, s->chosen, sizeof(int) * s->depth);
+        }
+        return;
+    }
+    if (cost + bound >= s->best_cost) return;
+
+    for (int i = m->row_start[pick]; i < m->row_start[pick + 1] && !s->aborted; i++) {
+        int p = m->row_primes[i];
+        if (cost + m->cost[p] >= s->best_cost) continue;
+        select_prime(m, p, 1);
+        s->chosen[s->depth++] = p;
+        search_cover(s, cost + m->cost[p]);
+        s->depth--;
+        select_prime(m, p, -1);
+    }
+}
+
+static void free_cover_matrix(cover_matrix *m) {
+    free(m->row_start);
+    free(m->row_primes);
+    free(m->prime_start);
+    free(m->prime_rows);
+    free(m->cost);
+    free(m->cover);
+}
+
+// primos com menos literais primeiro: as listas de cada linha saem ordenadas pelo custo
+static int compare_literals(const void *a, const void *b) {
+    int la = literal_count(*(const implicant *) a), lb = literal_count(*(const implicant *) b);
+    return la - lb;
+}
+
+// 'primes' deve estar em ordem crescente de literais (compare_literals)
+static int build_cover_matrix(const uint64_t *table, int n, const cube_list *primes, int *row_of,
+                              cover_matrix *m) {
+    uint64_t rows = 1ULL << n;
+    long entries = 0;
+
+    memset(m, 0, sizeof(*m));
+    m->num_primes = primes->count;
+    for (uint64_t i = 0; i < rows; i++) row_of[i] = (table[i / 64] >> (i % 64)) & 1 ? m->num_rows++ : -1;
+    for (int p = 0; p < primes->count; p++) entries += 1L << (n - literal_count(primes->items[p]));
+
+    m->row_start = calloc((size_t) m->num_rows + 1, sizeof(int));
+    m->row_primes = malloc(sizeof(int) * (entries > 0 ? entries : 1));
+    m->prime_start = malloc(sizeof(int) * ((size_t) primes->count + 1));
+    m->prime_rows = malloc(sizeof(int) * (entries > 0 ? entries : 1));
+    m->cost = malloc(sizeof(long) * (primes->count > 0 ? primes->count : 1));
+    m->cover = calloc((size_t) m->num_rows + 1, sizeof(int));
+    if (!m->row_start || !m->row_primes || !m->prime_start || !m->prime_rows || !m->cost || !m->cover) {
+        free_cover_matrix(m);
+        return 0;
+    }
+
+    // linhas de cada primo: os subconjuntos das variáveis ausentes sobre o valor fixo
+    long at = 0;
+    for (int p = 0; p < primes->count; p++) {
+        implicant c = primes->items[p];
+        uint32_t dashes = ((1u << n) - 1) & ~c.care, sub = 0;
+
+        m->prime_start[p] = (int) at;
+        m->cost[p] = term_cost(c, n);
+        do {
+            int r = row_of[c.value | sub];
+            m->prime_rows[at++] = r;
+            m->row_start[r + 1]++;
+            sub = (sub - dashes) & dashes;
+        } while (sub);
+    }
+    m->prime_start[primes->count] = (int) at;
+
+    // transposta
+    for (int r = 0; r < m->num_rows; r++) m->row_start[r + 1] += m->row_start[r];
+    for (int p = 0; p < primes->count; p++)
+        for (int i = m->prime_start[p]; i < m->prime_start[p + 1]; i++)
+            m->row_primes[m->row_start[m->prime_rows[i]] + m->cover[m->prime_rows[i]]++] = p;
+    memset(m->cover, 0, sizeof(int) * m->num_rows);
+    return 1;
+}
+
+// heap de máximo dos primos pelo ganho, com o menor custo no empate
+typedef struct {
+    long gain;
+    int prime;
+} heap_entry;
+
+typedef struct {
+    heap_entry *items;
+    int count;
+    const long *cost;
+} gain_heap;
+
+static int heap_before(const gain_heap *h, heap_entry a, heap_entry b) {
+    if (a.gain != b.gain) return a.gain > b.gain;
+    if (h->cost[a.prime] != h->cost[b.prime]) return h->cost[a.prime] < h->cost[b.prime];
+    return a.prime < b.prime;
+}
+
+// o heap tem espaço para todos os primos: cada um está nele no máximo uma vez
+static void heap_push(gain_heap *h, long gain, int prime) {
+    int i = h->count++;
+    heap_entry e = { gain, prime };
+
+    while (i > 0 && heap_before(h, e, h->items[(i - 1) / 2])) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i] = e;
+}
+
+static heap_entry heap_pop(gain_heap *h) {
+    heap_entry top = h->items[0], last = h->items[--h->count];
+    int i = 0;
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= h->count) break;
+        if (child + 1 < h->count && heap_before(h, h->items[child + 1], h->items[child])) child++;
+        if (!heap_before(h, h->items[child], last)) break;
+        h->items[i] = h->items[child];
+        i = child;
+    }
+    if (h->count > 0) h->items[i] = last;
+    return top;
+}
+
+/*
+ * escolhe os primos: essenciais (únicos a cobrir alguma linha), depois uma
+ * cobertura gulosa sem termos redundantes e, se as linhas restantes forem
+ * poucas, a busca exata com o guloso como limite inicial
+ */
+static int cover_primes(const uint64_t *table, int n, cube_list *primes, cube_list *out, int *exact) {
+    int *row_of = malloc(sizeof(int) * ((size_t) 1 << n));
+    cover_matrix m;
+
+    if (primes->count > 1) qsort(primes->items, primes->count, sizeof(implicant), compare_literals);
+    int ok = row_of && build_cover_matrix(table, n, primes, row_of, &m);
+    free(row_of);
+    if (!ok) return 0;
+
+    unsigned char *selected = calloc(primes->count > 0 ? primes->count : 1, 1);
+    long *gain = malloc(sizeof(long) * (primes->count > 0 ? primes->count : 1));
+    int *rest = malloc(sizeof(int) * (m.num_rows > 0 ? m.num_rows : 1));
+    int num_rest = 0;
+    ok = selected && gain && rest;
+
+    // essenciais
+    for (int r = 0; ok && r < m.num_rows; r++) {
+        if (m.row_start[r + 1] - m.row_start[r] != 1) continue;
+        int p = m.row_primes[m.row_start[r]];
+        if (!selected[p]) {
+            selected[p] = 1;
+            select_prime(&m, p, 1);
+        }
+    }
+    for (int r = 0; ok && r < m.num_rows; r++)
+        if (m.cover[r] == 0) rest[num_rest++] = r;
+
+    // guloso: o primo que cobre mais linhas descobertas, com menos literais no empate; os
+    // ganhos só diminuem, então o heap guarda ganhos antigos e confere cada um ao sair
+    gain_heap heap = { malloc(sizeof(heap_entry) * (primes->count > 0 ? primes->count : 1)), 0, m.cost };
+    int *greedy = malloc(sizeof(int) * (num_rest > 0 ? num_rest : 1));
+    int greedy_len = 0;
+    ok = ok && heap.items && greedy;
+    for (int p = 0; ok && p < primes->count; p++) {
+        gain[p] = 0;
+        for (int i = m.prime_start[p]; i < m.prime_start[p + 1]; i++) gain[p] += m.cover[m.prime_rows[i]] == 0;
+        if (gain[p] > 0) heap_push(&heap, gain[p], p);
+    }
+    for (long uncovered = num_rest; ok && uncovered > 0; ) {
+        heap_entry top = heap_pop(&heap);
+        int best = top.prime;
+        if (top.gain != gain[best]) {
+            if (gain[best] > 0) heap_push(&heap, gain[best], best);
+            continue;
+        }
+
+        for (int i = m.prime_start[best]; i < m.prime_start[best + 1]; i++) {
+            int r = m.prime_rows[i];
+            if (m.cover[r]++ == 0) {
+                uncovered--;
+                for (int j = m.row_start[r]; j < m.row_start[r + 1]; j++) gain[m.row_primes[j]]--;
+            }
+        }
+        greedy[greedy_len++] = best;
+    }
+    free(heap.items);
+
+    // remove do guloso os termos cujas linhas os outros já cobrem, dos escolhidos por
+    // último (menor ganho) para os primeiros
+    for (int g = greedy_len - 1; ok && g >= 0; g--) {
+        int p = greedy[g], redundant = 1;
+        for (int i = m.prime_start[p]; i < m.prime_start[p + 1] && redundant; i++)
+            redundant = m.cover[m.prime_rows[i]] > 1;
+        if (!redundant) continue;
+        select_prime(&m, p, -1);
+        greedy[g] = -1;
+    }
+
+    long greedy_cost = 0;
+    int kept = 0;
+    for (int g = 0; ok && g < greedy_len; g++) {
+        if (greedy[g] < 0) continue;
+        greedy_cost += m.cost[greedy[g]];
+        greedy[kept++] = greedy[g];
+    }
+    greedy_len = kept;
+
+    // busca exata: começa do guloso e só aceita coberturas mais baratas
+    *exact = num_rest == 0;
+    if (ok && num_rest > 0 && num_rest <= MINIMIZE_SEARCH_ROWS) {
+        cover_search s = { &m, rest, num_rest, NULL, 0, NULL, 0, NULL, 0, greedy_cost + 1, 0, 0 };
+        s.mark = calloc(primes->count, sizeof(int));
+        s.chosen = malloc(sizeof(int) * num_rest);
+        s.best = malloc(sizeof(int) * num_rest);
+        ok = s.mark && s.chosen && s.best;
+
+        for (int g = 0; ok && g < greedy_len; g++) select_prime(&m, greedy[g], -1);
+        if (ok) search_cover(&s, 0);
+
+        if (ok && s.best_cost <= greedy_cost) {
+            memcpy(greedy, s.best, sizeof(int) * s.best_len);
+            greedy_len = s.best_len;
+        }
+        *exact = ok && !s.aborted;
+        free(s.mark);
+        free(s.chosen);
+        free(s.best);
+    }
+
+    for (int g = 0; ok && g < greedy_len; g++) selected[greedy[g]] = 1;
+    for (int p = 0; ok && p < primes->count; p++)
+        if (selected[p]) ok = cube_list_push(out, primes->items[p]);
+
+    free(greedy);
+    free(selected);
+    free(gain);
+    free(rest);
+    free_cover_matrix(&m);
+    return ok;
+}
+
+// --- heurístico no estilo Espresso ---
+
+// estado do heurístico: bitmap da função e quantos cubos cobrem cada linha
+typedef struct {
+    int n;
+    const uint64_t *table;
+    uint16_t *counts;
+    cube_list cover;
+} espresso_state;
+
+// linhas de uma palavra (bits 0-5 do índice) que concordam com o cubo
+static uint64_t low_pattern(implicant c) {
+    static const uint64_t bit_set[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    uint64_t pattern = ~0ULL;
+
+    for (int b = 0; b < 6; b++)
+        if (c.care & (1u << b)) pattern &= (c.value & (1u << b)) ? bit_set[b] : ~bit_set[b];
+    return pattern;
+}
+
+// percorre as palavras do cubo: subconjuntos das variáveis ausentes nos bits 6 em diante
+typedef struct {
+    uint32_t dashes, sub, base;
+    int done;
+} cube_words;
+
+static void cube_words_init(cube_words *it, int n, implicant c) {
+    it->dashes = ((1u << (n - 6)) - 1) & ~(c.care >> 6);
+    it->sub = 0;
+    it->base = c.value >> 6;
+    it->done = 0;
+}
+
+static int cube_words_next(cube_words *it, uint64_t *w) {
+    if (it->done) return 0;
+    *w = it->base | it->sub;
+    it->sub = (it->sub - it->dashes) & it->dashes;
+    it->done = it->sub == 0;
+    return 1;
+}
+
+// 1 se todas as linhas do cubo são verdadeiras
+static int cube_inside(const uint64_t *table, int n, implicant c) {
+    uint64_t pattern = low_pattern(c), w;
+    cube_words it;
+
+    for (cube_words_init(&it, n, c); cube_words_next(&it, &w); )
+        if ((table[w] & pattern) != pattern) return 0;
+    return 1;
+}
+
+// soma 'delta' à contagem de cobertura de cada linha do cubo
+static void count_cube(espresso_state *st, implicant c, int delta) {
+    uint64_t pattern = low_pattern(c), w;
+    cube_words it;
+
+    for (cube_words_init(&it, st->n, c); cube_words_next(&it, &w); ) {
+        uint16_t *row = st->counts + w * 64;
+        for (uint64_t bits = pattern; bits; bits &= bits - 1) {
+            uint16_t *count = row + lowest_set_bit(bits);
+            if (*count != COUNT_SATURATED) *count = (uint16_t) (*count + delta);
+        }
+    }
+}
+
+// 1 se todas as linhas do cubo são cobertas por pelo menos outro cubo
+static int cube_redundant(const espresso_state *st, implicant c) {
+    uint64_t pattern = low_pattern(c), w;
+    cube_words it;
+
+    for (cube_words_init(&it, st->n, c); cube_words_next(&it, &w); ) {
+        const uint16_t *row = st->counts + w * 64;
+        for (uint64_t bits = pattern; bits; bits &= bits - 1)
+            if (row[lowest_set_bit(bits)] < 2) return 0;
+    }
+    return 1;
+}
+
+// tira literais enquanto o cubo continuar dentro da função, começando pelo bit 'start'
+static implicant expand_cube(const uint64_t *table, int n, implicant c, int start) {
+    for (int t = 0; t < n; t++) {
+        uint32_t bit = 1u << ((start + t) % n);
+        if (!(c.care & bit)) continue;
+        implicant raised = { c.care & ~bit, c.value & ~bit };
+        if (cube_inside(table, n, raised)) c = raised;
+    }
+    return c;
+}
+
+// cubos com mais literais primeiro: são os que mais provavelmente sobram
+static int compare_size(const void *a, const void *b) {
+    int la = literal_count(*(const implicant *) a), lb = literal_count(*(const implicant *) b);
+    return lb - la;
+}
+
+// remove os cubos redundantes, dos menores para os maiores
+static void irredundant(espresso_state *st) {
+    int kept = 0;
+
+    if (st->cover.count > 1) qsort(st->cover.items, st->cover.count, sizeof(implicant), compare_size);
+    for (int i = 0; i < st->cover.count; i++) {
+        implicant c = st->cover.items[i];
+        if (cube_redundant(st, c)) count_cube(st, c, -1);
+        else st->cover.items[kept++] = c;
+    }
+    st->cover.count = kept;
+}
+
+// reduz cada cubo ao menor cubo com as linhas que só ele cobre e o expande em outra direção
+static void reduce_expand(espresso_state *st, int pass) {
+    int kept = 0;
+
+    for (int i = 0; i < st->cover.count; i++) {
+        implicant c = st->cover.items[i];
+        uint64_t pattern = low_pattern(c), w;
+        uint32_t all_and = ~0u, all_or = 0;
+        cube_words it;
+
+        for (cube_words_init(&it, st->n, c); cube_words_next(&it, &w); ) {
+            const uint16_t *row = st->counts + w * 64;
+            for (uint64_t bits = pattern; bits; bits &= bits - 1) {
+                int b = lowest_set_bit(bits);
+                if (row[b] != 1) continue;
+                uint32_t m = (uint32_t) (w * 64 + (uint64_t) b);
+                all_and &= m;
+                all_or |= m;
+            }
+        }
+
+        count_cube(st, c, -1);
+        if (all_or == 0 && all_and == ~0u) continue; // nenhuma linha só dele: sai da cobertura
+
+        uint32_t full = (1u << st->n) - 1;
+        implicant reduced = { full & ~(all_and ^ all_or), all_and };
+        c = expand_cube(st->table, st->n, reduced, (i + pass * 5 + 1) % st->n);
+        count_cube(st, c, 1);
+        st->cover.items[kept++] = c;
+    }
+    st->cover.count = kept;
+}
+
+static long cover_cost(const cube_list *cover, int n) {
+    long cost = 0;
+    for (int i = 0; i < cover->count; i++) cost += term_cost(cover->items[i], n);
+    return cost;
+}
+
+static int espresso(const uint64_t *table, int n, cube_list *out) {
+    uint64_t words = 1ULL << (n - 6);
+    uint64_t *covered = calloc(words, sizeof(uint64_t));
+    espresso_state st = { n, table, calloc((size_t) words * 64, sizeof(uint16_t)), { NULL, 0, 0 } };
+    int ok = covered && st.counts;
+
+    // cobertura inicial: cada linha ainda descoberta é expandida até um primo
+    for (uint64_t w = 0; ok && w < words; w++) {
+        uint64_t rest;
+        while (ok && (rest = table[w] & ~covered[w])) {
+            implicant c = { (1u << n) - 1, (uint32_t) (w * 64 + (uint64_t) lowest_set_bit(rest)) };
+            c = expand_cube(table, n, c, st.cover.count % n);
+            uint64_t pattern = low_pattern(c), cw;
+            cube_words it;
+            for (cube_words_init(&it, n, c); cube_words_next(&it, &cw); ) covered[cw] |= pattern;
+            count_cube(&st, c, 1);
+            ok = cube_list_push(&st.cover, c);
+        }
+    }
+    free(covered);
+
+    if (ok) irredundant(&st);
+
+    // reduz, expande e remove enquanto o custo cair, guardando a melhor cobertura
+    long best_cost = cover_cost(&st.cover, n);
+    for (int pass = 0; ok && pass < MINIMIZE_PASSES; pass++) {
+        cube_list before = { malloc(sizeof(implicant) * (st.cover.count > 0 ? st.cover.count : 1)),
+                             st.cover.count, st.cover.count };
+        if (!before.items) {
+            ok = 0;
+            break;
+        }
+        memcpy(before.items, st.cover.items, sizeof(implicant) * st.cover.count);
+
+        reduce_expand(&st, pass);
+        irredundant(&st);
+        long cost = cover_cost(&st.cover, n);
+        if (cost >= best_cost) {
+            free(st.cover.items);
+            st.cover = before;
+            break;
+        }
+        free(before.items);
+        best_cost = cost;
+    }
+
+    for (int i = 0; ok && i < st.cover.count; i++) ok = cube_list_push(out, st.cover.items[i]);
+    free(st.cover.items);
+    free(st.counts);
+    return ok;
+}
+
+// --- interface ---
+
+// ordem de saída: variáveis dos primeiros slots antes, positivos antes dos negados
+static int compare_terms(const void *a, const void *b) {
+    const implicant *x = a, *y = b;
+    if (x->care != y->care) return x->care > y->care ? -1 : 1;
+    if (x->value != y->value) return x->value > y->value ? -1 : 1;
+    return 0;
+}
+
+int minimize_table(const uint64_t *table, int num_vars, minimize_form form, minimized_formula *result,
+                   error_status *status) {
+    uint64_t words = num_vars > 6 ? 1ULL << (num_vars - 6) : 1;
+    uint64_t mask = num_vars < 6 ? (1ULL << (1u << num_vars)) - 1 : ~0ULL;
+    uint64_t *function = malloc(sizeof(uint64_t) * words);
+    cube_list primes = { NULL, 0, 0 }, cover = { NULL, 0, 0 };
+    int ok = function != NULL;
+
+    init_error_status(status);
+    memset(result, 0, sizeof(*result));
+    result->form = form;
+    result->num_vars = num_vars;
+
+    // o produto de somas é a negação da soma de produtos das linhas falsas
+    for (uint64_t w = 0; ok && w < words; w++) function[w] = (form == MINIMIZE_POS ? ~table[w] : table[w]) & mask;
+
+    if (ok && num_vars <= MINIMIZE_EXACT_VARS) {
+        ok = prime_implicants(function, num_vars, &primes) &&
+             cover_primes(function, num_vars, &primes, &cover, &result->exact);
+    } else if (ok) {
+        ok = espresso(function, num_vars, &cover);
+    }
+
+    free(function);
+    free(primes.items);
+    if (!ok) {
+        free(cover.items);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    if (cover.count > 1) qsort(cover.items, cover.count, sizeof(implicant), compare_terms);
+    result->terms = cover.items;
+    result->num_terms = cover.count;
+    if (cover.count == 0 || (cover.count == 1 && cover.items[0].care == 0)) result->exact = 1; // constante
+    for (int t = 0; t < cover.count; t++) result->literals += literal_count(cover.items[t]);
+    return 1;
+}
+
+// avalia um pedaço da tabela direto no bitmap
+typedef struct {
+    const program *prog;
+    uint64_t blocks;
+    uint64_t *table;
+    int *failed; // por trabalhador: 1 = falha de alocação ao avaliar
+} minimize_job;
+
+static void evaluate_table_chunk(void *ctx, int worker, uint64_t chunk) {
+    minimize_job *job = ctx;
+    uint64_t first = chunk * MINIMIZE_CHUNK_WORDS;
+    uint64_t count = job->blocks - first < MINIMIZE_CHUNK_WORDS ? job->blocks - first : MINIMIZE_CHUNK_WORDS;
+
+    if (!evaluate_blocks(job->prog, first, count, job->table + first)) job->failed[worker] = 1;
+}
+
+int minimize_program(const program *prog, minimize_form form, int threads, minimized_formula *result,
+                     error_status *status) {
+    init_error_status(status);
+    if (prog->num_vars > MINIMIZE_MAX_VARS) {
+        char detail[64];
+        sprintf(detail, "%d (maximo de %d)", prog->num_vars, MINIMIZE_MAX_VARS);
+        set_error(status, ERR_TOO_MANY_VARIABLES, -1, detail);
+        return 0;
+    }
+
+    uint64_t rows = 1ULL << prog->num_vars;
+    minimize_job job = { prog, (rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD, NULL, NULL };
+    uint64_t chunks = (job.blocks + MINIMIZE_CHUNK_WORDS - 1) / MINIMIZE_CHUNK_WORDS;
+    thread_pool *pool = threads > 1 && chunks > 1 ? thread_pool_create(threads) : NULL;
+    int workers = pool ? thread_pool_size(pool) : 1, ok = 1;
+
+    job.table = malloc(sizeof(uint64_t) * job.blocks);
+    job.failed = calloc(workers, sizeof(int));
+    if (!job.table || !job.failed) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        free(job.table);
+        free(job.failed);
+        thread_pool_destroy(pool);
+        return 0;
+    }
+
+    if (pool) thread_pool_run(pool, chunks, evaluate_table_chunk, &job);
+    else for (uint64_t c = 0; c < chunks && !job.failed[0]; c++) evaluate_table_chunk(&job, 0, c);
+    thread_pool_destroy(pool);
+
+    for (int w = 0; w < workers; w++)
+        if (job.failed[w]) ok = 0;
+    if (ok) ok = minimize_table(job.table, prog->num_vars, form, result, status);
+    else set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+
+    free(job.table);
+    free(job.failed);
+    return ok;
+}
+
+char *format_minimized(const minimized_formula *formula, char *const *var_names) {
+    int n = formula->num_vars;
+    int pos = formula->form == MINIMIZE_POS;
+    const char *inner = pos ? " | " : " & ";
+    const char *outer = pos ? " & " : " | ";
+    size_t names = 0;
+
+    for (int j = 0; j < n; j++) names += strlen(var_names[j]) + 4;
+    char *text = malloc(names * 2 + ((size_t) formula->num_terms + 1) * (names + 8) + 16);
+    if (!text) return NULL;
+
+    // constantes: sem termos (SOP falsa, POS verdadeira) ou um termo sem literais
+    int constant = formula->num_terms == 0 || formula->terms[0].care == 0;
+    if (constant) {
+        int value = (formula->num_terms == 0) == pos;
+        sprintf(text, "%s %s ~%s", var_names[0], value ? "|" : "&", var_names[0]);
+        return text;
+    }
+
+    size_t len = 0;
+    for (int t = 0; t < formula->num_terms; t++) {
+        implicant c = formula->terms[t];
+        int wrap = formula->num_terms > 1 && literal_count(c) > 1;
+        int first = 1;
+
+        if (t) len += sprintf(text + len, "%s", outer);
+        if (wrap) text[len++] = '(';
+        for (int j = 0; j < n; j++) {
+            uint32_t bit = 1u << (n - 1 - j);
+            if (!(c.care & bit)) continue;
+            // a cláusula do produto de somas nega o cubo da linha falsa
+            int positive = ((c.value & bit) != 0) != pos;
+            len += sprintf(text + len, "%s%s%s", first ? "" : inner, positive ? "" : "~", var_names[j]);
+            first = 0;
+        }
+        if (wrap) text[len++] = ')';
+    }
+    text[len] = '\0';
+    return text;
+}
+
+void free_minimized(minimized_formula *formula) {
+    free(formula->terms);
+    formula->terms = NULL;
+    formula->num_terms = 0;
+}
+
+void print_minimized(const char *expression, minimize_form form, int threads, FILE *out) {
+    error_status status;
+    program prog;
+    minimized_formula formula;
+
+    if (!out) out = stdout;
+
+    if (!parse_expression(expression, &prog, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return;
+    }
+
+    char *text = NULL;
+    int minimized = minimize_program(&prog, form, threads, &formula, &status);
+    if (minimized && !(text = format_minimized(&formula, prog.var_names)))
+        set_error(&status, ERR_MEMORY_ALLOCATION, -1, "");
+
+    if (text) {
+        fprintf(out, "%s: %s\n", expression, text);
+        fprintf(out, "  %d %s, %d literais (%s)\n", formula.num_terms, form == MINIMIZE_POS ? "clausulas" : "termos",
+                formula.literals, formula.exact ? "cobertura minima" : "heuristica");
+    } else {
+        fprintf(stderr, "Erro: %s\n", status.message);
+    }
+
+    if (minimized) free_minimized(&formula);
+    free(text);
+    free_program(&prog);
+}
@@ -0,0 +1,100 @@
+#ifndef MINIMIZE_H
+#define MINIMIZE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+#define MINIMIZE_MAX_VARS 24   ///< maior tabela minimizada (bitmap de 2^24 linhas)
+#define MINIMIZE_EXACT_VARS 16 ///< até aqui todos os implicantes primos são gerados (Quine-McCluskey)
+
+/// @brief forma da expressão minimizada
+typedef enum minimize_form {
+    MINIMIZE_SOP, ///< soma de produtos: disjunção de conjunções de literais
+    MINIMIZE_POS  ///< produto de somas: conjunção de disjunções de literais
+} minimize_form;
+
+/**
+ * @brief cubo: conjunção de literais sobre os bits do índice da linha
+ *
+ * o bit b corresponde à variável do slot num_vars - 1 - b, como na tabela
+ */
+typedef struct {
+    uint32_t care;  ///< bit b = a variável aparece no termo
+    uint32_t value; ///< bit b = valor exigido da variável (contido em 'care')
+} implicant;
+
+/// @brief expressão minimizada
+typedef struct {
+    minimize_form form; ///< forma da expressão
+    int num_vars;       ///< número de variáveis da tabela
+    int num_terms;      ///< número de termos
+    implicant *terms;   ///< SOP: cubos das linhas verdadeiras; POS: cubos das linhas falsas (cada um vira uma cláusula)
+    int literals;       ///< total de literais dos termos
+    int exact;          ///< 1 = cobertura mínima comprovada, 0 = resultado do heurístico
+} minimized_formula;
+
+/**
+ * @brief minimiza a função dada pelo bitmap da tabela verdade
+ *
+ * até MINIMIZE_EXACT_VARS variáveis os implicantes primos são gerados nível
+ * a nível (Quine-McCluskey) com um conjunto de bits por combinação de
+ * variáveis ausentes, e a cobertura sai dos primos essenciais mais uma busca
+ * exata limitada (ou gulosa, quando a busca não cabe). acima disso um
+ * heurístico no estilo Espresso expande, reduz e remove cubos redundantes
+ * sobre o bitmap. o produto de somas é a soma de produtos das linhas falsas
+ *
+ * @param table bitmap das linhas: a linha i é o bit (i % 64) da palavra i / 64
+ * @param num_vars número de variáveis (1 a MINIMIZE_MAX_VARS)
+ * @param form forma desejada
+ * @param result expressão de saída (liberar com free_minimized)
+ * @param status recebe o erro de memória
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int minimize_table(const uint64_t *table, int num_vars, minimize_form form, minimized_formula *result,
+                   error_status *status);
+
+/**
+ * @brief avalia a tabela do programa com o núcleo empacotado e a minimiza
+ *
+ * @param prog programa compilado (até MINIMIZE_MAX_VARS variáveis)
+ * @param form forma desejada
+ * @param threads threads da avaliação da tabela (1 = serial)
+ * @param result expressão de saída (liberar com free_minimized)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int minimize_program(const program *prog, minimize_form form, int threads, minimized_formula *result,
+                     error_status *status);
+
+/**
+ * @brief texto da expressão minimizada, aceito de volta pelo leitor de expressões
+ *
+ * funções constantes saem como "a & ~a" ou "a | ~a" com a primeira variável
+ *
+ * @param formula expressão minimizada
+ * @param var_names nome de cada slot
+ * @return char* string alocada (liberar com free) ou NULL em falha de alocação
+ */
+char *format_minimized(const minimized_formula *formula, char *const *var_names);
+
+/**
+ * @brief libera os termos da expressão minimizada
+ *
+ * @param formula expressão preenchida por minimize_table ou minimize_program
+ */
+void free_minimized(minimized_formula *formula);
+
+/**
+ * @brief minimiza uma expressão e imprime "expressao: minimizada" com o tamanho do resultado
+ *
+ * @param expression string contendo a expressão lógica
+ * @param form forma desejada
+ * @param threads threads da avaliação da tabela
+ * @param out destino (NULL = stdout)
+ */
+void print_minimized(const char *expression, minimize_form form, int threads, FILE *out);
+
+#endif // MINIMIZE_H
@@ -0,0 +1,188 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "output.h"
+#include "stats.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+int writer_init(output_writer *writer, FILE *file) {
+    memset(writer, 0, sizeof(*writer));
+    writer->file = file;
+    writer->fd = -1;
+    writer->capacity = OUTPUT_BUFFER_SIZE;
+    writer->buffer = malloc(writer->capacity);
+    return writer->buffer != NULL;
+}
+
+int writer_init_sink(output_writer *writer, output_sink sink, void *ctx) {
+    if (!writer_init(writer, NULL)) return 0;
+    writer->sink = sink;
+    writer->sink_ctx = ctx;
+    return 1;
+}
+
+int writer_init_mapped(output_writer *writer, const char *path, size_t total_size) {
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = -1;
+
+#ifdef _WIN32
+    (void) path; (void) total_size;
+    return 0; // sem mapeamento: o chamador usa o modo bufferizado
+#else
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return 0;
+
+    if (total_size == 0 || ftruncate(fd, (off_t) total_size) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+
+    writer->map = map;
+    writer->map_size = total_size;
+    writer->fd = fd;
+    return 1;
+#endif
+}
+
+// grava o conteúdo pendente do buffer com uma única chamada
+void writer_flush(output_writer *writer) {
+    if (writer->map || writer->used == 0) return;
+    STATS_BEGIN(start);
+    if (writer->sink) {
+        if (!writer->failed && !writer->sink(writer->sink_ctx, writer->buffer, writer->used)) writer->failed = 1;
+    } else if (fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+        writer->failed = 1;
+    }
+    writer->used = 0;
+    STATS_END(STATS_WRITE, start);
+}
+
+char *writer_reserve(output_writer *writer, size_t size) {
+    if (writer->map) {
+        if (writer->map_used + size > writer->map_size) {
+            writer->failed = 1;
+            return NULL;
+        }
+        return writer->map + writer->map_used;
+    }
+
+    if (writer->used + size > writer->capacity) writer_flush(writer);
+
+    // reservas maiores que o buffer fazem o buffer crescer
+    if (size > writer->capacity) {
+        char *grown = realloc(writer->buffer, size);
+        if (!grown) {
+            writer->failed = 1;
+            return NULL;
+        }
+        writer->buffer = grown;
+        writer->capacity = size;
+    }
+
+    return writer->buffer + writer->used;
+}
+
+void writer_commit(output_writer *writer, size_t size) {
+    STATS_ADD(STATS_BYTES, size);
+    if (writer->map) {
+        writer->map_used += size;
+    } else {
+        writer->used += size;
+    }
+}
+
+void writer_put(output_writer *writer, const char *data, size_t size) {
+    char *dst = writer_reserve(writer, size);
+    if (!dst) return;
+
+    memcpy(dst, data, size);
+    writer_commit(writer, size);
+}
+
+int writer_close(output_writer *writer) {
+    STATS_BEGIN(start);
+    if (writer->map) {
+#ifndef _WIN32
+        if (writer->map_used != writer->map_size) writer->failed = 1;
+        if (munmap(writer->map, writer->map_size) != 0) writer->failed = 1;
+        if (close(writer->fd) != 0) writer->failed = 1;
+#endif
+        writer->map = NULL;
+    } else if (writer->sink) {
+        writer_flush(writer);
+    } else if (writer->file) {
+        writer_flush(writer);
+        if (fflush(writer->file) != 0) writer->failed = 1;
+    }
+
+    STATS_END(STATS_WRITE, start);
+
+    free(writer->buffer);
+    writer->buffer = NULL;
+    return !writer->failed;
+}
+
+int row_template_init(row_template *tmpl, int num_vars, char *const *names) {
+    tmpl->num_vars = num_vars;
+    tmpl->length = 3;
+    for (int j = 0; j < num_vars; j++)
+        tmpl->length += (names ? strlen(names[j]) : 1) + 3;
+
+    tmpl->text = malloc(tmpl->length);
+    tmpl->column_pos = malloc(sizeof(size_t) * ((size_t) num_vars + 1));
+    if (!tmpl->text || !tmpl->column_pos) {
+        row_template_free(tmpl);
+        return 0;
+    }
+
+    // " F |" por variável (com espaços até a largura do nome) seguido de " F\n" para o resultado
+    char *p = tmpl->text;
+    for (int j = 0; j < num_vars; j++) {
+        size_t width = names ? strlen(names[j]) : 1;
+        *p++ = ' ';
+        tmpl->column_pos[j] = (size_t) (p - tmpl->text);
+        *p++ = 'F';
+        memset(p, ' ', width);
+        p += width;
+        *p++ = '|';
+    }
+    tmpl->column_pos[num_vars] = (size_t) (p - tmpl->text) + 1;
+    memcpy(p, " F\n", 3);
+    tmpl->row = 0;
+    return 1;
+}
+
+void row_template_set(row_template *tmpl, long long row, int result) {
+    // só as colunas cujos bits mudaram em relação à linha anterior são reescritas
+    unsigned long long changed = (unsigned long long) (row ^ tmpl->row);
+
+    while (changed) {
+        int bit = 0;
+        while (!((changed >> bit) & 1)) bit++;
+        changed &= changed - 1;
+
+        int column = tmpl->num_vars - bit - 1;
+        tmpl->text[tmpl->column_pos[column]] = ((row >> bit) & 1) ? 'V' : 'F';
+    }
+
+    tmpl->text[tmpl->column_pos[tmpl->num_vars]] = result ? 'V' : 'F';
+    tmpl->row = row;
+}
+
+void row_template_free(row_template *tmpl) {
+    free(tmpl->text);
+    free(tmpl->column_pos);
+    tmpl->text = NULL;
+    tmpl->column_pos = NULL;
+}
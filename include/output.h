@@ -0,0 +1,146 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define OUTPUT_BUFFER_SIZE (1 << 20) ///< tamanho padrão do buffer de saída (1 MiB)
+
+/// @brief função que recebe cada trecho do buffer (modo com função de destino); 0 = parar
+typedef int (*output_sink)(void *ctx, const char *data, size_t size);
+
+/// @brief destino da tabela: buffer grande reutilizável, arquivo mapeado em memória ou função
+typedef struct {
+    FILE *file;      ///< destino do modo bufferizado (NULL no modo mapeado)
+    char *buffer;    ///< buffer de saída do modo bufferizado
+    size_t capacity; ///< capacidade do buffer
+    size_t used;     ///< bytes pendentes no buffer
+
+    output_sink sink; ///< destino do modo com função (NULL = grava em 'file')
+    void *sink_ctx;   ///< contexto repassado a 'sink'
+
+    char *map;       ///< região mapeada do arquivo (NULL no modo bufferizado)
+    size_t map_size; ///< tamanho total do arquivo mapeado
+    size_t map_used; ///< bytes já escritos na região mapeada
+    int fd;          ///< descritor do arquivo mapeado
+
+    int failed;      ///< 1 se alguma escrita falhou
+} output_writer;
+
+/// @brief linha da tabela pré-formatada (" V | F | ... | V\n") atualizada por diferença
+typedef struct {
+    char *text;          ///< texto da linha corrente
+    size_t length;       ///< tamanho da linha em bytes
+    size_t *column_pos;  ///< posição do V/F de cada coluna (a última é o resultado)
+    int num_vars;        ///< número de colunas de variáveis
+    long long row;       ///< linha cujos valores de variáveis estão em 'text'
+} row_template;
+
+/**
+ * @brief inicializa um escritor bufferizado sobre um FILE
+ *
+ * @param writer escritor a inicializar
+ * @param file destino (por exemplo stdout)
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int writer_init(output_writer *writer, FILE *file);
+
+/**
+ * @brief inicializa um escritor bufferizado que entrega o buffer a uma função
+ *
+ * cada descarga chama 'sink' uma vez; se ela retornar 0 a escrita é marcada
+ * como falha e os trechos seguintes são descartados
+ *
+ * @param writer escritor a inicializar
+ * @param sink função de destino
+ * @param ctx contexto repassado a 'sink'
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int writer_init_sink(output_writer *writer, output_sink sink, void *ctx);
+
+/**
+ * @brief inicializa um escritor que grava direto em um arquivo mapeado em memória
+ *
+ * o arquivo é criado (ou truncado) com exatamente 'total_size' bytes
+ *
+ * @param writer escritor a inicializar
+ * @param path caminho do arquivo de saída
+ * @param total_size tamanho final do arquivo
+ * @return int 1 em caso de sucesso, 0 se o mapeamento não for possível nesta plataforma
+ */
+int writer_init_mapped(output_writer *writer, const char *path, size_t total_size);
+
+/**
+ * @brief reserva 'size' bytes contíguos para escrita direta
+ *
+ * o conteúdo só é considerado escrito após writer_commit
+ *
+ * @param writer escritor
+ * @param size número de bytes
+ * @return char* ponteiro para a área reservada ou NULL em caso de falha
+ */
+char *writer_reserve(output_writer *writer, size_t size);
+
+/**
+ * @brief confirma 'size' bytes escritos na última área reservada
+ *
+ * @param writer escritor
+ * @param size número de bytes efetivamente escritos
+ */
+void writer_commit(output_writer *writer, size_t size);
+
+/**
+ * @brief copia 'size' bytes para a saída
+ *
+ * @param writer escritor
+ * @param data dados a escrever
+ * @param size número de bytes
+ */
+void writer_put(output_writer *writer, const char *data, size_t size);
+
+/**
+ * @brief grava o conteúdo pendente do buffer no FILE (sem efeito no modo mapeado)
+ *
+ * permite intercalar escritas diretas no mesmo FILE sem perder a ordem
+ *
+ * @param writer escritor
+ */
+void writer_flush(output_writer *writer);
+
+/**
+ * @brief descarrega o buffer e libera os recursos do escritor
+ *
+ * @param writer escritor
+ * @return int 1 se todas as escritas foram bem-sucedidas, 0 caso contrário
+ */
+int writer_close(output_writer *writer);
+
+/**
+ * @brief prepara o modelo de linha para uma tabela com 'num_vars' variáveis
+ *
+ * cada coluna tem a largura do nome da variável, alinhada com o cabeçalho
+ *
+ * @param tmpl modelo a inicializar
+ * @param num_vars número de variáveis
+ * @param names nomes das variáveis (NULL = colunas de uma letra)
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int row_template_init(row_template *tmpl, int num_vars, char *const *names);
+
+/**
+ * @brief atualiza o modelo para a linha 'row', reescrevendo apenas os bytes V/F que mudaram
+ *
+ * @param tmpl modelo de linha
+ * @param row índice da linha (bits das variáveis)
+ * @param result resultado da expressão na linha
+ */
+void row_template_set(row_template *tmpl, long long row, int result);
+
+/**
+ * @brief libera o modelo de linha
+ *
+ * @param tmpl modelo de linha
+ */
+void row_template_free(row_template *tmpl);
+
+#endif // OUTPUT_H
@@ -0,0 +1,283 @@
+#include <stdlib.h>
+
+#include "parallel.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+
+typedef SRWLOCK pool_mutex;
+typedef CONDITION_VARIABLE pool_cond;
+typedef HANDLE pool_thread;
+
+static void mutex_init(pool_mutex *m)    { InitializeSRWLock(m); }
+static void mutex_destroy(pool_mutex *m) { (void) m; }
+static void mutex_lock(pool_mutex *m)    { AcquireSRWLockExclusive(m); }
+static void mutex_unlock(pool_mutex *m)  { ReleaseSRWLockExclusive(m); }
+static void cond_init(pool_cond *c)      { InitializeConditionVariable(c); }
+static void cond_destroy(pool_cond *c)   { (void) c; }
+static void cond_wait(pool_cond *c, pool_mutex *m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static void cond_broadcast(pool_cond *c) { WakeAllConditionVariable(c); }
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t pool_mutex;
+typedef pthread_cond_t pool_cond;
+typedef pthread_t pool_thread;
+
+static void mutex_init(pool_mutex *m)    { pthread_mutex_init(m, NULL); }
+static void mutex_destroy(pool_mutex *m) { pthread_mutex_destroy(m); }
+static void mutex_lock(pool_mutex *m)    { pthread_mutex_lock(m); }
+static void mutex_unlock(pool_mutex *m)  { pthread_mutex_unlock(m); }
+static void cond_init(pool_cond *c)      { pthread_cond_init(c, NULL); }
+static void cond_destroy(pool_cond *c)   { pthread_cond_destroy(c); }
+static void cond_wait(pool_cond *c, pool_mutex *m) { pthread_cond_wait(c, m); }
+static void cond_broadcast(pool_cond *c) { pthread_cond_broadcast(c); }
+#endif
+
+// faixa de pedaços pendentes de um trabalhador: [next, end)
+typedef struct {
+    pool_mutex lock;
+    uint64_t next;
+    uint64_t end;
+    int stopped; // thread_pool_stop esvaziou a faixa: nada roubado entra nela
+} work_range;
+
+struct thread_pool;
+
+// argumento de cada thread auxiliar
+typedef struct {
+    struct thread_pool *pool;
+    int index;
+} worker_arg;
+
+struct thread_pool {
+    int size;               // número de trabalhadores (inclui a thread chamadora)
+    pool_thread *threads;   // threads auxiliares (size - 1)
+    worker_arg *args;
+    work_range *ranges;     // uma faixa por trabalhador
+
+    pool_mutex lock;        // protege os campos abaixo
+    pool_cond wake;         // sinaliza novo trabalho ou encerramento
+    pool_cond done;         // sinaliza fim dos trabalhadores auxiliares
+    unsigned long generation; // incrementado a cada chamada de thread_pool_run
+    int active;             // trabalhadores auxiliares ainda ocupados
+    int shutdown;
+
+    chunk_fn fn;            // trabalho corrente
+    void *ctx;
+};
+
+int available_cores(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+#endif
+}
+
+// retira o próximo pedaço da própria faixa; retorna 0 se estiver vazia
+static int take_own(work_range *range, uint64_t *chunk) {
+    int found = 0;
+
+    mutex_lock(&range->lock);
+    if (range->next < range->end) {
+        *chunk = range->next++;
+        found = 1;
+    }
+    mutex_unlock(&range->lock);
+    return found;
+}
+
+// rouba a metade final da faixa de outro trabalhador para a própria faixa
+static int steal(thread_pool *pool, int self) {
+    for (int k = 1; k < pool->size; k++) {
+        work_range *victim = &pool->ranges[(self + k) % pool->size];
+        uint64_t lo = 0, hi = 0;
+
+        mutex_lock(&victim->lock);
+        uint64_t remaining = victim->end - victim->next;
+        if (remaining > 0) {
+            uint64_t stolen = (remaining + 1) / 2;
+            hi = victim->end;
+            lo = hi - stolen;
+            victim->end = lo;
+        }
+        mutex_unlock(&victim->lock);
+
+        if (hi > lo) {
+            work_range *own = &pool->ranges[self];
+            int stopped;
+            mutex_lock(&own->lock);
+            stopped = own->stopped;
+            if (!stopped) {
+                own->next = lo;
+                own->end = hi;
+            }
+            mutex_unlock(&own->lock);
+            return !stopped;
+        }
+    }
+    return 0;
+}
+
+// laço de um trabalhador: consome a própria faixa e rouba até não restar trabalho
+static void work(thread_pool *pool, int self) {
+    uint64_t chunk;
+
+    for (;;) {
+        while (take_own(&pool->ranges[self], &chunk))
+            pool->fn(pool->ctx, self, chunk);
+        if (!steal(pool, self)) break;
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall worker_main(void *p)
+#else
+static void *worker_main(void *p)
+#endif
+{
+    worker_arg *arg = p;
+    thread_pool *pool = arg->pool;
+    unsigned long seen = 0;
+
+    for (;;) {
+        mutex_lock(&pool->lock);
+        while (!pool->shutdown && pool->generation == seen)
+            cond_wait(&pool->wake, &pool->lock);
+        if (pool->shutdown) {
+            mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        mutex_unlock(&pool->lock);
+
+        work(pool, arg->index);
+
+        mutex_lock(&pool->lock);
+        if (--pool->active == 0) cond_broadcast(&pool->done);
+        mutex_unlock(&pool->lock);
+    }
+    return 0;
+}
+
+thread_pool *thread_pool_create(int threads) {
+    if (threads < 1) threads = 1;
+
+    thread_pool *pool = calloc(1, sizeof(thread_pool));
+    if (!pool) return NULL;
+
+    pool->size = threads;
+    pool->ranges = calloc(threads, sizeof(work_range));
+    pool->threads = calloc(threads, sizeof(pool_thread));
+    pool->args = calloc(threads, sizeof(worker_arg));
+    if (!pool->ranges || !pool->threads || !pool->args) {
+        free(pool->ranges);
+        free(pool->threads);
+        free(pool->args);
+        free(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) mutex_init(&pool->ranges[i].lock);
+    mutex_init(&pool->lock);
+    cond_init(&pool->wake);
+    cond_init(&pool->done);
+
+    // o trabalhador 0 é a thread que chama thread_pool_run
+    for (int i = 1; i < threads; i++) {
+        pool->args[i].pool = pool;
+        pool->args[i].index = i;
+#ifdef _WIN32
+        pool->threads[i] = (HANDLE) _beginthreadex(NULL, 0, worker_main, &pool->args[i], 0, NULL);
+        int failed = pool->threads[i] == 0;
+#else
+        int failed = pthread_create(&pool->threads[i], NULL, worker_main, &pool->args[i]) != 0;
+#endif
+        if (failed) {
+            pool->size = i; // encerra apenas as threads já criadas
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+int thread_pool_size(const thread_pool *pool) {
+    return pool->size;
+}
+
+void thread_pool_run(thread_pool *pool, uint64_t chunks, chunk_fn fn, void *ctx) {
+    if (chunks == 0) return;
+
+    // divide os pedaços em faixas contíguas, uma por trabalhador
+    for (int i = 0; i < pool->size; i++) {
+        pool->ranges[i].next = chunks * i / pool->size;
+        pool->ranges[i].end = chunks * (i + 1) / pool->size;
+        pool->ranges[i].stopped = 0;
+    }
+
+    pool->fn = fn;
+    pool->ctx = ctx;
+
+    if (pool->size > 1) {
+        mutex_lock(&pool->lock);
+        pool->active = pool->size - 1;
+        pool->generation++;
+        cond_broadcast(&pool->wake);
+        mutex_unlock(&pool->lock);
+    }
+
+    work(pool, 0);
+
+    if (pool->size > 1) {
+        mutex_lock(&pool->lock);
+        while (pool->active > 0)
+            cond_wait(&pool->done, &pool->lock);
+        mutex_unlock(&pool->lock);
+    }
+}
+
+void thread_pool_stop(thread_pool *pool) {
+    for (int i = 0; i < pool->size; i++) {
+        work_range *range = &pool->ranges[i];
+        mutex_lock(&range->lock);
+        range->end = range->next;
+        range->stopped = 1;
+        mutex_unlock(&range->lock);
+    }
+}
+
+void thread_pool_destroy(thread_pool *pool) {
+    if (!pool) return;
+
+    mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    cond_broadcast(&pool->wake);
+    mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->size; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+
+    for (int i = 0; i < pool->size; i++) mutex_destroy(&pool->ranges[i].lock);
+    mutex_destroy(&pool->lock);
+    cond_destroy(&pool->wake);
+    cond_destroy(&pool->done);
+
+    free(pool->ranges);
+    free(pool->threads);
+    free(pool->args);
+    free(pool);
+}
@@ -0,0 +1,69 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdint.h>
+
+/// @brief função executada para cada pedaço (chunk) de trabalho
+/// @param ctx contexto do usuário
+/// @param worker índice da thread que executa (0 = thread chamadora)
+/// @param chunk índice do pedaço
+typedef void (*chunk_fn)(void *ctx, int worker, uint64_t chunk);
+
+/// @brief pool de threads persistente com roubo de trabalho entre faixas de pedaços
+typedef struct thread_pool thread_pool;
+
+/**
+ * @brief número de núcleos disponíveis no sistema (no mínimo 1)
+ *
+ * @return int quantidade de processadores lógicos
+ */
+int available_cores(void);
+
+/**
+ * @brief cria um pool com 'threads' trabalhadores (a thread chamadora conta como um)
+ *
+ * @param threads número total de trabalhadores (>= 1)
+ * @return thread_pool* pool criado ou NULL em caso de falha
+ */
+thread_pool *thread_pool_create(int threads);
+
+/**
+ * @brief número de trabalhadores do pool
+ *
+ * @param pool pool de threads
+ * @return int quantidade de trabalhadores
+ */
+int thread_pool_size(const thread_pool *pool);
+
+/**
+ * @brief executa fn para cada pedaço 0..chunks-1 e aguarda o término
+ *
+ * cada trabalhador recebe uma faixa contígua de pedaços e consome do início;
+ * quando a sua faixa acaba, rouba a metade final da faixa de outro trabalhador
+ *
+ * @param pool pool de threads
+ * @param chunks número de pedaços
+ * @param fn função a executar por pedaço
+ * @param ctx contexto repassado a fn
+ */
+void thread_pool_run(thread_pool *pool, uint64_t chunks, chunk_fn fn, void *ctx);
+
+/**
+ * @brief descarta os pedaços ainda não iniciados da execução corrente
+ *
+ * chamada de dentro de fn quando o resultado já é conhecido (busca com
+ * parada antecipada); os pedaços em andamento terminam normalmente e
+ * thread_pool_run retorna assim que eles acabam
+ *
+ * @param pool pool de threads
+ */
+void thread_pool_stop(thread_pool *pool);
+
+/**
+ * @brief encerra os trabalhadores e libera o pool
+ *
+ * @param pool pool de threads (pode ser NULL)
+ */
+void thread_pool_destroy(thread_pool *pool);
+
+#endif // PARALLEL_H
@@ -0,0 +1,160 @@
+#include "partial.h"
+#include "dag.h"
+
+// slot da variável com o nome dado (nomes em ordem crescente) ou -1
+static int find_var(const program *prog, const char *name, int length) {
+    int lo = 0, hi = prog->num_vars - 1;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const char *var = prog->var_names[mid];
+        int c = strncmp(var, name, length);
+        if (c == 0) c = var[length] ? 1 : 0; // prefixo igual: o nome mais longo vem depois
+        if (c == 0) return mid;
+        if (c < 0) lo = mid + 1; else hi = mid - 1;
+    }
+    return -1;
+}
+
+// valor escrito na atribuição: 1/V, 0/F ou -1
+static int parse_value(char c) {
+    switch (c) {
+        case '1': case 'V': case 'v': return 1;
+        case '0': case 'F': case 'f': return 0;
+        default:  return -1;
+    }
+}
+
+int parse_partial_assignment(const program *prog, const char *spec, signed char *values, error_status *status) {
+    char detail[96];
+
+    init_error_status(status);
+    for (int j = 0; j < prog->num_vars; j++) values[j] = PARTIAL_FREE;
+
+    for (int i = 0; spec[i];) {
+        if (spec[i] == ',' || isspace((unsigned char) spec[i])) {
+            i++;
+            continue;
+        }
+
+        // nome=valor, com espaços opcionais em volta do '='
+        int start = i;
+        if (isalpha((unsigned char) spec[i]))
+            while (isalnum((unsigned char) spec[i]) || spec[i] == '_') i++;
+        int length = i - start;
+        while (spec[i] == ' ') i++;
+        int eq = spec[i] == '=';
+        if (eq) i++;
+        while (eq && spec[i] == ' ') i++;
+        int value = eq ? parse_value(spec[i]) : -1;
+        if (value >= 0) i++;
+
+        if (length == 0 || value < 0 || (spec[i] && spec[i] != ',' && !isspace((unsigned char) spec[i]))) {
+            snprintf(detail, sizeof(detail), "esperado nome=valor (0, 1, V ou F) na posicao %d da atribuicao", start);
+            set_error(status, ERR_INVALID_ARGUMENT, start, detail);
+            return 0;
+        }
+
+        int slot = find_var(prog, spec + start, length);
+        if (slot < 0) {
+            snprintf(detail, sizeof(detail), "variavel fixada fora da expressao: %.*s",
+                     length > 48 ? 48 : length, spec + start);
+            set_error(status, ERR_INVALID_ARGUMENT, start, detail);
+            return 0;
+        }
+        if (values[slot] != PARTIAL_FREE) {
+            snprintf(detail, sizeof(detail), "variavel fixada duas vezes: %s", prog->var_names[slot]);
+            set_error(status, ERR_INVALID_ARGUMENT, start, detail);
+            return 0;
+        }
+        values[slot] = (signed char) value;
+    }
+    return 1;
+}
+
+// nomes das variáveis livres em um único bloco, como em compile.c: ponteiros seguidos dos textos
+static int store_free_names(const program *prog, const signed char *values, program *out) {
+    size_t bytes = sizeof(char *) * (out->num_vars > 0 ? out->num_vars : 1);
+    for (int j = 0; j < prog->num_vars; j++)
+        if (values[j] == PARTIAL_FREE) bytes += strlen(prog->var_names[j]) + 1;
+
+    out->var_names = malloc(bytes);
+    if (!out->var_names) return 0;
+
+    char *text = (char *) (out->var_names + (out->num_vars > 0 ? out->num_vars : 1));
+    for (int j = 0, k = 0; j < prog->num_vars; j++) {
+        if (values[j] != PARTIAL_FREE) continue;
+        size_t length = strlen(prog->var_names[j]);
+        memcpy(text, prog->var_names[j], length + 1);
+        out->var_names[k++] = text;
+        text += length + 1;
+    }
+    return 1;
+}
+
+int fix_variables(const program *prog, const signed char *values, program *out, error_status *status) {
+    arena scratch;
+    expr_dag dag;
+    int ok = 0;
+
+    init_error_status(status);
+    memset(out, 0, sizeof(*out));
+    arena_init(&scratch, 0);
+
+    // cada instrução cria no máximo um nó; as duas constantes são reservadas pelo grafo
+    int *slot_of = arena_alloc(&scratch, sizeof(int) * (prog->num_vars + 1));
+    int *stack = arena_alloc(&scratch, sizeof(int) * (prog->max_depth + prog->num_temps + 1));
+    if (!slot_of || !stack || !dag_init(&dag, prog->length, 1, &scratch)) goto done;
+
+    // as livres ocupam os primeiros slots, na ordem original
+    for (int j = 0; j < prog->num_vars; j++) slot_of[j] = values[j] == PARTIAL_FREE ? out->num_vars++ : -1;
+
+    int *temps = stack + prog->max_depth;
+    int top = -1;
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+
+        switch (ins->op) {
+            case OP_LOAD:
+                stack[++top] = slot_of[ins->slot] >= 0 ? dag_load(&dag, slot_of[ins->slot])
+                                                       : dag_const(&dag, values[ins->slot]);
+                break;
+            case OP_CONST: stack[++top] = dag_const(&dag, ins->slot); break;
+            case OP_NOT:   stack[top] = dag_not(&dag, stack[top]); break;
+            case OP_STORE: temps[ins->slot] = stack[top]; continue;
+            case OP_FETCH: stack[++top] = temps[ins->slot]; break;
+            default: {
+                int b = stack[top--];
+                stack[top] = dag_binary(&dag, ins->op, stack[top], b);
+                break;
+            }
+        }
+        if (stack[top] < 0) goto done;
+    }
+
+    ok = store_free_names(prog, values, out) && dag_lower(&dag, stack[0], 1, &scratch, out);
+
+done:
+    arena_free(&scratch);
+    if (!ok) {
+        free_program(out);
+        out->num_vars = 0;
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+    }
+    return ok;
+}
+
+int restrict_program(const program *prog, const char *spec, program *out, error_status *status) {
+    signed char *values = malloc(prog->num_vars > 0 ? prog->num_vars : 1);
+
+    init_error_status(status);
+    memset(out, 0, sizeof(*out));
+    if (!values) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    int ok = parse_partial_assignment(prog, spec, values, status) && fix_variables(prog, values, out, status);
+    free(values);
+    return ok;
+}
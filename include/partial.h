@@ -0,0 +1,53 @@
+#ifndef PARTIAL_H
+#define PARTIAL_H
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+#define PARTIAL_FREE (-1) ///< valor de fix_variables para uma variável que continua livre
+
+/**
+ * @brief lê uma atribuição parcial como "a=1,b=0" sobre as variáveis do programa
+ *
+ * cada item é nome=valor, separado por vírgulas ou espaços; o valor é 1/V
+ * (verdadeiro) ou 0/F (falso). nomes fora da expressão e variáveis fixadas
+ * duas vezes são erros
+ *
+ * @param prog programa compilado
+ * @param spec texto da atribuição
+ * @param values recebe, por slot, 0, 1 ou PARTIAL_FREE (prog->num_vars posições)
+ * @param status recebe ERR_INVALID_ARGUMENT com o item rejeitado
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int parse_partial_assignment(const program *prog, const char *spec, signed char *values, error_status *status);
+
+/**
+ * @brief programa só sobre as variáveis livres, com as fixadas trocadas por constantes
+ *
+ * o programa é refeito como grafo simplificado (dag.h): as constantes se
+ * propagam, e subexpressões cujo valor já é decidido pelas variáveis fixadas
+ * (x & 0, x | 1, 0 -> x, ...) somem junto com os seus operandos. as variáveis
+ * livres mantêm a ordem original, então cada linha da tabela restrita é a
+ * linha da tabela inteira com as fixadas nos valores dados; uma variável
+ * livre que deixa de aparecer continua como coluna
+ *
+ * @param prog programa compilado
+ * @param values por slot: 0, 1 ou PARTIAL_FREE
+ * @param out programa restrito (liberar com free_program)
+ * @param status recebe o erro de memória
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int fix_variables(const program *prog, const signed char *values, program *out, error_status *status);
+
+/**
+ * @brief parse_partial_assignment seguido de fix_variables
+ *
+ * @param prog programa compilado
+ * @param spec texto da atribuição (ex: "a=1,b=0")
+ * @param out programa restrito (liberar com free_program)
+ * @param status ponteiro para estrutura de status de erro
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int restrict_program(const program *prog, const char *spec, program *out, error_status *status);
+
+#endif // PARTIAL_H
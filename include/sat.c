@@ -0,0 +1,592 @@
+#include "sat.h"
+
+#define VAR_DECAY 0.95    // decaimento da atividade VSIDS por conflito
+#define RESTART_BASE 100  // conflitos da unidade de Luby
+
+// valores de atribuição
+#define VAL_FALSE 0
+#define VAL_TRUE 1
+#define VAL_UNDEF 2
+
+int cnf_init(cnf_formula *cnf, int num_vars) {
+    cnf->num_vars = num_vars;
+    cnf->num_lits = 0;
+    cnf->lits_cap = 64;
+    cnf->num_clauses = 0;
+    cnf->clauses_cap = 16;
+    cnf->lits = malloc(sizeof(int) * cnf->lits_cap);
+    cnf->starts = malloc(sizeof(int) * (cnf->clauses_cap + 1));
+    if (!cnf->lits || !cnf->starts) {
+        cnf_free(cnf);
+        return 0;
+    }
+    cnf->starts[0] = 0;
+    return 1;
+}
+
+int cnf_new_var(cnf_formula *cnf) {
+    return cnf->num_vars++;
+}
+
+int cnf_add_clause(cnf_formula *cnf, const int *lits, int size) {
+    if (cnf->num_lits + size > cnf->lits_cap) {
+        int cap = cnf->lits_cap;
+        while (cnf->num_lits + size > cap) cap *= 2;
+        int *grown = realloc(cnf->lits, sizeof(int) * cap);
+        if (!grown) return 0;
+        cnf->lits = grown;
+        cnf->lits_cap = cap;
+    }
+    if (cnf->num_clauses + 1 > cnf->clauses_cap) {
+        int cap = cnf->clauses_cap * 2;
+        int *grown = realloc(cnf->starts, sizeof(int) * (cap + 1));
+        if (!grown) return 0;
+        cnf->starts = grown;
+        cnf->clauses_cap = cap;
+    }
+
+    memcpy(cnf->lits + cnf->num_lits, lits, sizeof(int) * size);
+    cnf->num_lits += size;
+    cnf->starts[++cnf->num_clauses] = cnf->num_lits;
+    return 1;
+}
+
+void cnf_free(cnf_formula *cnf) {
+    free(cnf->lits);
+    free(cnf->starts);
+    cnf->lits = NULL;
+    cnf->starts = NULL;
+}
+
+// adiciona as cláusulas de Tseitin para x <-> (a op b)
+static int encode_gate(cnf_formula *cnf, op_code op, int x, int a, int b) {
+    int nx = SAT_NEG(x), na = SAT_NEG(a), nb = SAT_NEG(b);
+
+    switch (op) {
+        case OP_IMPLIES:
+            a = na; na = SAT_NEG(a); // a -> b equivale a ~a | b
+            /* fall through */
+        case OP_OR: {
+            int c1[] = { x, na }, c2[] = { x, nb }, c3[] = { nx, a, b };
+            return cnf_add_clause(cnf, c1, 2) && cnf_add_clause(cnf, c2, 2) && cnf_add_clause(cnf, c3, 3);
+        }
+        case OP_AND: {
+            int c1[] = { nx, a }, c2[] = { nx, b }, c3[] = { x, na, nb };
+            return cnf_add_clause(cnf, c1, 2) && cnf_add_clause(cnf, c2, 2) && cnf_add_clause(cnf, c3, 3);
+        }
+        default: { // OP_IFF
+            int c1[] = { nx, na, b }, c2[] = { nx, a, nb }, c3[] = { x, a, b }, c4[] = { x, na, nb };
+            return cnf_add_clause(cnf, c1, 3) && cnf_add_clause(cnf, c2, 3) &&
+                   cnf_add_clause(cnf, c3, 3) && cnf_add_clause(cnf, c4, 3);
+        }
+    }
+}
+
+int tseitin_encode(const program *prog, cnf_formula *cnf, int *root_lit) {
+    int *stack = malloc(sizeof(int) * (prog->max_depth + prog->num_temps));
+    int top = -1;
+
+    if (!stack || !cnf_init(cnf, prog->num_vars)) {
+        free(stack);
+        return 0;
+    }
+    int *temps = stack + prog->max_depth; // subexpressões compartilhadas reutilizam o mesmo literal
+
+    // a pilha do programa passa a conter literais em vez de valores
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+
+        if (ins->op == OP_LOAD) {
+            stack[++top] = SAT_LIT(ins->slot, 0);
+        } else if (ins->op == OP_NOT) {
+            stack[top] = SAT_NEG(stack[top]);
+        } else if (ins->op == OP_STORE) {
+            temps[ins->slot] = stack[top];
+        } else if (ins->op == OP_FETCH) {
+            stack[++top] = temps[ins->slot];
+        } else if (ins->op == OP_CONST) {
+            // constante: variável nova fixada por uma cláusula unitária
+            int x = SAT_LIT(cnf_new_var(cnf), 0);
+            int unit[] = { ins->slot ? x : SAT_NEG(x) };
+            if (!cnf_add_clause(cnf, unit, 1)) {
+                free(stack);
+                cnf_free(cnf);
+                return 0;
+            }
+            stack[++top] = x;
+        } else {
+            int b = stack[top--];
+            int a = stack[top];
+            int x = SAT_LIT(cnf_new_var(cnf), 0);
+            if (!encode_gate(cnf, ins->op, x, a, b)) {
+                free(stack);
+                cnf_free(cnf);
+                return 0;
+            }
+            stack[top] = x;
+        }
+    }
+
+    *root_lit = stack[0];
+    free(stack);
+    return 1;
+}
+
+// vetor dinâmico de inteiros (listas de vigilância, cláusula aprendida)
+typedef struct {
+    int *data;
+    int size;
+    int cap;
+} int_vec;
+
+static int vec_push(int_vec *v, int x) {
+    if (v->size == v->cap) {
+        int cap = v->cap ? v->cap * 2 : 4;
+        int *grown = realloc(v->data, sizeof(int) * cap);
+        if (!grown) return 0;
+        v->data = grown;
+        v->cap = cap;
+    }
+    v->data[v->size++] = x;
+    return 1;
+}
+
+// cláusula do resolvedor: literais em clause_lits[start .. start+size-1]; os dois
+// primeiros são os vigiados e, em cláusulas de razão, o primeiro é o implicado
+typedef struct {
+    int start;
+    int size;
+} clause_ref;
+
+typedef struct {
+    int num_vars;
+    int failed;          // falta de memória
+
+    int_vec lits;        // literais de todas as cláusulas
+    clause_ref *clauses;
+    int num_clauses;
+    int clauses_cap;
+
+    int_vec *watches;    // watches[l]: cláusulas que vigiam o literal l
+
+    unsigned char *value; // valor de cada variável (VAL_*)
+    unsigned char *phase; // última polaridade atribuída (memória de fase)
+    int *level;           // nível de decisão de cada variável
+    int *reason;          // cláusula que implicou a variável (-1 = decisão)
+    int *trail;           // literais atribuídos, em ordem
+    int trail_size;
+    int qhead;            // próximo literal da trilha a propagar
+    int *trail_lim;       // início de cada nível de decisão na trilha
+    int decision_level;
+
+    double *activity;     // atividade VSIDS
+    double var_inc;
+    int *heap;            // heap máximo de variáveis por atividade
+    int heap_size;
+    int *heap_pos;        // posição no heap (-1 = fora)
+
+    unsigned char *seen;  // marcas da análise de conflito
+    int_vec learnt;
+} solver;
+
+static int lit_value(const solver *s, int lit) {
+    unsigned char v = s->value[SAT_VAR(lit)];
+    if (v == VAL_UNDEF) return VAL_UNDEF;
+    return v ^ (lit & 1);
+}
+
+// --- heap de variáveis ordenado por atividade ---
+
+static void heap_swap(solver *s, int i, int j) {
+    int a = s->heap[i], b = s->heap[j];
+    s->heap[i] = b; s->heap_pos[b] = i;
+    s->heap[j] = a; s->heap_pos[a] = j;
+}
+
+static void heap_up(solver *s, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (s->activity[s->heap[parent]] >= s->activity[s->heap[i]]) break;
+        heap_swap(s, i, parent);
+        i = parent;
+    }
+}
+
+static void heap_down(solver *s, int i) {
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < s->heap_size && s->activity[s->heap[l]] > s->activity[s->heap[best]]) best = l;
+        if (r < s->heap_size && s->activity[s->heap[r]] > s->activity[s->heap[best]]) best = r;
+        if (best == i) break;
+        heap_swap(s, i, best);
+        i = best;
+    }
+}
+
+static void heap_insert(solver *s, int var) {
+    if (s->heap_pos[var] >= 0) return;
+    s->heap[s->heap_size] = var;
+    s->heap_pos[var] = s->heap_size++;
+    heap_up(s, s->heap_pos[var]);
+}
+
+static int heap_pop(solver *s) {
+    int top = s->heap[0];
+    s->heap_size--;
+    s->heap_pos[top] = -1;
+    if (s->heap_size > 0) {
+        s->heap[0] = s->heap[s->heap_size];
+        s->heap_pos[s->heap[0]] = 0;
+        heap_down(s, 0);
+    }
+    return top;
+}
+
+static void bump_activity(solver *s, int var) {
+    s->activity[var] += s->var_inc;
+    if (s->activity[var] > 1e100) {
+        for (int v = 0; v < s->num_vars; v++) s->activity[v] *= 1e-100;
+        s->var_inc *= 1e-100;
+    }
+    if (s->heap_pos[var] >= 0) heap_up(s, s->heap_pos[var]);
+}
+
+// --- atribuição e retrocesso ---
+
+static void enqueue(solver *s, int lit, int reason) {
+    int var = SAT_VAR(lit);
+    s->value[var] = (lit & 1) ? VAL_FALSE : VAL_TRUE;
+    s->level[var] = s->decision_level;
+    s->reason[var] = reason;
+    s->trail[s->trail_size++] = lit;
+}
+
+static void cancel_until(solver *s, int level) {
+    if (s->decision_level <= level) return;
+
+    for (int i = s->trail_size - 1; i >= s->trail_lim[level]; i--) {
+        int var = SAT_VAR(s->trail[i]);
+        s->phase[var] = s->value[var];
+        s->value[var] = VAL_UNDEF;
+        s->reason[var] = -1;
+        heap_insert(s, var);
+    }
+    s->trail_size = s->trail_lim[level];
+    s->qhead = s->trail_size;
+    s->decision_level = level;
+}
+
+// --- banco de cláusulas ---
+
+// armazena a cláusula e vigia os dois primeiros literais; retorna o índice
+static int store_clause(solver *s, const int *lits, int size) {
+    if (s->num_clauses == s->clauses_cap) {
+        int cap = s->clauses_cap ? s->clauses_cap * 2 : 16;
+        clause_ref *grown = realloc(s->clauses, sizeof(clause_ref) * cap);
+        if (!grown) {
+            s->failed = 1;
+            return -1;
+        }
+        s->clauses = grown;
+        s->clauses_cap = cap;
+    }
+
+    int index = s->num_clauses++;
+    s->clauses[index].start = s->lits.size;
+    s->clauses[index].size = size;
+    for (int i = 0; i < size; i++)
+        if (!vec_push(&s->lits, lits[i])) s->failed = 1;
+
+    if (!vec_push(&s->watches[lits[0]], index) || !vec_push(&s->watches[lits[1]], index))
+        s->failed = 1;
+    return index;
+}
+
+// adiciona uma cláusula original no nível 0; retorna 0 se a fórmula ficou insatisfazível
+static int add_input_clause(solver *s, const int *lits, int size) {
+    int buffer[64];
+    int *kept = size <= 64 ? buffer : malloc(sizeof(int) * size);
+    int count = 0;
+
+    if (!kept) {
+        s->failed = 1;
+        return 0;
+    }
+
+    // remove literais falsos e repetidos; cláusulas já satisfeitas são ignoradas
+    for (int i = 0; i < size; i++) {
+        int v = lit_value(s, lits[i]);
+        int duplicate = 0, tautology = 0;
+        if (v == VAL_TRUE) tautology = 1;
+        for (int k = 0; k < count; k++) {
+            if (kept[k] == lits[i]) duplicate = 1;
+            if (kept[k] == SAT_NEG(lits[i])) tautology = 1;
+        }
+        if (tautology) {
+            if (kept != buffer) free(kept);
+            return 1;
+        }
+        if (!duplicate && v == VAL_UNDEF) kept[count++] = lits[i];
+    }
+
+    int ok = 1;
+    if (count == 0) {
+        ok = 0;
+    } else if (count == 1) {
+        enqueue(s, kept[0], -1);
+    } else {
+        store_clause(s, kept, count);
+    }
+
+    if (kept != buffer) free(kept);
+    return ok;
+}
+
+// --- propagação com literais vigiados ---
+
+// retorna a cláusula em conflito ou -1
+static int propagate(solver *s) {
+    while (s->qhead < s->trail_size) {
+        int p = s->trail[s->qhead++];
+        int false_lit = SAT_NEG(p);
+        int_vec *ws = &s->watches[false_lit];
+        int i = 0, j = 0;
+
+        while (i < ws->size) {
+            int c = ws->data[i++];
+            int *lits = s->lits.data + s->clauses[c].start;
+            int size = s->clauses[c].size;
+
+            // garante que o literal falso vigiado está na posição 1
+            if (lits[0] == false_lit) {
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+
+            // cláusula já satisfeita pelo outro vigiado
+            if (lit_value(s, lits[0]) == VAL_TRUE) {
+                ws->data[j++] = c;
+                continue;
+            }
+
+            // procura um novo literal não falso para vigiar
+            int moved = 0;
+            for (int k = 2; k < size; k++) {
+                if (lit_value(s, lits[k]) != VAL_FALSE) {
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    if (!vec_push(&s->watches[lits[1]], c)) s->failed = 1;
+                    moved = 1;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            // cláusula unitária ou em conflito
+            ws->data[j++] = c;
+            if (lit_value(s, lits[0]) == VAL_FALSE) {
+                while (i < ws->size) ws->data[j++] = ws->data[i++];
+                ws->size = j;
+                return c;
+            }
+            enqueue(s, lits[0], c);
+        }
+        ws->size = j;
+    }
+    return -1;
+}
+
+// --- análise de conflito (primeiro UIP) ---
+
+// monta a cláusula aprendida em s->learnt e retorna o nível de retrocesso
+static int analyze(solver *s, int conflict) {
+    int path_count = 0;
+    int p = -1;
+    int index = s->trail_size - 1;
+
+    s->learnt.size = 0;
+    vec_push(&s->learnt, -1); // reservado para o UIP
+
+    do {
+        clause_ref *c = &s->clauses[conflict];
+        int *lits = s->lits.data + c->start;
+
+        for (int k = (p == -1) ? 0 : 1; k < c->size; k++) {
+            int q = lits[k];
+            int var = SAT_VAR(q);
+            if (s->seen[var] || s->level[var] == 0) continue;
+
+            s->seen[var] = 1;
+            bump_activity(s, var);
+            if (s->level[var] >= s->decision_level) {
+                path_count++;
+            } else if (!vec_push(&s->learnt, q)) {
+                s->failed = 1;
+            }
+        }
+
+        // próximo literal marcado na trilha, do fim para o início
+        while (!s->seen[SAT_VAR(s->trail[index])]) index--;
+        p = s->trail[index--];
+        conflict = s->reason[SAT_VAR(p)];
+        s->seen[SAT_VAR(p)] = 0;
+        path_count--;
+    } while (path_count > 0);
+
+    s->learnt.data[0] = SAT_NEG(p);
+
+    // nível de retrocesso: o maior nível entre os demais literais (colocado na posição 1)
+    int back_level = 0;
+    for (int k = 1; k < s->learnt.size; k++) {
+        int lvl = s->level[SAT_VAR(s->learnt.data[k])];
+        if (lvl > back_level) {
+            back_level = lvl;
+            int tmp = s->learnt.data[1];
+            s->learnt.data[1] = s->learnt.data[k];
+            s->learnt.data[k] = tmp;
+        }
+    }
+
+    for (int k = 1; k < s->learnt.size; k++) s->seen[SAT_VAR(s->learnt.data[k])] = 0;
+    return back_level;
+}
+
+// sequência de Luby: 1 1 2 1 1 2 4 1 1 2 ...
+static double luby(int i) {
+    int size = 1, seq = 0;
+    while (size < i + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != i) {
+        size = (size - 1) / 2;
+        seq--;
+        i = i % size;
+    }
+    double r = 1;
+    while (seq-- > 0) r *= 2;
+    return r;
+}
+
+static int solver_init(solver *s, int num_vars) {
+    memset(s, 0, sizeof(*s));
+    s->num_vars = num_vars;
+    s->var_inc = 1.0;
+
+    int n = num_vars > 0 ? num_vars : 1;
+    s->watches = calloc(2 * n, sizeof(int_vec));
+    s->value = malloc(n);
+    s->phase = calloc(n, 1);
+    s->level = calloc(n, sizeof(int));
+    s->reason = malloc(sizeof(int) * n);
+    s->trail = malloc(sizeof(int) * n);
+    s->trail_lim = malloc(sizeof(int) * (n + 1));
+    s->activity = calloc(n, sizeof(double));
+    s->heap = malloc(sizeof(int) * n);
+    s->heap_pos = malloc(sizeof(int) * n);
+    s->seen = calloc(n, 1);
+
+    if (!s->watches || !s->value || !s->phase || !s->level || !s->reason || !s->trail ||
+        !s->trail_lim || !s->activity || !s->heap || !s->heap_pos || !s->seen)
+        return 0;
+
+    for (int v = 0; v < num_vars; v++) {
+        s->value[v] = VAL_UNDEF;
+        s->reason[v] = -1;
+        s->heap_pos[v] = -1;
+        heap_insert(s, v);
+    }
+    return 1;
+}
+
+static void solver_free(solver *s) {
+    if (s->watches)
+        for (int l = 0; l < 2 * (s->num_vars > 0 ? s->num_vars : 1); l++) free(s->watches[l].data);
+    free(s->watches);
+    free(s->lits.data);
+    free(s->clauses);
+    free(s->value);
+    free(s->phase);
+    free(s->level);
+    free(s->reason);
+    free(s->trail);
+    free(s->trail_lim);
+    free(s->activity);
+    free(s->heap);
+    free(s->heap_pos);
+    free(s->seen);
+    free(s->learnt.data);
+}
+
+// laço CDCL: 1 = satisfazível, 0 = insatisfazível
+static int search(solver *s) {
+    int restarts = 0;
+    long conflicts_left = (long) (luby(0) * RESTART_BASE);
+
+    for (;;) {
+        int conflict = propagate(s);
+        if (s->failed) return -1;
+
+        if (conflict >= 0) {
+            if (s->decision_level == 0) return 0;
+
+            int back_level = analyze(s, conflict);
+            cancel_until(s, back_level);
+
+            if (s->learnt.size == 1) {
+                enqueue(s, s->learnt.data[0], -1);
+            } else {
+                int c = store_clause(s, s->learnt.data, s->learnt.size);
+                if (c < 0) return -1;
+                enqueue(s, s->learnt.data[0], c);
+            }
+            s->var_inc /= VAR_DECAY;
+
+            if (--conflicts_left <= 0) {
+                restarts++;
+                conflicts_left = (long) (luby(restarts) * RESTART_BASE);
+                cancel_until(s, 0);
+            }
+            continue;
+        }
+
+        // escolhe a variável livre mais ativa
+        int var = -1;
+        while (s->heap_size > 0) {
+            int candidate = heap_pop(s);
+            if (s->value[candidate] == VAL_UNDEF) {
+                var = candidate;
+                break;
+            }
+        }
+        if (var < 0) return 1; // todas atribuídas sem conflito
+
+        s->trail_lim[s->decision_level++] = s->trail_size;
+        enqueue(s, SAT_LIT(var, s->phase[var] != VAL_TRUE), -1);
+    }
+}
+
+int sat_solve(const cnf_formula *cnf, unsigned char *model) {
+    solver s;
+    int result;
+
+    if (!solver_init(&s, cnf->num_vars)) {
+        solver_free(&s);
+        return -1;
+    }
+
+    result = 1;
+    for (int c = 0; c < cnf->num_clauses && result == 1; c++) {
+        if (!add_input_clause(&s, cnf->lits + cnf->starts[c], cnf->starts[c + 1] - cnf->starts[c]))
+            result = s.failed ? -1 : 0;
+    }
+
+    if (result == 1) result = search(&s);
+
+    if (result == 1 && model) {
+        for (int v = 0; v < cnf->num_vars; v++) model[v] = s.value[v] == VAL_TRUE;
+    }
+
+    solver_free(&s);
+    return result;
+}
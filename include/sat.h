@@ -0,0 +1,85 @@
+#ifndef SAT_H
+#define SAT_H
+
+#include "compile.h" // programa pós-fixo compilado
+
+/// literal da variável v: 2v (positivo) ou 2v + 1 (negado)
+#define SAT_LIT(var, negated) ((var) * 2 + ((negated) ? 1 : 0))
+#define SAT_VAR(lit) ((lit) >> 1)   ///< variável de um literal
+#define SAT_NEG(lit) ((lit) ^ 1)    ///< negação de um literal
+
+/// @brief fórmula em forma normal conjuntiva (lista de cláusulas de literais)
+typedef struct {
+    int num_vars;     ///< número de variáveis (originais + auxiliares)
+    int *lits;        ///< literais de todas as cláusulas, em sequência
+    int num_lits;     ///< literais armazenados
+    int lits_cap;     ///< capacidade de 'lits'
+    int *starts;      ///< início de cada cláusula em 'lits' (num_clauses + 1 entradas)
+    int num_clauses;  ///< número de cláusulas
+    int clauses_cap;  ///< capacidade de 'starts'
+} cnf_formula;
+
+/**
+ * @brief inicializa uma fórmula vazia com 'num_vars' variáveis
+ *
+ * @param cnf fórmula a inicializar
+ * @param num_vars número inicial de variáveis
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int cnf_init(cnf_formula *cnf, int num_vars);
+
+/**
+ * @brief cria uma nova variável auxiliar
+ *
+ * @param cnf fórmula
+ * @return int índice da nova variável
+ */
+int cnf_new_var(cnf_formula *cnf);
+
+/**
+ * @brief adiciona uma cláusula (disjunção dos literais)
+ *
+ * @param cnf fórmula
+ * @param lits literais da cláusula
+ * @param size número de literais
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int cnf_add_clause(cnf_formula *cnf, const int *lits, int size);
+
+/**
+ * @brief libera a memória da fórmula
+ *
+ * @param cnf fórmula
+ */
+void cnf_free(cnf_formula *cnf);
+
+/**
+ * @brief converte o programa em CNF pela transformação de Tseitin
+ *
+ * as variáveis 0..num_vars-1 são os slots do programa; cada operador binário
+ * ganha uma variável auxiliar equivalente à subfórmula (a negação apenas
+ * inverte o literal). a raiz não é afirmada: o chamador adiciona a cláusula
+ * unitária com root_lit ou com a sua negação
+ *
+ * @param prog programa compilado
+ * @param cnf fórmula de saída (liberar com cnf_free)
+ * @param root_lit literal equivalente à expressão inteira
+ * @return int 1 em caso de sucesso, 0 se faltar memória
+ */
+int tseitin_encode(const program *prog, cnf_formula *cnf, int *root_lit);
+
+/**
+ * @brief decide a satisfatibilidade com um resolvedor CDCL
+ *
+ * usa literais vigiados (dois por cláusula), aprendizado de cláusulas pelo
+ * primeiro ponto de implicação único, heurística VSIDS, memória de fase e
+ * reinícios segundo a sequência de Luby
+ *
+ * @param cnf fórmula
+ * @param model se não for NULL e a fórmula for satisfazível, recebe o valor
+ *        (0 ou 1) de cada variável
+ * @return int 1 = satisfazível, 0 = insatisfazível, -1 = falta de memória
+ */
+int sat_solve(const cnf_formula *cnf, unsigned char *model);
+
+#endif // SAT_H
@@ -0,0 +1,814 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "session.h"
+#include "eval.h"
+#include "compile.h"
+#include "simd.h"
+
+#define SESSION_MAX_DEPTH 4096 // aninhamento lido pelo analisador recursivo; acima disso tudo é refeito
+
+// operação de um nó da árvore e de uma célula
+enum { NODE_VAR, NODE_NOT, NODE_AND, NODE_OR, NODE_IMPLIES, NODE_IFF };
+
+// tokens do analisador
+enum { TOK_END, TOK_VAR, TOK_NOT, TOK_AND, TOK_OR, TOK_IMPLIES, TOK_IFF, TOK_OPEN, TOK_CLOSE, TOK_BAD };
+
+// subfórmula distinta: operador e células dos operandos, com a tabela inteira
+typedef struct {
+    int op;         // -1 = célula livre (a memória da tabela fica para a próxima)
+    int a, b;       // células dos operandos (-1 = sem operando)
+    int var;        // nome da variável (NODE_VAR)
+    uint64_t *bits; // tabela da subfórmula, com 'cell_words' palavras
+    int next;       // próxima célula do mesmo balde ou da lista livre
+    int mark;       // alcançada a partir da raiz na última coleta
+} session_cell;
+
+// nó da árvore: a posição no texto, que a célula não guarda
+typedef struct {
+    int op;             // -1 = nó livre
+    int left, right;    // filhos (-1 = sem filho); 'left' encadeia a lista livre
+    int parent;
+    int var;            // nome da variável (NODE_VAR)
+    size_t start, end;  // trecho [start, end) do texto, incluindo parênteses em volta
+    int cell;           // célula com a tabela do nó
+} session_node;
+
+typedef struct {
+    char *name;
+    int uses; // folhas da árvore com este nome
+    int slot; // coluna na tabela
+} session_name;
+
+struct edit_session {
+    char *text;
+    size_t length;
+    int valid;      // o texto atual é uma expressão válida
+    int tree_valid; // há árvore da última versão válida (0 = refazer tudo na próxima edição)
+    size_t dirty_start, dirty_end; // trecho alterado desde a árvore quando o texto atual é inválido
+    session_update update;
+
+    session_node *nodes;
+    int num_nodes, node_capacity, free_node;
+    int root;
+    int *created;   // nós criados pela leitura em andamento (desfeitos se ela falhar)
+    int num_created, created_capacity;
+
+    session_name *names;
+    int num_names, names_capacity;
+    int num_vars;
+
+    session_cell *cells;
+    int num_cells, cell_capacity, free_cell;
+    int *buckets;   // tabela de hash das células (-1 = vazio)
+    int num_buckets;
+    int root_cell;
+    uint64_t cell_words; // tamanho das tabelas já alocadas nas células
+
+    uint64_t words;     // palavras de cada tabela
+    uint64_t mask;      // linhas válidas da palavra única de tabelas com menos de 64 linhas
+    uint64_t *fallback; // tabela do programa compilado quando o texto fica fora da gramática da árvore
+};
+
+// --- nós ---
+
+static int new_node(edit_session *s, int op, int left, int right, int var, size_t start, size_t end) {
+    int index = s->free_node;
+
+    if (s->num_created == s->created_capacity) {
+        int capacity = s->created_capacity ? s->created_capacity * 2 : 64;
+        int *grown = realloc(s->created, sizeof(int) * capacity);
+        if (!grown) return -1;
+        s->created = grown;
+        s->created_capacity = capacity;
+    }
+
+    if (index >= 0) {
+        s->free_node = s->nodes[index].left;
+    } else {
+        if (s->num_nodes == s->node_capacity) {
+            int capacity = s->node_capacity ? s->node_capacity * 2 : 64;
+            session_node *grown = realloc(s->nodes, sizeof(session_node) * capacity);
+            if (!grown) return -1;
+            s->nodes = grown;
+            s->node_capacity = capacity;
+        }
+        index = s->num_nodes++;
+    }
+
+    session_node *node = &s->nodes[index];
+    node->op = op;
+    node->left = left;
+    node->right = right;
+    node->parent = -1;
+    node->var = var;
+    node->start = start;
+    node->end = end;
+    node->cell = -1;
+    if (left >= 0) s->nodes[left].parent = index;
+    if (right >= 0) s->nodes[right].parent = index;
+    if (op == NODE_VAR) s->names[var].uses++;
+
+    s->created[s->num_created++] = index;
+    return index;
+}
+
+static void free_node(edit_session *s, int index) {
+    session_node *node = &s->nodes[index];
+    if (node->op == NODE_VAR) s->names[node->var].uses--;
+    node->op = -1;
+    node->left = s->free_node;
+    s->free_node = index;
+}
+
+// libera o nó e toda a subárvore
+static void free_subtree(edit_session *s, int index) {
+    while (index >= 0) {
+        int left = s->nodes[index].left, right = s->nodes[index].right;
+        free_node(s, index);
+        free_subtree(s, right);
+        index = left; // o filho esquerdo segue sem recursão (cadeias de '&' crescem à esquerda)
+    }
+}
+
+// --- leitura de um trecho ---
+
+typedef struct {
+    edit_session *s;
+    const char *text;
+    size_t pos, end; // janela [pos, end) ainda não lida
+    int depth;
+    int new_name;    // apareceu um nome que a árvore ainda não tinha
+    int failed;
+} span_parser;
+
+static int is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+static int is_letter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+static int is_name_char(char c) { return is_letter(c) || (c >= '0' && c <= '9') || c == '_'; }
+
+// próximo token da janela, depois dos espaços; 'length' recebe o tamanho do token
+static int peek_token(span_parser *p, size_t *length) {
+    const char *t = p->text;
+
+    while (p->pos < p->end && is_space(t[p->pos])) p->pos++;
+    *length = 1;
+    if (p->pos >= p->end) return TOK_END;
+
+    size_t i = p->pos;
+    switch (t[i]) {
+        case '~': return TOK_NOT;
+        case '&': return TOK_AND;
+        case '|': return TOK_OR;
+        case '(': return TOK_OPEN;
+        case ')': return TOK_CLOSE;
+        case '-':
+            *length = 2;
+            return i + 1 < p->end && t[i+1] == '>' ? TOK_IMPLIES : TOK_BAD;
+        case '<':
+            *length = 3;
+            return i + 2 < p->end && t[i+1] == '-' && t[i+2] == '>' ? TOK_IFF : TOK_BAD;
+        default:
+            if (!is_letter(t[i])) return TOK_BAD;
+            while (i + *length < p->end && is_name_char(t[i + *length])) (*length)++;
+            return TOK_VAR;
+    }
+}
+
+// índice do nome, acrescentado à lista se ainda não existir
+static int intern_name(span_parser *p, const char *name, size_t length) {
+    edit_session *s = p->s;
+
+    for (int i = 0; i < s->num_names; i++)
+        if (strlen(s->names[i].name) == length && memcmp(s->names[i].name, name, length) == 0) {
+            if (s->names[i].uses == 0) p->new_name = 1;
+            return i;
+        }
+
+    if (s->num_names == s->names_capacity) {
+        int capacity = s->names_capacity ? s->names_capacity * 2 : 16;
+        session_name *grown = realloc(s->names, sizeof(session_name) * capacity);
+        if (!grown) return -1;
+        s->names = grown;
+        s->names_capacity = capacity;
+    }
+
+    char *copy = malloc(length + 1);
+    if (!copy) return -1;
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+
+    s->names[s->num_names] = (session_name) { copy, 0, -1 };
+    p->new_name = 1;
+    return s->num_names++;
+}
+
+static int parse_iff(span_parser *p);
+
+static int parse_fail(span_parser *p) {
+    p->failed = 1;
+    return -1;
+}
+
+// variável, grupo entre parênteses ou negação deles
+static int parse_unary(span_parser *p) {
+    size_t length;
+    int tok = peek_token(p, &length);
+    size_t start = p->pos;
+    int node;
+
+    if (p->failed || ++p->depth > SESSION_MAX_DEPTH) return parse_fail(p);
+
+    if (tok == TOK_NOT) {
+        p->pos += length;
+        int child = parse_unary(p);
+        node = child < 0 ? -1 : new_node(p->s, NODE_NOT, child, -1, -1, start, p->s->nodes[child].end);
+    } else if (tok == TOK_VAR) {
+        int var = intern_name(p, p->text + start, length);
+        p->pos += length;
+        node = var < 0 ? -1 : new_node(p->s, NODE_VAR, -1, -1, var, start, p->pos);
+    } else if (tok == TOK_OPEN) {
+        // o grupo é o próprio nó de dentro, com o trecho estendido até os parênteses
+        p->pos += length;
+        node = parse_iff(p);
+        if (node >= 0 && peek_token(p, &length) == TOK_CLOSE) {
+            p->pos += length;
+            p->s->nodes[node].start = start;
+            p->s->nodes[node].end = p->pos;
+        } else {
+            node = -1;
+        }
+    } else {
+        node = -1;
+    }
+
+    p->depth--;
+    return node < 0 ? parse_fail(p) : node;
+}
+
+// operações binárias associativas à esquerda de um nível
+static int parse_left(span_parser *p, int tok, int op, int (*operand)(span_parser *)) {
+    size_t length;
+    int left = operand(p);
+
+    while (left >= 0 && peek_token(p, &length) == tok) {
+        p->pos += length;
+        int right = operand(p);
+        if (right < 0) return parse_fail(p);
+        left = new_node(p->s, op, left, right, -1, p->s->nodes[left].start, p->s->nodes[right].end);
+        if (left < 0) return parse_fail(p);
+    }
+    return left;
+}
+
+static int parse_and(span_parser *p) { return parse_left(p, TOK_AND, NODE_AND, parse_unary); }
+static int parse_or(span_parser *p) { return parse_left(p, TOK_OR, NODE_OR, parse_and); }
+
+// '->' associa à direita, como na leitura da linha de comando
+static int parse_implies(span_parser *p) {
+    size_t length;
+    int left = parse_or(p);
+
+    if (left < 0 || peek_token(p, &length) != TOK_IMPLIES) return left;
+    if (++p->depth > SESSION_MAX_DEPTH) return parse_fail(p);
+    p->pos += length;
+    int right = parse_implies(p);
+    p->depth--;
+    if (right < 0) return parse_fail(p);
+
+    int node = new_node(p->s, NODE_IMPLIES, left, right, -1, p->s->nodes[left].start, p->s->nodes[right].end);
+    return node < 0 ? parse_fail(p) : node;
+}
+
+static int parse_iff(span_parser *p) { return parse_left(p, TOK_IFF, NODE_IFF, parse_implies); }
+
+// lê a janela [start, end) inteira: como operando (unary = 1) ou como expressão completa;
+// em caso de falha os nós criados são desfeitos
+static int parse_span(edit_session *s, size_t start, size_t end, int unary, int *new_name) {
+    span_parser p = { s, s->text, start, end, 0, 0, 0 };
+    size_t length;
+
+    s->num_created = 0;
+    int node = unary ? parse_unary(&p) : parse_iff(&p);
+    if (node >= 0 && peek_token(&p, &length) != TOK_END) node = -1;
+
+    if (node < 0) {
+        for (int i = 0; i < s->num_created; i++) free_node(s, s->created[i]);
+        s->num_created = 0;
+        return -1;
+    }
+    *new_name = p.new_name;
+    return node;
+}
+
+// --- células ---
+
+static uint64_t cell_hash(int op, int a, int b, int var) {
+    uint64_t h = (uint64_t) op * 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (uint64_t) (a + 1)) * 0xff51afd7ed558ccdULL;
+    h = (h ^ (uint64_t) (b + 1)) * 0xc4ceb9fe1a85ec53ULL;
+    h = (h ^ (uint64_t) (var + 1)) * 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 29);
+}
+
+// refaz a tabela de hash com todas as células vivas
+static int rebuild_buckets(edit_session *s) {
+    int size = 64;
+    while (size < s->cell_capacity * 2) size *= 2;
+
+    if (size != s->num_buckets) {
+        int *grown = realloc(s->buckets, sizeof(int) * size);
+        if (!grown) return 0;
+        s->buckets = grown;
+        s->num_buckets = size;
+    }
+    for (int i = 0; i < size; i++) s->buckets[i] = -1;
+
+    for (int c = 0; c < s->num_cells; c++) {
+        session_cell *cell = &s->cells[c];
+        if (cell->op < 0) continue;
+        int bucket = (int) (cell_hash(cell->op, cell->a, cell->b, cell->var) & (uint64_t) (size - 1));
+        cell->next = s->buckets[bucket];
+        s->buckets[bucket] = c;
+    }
+    return 1;
+}
+
+// tabela da variável: bit r da palavra w = bit (num_vars - 1 - slot) da linha w * 64 + r
+static void variable_bits(const edit_session *s, int slot, uint64_t *bits) {
+    static const uint64_t low_patterns[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    int bit = s->num_vars - 1 - slot;
+
+    for (uint64_t w = 0; w < s->words; w++)
+        bits[w] = bit < 6 ? low_patterns[bit] : ((w >> (bit - 6)) & 1) ? ~0ULL : 0;
+}
+
+// calcula a tabela da célula a partir das tabelas dos operandos
+static void compute_cell(const edit_session *s, session_cell *cell) {
+    const uint64_t *a = cell->a >= 0 ? s->cells[cell->a].bits : NULL;
+    const uint64_t *b = cell->b >= 0 ? s->cells[cell->b].bits : NULL;
+    uint64_t *out = cell->bits;
+    uint64_t n = s->words;
+
+    switch (cell->op) {
+        case NODE_VAR:     variable_bits(s, s->names[cell->var].slot, out); break;
+        case NODE_NOT:     for (uint64_t w = 0; w < n; w++) out[w] = ~a[w]; break;
+        case NODE_AND:     for (uint64_t w = 0; w < n; w++) out[w] = a[w] & b[w]; break;
+        case NODE_OR:      for (uint64_t w = 0; w < n; w++) out[w] = a[w] | b[w]; break;
+        case NODE_IMPLIES: for (uint64_t w = 0; w < n; w++) out[w] = ~a[w] | b[w]; break;
+        case NODE_IFF:     for (uint64_t w = 0; w < n; w++) out[w] = ~(a[w] ^ b[w]); break;
+    }
+    if (n == 1) out[0] &= s->mask;
+}
+
+// célula com esse operador e operandos: a existente ou uma nova, já calculada
+static int intern_cell(edit_session *s, int op, int a, int b, int var) {
+    uint64_t bucket = cell_hash(op, a, b, var) & (uint64_t) (s->num_buckets - 1);
+
+    for (int c = s->buckets[bucket]; c >= 0; c = s->cells[c].next) {
+        const session_cell *cell = &s->cells[c];
+        if (cell->op == op && cell->a == a && cell->b == b && cell->var == var) return c;
+    }
+
+    // células livres reaproveitam a memória da tabela: uma edição troca poucas
+    // subfórmulas e não paga alocação nem falta de página a cada vez
+    int index = s->free_cell;
+    uint64_t *bits;
+    if (index >= 0) {
+        s->free_cell = s->cells[index].next;
+        bits = s->cells[index].bits;
+    } else {
+        if (s->num_cells == s->cell_capacity) {
+            int capacity = s->cell_capacity ? s->cell_capacity * 2 : 64;
+            session_cell *grown = realloc(s->cells, sizeof(session_cell) * capacity);
+            if (!grown) return -1;
+            s->cells = grown;
+            s->cell_capacity = capacity;
+        }
+        bits = malloc(sizeof(uint64_t) * s->cell_words);
+        if (!bits) return -1;
+        index = s->num_cells++;
+    }
+
+    session_cell *cell = &s->cells[index];
+    *cell = (session_cell) { op, a, b, var, bits, -1, 0 };
+    compute_cell(s, cell);
+    s->update.computed++;
+
+    // a tabela de hash cresce junto com o vetor de células
+    if (s->cell_capacity * 2 > s->num_buckets) {
+        if (!rebuild_buckets(s)) return -1;
+    } else {
+        cell->next = s->buckets[bucket];
+        s->buckets[bucket] = index;
+    }
+    return index;
+}
+
+// célula de um nó cujos filhos já têm célula
+static int intern_node(edit_session *s, int index) {
+    const session_node *node = &s->nodes[index];
+    int a = node->left >= 0 ? s->nodes[node->left].cell : -1;
+    int b = node->right >= 0 ? s->nodes[node->right].cell : -1;
+    int cell = intern_cell(s, node->op, a, b, node->op == NODE_VAR ? node->var : -1);
+
+    s->nodes[index].cell = cell;
+    return cell >= 0;
+}
+
+// células dos nós criados pela última leitura: a ordem de criação já põe os filhos antes do pai
+static int intern_created(edit_session *s) {
+    for (int i = 0; i < s->num_created; i++)
+        if (!intern_node(s, s->created[i])) return 0;
+    return 1;
+}
+
+static void mark_cells(edit_session *s, int c) {
+    while (c >= 0 && !s->cells[c].mark) {
+        s->cells[c].mark = 1;
+        mark_cells(s, s->cells[c].b);
+        c = s->cells[c].a;
+    }
+}
+
+// libera as células que a árvore atual não usa mais
+static int collect_cells(edit_session *s) {
+    int live = 0;
+
+    for (int c = 0; c < s->num_cells; c++) s->cells[c].mark = 0;
+    mark_cells(s, s->root_cell);
+
+    for (int c = 0; c < s->num_cells; c++) {
+        session_cell *cell = &s->cells[c];
+        if (cell->op < 0) continue;
+        if (cell->mark) {
+            live++;
+            continue;
+        }
+        cell->op = -1;
+        cell->next = s->free_cell;
+        s->free_cell = c;
+    }
+
+    s->update.reused = live - s->update.computed;
+    return rebuild_buckets(s);
+}
+
+// esvazia as células; as tabelas alocadas ficam se o tamanho continuar 'words'
+static void clear_cells(edit_session *s, uint64_t words) {
+    s->free_cell = -1;
+    s->root_cell = -1;
+    if (words != s->cell_words) {
+        for (int c = 0; c < s->num_cells; c++) free(s->cells[c].bits);
+        s->num_cells = 0;
+        s->cell_words = words;
+    }
+    for (int c = s->num_cells - 1; c >= 0; c--) {
+        s->cells[c].op = -1;
+        s->cells[c].next = s->free_cell;
+        s->free_cell = c;
+    }
+}
+
+// --- reconstrução completa ---
+
+// ordena os nomes usados (ordem da tabela, como na compilação) e fixa os slots
+static int assign_slots(edit_session *s, error_status *status) {
+    int order[SESSION_MAX_VARS];
+    int count = 0;
+
+    for (int i = 0; i < s->num_names; i++) {
+        s->names[i].slot = -1;
+        if (s->names[i].uses == 0) continue;
+        if (count == SESSION_MAX_VARS) {
+            char detail[64];
+            int total = 0;
+            for (int j = 0; j < s->num_names; j++) total += s->names[j].uses > 0;
+            sprintf(detail, "%d (maximo de %d)", total, SESSION_MAX_VARS);
+            set_error(status, ERR_TOO_MANY_VARIABLES, -1, detail);
+            return 0;
+        }
+        order[count++] = i;
+    }
+
+    // ordenação por inserção: no máximo SESSION_MAX_VARS nomes
+    for (int i = 1; i < count; i++)
+        for (int j = i; j > 0 && strcmp(s->names[order[j - 1]].name, s->names[order[j]].name) > 0; j--) {
+            int t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    for (int k = 0; k < count; k++) s->names[order[k]].slot = k;
+
+    s->num_vars = count;
+    s->words = count >= 6 ? 1ULL << (count - 6) : 1;
+    s->mask = count >= 6 ? ~0ULL : (1ULL << (1 << count)) - 1;
+    return 1;
+}
+
+static void clear_tree(edit_session *s) {
+    s->num_nodes = 0;
+    s->free_node = -1;
+    s->root = -1;
+    for (int i = 0; i < s->num_names; i++) free(s->names[i].name);
+    s->num_names = 0;
+    s->num_vars = 0;
+    free(s->fallback);
+    s->fallback = NULL;
+}
+
+// texto fora da gramática da árvore: a leitura da linha de comando decide,
+// e se ela aceitar a tabela vem do programa compilado
+static int rebuild_from_program(edit_session *s, error_status *status) {
+    program prog;
+
+    if (!parse_expression(s->text, &prog, status)) return 0;
+    if (prog.num_vars > SESSION_MAX_VARS) {
+        char detail[64];
+        sprintf(detail, "%d (maximo de %d)", prog.num_vars, SESSION_MAX_VARS);
+        set_error(status, ERR_TOO_MANY_VARIABLES, -1, detail);
+        free_program(&prog);
+        return 0;
+    }
+
+    // os nomes ficam na sessão para session_var_name
+    for (int j = 0; j < prog.num_vars; j++) {
+        span_parser p = { s, NULL, 0, 0, 0, 0, 0 };
+        int var = intern_name(&p, prog.var_names[j], strlen(prog.var_names[j]));
+        if (var < 0) {
+            free_program(&prog);
+            set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+            return 0;
+        }
+        s->names[var].uses = 1;
+    }
+    if (!assign_slots(s, status)) {
+        free_program(&prog);
+        return 0;
+    }
+    clear_cells(s, s->words);
+
+    s->fallback = malloc(sizeof(uint64_t) * s->words);
+    if (!s->fallback) {
+        free_program(&prog);
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+    int evaluated = evaluate_blocks(&prog, 0, s->words, s->fallback);
+    free_program(&prog);
+    if (!evaluated) {
+        free(s->fallback);
+        s->fallback = NULL;
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+    if (s->words == 1) s->fallback[0] &= s->mask;
+
+    s->valid = 1;
+    s->update.computed = 1;
+    return 1;
+}
+
+static int rebuild(edit_session *s, error_status *status) {
+    int new_name;
+
+    clear_tree(s);
+    s->update = (session_update) { 1, (int) s->length, 0, 0 };
+    s->valid = 0;
+    s->tree_valid = 0;
+
+    s->root = parse_span(s, 0, s->length, 0, &new_name);
+    if (s->root < 0) return rebuild_from_program(s, status);
+    if (!assign_slots(s, status)) return 0;
+    clear_cells(s, s->words);
+    if (!rebuild_buckets(s) || !intern_created(s)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+
+    s->root_cell = s->nodes[s->root].cell;
+    s->valid = 1;
+    s->tree_valid = 1;
+    return 1;
+}
+
+// o texto novo não cabe na árvore: se a leitura da linha de comando também o
+// rejeita, a árvore antiga fica à espera da correção, com o trecho alterado anotado
+static int keep_pending(edit_session *s, error_status *status) {
+    program prog;
+
+    if (parse_expression(s->text, &prog, status)) {
+        free_program(&prog);
+        return rebuild(s, status);
+    }
+    s->valid = 0;
+    s->update = (session_update) { 0, (int) s->length, 0, 0 };
+    return 0;
+}
+
+// --- interface ---
+
+edit_session *session_create(void) {
+    edit_session *s = calloc(1, sizeof(edit_session));
+    if (!s) return NULL;
+
+    s->text = calloc(1, 1);
+    if (!s->text) {
+        free(s);
+        return NULL;
+    }
+    s->free_node = -1;
+    s->free_cell = -1;
+    s->root = -1;
+    s->root_cell = -1;
+    return s;
+}
+
+void session_destroy(edit_session *s) {
+    if (!s) return;
+    clear_tree(s);
+    for (int c = 0; c < s->num_cells; c++) free(s->cells[c].bits);
+    free(s->text);
+    free(s->nodes);
+    free(s->created);
+    free(s->names);
+    free(s->cells);
+    free(s->buckets);
+    free(s);
+}
+
+int session_set_text(edit_session *s, const char *text, error_status *status) {
+    init_error_status(status);
+
+    size_t length = text ? strlen(text) : 0;
+    char *copy = malloc(length + 1);
+    if (!copy) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+    if (length > 0) memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    free(s->text);
+    s->text = copy;
+    s->length = length;
+    return rebuild(s, status);
+}
+
+// posição depois da edição; posições dentro do trecho removido vão para 'inside'
+static size_t shift_position(size_t position, size_t offset, size_t removed, size_t added, size_t inside) {
+    if (position >= offset + removed) return position + added - removed;
+    return position > offset ? inside : position;
+}
+
+// desloca os trechos de todos os nós para as posições depois da edição; um nó
+// que começa ou termina dentro do trecho removido passa a não conter a edição
+static void shift_spans(edit_session *s, size_t offset, size_t removed, size_t added) {
+    for (int i = 0; i < s->num_nodes; i++) {
+        session_node *node = &s->nodes[i];
+        if (node->op < 0) continue;
+        node->start = shift_position(node->start, offset, removed, added, offset + added);
+        node->end = shift_position(node->end, offset, removed, added, offset);
+    }
+}
+
+int session_edit(edit_session *s, size_t offset, size_t removed, const char *inserted, error_status *status) {
+    size_t added = inserted ? strlen(inserted) : 0;
+
+    init_error_status(status);
+    if (offset > s->length || removed > s->length - offset) {
+        set_error(status, ERR_INVALID_ARGUMENT, -1, "trecho alem do fim do texto");
+        return 0;
+    }
+
+    char *text = malloc(s->length - removed + added + 1);
+    if (!text) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        return 0;
+    }
+    memcpy(text, s->text, offset);
+    if (added > 0) memcpy(text + offset, inserted, added);
+    memcpy(text + offset + added, s->text + offset + removed, s->length - offset - removed + 1);
+
+    size_t old_length = s->length;
+    free(s->text);
+    s->text = text;
+    s->length = old_length - removed + added;
+
+    if (!s->tree_valid) return rebuild(s, status);
+
+    // trecho alterado desde a árvore, somando as edições feitas com o texto inválido
+    size_t first = offset, last = offset + removed;
+    if (!s->valid) {
+        if (s->dirty_start < first) first = s->dirty_start;
+        if (s->dirty_end > last) last = s->dirty_end;
+    }
+
+    // o menor nó que contém o trecho com um caractere de folga de cada lado: os
+    // tokens logo fora do trecho relido continuam separados como antes; sem
+    // folga (edição no começo ou no fim) o texto inteiro é relido
+    int node = s->root;
+    while (first > 0 && last < old_length) {
+        size_t low = first - 1, high = last + 1;
+        const session_node *n = &s->nodes[node];
+        int next = -1;
+        if (n->left >= 0 && s->nodes[n->left].start <= low && s->nodes[n->left].end >= high) next = n->left;
+        else if (n->right >= 0 && s->nodes[n->right].start <= low && s->nodes[n->right].end >= high) next = n->right;
+        if (next < 0) break;
+        node = next;
+    }
+
+    shift_spans(s, offset, removed, added);
+    s->dirty_start = first;
+    s->dirty_end = last + added - removed;
+    s->update = (session_update) { 0, 0, 0, 0 };
+
+    // sobe até um trecho que, relido sozinho, ocupa a mesma posição na árvore: um
+    // operando completo (variável, grupo ou negação) ou a expressão inteira
+    int replacement = -1, new_name = 0;
+    for (; node >= 0; node = s->nodes[node].parent) {
+        int is_root = s->nodes[node].parent < 0;
+        size_t start = is_root ? 0 : s->nodes[node].start;
+        size_t end = is_root ? s->length : s->nodes[node].end;
+
+        replacement = parse_span(s, start, end, !is_root, &new_name);
+        if (replacement >= 0) {
+            s->update.reparsed = (int) (end - start);
+            break;
+        }
+    }
+    if (replacement < 0) return keep_pending(s, status);
+
+    // o conjunto de variáveis mudou: as colunas da tabela mudam e tudo é refeito
+    int parent = s->nodes[node].parent;
+    free_subtree(s, node);
+    for (int i = 0; i < s->num_names; i++)
+        if (s->names[i].uses == 0 && s->names[i].slot >= 0) new_name = 1;
+    if (new_name) return rebuild(s, status);
+
+    s->nodes[replacement].parent = parent;
+    if (parent < 0) {
+        s->root = replacement;
+    } else if (s->nodes[parent].left == node) {
+        s->nodes[parent].left = replacement;
+    } else {
+        s->nodes[parent].right = replacement;
+    }
+
+    // células da subárvore nova e dos ancestrais; os irmãos mantêm as suas
+    s->valid = 1;
+    int ok = intern_created(s);
+    for (int a = parent; ok && a >= 0; a = s->nodes[a].parent) ok = intern_node(s, a);
+    s->root_cell = s->nodes[s->root].cell;
+    if (!ok || !collect_cells(s)) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        s->valid = 0;
+        s->tree_valid = 0;
+        return 0;
+    }
+    return 1;
+}
+
+const char *session_text(const edit_session *s) {
+    return s->text;
+}
+
+session_update session_last_update(const edit_session *s) {
+    return s->update;
+}
+
+int session_num_vars(const edit_session *s) {
+    return s->valid ? s->num_vars : 0;
+}
+
+const char *session_var_name(const edit_session *s, int slot) {
+    if (!s->valid || slot < 0 || slot >= s->num_vars) return NULL;
+    for (int i = 0; i < s->num_names; i++)
+        if (s->names[i].slot == slot) return s->names[i].name;
+    return NULL;
+}
+
+const uint64_t *session_table(const edit_session *s, uint64_t *words) {
+    if (!s->valid) return NULL;
+    *words = s->words;
+    return s->tree_valid ? s->cells[s->root_cell].bits : s->fallback;
+}
+
+uint64_t session_count(const edit_session *s) {
+    uint64_t words, count = 0;
+    const uint64_t *table = session_table(s, &words);
+
+    for (uint64_t w = 0; table && w < words; w++) count += (uint64_t) count_word_ones(table[w]);
+    return count;
+}
+
+formula_class session_class(const edit_session *s) {
+    uint64_t count = session_count(s);
+
+    if (count == 0) return CLASS_CONTRADICTION;
+    if (count == 1ULL << s->num_vars) return CLASS_TAUTOLOGY;
+    return CLASS_CONTINGENT;
+}
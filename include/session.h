@@ -0,0 +1,125 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "classify.h"   // formula_class
+#include "validation.h" // status de erro
+
+#define SESSION_MAX_VARS 22 ///< maior tabela mantida pela sessão (um bitmap de 2^22 linhas por subfórmula)
+
+/// @brief sessão de edição (opaca): texto, árvore com trechos e bitmaps por subfórmula
+///
+/// cada subfórmula distinta (hash-consing sobre operador e operandos) guarda a
+/// tabela inteira em palavras de 64 linhas. uma edição relê apenas o menor
+/// operando que contém o trecho alterado e recalcula só as subfórmulas novas:
+/// a do trecho relido e as dos seus ancestrais; irmãos intocados reaproveitam
+/// os bitmaps
+typedef struct edit_session edit_session;
+
+/// @brief o que a última atualização precisou fazer
+typedef struct {
+    int full;     ///< 1 = tudo refeito (texto novo, variável nova ou removida, ou texto fora da gramática)
+    int reparsed; ///< caracteres relidos
+    int computed; ///< bitmaps calculados
+    int reused;   ///< bitmaps aproveitados da versão anterior
+} session_update;
+
+/**
+ * @brief cria uma sessão vazia
+ *
+ * @return edit_session* sessão ou NULL em falha de alocação
+ */
+edit_session *session_create(void);
+
+/**
+ * @brief libera a sessão e todos os bitmaps
+ *
+ * @param s sessão (NULL é aceito)
+ */
+void session_destroy(edit_session *s);
+
+/**
+ * @brief substitui o texto inteiro, recalculando tudo
+ *
+ * @param s sessão
+ * @param text expressão lógica
+ * @param status recebe o mesmo erro que a linha de comando daria para o texto
+ * @return int 1 se a expressão é válida, 0 caso contrário (o texto é guardado mesmo assim)
+ */
+int session_set_text(edit_session *s, const char *text, error_status *status);
+
+/**
+ * @brief troca 'removed' bytes a partir de 'offset' por 'inserted'
+ *
+ * depois de um texto inválido a próxima edição refaz tudo
+ *
+ * @param s sessão
+ * @param offset posição da edição no texto atual
+ * @param removed bytes removidos a partir de 'offset'
+ * @param inserted texto inserido (NULL = nada)
+ * @param status recebe o mesmo erro que a linha de comando daria para o texto novo
+ * @return int 1 se o texto novo é válido, 0 caso contrário (o texto é guardado mesmo assim)
+ */
+int session_edit(edit_session *s, size_t offset, size_t removed, const char *inserted, error_status *status);
+
+/**
+ * @brief texto atual da sessão
+ *
+ * @param s sessão
+ * @return const char* texto (válido até a próxima edição)
+ */
+const char *session_text(const edit_session *s);
+
+/**
+ * @brief resumo da última chamada de session_set_text ou session_edit
+ *
+ * @param s sessão
+ * @return session_update trabalho feito
+ */
+session_update session_last_update(const edit_session *s);
+
+/**
+ * @brief número de variáveis do texto atual
+ *
+ * @param s sessão com texto válido
+ * @return int número de variáveis (0 se o texto é inválido)
+ */
+int session_num_vars(const edit_session *s);
+
+/**
+ * @brief nome da variável de um slot, na ordem das colunas da tabela
+ *
+ * @param s sessão com texto válido
+ * @param slot slot da variável
+ * @return const char* nome ou NULL fora do intervalo
+ */
+const char *session_var_name(const edit_session *s, int slot);
+
+/**
+ * @brief tabela do texto atual: o bit r da palavra w é o resultado da linha w * 64 + r
+ *
+ * @param s sessão
+ * @param words recebe o número de palavras
+ * @return const uint64_t* palavras (válidas até a próxima edição) ou NULL se o texto é inválido
+ */
+const uint64_t *session_table(const edit_session *s, uint64_t *words);
+
+/**
+ * @brief linhas verdadeiras do texto atual
+ *
+ * @param s sessão com texto válido
+ * @return uint64_t contagem
+ */
+uint64_t session_count(const edit_session *s);
+
+/**
+ * @brief classificação do texto atual, lida da contagem
+ *
+ * @param s sessão com texto válido
+ * @return formula_class tautologia, contradição ou contingente
+ */
+formula_class session_class(const edit_session *s);
+
+#endif // SESSION_H
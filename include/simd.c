@@ -0,0 +1,157 @@
+#include "simd.h"
+#include "stats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define SIMD_X86_GCC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define SIMD_X86_MSVC
+#endif
+
+// núcleo portável: uma palavra de 64 linhas por passada
+static int portable_run(const program *prog, uint64_t first_block, uint64_t *out) {
+    return evaluate_block(prog, first_block, out);
+}
+
+static const eval_kernel portable_kernel = { "portable", 1, portable_run };
+
+// registradores cpuid da folha/subfolha pedida
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(SIMD_X86_GCC)
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#elif defined(SIMD_X86_MSVC)
+    int r[4];
+    __cpuidex(r, (int) leaf, (int) subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (unsigned) r[i];
+#else
+    (void) leaf; (void) subleaf;
+#endif
+}
+
+// estado de registradores habilitado pelo sistema operacional (XCR0)
+static unsigned long long xgetbv0(void) {
+#if defined(SIMD_X86_GCC)
+    unsigned lo, hi;
+    __asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long) hi << 32) | lo;
+#elif defined(SIMD_X86_MSVC)
+    return _xgetbv(0);
+#else
+    return 0;
+#endif
+}
+
+// verifica suporte da CPU e do sistema operacional: 1 = AVX2, 2 = AVX2 + AVX-512F
+static int detect_simd_level(void) {
+    unsigned regs[4];
+
+    cpuid(0, 0, regs);
+    if (regs[0] < 7) return 0;
+
+    cpuid(1, 0, regs);
+    int osxsave = (regs[2] >> 27) & 1;
+    int avx = (regs[2] >> 28) & 1;
+    if (!osxsave || !avx) return 0;
+
+    unsigned long long xcr0 = xgetbv0();
+    if ((xcr0 & 0x6) != 0x6) return 0; // estados XMM e YMM
+
+    cpuid(7, 0, regs);
+    int avx2 = (regs[1] >> 5) & 1;
+    int avx512f = (regs[1] >> 16) & 1;
+    if (!avx2) return 0;
+
+    if (avx512f && (xcr0 & 0xE6) == 0xE6) return 2; // opmask e ZMM
+    return 1;
+}
+
+int supported_eval_kernels(const eval_kernel **kernels, int max) {
+    int count = 0;
+    int level = detect_simd_level();
+
+    if (count < max) kernels[count++] = &portable_kernel;
+    if (level >= 1 && avx2_eval_kernel() && count < max) kernels[count++] = avx2_eval_kernel();
+    if (level >= 2 && avx512_eval_kernel() && count < max) kernels[count++] = avx512_eval_kernel();
+
+    return count;
+}
+
+static const eval_kernel *selected; // escrito só por choose_kernel, uma vez por processo
+
+static void choose_kernel(void) {
+    const eval_kernel *kernels[3];
+    int count = supported_eval_kernels(kernels, 3);
+    selected = kernels[count - 1];
+}
+
+#ifdef _WIN32
+static INIT_ONCE select_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK choose_kernel_once(PINIT_ONCE once, PVOID param, PVOID *context) {
+    (void) once; (void) param; (void) context;
+    choose_kernel();
+    return TRUE;
+}
+#else
+static pthread_once_t select_once = PTHREAD_ONCE_INIT;
+#endif
+
+const eval_kernel *select_eval_kernel(void) {
+    // a primeira chamada detecta; as concorrentes esperam por ela e veem o núcleo já publicado
+#ifdef _WIN32
+    InitOnceExecuteOnce(&select_once, choose_kernel_once, NULL, NULL);
+#else
+    pthread_once(&select_once, choose_kernel);
+#endif
+    return selected;
+}
+
+// programas maiores que as pilhas dos núcleos: uma área no heap para todos os blocos
+static int evaluate_deep_blocks(const program *prog, uint64_t first_block, uint64_t count, uint64_t *out) {
+    uint64_t words[MAX_TABLE_VARS];
+    uint64_t *stack = malloc(sizeof(uint64_t) * (prog->max_depth + prog->num_temps));
+
+    if (!stack) return 0;
+    for (uint64_t i = 0; i < count; i++) {
+        load_block_words(prog, first_block + i, words);
+        out[i] = run_program_word(prog, words, stack);
+    }
+    free(stack);
+    return 1;
+}
+
+int evaluate_blocks_with(const eval_kernel *kernel, const program *prog,
+                         uint64_t first_block, uint64_t count, uint64_t *out) {
+    uint64_t done = 0;
+    uint64_t width = (uint64_t) kernel->words_per_pass;
+    int ok = 1;
+    STATS_BEGIN(start);
+
+    if (prog->max_depth + prog->num_temps > BLOCK_STACK_DEPTH) {
+        ok = evaluate_deep_blocks(prog, first_block, count, out);
+    } else {
+        // passadas completas com o núcleo vetorial
+        for (; ok && done + width <= count; done += width)
+            ok = kernel->run(prog, first_block + done, out + done);
+
+        // blocos restantes, um por vez
+        for (; ok && done < count; done++)
+            ok = evaluate_block(prog, first_block + done, out + done);
+    }
+
+    STATS_END(STATS_EVALUATE, start);
+    STATS_PROGRAM(prog, count);
+    return ok;
+}
+
+int evaluate_blocks(const program *prog, uint64_t first_block, uint64_t count, uint64_t *out) {
+    return evaluate_blocks_with(select_eval_kernel(), prog, first_block, count, out);
+}
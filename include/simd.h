@@ -0,0 +1,61 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "bitslice.h" // avaliação empacotada de 64 linhas por palavra
+
+/// @brief núcleo de avaliação que processa vários blocos de 64 linhas por passada
+typedef struct eval_kernel {
+    const char *name;   ///< nome do núcleo ("portable", "avx2", "avx512")
+    int words_per_pass; ///< blocos de 64 linhas avaliados em cada passada
+    /// avalia os blocos first_block .. first_block + words_per_pass - 1 em out; 0 em falha de alocação
+    int (*run)(const program *prog, uint64_t first_block, uint64_t *out);
+} eval_kernel;
+
+/**
+ * @brief escolhe o melhor núcleo suportado pela CPU atual (consulta CPUID uma vez)
+ *
+ * @return const eval_kernel* núcleo selecionado; nunca NULL (há sempre o portável)
+ */
+const eval_kernel *select_eval_kernel(void);
+
+/**
+ * @brief lista os núcleos que podem ser executados nesta CPU, do mais simples ao mais largo
+ *
+ * @param kernels array de saída
+ * @param max capacidade do array
+ * @return int número de núcleos escritos
+ */
+int supported_eval_kernels(const eval_kernel **kernels, int max);
+
+/**
+ * @brief avalia 'count' blocos consecutivos com um núcleo específico
+ *
+ * passadas completas usam o núcleo; o restante é avaliado bloco a bloco.
+ * programas com pilha e temporários acima de BLOCK_STACK_DEPTH usam o caminho portável
+ *
+ * @param kernel núcleo a utilizar
+ * @param prog programa compilado
+ * @param first_block primeiro bloco
+ * @param count número de blocos
+ * @param out array de saída com 'count' palavras
+ * @return int 1 em caso de sucesso, 0 se a área de um programa profundo não pôde ser alocada
+ */
+int evaluate_blocks_with(const eval_kernel *kernel, const program *prog,
+                         uint64_t first_block, uint64_t count, uint64_t *out);
+
+/**
+ * @brief avalia 'count' blocos consecutivos com o núcleo selecionado para esta CPU
+ *
+ * @param prog programa compilado
+ * @param first_block primeiro bloco
+ * @param count número de blocos
+ * @param out array de saída com 'count' palavras
+ * @return int 1 em caso de sucesso, 0 em falha de alocação (como evaluate_blocks_with)
+ */
+int evaluate_blocks(const program *prog, uint64_t first_block, uint64_t count, uint64_t *out);
+
+// núcleos específicos de ISA; retornam NULL quando o arquivo foi compilado sem o conjunto de instruções
+const eval_kernel *avx2_eval_kernel(void);
+const eval_kernel *avx512_eval_kernel(void);
+
+#endif // SIMD_H
@@ -0,0 +1,61 @@
+#include "simd.h"
+
+// compilado com -mavx2 (ou /arch:AVX2); só é chamado após a verificação de CPUID
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#define AVX2_WORDS 4 // 4 blocos de 64 linhas = 256 linhas por passada
+
+// pilha local: o núcleo só recebe programas até BLOCK_STACK_DEPTH e nunca falha
+static int avx2_run(const program *prog, uint64_t first_block, uint64_t *out) {
+    __m256i vars[MAX_TABLE_VARS];
+    __m256i stack[BLOCK_STACK_DEPTH];
+    __m256i *temps = stack + prog->max_depth; // temporários logo depois da pilha
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    int top = -1;
+
+    // palavras das variáveis: máscaras fixas nos bits baixos, constantes por bloco nos demais
+    for (int j = 0; j < prog->num_vars; j++) {
+        int bit = prog->num_vars - j - 1;
+        if (bit < 6) {
+            vars[j] = _mm256_set1_epi64x((long long) block_lane_masks[bit]);
+        } else {
+            long long lane[AVX2_WORDS];
+            for (int l = 0; l < AVX2_WORDS; l++)
+                lane[l] = (((first_block + l) * ROWS_PER_WORD >> bit) & 1) ? -1LL : 0LL;
+            vars[j] = _mm256_set_epi64x(lane[3], lane[2], lane[1], lane[0]);
+        }
+    }
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        switch (ins->op) {
+            case OP_LOAD:    stack[++top] = vars[ins->slot]; break;
+            case OP_NOT:     stack[top] = _mm256_xor_si256(stack[top], ones); break;
+            case OP_AND:     top--; stack[top] = _mm256_and_si256(stack[top], stack[top+1]); break;
+            case OP_OR:      top--; stack[top] = _mm256_or_si256(stack[top], stack[top+1]); break;
+            case OP_IMPLIES: top--; stack[top] = _mm256_or_si256(_mm256_xor_si256(stack[top], ones), stack[top+1]); break;
+            case OP_IFF:     top--; stack[top] = _mm256_xor_si256(_mm256_xor_si256(stack[top], stack[top+1]), ones); break;
+            case OP_CONST:   stack[++top] = ins->slot ? ones : _mm256_setzero_si256(); break;
+            case OP_STORE:   temps[ins->slot] = stack[top]; break;
+            case OP_FETCH:   stack[++top] = temps[ins->slot]; break;
+        }
+    }
+
+    _mm256_storeu_si256((__m256i *) out, stack[0]);
+    return 1;
+}
+
+static const eval_kernel avx2_kernel = { "avx2", AVX2_WORDS, avx2_run };
+
+const eval_kernel *avx2_eval_kernel(void) {
+    return &avx2_kernel;
+}
+
+#else
+
+const eval_kernel *avx2_eval_kernel(void) {
+    return NULL;
+}
+
+#endif
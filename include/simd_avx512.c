@@ -0,0 +1,87 @@
+#include "simd.h"
+
+// compilado com -mavx512f (ou /arch:AVX512); só é chamado após a verificação de CPUID
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+#define AVX512_WORDS 8 // 8 blocos de 64 linhas = 512 linhas por passada
+
+// tabelas-verdade de 3 entradas para vpternlogq (a = 0xF0, b = 0xCC)
+#define TERN_NOT_A     0x0F // ~a
+#define TERN_A_IMPL_B  0xCF // ~a | b
+#define TERN_A_IFF_B   0xC3 // ~(a ^ b)
+
+// pilha local: o núcleo só recebe programas até BLOCK_STACK_DEPTH e nunca falha
+static int avx512_run(const program *prog, uint64_t first_block, uint64_t *out) {
+    __m512i vars[MAX_TABLE_VARS];
+    __m512i stack[BLOCK_STACK_DEPTH];
+    __m512i *temps = stack + prog->max_depth; // temporários logo depois da pilha
+    int top = -1;
+
+    // palavras das variáveis: máscaras fixas nos bits baixos, constantes por bloco nos demais
+    for (int j = 0; j < prog->num_vars; j++) {
+        int bit = prog->num_vars - j - 1;
+        if (bit < 6) {
+            vars[j] = _mm512_set1_epi64((long long) block_lane_masks[bit]);
+        } else {
+            long long lane[AVX512_WORDS];
+            for (int l = 0; l < AVX512_WORDS; l++)
+                lane[l] = (((first_block + l) * ROWS_PER_WORD >> bit) & 1) ? -1LL : 0LL;
+            vars[j] = _mm512_set_epi64(lane[7], lane[6], lane[5], lane[4], lane[3], lane[2], lane[1], lane[0]);
+        }
+    }
+
+    for (int i = 0; i < prog->length; i++) {
+        const instruction *ins = &prog->code[i];
+        __m512i a, b;
+        switch (ins->op) {
+            case OP_LOAD:
+                stack[++top] = vars[ins->slot];
+                break;
+            case OP_NOT:
+                a = stack[top];
+                stack[top] = _mm512_ternarylogic_epi64(a, a, a, TERN_NOT_A);
+                break;
+            case OP_AND:
+                top--; stack[top] = _mm512_and_si512(stack[top], stack[top+1]);
+                break;
+            case OP_OR:
+                top--; stack[top] = _mm512_or_si512(stack[top], stack[top+1]);
+                break;
+            case OP_IMPLIES:
+                top--; a = stack[top]; b = stack[top+1];
+                stack[top] = _mm512_ternarylogic_epi64(a, b, b, TERN_A_IMPL_B);
+                break;
+            case OP_IFF:
+                top--; a = stack[top]; b = stack[top+1];
+                stack[top] = _mm512_ternarylogic_epi64(a, b, b, TERN_A_IFF_B);
+                break;
+            case OP_CONST:
+                stack[++top] = _mm512_set1_epi64(ins->slot ? -1LL : 0LL);
+                break;
+            case OP_STORE:
+                temps[ins->slot] = stack[top];
+                break;
+            case OP_FETCH:
+                stack[++top] = temps[ins->slot];
+                break;
+        }
+    }
+
+    _mm512_storeu_si512((void *) out, stack[0]);
+    return 1;
+}
+
+static const eval_kernel avx512_kernel = { "avx512", AVX512_WORDS, avx512_run };
+
+const eval_kernel *avx512_eval_kernel(void) {
+    return &avx512_kernel;
+}
+
+#else
+
+const eval_kernel *avx512_eval_kernel(void) {
+    return NULL;
+}
+
+#endif
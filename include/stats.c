@@ -0,0 +1,200 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+#include "compile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+stats_flag stats_active = 0;
+
+static const char *phase_names[STATS_PHASES] = { "read", "compile", "evaluate", "format", "write" };
+static const char *phase_labels[STATS_PHASES] = { "leitura", "compilacao", "avaliacao", "formatacao", "gravacao" };
+
+uint64_t stats_now(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * 1e9 / (double) frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+#if LOGIC_STATS
+
+#ifdef _MSC_VER
+#define STATS_THREAD_LOCAL __declspec(thread)
+#else
+#define STATS_THREAD_LOCAL _Thread_local
+#endif
+
+// contadores de uma thread; só a própria thread escreve, e a soma é feita
+// depois que as threads terminaram (ou entre rodadas do pool)
+typedef struct stats_slot {
+    uint64_t nanoseconds[STATS_PHASES];
+    uint64_t calls[STATS_PHASES];
+    uint64_t counters[STATS_COUNTERS];
+    int stack_high_water;
+    struct stats_slot *next;
+} stats_slot;
+
+static STATS_THREAD_LOCAL stats_slot *local_slot; // contadores da thread atual
+static STATS_THREAD_LOCAL int local_generation;   // coleta em que 'local_slot' foi registrado
+static stats_slot *slots;                         // todas as threads que mediram algo
+static stats_flag generation = 1;                 // muda a cada liberação dos contadores
+static uint64_t enabled_at;                       // instante de stats_enable
+
+#ifdef _WIN32
+static SRWLOCK slots_lock = SRWLOCK_INIT;
+static void lock_slots(void)   { AcquireSRWLockExclusive(&slots_lock); }
+static void unlock_slots(void) { ReleaseSRWLockExclusive(&slots_lock); }
+#else
+static pthread_mutex_t slots_lock = PTHREAD_MUTEX_INITIALIZER;
+static void lock_slots(void)   { pthread_mutex_lock(&slots_lock); }
+static void unlock_slots(void) { pthread_mutex_unlock(&slots_lock); }
+#endif
+
+// contadores da thread atual, registrados na primeira medida de cada coleta; o
+// ponteiro de uma coleta anterior já foi liberado e não é mais seguido
+static stats_slot *thread_slot(void) {
+    if (local_slot && local_generation == generation) return local_slot;
+
+    stats_slot *slot = calloc(1, sizeof(stats_slot));
+    if (!slot) return NULL;
+
+    lock_slots();
+    slot->next = slots;
+    slots = slot;
+    local_generation = generation;
+    unlock_slots();
+    local_slot = slot;
+    return slot;
+}
+
+// libera os contadores de todas as threads; a nova geração faz cada thread
+// registrar um slot novo em vez de usar o que ficou no seu ponteiro local
+static void release_slots(void) {
+    lock_slots();
+    while (slots) {
+        stats_slot *next = slots->next;
+        free(slots);
+        slots = next;
+    }
+    generation = generation + 1;
+    unlock_slots();
+    local_slot = NULL;
+}
+
+int stats_enable(void) {
+    release_slots();
+    enabled_at = stats_now();
+    stats_active = 1;
+    return 1;
+}
+
+void stats_disable(void) {
+    stats_active = 0;
+    release_slots();
+}
+
+void stats_add_time(stats_phase phase, uint64_t nanoseconds) {
+    stats_slot *slot = thread_slot();
+    if (!slot) return;
+    slot->nanoseconds[phase] += nanoseconds;
+    slot->calls[phase]++;
+}
+
+void stats_add(stats_counter counter, uint64_t amount) {
+    stats_slot *slot = thread_slot();
+    if (slot) slot->counters[counter] += amount;
+}
+
+void stats_add_program(const program *prog, uint64_t words) {
+    stats_slot *slot = thread_slot();
+    if (!slot) return;
+
+    // carregamentos, constantes e temporários não são operadores
+    uint64_t operators = 0;
+    for (int i = 0; i < prog->length; i++) {
+        op_code op = prog->code[i].op;
+        operators += op != OP_LOAD && op != OP_CONST && op != OP_STORE && op != OP_FETCH;
+    }
+
+    // tabelas com menos de 64 linhas ocupam uma palavra só parcialmente
+    slot->counters[STATS_ROWS] += prog->num_vars < 6 ? words << prog->num_vars : words * 64;
+    slot->counters[STATS_OPERATIONS] += operators * words;
+    if (prog->max_depth > slot->stack_high_water) slot->stack_high_water = prog->max_depth;
+}
+
+void stats_collect(stats_report *report) {
+    memset(report, 0, sizeof(*report));
+    if (stats_active) report->wall_nanoseconds = stats_now() - enabled_at;
+
+    lock_slots();
+    for (const stats_slot *slot = slots; slot; slot = slot->next) {
+        for (int p = 0; p < STATS_PHASES; p++) {
+            report->nanoseconds[p] += slot->nanoseconds[p];
+            report->calls[p] += slot->calls[p];
+        }
+        for (int c = 0; c < STATS_COUNTERS; c++) report->counters[c] += slot->counters[c];
+        if (slot->stack_high_water > report->stack_high_water) report->stack_high_water = slot->stack_high_water;
+        report->threads++;
+    }
+    unlock_slots();
+}
+
+#else
+
+// instrumentação removida na compilação: nada é medido
+int stats_enable(void) { return 0; }
+void stats_disable(void) {}
+void stats_add_time(stats_phase phase, uint64_t nanoseconds) { (void) phase; (void) nanoseconds; }
+void stats_add(stats_counter counter, uint64_t amount) { (void) counter; (void) amount; }
+void stats_add_program(const program *prog, uint64_t words) { (void) prog; (void) words; }
+void stats_collect(stats_report *report) { memset(report, 0, sizeof(*report)); }
+
+#endif
+
+void stats_print(const stats_report *report, FILE *out) {
+    fprintf(out, "estatisticas: %.3f ms decorridos, threads: %d (tempos somados entre as threads)\n",
+            report->wall_nanoseconds / 1e6, report->threads);
+    for (int p = 0; p < STATS_PHASES; p++)
+        fprintf(out, "  %-12s %12.3f ms  %10llu trechos\n", phase_labels[p], report->nanoseconds[p] / 1e6,
+                (unsigned long long) report->calls[p]);
+
+    uint64_t rows = report->counters[STATS_ROWS];
+    uint64_t evaluating = report->nanoseconds[STATS_EVALUATE];
+    fprintf(out, "  linhas avaliadas      %llu", (unsigned long long) rows);
+    if (rows > 0 && evaluating > 0) fprintf(out, " (%.3f ns/linha)", (double) evaluating / (double) rows);
+    fprintf(out, "\n  operadores aplicados  %llu (palavras de 64 linhas)\n",
+            (unsigned long long) report->counters[STATS_OPERATIONS]);
+    fprintf(out, "  pilha maxima          %d valores\n", report->stack_high_water);
+
+    uint64_t bytes = report->counters[STATS_BYTES];
+    uint64_t writing = report->nanoseconds[STATS_FORMAT] + report->nanoseconds[STATS_WRITE];
+    fprintf(out, "  bytes gravados        %llu", (unsigned long long) bytes);
+    if (bytes > 0 && writing > 0) fprintf(out, " (%.1f MB/s formatando e gravando)", bytes * 1e3 / (double) writing);
+    fprintf(out, "\n");
+}
+
+void stats_write_json(const stats_report *report, FILE *out) {
+    fprintf(out, "{\n  \"wall_ns\": %llu,\n  \"threads\": %d,\n  \"phases\": {\n",
+            (unsigned long long) report->wall_nanoseconds, report->threads);
+    for (int p = 0; p < STATS_PHASES; p++)
+        fprintf(out, "    \"%s\": {\"ns\": %llu, \"calls\": %llu}%s\n", phase_names[p],
+                (unsigned long long) report->nanoseconds[p], (unsigned long long) report->calls[p],
+                p + 1 < STATS_PHASES ? "," : "");
+    fprintf(out, "  },\n  \"rows\": %llu,\n  \"operations\": %llu,\n  \"stack_high_water\": %d,\n  \"bytes\": %llu\n}\n",
+            (unsigned long long) report->counters[STATS_ROWS], (unsigned long long) report->counters[STATS_OPERATIONS],
+            report->stack_high_water, (unsigned long long) report->counters[STATS_BYTES]);
+}
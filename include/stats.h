@@ -0,0 +1,153 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// instrumentação dos caminhos quentes: com LOGIC_STATS = 0 as macros abaixo
+// não geram código; compilada, cada ponto custa um teste de 'stats_active'
+// enquanto a coleta está desligada
+#ifndef LOGIC_STATS
+#define LOGIC_STATS 1
+#endif
+
+/// @brief fases com tempo medido
+typedef enum stats_phase {
+    STATS_READ,     ///< leitura e validação da expressão (read_expression)
+    STATS_COMPILE,  ///< compilação para o programa pós-fixo
+    STATS_EVALUATE, ///< cálculo dos resultados das linhas (qualquer motor)
+    STATS_FORMAT,   ///< texto das linhas, sem o tempo de avaliação
+    STATS_WRITE,    ///< gravação no destino (fwrite, fflush, munmap)
+    STATS_PHASES
+} stats_phase;
+
+/// @brief contadores somados entre as threads
+typedef enum stats_counter {
+    STATS_ROWS,       ///< linhas avaliadas
+    STATS_OPERATIONS, ///< operadores aplicados pelo programa, uma vez por palavra de 64 linhas
+    STATS_BYTES,      ///< bytes entregues ao destino da tabela
+    STATS_COUNTERS
+} stats_counter;
+
+/// @brief totais de uma coleta
+typedef struct {
+    uint64_t nanoseconds[STATS_PHASES]; ///< tempo de cada fase, somado entre as threads
+    uint64_t calls[STATS_PHASES];       ///< trechos medidos de cada fase
+    uint64_t counters[STATS_COUNTERS];  ///< contadores
+    int stack_high_water;               ///< maior pilha de valores usada por um programa avaliado
+    int threads;                        ///< threads que registraram alguma medida
+    uint64_t wall_nanoseconds;          ///< tempo decorrido desde stats_enable
+} stats_report;
+
+// lido pelas threads de trabalho enquanto outra thread liga ou desliga a coleta
+#if defined(_MSC_VER) && !defined(__clang__)
+typedef volatile long stats_flag; ///< no MSVC, volatile tem semântica de aquisição e liberação
+#else
+typedef _Atomic int stats_flag;
+#endif
+
+/// @brief 1 enquanto a coleta está ligada (lido pelas macros)
+extern stats_flag stats_active;
+
+/**
+ * @brief relógio monotônico em nanossegundos
+ *
+ * @return uint64_t instante atual (apenas diferenças têm significado)
+ */
+uint64_t stats_now(void);
+
+/**
+ * @brief zera os totais e liga a coleta
+ *
+ * @return int 1 em caso de sucesso, 0 se a instrumentação foi removida na compilação
+ */
+int stats_enable(void);
+
+/**
+ * @brief desliga a coleta e libera os contadores das threads
+ *
+ * deve ser chamada sem outras threads medindo (depois que os pools terminaram)
+ */
+void stats_disable(void);
+
+/**
+ * @brief soma 'nanoseconds' ao tempo da fase na thread atual
+ *
+ * @param phase fase
+ * @param nanoseconds duração do trecho
+ */
+void stats_add_time(stats_phase phase, uint64_t nanoseconds);
+
+/**
+ * @brief soma 'amount' ao contador na thread atual
+ *
+ * @param counter contador
+ * @param amount valor a somar
+ */
+void stats_add(stats_counter counter, uint64_t amount);
+
+struct program; // programa compilado (compile.h)
+
+/**
+ * @brief registra a avaliação de 'words' palavras de 64 linhas de um programa
+ *
+ * soma as linhas, os operadores aplicados e atualiza a pilha máxima
+ *
+ * @param prog programa avaliado
+ * @param words palavras avaliadas
+ */
+void stats_add_program(const struct program *prog, uint64_t words);
+
+/**
+ * @brief soma os contadores de todas as threads
+ *
+ * @param report totais de saída
+ */
+void stats_collect(stats_report *report);
+
+/**
+ * @brief imprime os totais em texto, uma fase ou contador por linha
+ *
+ * @param report totais
+ * @param out destino
+ */
+void stats_print(const stats_report *report, FILE *out);
+
+/**
+ * @brief grava os totais em JSON
+ *
+ * @param report totais
+ * @param out destino
+ */
+void stats_write_json(const stats_report *report, FILE *out);
+
+// STATS_BEGIN declara 'start' e STATS_TOTAL um acumulador para STATS_LAP;
+// STATS_END_EXCEPT(fase, start, outro) desconta 'outro' do trecho. com a coleta
+// desligada 'start' fica em 0 e o trecho não é medido, mesmo que stats_enable
+// aconteça antes do fim dele
+#if LOGIC_STATS
+#define STATS_BEGIN(start) uint64_t start = stats_active ? stats_now() : 0
+#define STATS_TOTAL(total) uint64_t total = 0
+#define STATS_LAP(start, total) \
+    do { if (stats_active && (start)) (total) += stats_now() - (start); } while (0)
+#define STATS_END(phase, start) STATS_END_EXCEPT(phase, start, 0)
+#define STATS_END_EXCEPT(phase, start, other) \
+    do { if (stats_active && (start)) stats_add_time((phase), stats_now() - (start) - (other)); } while (0)
+#define STATS_ADD_TIME(phase, nanoseconds) \
+    do { if (stats_active) stats_add_time((phase), (nanoseconds)); } while (0)
+#define STATS_ADD(counter, amount) \
+    do { if (stats_active) stats_add((counter), (amount)); } while (0)
+#define STATS_PROGRAM(prog, words) \
+    do { if (stats_active) stats_add_program((prog), (words)); } while (0)
+#else
+#define STATS_BEGIN(start)
+#define STATS_TOTAL(total)
+#define STATS_LAP(start, total) ((void) 0)
+#define STATS_END(phase, start) ((void) 0)
+#define STATS_END_EXCEPT(phase, start, other) ((void) 0)
+#define STATS_ADD_TIME(phase, nanoseconds) ((void) 0)
+#define STATS_ADD(counter, amount) ((void) 0)
+#define STATS_PROGRAM(prog, words) ((void) 0)
+#endif
+
+#endif // STATS_H
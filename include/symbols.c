@@ -0,0 +1,78 @@
+#include <string.h>
+
+#include "symbols.h"
+
+#define SYMBOLS_INITIAL 16 // capacidade inicial (dobra quando enche)
+
+// FNV-1a sobre os caracteres do nome
+static unsigned hash_name(const char *name, int length) {
+    unsigned h = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        h ^= (unsigned char) name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// realoca os vetores na arena com o dobro da capacidade e reinsere os ids
+static int grow_table(symbol_table *table) {
+    int capacity = table->capacity ? table->capacity * 2 : SYMBOLS_INITIAL;
+    int num_buckets = capacity * 4;
+    symbol *symbols = arena_alloc(table->store, sizeof(symbol) * capacity);
+    int *buckets = arena_alloc(table->store, sizeof(int) * num_buckets);
+    if (!symbols || !buckets) return 0;
+
+    if (table->count) memcpy(symbols, table->symbols, sizeof(symbol) * table->count);
+    memset(buckets, 0, sizeof(int) * num_buckets);
+    for (int id = 0; id < table->count; id++) {
+        unsigned b = symbols[id].hash & (num_buckets - 1);
+        while (buckets[b]) b = (b + 1) & (num_buckets - 1);
+        buckets[b] = id + 1;
+    }
+
+    table->symbols = symbols;
+    table->capacity = capacity;
+    table->buckets = buckets;
+    table->num_buckets = num_buckets;
+    return 1;
+}
+
+void symbols_init(symbol_table *table, arena *store) {
+    table->store = store;
+    table->symbols = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->buckets = NULL;
+    table->num_buckets = 0;
+}
+
+int symbols_intern(symbol_table *table, const char *name, int length) {
+    unsigned h = hash_name(name, length);
+
+    if (table->num_buckets) {
+        unsigned b = h & (table->num_buckets - 1);
+        for (; table->buckets[b]; b = (b + 1) & (table->num_buckets - 1)) {
+            const symbol *s = &table->symbols[table->buckets[b] - 1];
+            if (s->hash == h && s->length == length && memcmp(s->name, name, length) == 0)
+                return table->buckets[b] - 1;
+        }
+    }
+
+    if (table->count == table->capacity && !grow_table(table)) return -1;
+
+    int id = table->count++;
+    table->symbols[id].name = name;
+    table->symbols[id].length = length;
+    table->symbols[id].hash = h;
+
+    unsigned b = h & (table->num_buckets - 1);
+    while (table->buckets[b]) b = (b + 1) & (table->num_buckets - 1);
+    table->buckets[b] = id + 1;
+    return id;
+}
+
+int symbols_compare(const symbol *a, const symbol *b) {
+    int n = a->length < b->length ? a->length : b->length;
+    int c = memcmp(a->name, b->name, n);
+    return c ? c : a->length - b->length;
+}
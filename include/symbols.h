@@ -0,0 +1,52 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include "arena.h"
+
+/// @brief identificador interno: aponta para o texto original da expressão
+typedef struct {
+    const char *name; ///< início do nome (não termina em '\0')
+    int length;       ///< número de caracteres do nome
+    unsigned hash;    ///< hash do nome
+} symbol;
+
+/// @brief tabela de símbolos com espalhamento aberto; toda a memória vem de uma arena
+typedef struct {
+    arena *store;    ///< arena de onde vêm os vetores (liberados com ela)
+    symbol *symbols; ///< símbolos pela ordem de primeira ocorrência (id = índice)
+    int count;       ///< número de símbolos
+    int capacity;    ///< capacidade de 'symbols'
+    int *buckets;    ///< id + 1 de cada balde (0 = vazio)
+    int num_buckets; ///< potência de 2, sempre maior que 2 * capacity
+} symbol_table;
+
+/**
+ * @brief inicializa uma tabela vazia sobre a arena
+ *
+ * @param table tabela a inicializar
+ * @param store arena usada pela tabela
+ */
+void symbols_init(symbol_table *table, arena *store);
+
+/**
+ * @brief devolve o id do nome, inserindo-o se ainda não existir
+ *
+ * o texto não é copiado: 'name' precisa continuar válido enquanto a tabela for usada
+ *
+ * @param table tabela de símbolos
+ * @param name início do nome
+ * @param length número de caracteres
+ * @return int id do símbolo (0, 1, ... na ordem de inserção) ou -1 em falha de alocação
+ */
+int symbols_intern(symbol_table *table, const char *name, int length);
+
+/**
+ * @brief compara dois nomes em ordem lexicográfica (a mesma de strcmp)
+ *
+ * @param a primeiro símbolo
+ * @param b segundo símbolo
+ * @return int negativo, zero ou positivo
+ */
+int symbols_compare(const symbol *a, const symbol *b);
+
+#endif // SYMBOLS_H
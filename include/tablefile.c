@@ -0,0 +1,415 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "tablefile.h"
+#include "eval.h"
+#include "bitslice.h"
+#include "simd.h"
+#include "parallel.h"
+#include "output.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define TABLE_FILE_HEADER 32    // bytes fixos do cabeçalho
+#define TABLE_FILE_ENTRY 16     // bytes de cada registro do diretório
+#define TABLE_FILE_ROUND 4      // blocos por thread em cada rodada de avaliação
+#define TABLE_FILE_MAX_CHUNK_BITS 31 // a contagem de um bloco cabe em u32
+
+// inteiro little-endian de 'bytes' bytes
+static void put_le(unsigned char *p, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) p[i] = (unsigned char) (v >> (8 * i));
+}
+
+static uint64_t get_le(const unsigned char *p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) v |= (uint64_t) p[i] << (8 * i);
+    return v;
+}
+
+static uint64_t get_le64(const unsigned char *p) {
+    return get_le(p, 8);
+}
+
+// registro do diretório em memória, enquanto o arquivo é gravado
+typedef struct {
+    uint64_t offset;
+    uint32_t kind;
+    uint32_t ones;
+} chunk_entry;
+
+// blocos de uma rodada, avaliados em paralelo
+typedef struct {
+    const program *prog;
+    uint64_t first_chunk;
+    uint64_t chunk_words; // palavras por bloco
+    uint64_t *words;      // 'chunk_words' palavras por bloco da rodada
+    int *failed;          // por trabalhador: 1 = falha de alocação ao avaliar
+} file_job;
+
+static void evaluate_file_chunk(void *ctx, int worker, uint64_t chunk) {
+    file_job *job = ctx;
+    if (!evaluate_blocks(job->prog, (job->first_chunk + chunk) * job->chunk_words, job->chunk_words,
+                         job->words + chunk * job->chunk_words))
+        job->failed[worker] = 1;
+}
+
+// cabeçalho completo (parte fixa, nomes e expressão) alinhado a 8 bytes
+static unsigned char *build_header(const program *prog, const char *expression, int chunk_bits, size_t *size) {
+    size_t expression_length = strlen(expression);
+    size_t length = TABLE_FILE_HEADER + expression_length + 1;
+    for (int j = 0; j < prog->num_vars; j++) length += strlen(prog->var_names[j]) + 1;
+    length = (length + 7) & ~(size_t) 7;
+
+    unsigned char *header = calloc(1, length); // o alinhamento final fica zerado
+    if (!header) return NULL;
+
+    memcpy(header, TABLE_FILE_MAGIC, 4);
+    put_le(header + 4, TABLE_FILE_VERSION, 2);
+    put_le(header + 6, (uint64_t) chunk_bits, 2);
+    put_le(header + 8, (uint64_t) prog->num_vars, 4);
+    put_le(header + 12, expression_length, 4);
+    put_le(header + 16, 1ULL << prog->num_vars, 8);
+    put_le(header + 24, (1ULL << prog->num_vars) >> chunk_bits, 8);
+
+    size_t pos = TABLE_FILE_HEADER;
+    for (int j = 0; j < prog->num_vars; j++) {
+        size_t n = strlen(prog->var_names[j]) + 1;
+        memcpy(header + pos, prog->var_names[j], n);
+        pos += n;
+    }
+    memcpy(header + pos, expression, expression_length + 1);
+
+    *size = length;
+    return header;
+}
+
+int write_table_file(const program *prog, const char *expression, FILE *out, int threads, error_status *status) {
+    if (!check_table_size(prog, status)) return 0;
+    if (strlen(expression) > UINT32_MAX) {
+        set_error(status, ERR_EXPRESSION_TOO_LONG, -1, "o cabecalho binario guarda ate 4 GiB de texto");
+        return 0;
+    }
+
+    // tabelas menores que um bloco viram um único bloco com todas as linhas
+    int chunk_bits = prog->num_vars < TABLE_FILE_CHUNK_BITS ? prog->num_vars : TABLE_FILE_CHUNK_BITS;
+    uint64_t chunk_rows = 1ULL << chunk_bits;
+    uint64_t num_chunks = (1ULL << prog->num_vars) >> chunk_bits;
+    uint64_t chunk_words = (chunk_rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+    uint64_t mask = chunk_rows < ROWS_PER_WORD ? (1ULL << chunk_rows) - 1 : ~0ULL;
+    uint64_t round = (uint64_t) (threads > 1 ? threads : 1) * TABLE_FILE_ROUND;
+    size_t header_size = 0;
+
+    unsigned char *header = build_header(prog, expression, chunk_bits, &header_size);
+    chunk_entry *directory = num_chunks <= SIZE_MAX / sizeof(chunk_entry)
+                           ? calloc(num_chunks, sizeof(chunk_entry)) : NULL;
+    uint64_t *words = malloc(sizeof(uint64_t) * chunk_words * round);
+    thread_pool *pool = thread_pool_create(threads);
+    int *failed = pool ? calloc(thread_pool_size(pool), sizeof(int)) : NULL;
+    output_writer writer;
+    int ok = header && directory && words && failed && writer_init(&writer, out);
+
+    if (!ok) {
+        set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+        free(header);
+        free(directory);
+        free(words);
+        free(failed);
+        thread_pool_destroy(pool);
+        return 0;
+    }
+
+    writer_put(&writer, (const char *) header, header_size);
+    uint64_t position = header_size;
+
+    for (uint64_t first = 0; ok && first < num_chunks; first += round) {
+        uint64_t count = num_chunks - first < round ? num_chunks - first : round;
+        file_job job = { prog, first, chunk_words, words, failed };
+        thread_pool_run(pool, count, evaluate_file_chunk, &job);
+
+        // um bloco sem resultado invalida o arquivo: nada mais é gravado
+        for (int t = 0; t < thread_pool_size(pool); t++)
+            if (failed[t]) ok = 0;
+        if (!ok) {
+            set_error(status, ERR_MEMORY_ALLOCATION, -1, "");
+            break;
+        }
+
+        // classificação e gravação em ordem: o conteúdo não depende do número de threads
+        for (uint64_t c = 0; c < count; c++) {
+            uint64_t *bits = words + c * chunk_words;
+            chunk_entry *entry = &directory[first + c];
+            uint64_t ones = 0;
+
+            bits[chunk_words - 1] &= mask;
+            for (uint64_t w = 0; w < chunk_words; w++) ones += (uint64_t) count_word_ones(bits[w]);
+
+            entry->offset = 0;
+            entry->ones = (uint32_t) ones;
+            entry->kind = ones == 0 ? TABLE_CHUNK_ZERO : ones == chunk_rows ? TABLE_CHUNK_ONE : TABLE_CHUNK_RAW;
+            if (entry->kind != TABLE_CHUNK_RAW) continue;
+
+            size_t bytes = (size_t) chunk_words * 8;
+            unsigned char *dst = (unsigned char *) writer_reserve(&writer, bytes);
+            if (!dst) {
+                // o arquivo ficaria com blocos faltando: o diretório não é gravado
+                set_error(status, ERR_FILE_ACCESS, -1, "falha ao gravar a tabela binaria");
+                ok = 0;
+                break;
+            }
+            for (uint64_t w = 0; w < chunk_words; w++) put_le(dst + 8 * w, bits[w], 8);
+            writer_commit(&writer, bytes);
+
+            entry->offset = position;
+            position += bytes;
+        }
+    }
+
+    // diretório no fim: o leitor o encontra pelo tamanho do arquivo
+    for (uint64_t c = 0; ok && c < num_chunks; c++) {
+        unsigned char record[TABLE_FILE_ENTRY];
+        put_le(record, directory[c].offset, 8);
+        put_le(record + 8, directory[c].kind, 4);
+        put_le(record + 12, directory[c].ones, 4);
+        writer_put(&writer, (const char *) record, sizeof(record));
+    }
+
+    if (!writer_close(&writer) && ok) {
+        set_error(status, ERR_FILE_ACCESS, -1, "falha ao gravar a tabela binaria");
+        ok = 0;
+    }
+
+    free(header);
+    free(directory);
+    free(words);
+    free(failed);
+    thread_pool_destroy(pool);
+    return ok;
+}
+
+// carrega o arquivo inteiro: mapeado quando possível, lido para o heap caso contrário
+static int load_file(table_file *tf, const char *path) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0) return 0;
+
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return 0;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return -1; // vazio: existe, mas não é uma tabela
+    }
+
+    void *map = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // o mapeamento continua válido sem o descritor
+    if (map == MAP_FAILED) return 0;
+
+    tf->data = map;
+    tf->size = (size_t) info.st_size;
+    tf->mapped = 1;
+    return 1;
+#else
+    FILE *file = fopen(path, "rb");
+    long size = -1;
+    if (!file) return 0;
+
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) <= 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return size == 0 ? -1 : 0;
+    }
+
+    unsigned char *data = malloc((size_t) size);
+    if (!data || fread(data, 1, (size_t) size, file) != (size_t) size) {
+        free(data);
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+
+    tf->data = data;
+    tf->size = (size_t) size;
+    tf->mapped = 0;
+    return 1;
+#endif
+}
+
+// confere o cabeçalho e o diretório; devolve NULL ou o motivo da rejeição
+static const char *check_table_file(table_file *tf) {
+    const unsigned char *p = tf->data;
+    size_t size = tf->size;
+
+    if (size < TABLE_FILE_HEADER || memcmp(p, TABLE_FILE_MAGIC, 4) != 0) return "identificacao ausente";
+    if (get_le(p + 4, 2) != TABLE_FILE_VERSION) return "versao nao suportada";
+
+    uint64_t num_vars = get_le(p + 8, 4);
+    uint64_t chunk_bits = get_le(p + 6, 2);
+    uint64_t expression_length = get_le(p + 12, 4);
+    if (num_vars > MAX_TABLE_VARS || chunk_bits > num_vars || chunk_bits > TABLE_FILE_MAX_CHUNK_BITS)
+        return "cabecalho";
+
+    tf->num_vars = (int) num_vars;
+    tf->chunk_bits = (int) chunk_bits;
+    tf->rows = get_le64(p + 16);
+    tf->num_chunks = get_le64(p + 24);
+    if (tf->rows != 1ULL << num_vars || tf->num_chunks != tf->rows >> chunk_bits) return "cabecalho";
+
+    // nomes e expressão: texto terminado em '\0' dentro do arquivo
+    tf->var_names = malloc(sizeof(char *) * (num_vars > 0 ? num_vars : 1));
+    if (!tf->var_names) return "sem memoria para os nomes";
+
+    size_t pos = TABLE_FILE_HEADER;
+    for (int j = 0; j < tf->num_vars; j++) {
+        const unsigned char *end = memchr(p + pos, '\0', size - pos);
+        if (!end || end == p + pos) return "nomes das variaveis";
+        tf->var_names[j] = (const char *) (p + pos);
+        pos = (size_t) (end - p) + 1;
+    }
+    if (expression_length >= size - pos || p[pos + expression_length] != '\0') return "texto da expressao";
+    tf->expression = (const char *) (p + pos);
+    pos = (pos + expression_length + 1 + 7) & ~(size_t) 7;
+
+    // diretório no fim do arquivo
+    if (pos > size || tf->num_chunks > (size - pos) / TABLE_FILE_ENTRY) return "diretorio";
+    size_t data_end = size - (size_t) tf->num_chunks * TABLE_FILE_ENTRY;
+    uint64_t chunk_rows = 1ULL << chunk_bits;
+    uint64_t chunk_bytes = (chunk_rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD * 8;
+
+    tf->directory = p + data_end;
+    tf->chunk_prefix = malloc(sizeof(uint64_t) * (tf->num_chunks + 1));
+    if (!tf->chunk_prefix) return "sem memoria para o indice";
+
+    tf->true_rows = 0;
+    for (uint64_t c = 0; c < tf->num_chunks; c++) {
+        const unsigned char *entry = tf->directory + c * TABLE_FILE_ENTRY;
+        uint64_t offset = get_le64(entry);
+        uint64_t kind = get_le(entry + 8, 4);
+        uint64_t ones = get_le(entry + 12, 4);
+
+        if (kind == TABLE_CHUNK_ZERO && ones != 0) return "diretorio";
+        if (kind == TABLE_CHUNK_ONE && ones != chunk_rows) return "diretorio";
+        if (kind == TABLE_CHUNK_RAW && (ones > chunk_rows || offset < pos || offset % 8 != 0 ||
+                                        offset > data_end || data_end - offset < chunk_bytes))
+            return "diretorio";
+        if (kind > TABLE_CHUNK_RAW) return "diretorio";
+        tf->chunk_prefix[c] = tf->true_rows;
+        tf->true_rows += ones;
+    }
+    tf->chunk_prefix[tf->num_chunks] = tf->true_rows;
+    return NULL;
+}
+
+int table_file_open(table_file *tf, const char *path, error_status *status) {
+    memset(tf, 0, sizeof(*tf));
+
+    int loaded = load_file(tf, path);
+    if (loaded <= 0) {
+        if (loaded < 0) set_error(status, ERR_INVALID_TABLE_FILE, -1, "arquivo vazio");
+        else set_error(status, ERR_FILE_ACCESS, -1, path);
+        return 0;
+    }
+
+    const char *problem = check_table_file(tf);
+    if (problem) {
+        set_error(status, ERR_INVALID_TABLE_FILE, -1, problem);
+        table_file_close(tf);
+        return 0;
+    }
+    return 1;
+}
+
+void table_file_close(table_file *tf) {
+    if (tf->data) {
+#ifndef _WIN32
+        if (tf->mapped) munmap((void *) tf->data, tf->size);
+        else free((void *) tf->data);
+#else
+        free((void *) tf->data);
+#endif
+    }
+    free(tf->var_names);
+    free(tf->chunk_prefix);
+    memset(tf, 0, sizeof(*tf));
+}
+
+table_chunk_kind table_file_chunk(const table_file *tf, uint64_t chunk, const unsigned char **bitmap) {
+    const unsigned char *entry = tf->directory + chunk * TABLE_FILE_ENTRY;
+    table_chunk_kind kind = (table_chunk_kind) get_le(entry + 8, 4);
+    *bitmap = kind == TABLE_CHUNK_RAW ? tf->data + get_le64(entry) : NULL;
+    return kind;
+}
+
+int table_file_value(const table_file *tf, uint64_t row) {
+    const unsigned char *bitmap;
+    uint64_t local = row & ((1ULL << tf->chunk_bits) - 1);
+
+    switch (table_file_chunk(tf, row >> tf->chunk_bits, &bitmap)) {
+        case TABLE_CHUNK_ZERO: return 0;
+        case TABLE_CHUNK_ONE:  return 1;
+        default: return (int) ((get_le64(bitmap + 8 * (local / ROWS_PER_WORD)) >> (local % ROWS_PER_WORD)) & 1);
+    }
+}
+
+uint64_t table_file_word(const table_file *tf, uint64_t block) {
+    const unsigned char *bitmap;
+    uint64_t row = block * ROWS_PER_WORD;
+    uint64_t local = row & ((1ULL << tf->chunk_bits) - 1);
+
+    switch (table_file_chunk(tf, row >> tf->chunk_bits, &bitmap)) {
+        case TABLE_CHUNK_ZERO: return 0;
+        case TABLE_CHUNK_ONE:  return tf->rows < ROWS_PER_WORD ? (1ULL << tf->rows) - 1 : ~0ULL;
+        default: return get_le64(bitmap + 8 * (local / ROWS_PER_WORD));
+    }
+}
+
+// bits 1 das linhas [lo, hi) de um bitmap
+static uint64_t count_bitmap(const unsigned char *bitmap, uint64_t lo, uint64_t hi) {
+    if (lo >= hi) return 0;
+
+    uint64_t first = lo / ROWS_PER_WORD, last = (hi - 1) / ROWS_PER_WORD;
+    uint64_t total = 0;
+
+    for (uint64_t w = first; w <= last; w++) {
+        uint64_t word = get_le64(bitmap + 8 * w);
+        if (w == first) word &= ~0ULL << (lo % ROWS_PER_WORD);
+        if (w == last && hi % ROWS_PER_WORD) word &= (1ULL << (hi % ROWS_PER_WORD)) - 1;
+        total += (uint64_t) count_word_ones(word);
+    }
+    return total;
+}
+
+// linhas verdadeiras [lo, hi) dentro do bloco 'chunk'
+static uint64_t count_chunk(const table_file *tf, uint64_t chunk, uint64_t lo, uint64_t hi) {
+    uint64_t chunk_rows = 1ULL << tf->chunk_bits;
+    const unsigned char *bitmap;
+
+    if (lo >= hi) return 0;
+    switch (table_file_chunk(tf, chunk, &bitmap)) {
+        case TABLE_CHUNK_ZERO: return 0;
+        case TABLE_CHUNK_ONE:  return hi - lo;
+        default: break;
+    }
+    if (hi - lo <= chunk_rows / 2) return count_bitmap(bitmap, lo, hi);
+
+    // mais da metade do bloco: lê só o complemento
+    uint64_t ones = tf->chunk_prefix[chunk + 1] - tf->chunk_prefix[chunk];
+    return ones - count_bitmap(bitmap, 0, lo) - count_bitmap(bitmap, hi, chunk_rows);
+}
+
+uint64_t table_file_count(const table_file *tf, uint64_t first, uint64_t end) {
+    if (end > tf->rows) end = tf->rows;
+    if (first >= end) return 0;
+
+    // blocos de 'first' a 'end - 1' inteiros, menos as linhas de fora nas pontas
+    uint64_t c0 = first >> tf->chunk_bits, c1 = (end - 1) >> tf->chunk_bits;
+    uint64_t total = tf->chunk_prefix[c1 + 1] - tf->chunk_prefix[c0];
+    total -= count_chunk(tf, c0, 0, first - (c0 << tf->chunk_bits));
+    total -= count_chunk(tf, c1, end - (c1 << tf->chunk_bits), 1ULL << tf->chunk_bits);
+    return total;
+}
@@ -0,0 +1,136 @@
+#ifndef TABLEFILE_H
+#define TABLEFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "compile.h"    // programa pós-fixo compilado
+#include "validation.h" // status de erro
+
+/*
+ * formato binário da tabela verdade (todos os inteiros em little-endian):
+ *
+ *   0  "LTTB"             identificação
+ *   4  u16 versão         TABLE_FILE_VERSION
+ *   6  u16 chunk_bits     log2 das linhas por bloco
+ *   8  u32 num_vars
+ *  12  u32 tamanho do texto da expressão
+ *  16  u64 linhas         2^num_vars
+ *  24  u64 blocos         linhas / 2^chunk_bits, arredondado para cima
+ *  32  nomes das variáveis em ordem de slot, cada um terminado em '\0',
+ *      seguidos do texto da expressão e de '\0'; zeros até múltiplo de 8
+ *      dados dos blocos TABLE_CHUNK_RAW, em ordem
+ *      diretório: um registro de 16 bytes por bloco (u64 posição dos dados
+ *      no arquivo, u32 tipo, u32 linhas verdadeiras) ocupando o fim do arquivo
+ *
+ * a linha i tem a variável do slot j igual ao bit (num_vars - j - 1) de i,
+ * como na tabela em texto; no bitmap, a linha i é o bit (i % 64) da palavra
+ * i / 64 do seu bloco. bits além da última linha são zero. o arquivo depende
+ * apenas da expressão e do programa: gravar duas vezes gera os mesmos bytes
+ */
+
+#define TABLE_FILE_MAGIC "LTTB"  ///< identificação no início do arquivo
+#define TABLE_FILE_VERSION 1     ///< versão do formato
+#define TABLE_FILE_CHUNK_BITS 12 ///< 4096 linhas (512 bytes de bitmap) por bloco
+
+/// @brief como os dados de um bloco estão guardados
+typedef enum table_chunk_kind {
+    TABLE_CHUNK_ZERO = 0, ///< todas as linhas falsas (sem dados)
+    TABLE_CHUNK_ONE = 1,  ///< todas as linhas verdadeiras (sem dados)
+    TABLE_CHUNK_RAW = 2   ///< bitmap completo do bloco
+} table_chunk_kind;
+
+/// @brief tabela binária aberta para leitura (mapeada em memória; nada é copiado)
+typedef struct {
+    const unsigned char *data;  ///< conteúdo do arquivo
+    size_t size;                ///< tamanho do arquivo
+    int mapped;                 ///< 1 = 'data' é um mapeamento, 0 = lido para o heap
+    int num_vars;               ///< número de variáveis
+    uint64_t rows;              ///< número de linhas (2^num_vars)
+    uint64_t true_rows;         ///< linhas verdadeiras (soma do diretório)
+    const char *expression;     ///< texto da expressão (dentro de 'data')
+    const char **var_names;     ///< nome de cada slot (apontam para dentro de 'data')
+    int chunk_bits;             ///< log2 das linhas por bloco
+    uint64_t num_chunks;        ///< número de blocos
+    const unsigned char *directory; ///< registros dos blocos (dentro de 'data')
+    uint64_t *chunk_prefix;     ///< linhas verdadeiras antes de cada bloco (num_chunks + 1 entradas)
+} table_file;
+
+/**
+ * @brief grava a tabela verdade do programa no formato binário
+ *
+ * os blocos são avaliados com o núcleo empacotado, divididos entre 'threads'
+ * threads, e gravados em ordem; blocos inteiramente falsos ou verdadeiros
+ * ocupam só o registro do diretório
+ *
+ * @param prog programa compilado (até MAX_TABLE_VARS variáveis)
+ * @param expression texto da expressão guardado no cabeçalho
+ * @param out destino aberto em modo binário
+ * @param threads número de threads (1 = serial)
+ * @param status recebe o erro de memória ou de gravação
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int write_table_file(const program *prog, const char *expression, FILE *out, int threads, error_status *status);
+
+/**
+ * @brief abre uma tabela binária, mapeando o arquivo em memória
+ *
+ * o cabeçalho e o diretório são conferidos por inteiro; depois disso as
+ * consultas não fazem verificações nem cópias
+ *
+ * @param tf tabela de saída (fechar com table_file_close)
+ * @param path caminho do arquivo
+ * @param status recebe ERR_FILE_ACCESS ou ERR_INVALID_TABLE_FILE
+ * @return int 1 em caso de sucesso, 0 caso contrário
+ */
+int table_file_open(table_file *tf, const char *path, error_status *status);
+
+/**
+ * @brief libera o mapeamento, os nomes e as contagens acumuladas
+ *
+ * @param tf tabela aberta com table_file_open
+ */
+void table_file_close(table_file *tf);
+
+/**
+ * @brief resultado da linha 'row'
+ *
+ * @param tf tabela aberta
+ * @param row índice da linha (menor que tf->rows)
+ * @return int 0 ou 1
+ */
+int table_file_value(const table_file *tf, uint64_t row);
+
+/**
+ * @brief resultados das linhas block*64 a block*64 + 63, como em evaluate_block
+ *
+ * @param tf tabela aberta
+ * @param block índice do bloco de 64 linhas
+ * @return uint64_t bit k = resultado da linha block*64 + k (zero além da última linha)
+ */
+uint64_t table_file_word(const table_file *tf, uint64_t block);
+
+/**
+ * @brief número de linhas verdadeiras no intervalo [first, end)
+ *
+ * os blocos inteiros saem das contagens acumuladas; nas pontas é lida a
+ * menor parte do bloco (a contagem do bloco menos o complemento, se for menor)
+ *
+ * @param tf tabela aberta
+ * @param first primeira linha
+ * @param end linha seguinte à última (limitada a tf->rows)
+ * @return uint64_t linhas verdadeiras no intervalo
+ */
+uint64_t table_file_count(const table_file *tf, uint64_t first, uint64_t end);
+
+/**
+ * @brief tipo e dados de um bloco, direto do mapeamento
+ *
+ * @param tf tabela aberta
+ * @param chunk índice do bloco
+ * @param bitmap recebe o início das palavras little-endian do bloco (NULL se não for TABLE_CHUNK_RAW)
+ * @return table_chunk_kind como o bloco está guardado
+ */
+table_chunk_kind table_file_chunk(const table_file *tf, uint64_t chunk, const unsigned char **bitmap);
+
+#endif // TABLEFILE_H
@@ -26,7 +26,7 @@ void set_error(error_status *status, error_code code, int position, const char *
             sprintf(status->message, "A expressao esta vazia");
             break;
         case ERR_EXPRESSION_TOO_LONG:
-            sprintf(status->message, "A expressao excede o tamanho maximo permitido (%d caracteres)", MAX_EXPR); // mudar
+            sprintf(status->message, "A expressao excede o tamanho maximo permitido: %s", custom_msg);
             break;
         case ERR_CONSECUTIVE_OPERATORS:
             sprintf(status->message, "Operando consecutives invlidos na posicao %d: %s", position, custom_msg);
@@ -37,84 +37,40 @@ void set_error(error_status *status, error_code code, int position, const char *
         case ERR_MEMORY_ALLOCATION:
             sprintf(status->message, "Falha de alocacao de memoria");
             break;
+        case ERR_TOO_MANY_VARIABLES:
+            sprintf(status->message, "Variaveis demais para enumerar as linhas: %s", custom_msg);
+            break;
+        case ERR_FILE_ACCESS:
+            snprintf(status->message, MAX_ERROR_MSG, "Nao foi possivel acessar o arquivo '%s'", custom_msg);
+            break;
+        case ERR_INVALID_TABLE_FILE:
+            snprintf(status->message, MAX_ERROR_MSG, "Arquivo de tabela invalido: %s", custom_msg);
+            break;
+        case ERR_INVALID_ARGUMENT:
+            snprintf(status->message, MAX_ERROR_MSG, "Argumento invalido: %s", custom_msg);
+            break;
+        case ERR_INTERRUPTED:
+            snprintf(status->message, MAX_ERROR_MSG, "Operacao interrompida: %s", custom_msg);
+            break;
+        case ERR_NODE_LIMIT:
+            snprintf(status->message, MAX_ERROR_MSG,
+                     "O diagrama passou do limite de %s nos nesta ordem de variaveis (tente --order appearance)",
+                     custom_msg);
+            break;
+        case ERR_SEARCH_LIMIT:
+            snprintf(status->message, MAX_ERROR_MSG, "A busca passou do limite de trabalho: %s", custom_msg);
+            break;
         default:
             sprintf(status->message, "Erro desocnhecido");
     }
 }
 
 
-int check_parentheses_balance(const char *expression, error_status *status) {
-    int balance = 0;  // contador de balanço: incrementa em '(', decrementa em ')'
-    int i;
-    
-    // percorre a expressão caractere por caractere
-    for (i = 0; expression[i]; i++) {
-        if (expression[i] == '(') {
-            balance++;  // encontrou parêntese de abertura
-        } else if (expression[i] == ')') {
-            balance--;  // encontrou parêntese de fechamento
-            // se o balanço for negativo, há um parêntese de fechamento sem abertura correspondente
-            if (balance < 0) {
-                set_error(status, ERR_UNBALANCED_PARENTHESES, i, "Parentese de fechamento sem abertura correspondente");
-                return 0;
-            }
-        }
-    }
-    
-    // se o balanço final for positivo, há parênteses de abertura sem fechamento
-    if (balance > 0) {
-        set_error(status, ERR_UNBALANCED_PARENTHESES, i-1, "Parentese de abertura sem fechamento correspondente");
-        return 0;
-    }
-    
-    return 1;  // parênteses estão balanceados
-}
+int validate_expression(const char *expression, error_status *status) {
+    int size = 0;
 
-int check_consecutive_operators(const char *expression, error_status *status) {
-    for (int i = 0; expression[i]; i++) {
-        // verifica operadores binários & e |
-        if (strchr("&|", expression[i])) {
-            // operador binário no início ou fim da expressão
-            if (i == 0 || i == strlen(expression) - 1) {
-                set_error(status, ERR_MISSING_OPERAND, i, "Operador binario sem operandos suficientes");
-                return 0;
-            }
-            
-            // operadores binários consecutivos
-            if (strchr("&|", expression[i-1]) || strchr("&|", expression[i+1])) {
-                char err_msg[50];
-                sprintf(err_msg, "Operadores '%c' e '%c' consecutivos", expression[i-1], expression[i+1]);
-                set_error(status, ERR_CONSECUTIVE_OPERATORS, i, err_msg);
-                return 0;
-            }
-        }
-    }
-    return 1;  // não há operadores consecutivos inválidos
+    // a leitura sem destino para os tokens faz todas as verificações em uma passada
+    init_error_status(status);
+    read_expression(expression, NULL, &size, NULL, status);
+    return status->code == SUCCESS;
 }
-
-
-int validate_expression(const char *expression, error_status *status) {
-    // verifica se a expressão é nula ou vazia
-    if (!expression || strlen(expression) == 0) {
-        set_error(status, ERR_EMPTY_EXPRESSION, 0, "");
-        return 0;
-    }
-    
-    // verifica se a expressão excede o tamanho máximo permitido
-    if (strlen(expression) > MAX_EXPR) {
-        set_error(status, ERR_EXPRESSION_TOO_LONG, 0, "");
-        return 0;
-    }
-    
-    // verifica o balanceamento de parênteses
-    if (!check_parentheses_balance(expression, status)) {
-        return 0;
-    }
-    
-    // verifica operadores consecutivos inválidos
-    if (!check_consecutive_operators(expression, status)) {
-        return 0;
-    }
-    
-    return 1;  // expressão é válida
-}
\ No newline at end of file
@@ -20,7 +20,14 @@ typedef enum error_code{
     ERR_EXPRESSION_TOO_LONG,    ///< expressão excede o tamanho máximo permitido
     ERR_CONSECUTIVE_OPERATORS,  ///< operadores consecutivos sem operandos entre eles
     ERR_MISSING_OPERAND,        ///< operador sem operando correspondente
-    ERR_MEMORY_ALLOCATION       ///< erro na alocação de memória
+    ERR_MEMORY_ALLOCATION,      ///< erro na alocação de memória
+    ERR_TOO_MANY_VARIABLES,     ///< variáveis demais para enumerar a tabela
+    ERR_FILE_ACCESS,            ///< arquivo não pôde ser aberto, lido ou gravado
+    ERR_INVALID_TABLE_FILE,     ///< arquivo de tabela binária corrompido ou de outro formato
+    ERR_INVALID_ARGUMENT,       ///< parâmetro fora do intervalo aceito pela função
+    ERR_INTERRUPTED,            ///< o destino dos resultados pediu para parar
+    ERR_NODE_LIMIT,             ///< o diagrama de decisão passou do limite de nós
+    ERR_SEARCH_LIMIT            ///< a busca desistiu nos seus limites de trabalho
 } error_code;
 
 /// @brief estrutura para armazenar informações sobre erros de validação
@@ -48,26 +55,12 @@ void init_error_status(error_status *status);
 void set_error(error_status *status, error_code code, 
                int position, const char *custom_msg);
 
-/**
- * @brief verifica se os parênteses estão balanceados na expressão
- * 
- * @param expression string contendo a expressão lógica
- * @param status ponteiro para a estrutura de erro
- * @return int retorna 1 se os parênteses estiverem balanceados, 0 caso contrário
- */
-int check_parentheses_balance(const char *expression, error_status *status);
-
-/**
- * @brief verifica se há operadores consecutivos inválidos na expressão
- * 
- * @param expression string contendo a expressão lógica
- * @param status ponteiro para a estrutura de erro
- * @return int retorna 1 se a expressão for válida, 0 caso contrário
- */
-int check_consecutive_operator(const char *expression, error_status *status);
-
 /**
  * @brief valida se a expressão lógica segue as regras sintáticas corretas
+ *
+ * faz as verificações de parênteses, de operadores consecutivos e os erros
+ * léxicos de read_expression, com a mesma prioridade entre eles, em uma única
+ * passada pela expressão
  * 
  * @param expression string contendo a expressão lógica
  * @param status ponteiro para a estrutura de erro
@@ -1,21 +1,334 @@
 #include "../include/eval.h"
 #include "../include/validation.h"
+#include "../include/classify.h"
+#include "../include/bdd.h"
+#include "../include/batch.h"
+#include "../include/tablefile.h"
+#include "../include/cache.h"
+#include "../include/count.h"
+#include "../include/minimize.h"
+#include "../include/equiv.h"
+#include "../include/stats.h"
 
 // to do:
 // - lembrar de trocar o sprintf para tirar os warnings de segurança
 // - ...
 
-int main() {
-    char expression[MAX_EXPR];
+// imprime as opções aceitas pela linha de comando
+static void print_usage(const char *prog_name) {
+    fprintf(stderr, "uso: %s [--threads N] [--output ARQUIVO [--mmap | --binary]] [--gray | --bdd [--order ORDEM] | --jit]\n"
+                    "       [--classify | --bdd-summary | --count | --minimize | --minimize-pos | --equiv | --implies]\n"
+                    "       [--fix ATRIBUICAO] [--batch ENTRADA] [--inspect ARQUIVO]\n"
+                    "       [--cache DIR [--cache-size MB] [--cache-stats]] [--stats DESTINO]\n", prog_name);
+    fprintf(stderr, "  --threads N       divide a geracao da tabela entre N threads\n");
+    fprintf(stderr, "  --output ARQUIVO  grava a tabela em ARQUIVO em vez da saida padrao\n");
+    fprintf(stderr, "  --mmap            grava ARQUIVO mapeando-o em memoria\n");
+    fprintf(stderr, "  --binary          grava ARQUIVO no formato binario (1 bit por linha)\n");
+    fprintf(stderr, "  --gray            avalia as linhas em codigo Gray, reavaliando so o que muda\n");
+    fprintf(stderr, "  --bdd             le os resultados de um BDD ordenado e reduzido\n");
+    fprintf(stderr, "  --jit             gera codigo x86-64 para a expressao (interpretador se indisponivel)\n");
+    fprintf(stderr, "  --order ORDEM     ordem das variaveis no BDD: natural, appearance ou lista (ex: cab)\n");
+    fprintf(stderr, "  --fix ATRIBUICAO  fixa variaveis (ex: a=1,b=0) e enumera so as outras\n");
+    fprintf(stderr, "  --bdd-summary     classificacao, linhas verdadeiras e tamanho do BDD (sem tabela)\n");
+    fprintf(stderr, "  --classify        informa se e tautologia, contradicao ou contingente (sem tabela)\n");
+    fprintf(stderr, "  --batch ENTRADA   avalia uma expressao por linha de ENTRADA (- = entrada padrao)\n");
+    fprintf(stderr, "  --count           imprime apenas o numero exato de linhas verdadeiras (sem tabela)\n");
+    fprintf(stderr, "  --minimize        imprime uma soma de produtos minima equivalente (sem tabela)\n");
+    fprintf(stderr, "  --minimize-pos    imprime um produto de somas minimo equivalente (sem tabela)\n");
+    fprintf(stderr, "  --equiv           le duas expressoes e verifica se sao equivalentes, com um contraexemplo\n");
+    fprintf(stderr, "  --implies         le duas expressoes e verifica se a primeira implica a segunda\n");
+    fprintf(stderr, "                    (codigo de saida: 0 = vale, 1 = nao vale, 2 = erro)\n");
+    fprintf(stderr, "  --inspect ARQUIVO resume uma tabela binaria gravada com --binary\n");
+    fprintf(stderr, "  --cache DIR       reaproveita tabelas e classificacoes guardadas em DIR\n");
+    fprintf(stderr, "  --cache-size MB   limite do cache; as entradas menos usadas saem primeiro (padrao 256)\n");
+    fprintf(stderr, "  --cache-stats     imprime acertos e falhas do cache ao terminar\n");
+    fprintf(stderr, "  --stats DESTINO   tempos por fase e contadores: - = texto na saida de erro, senao JSON no arquivo\n");
+}
 
-    printf("digite uma expressao logica (use ~, &, |, ->, <->): ");
-    fgets(expression, MAX_EXPR, stdin);
-    
-    size_t len = strlen(expression);
-    
-    if (len > 0 && expression[len-1] == '\n') {
-        expression[len-1] = '\0';
+// lê uma linha inteira da entrada, sem limite de tamanho; NULL no fim da entrada ou sem memória
+static char *read_input_line(FILE *in) {
+    size_t capacity = 256, length = 0;
+    char *line = malloc(capacity);
+
+    while (line && fgets(line + length, (int) (capacity - length), in)) {
+        length += strlen(line + length);
+        if (length > 0 && line[length-1] == '\n') break;
+
+        // linha maior que o buffer: dobra e continua lendo
+        char *grown = realloc(line, capacity * 2);
+        if (!grown) {
+            free(line);
+            return NULL;
+        }
+        line = grown;
+        capacity *= 2;
+    }
+
+    if (line && length == 0 && feof(in)) {
+        free(line);
+        return NULL;
+    }
+    return line;
+}
+
+// remove a quebra de linha final deixada por read_input_line
+static void strip_newline(char *line) {
+    size_t len = strlen(line);
+    if (len > 0 && line[len-1] == '\n') line[len-1] = '\0';
+}
+
+// resume uma tabela binária: expressão, variáveis, contagens e blocos
+static int inspect_table_file(const char *path) {
+    table_file tf;
+    error_status status;
+    uint64_t kinds[3] = {0, 0, 0};
+
+    if (!table_file_open(&tf, path, &status)) {
+        fprintf(stderr, "Erro: %s\n", status.message);
+        return 1;
+    }
+
+    for (uint64_t c = 0; c < tf.num_chunks; c++) {
+        const unsigned char *bitmap;
+        kinds[table_file_chunk(&tf, c, &bitmap)]++;
+    }
+
+    printf("expressao: %s\n", tf.expression);
+    printf("variaveis:");
+    for (int j = 0; j < tf.num_vars; j++) printf(" %s", tf.var_names[j]);
+    printf("\nlinhas: %llu\nverdadeiras: %llu\n", (unsigned long long) tf.rows, (unsigned long long) tf.true_rows);
+    printf("blocos: %llu (%llu falsos, %llu verdadeiros, %llu com bitmap)\n", (unsigned long long) tf.num_chunks,
+           (unsigned long long) kinds[TABLE_CHUNK_ZERO], (unsigned long long) kinds[TABLE_CHUNK_ONE],
+           (unsigned long long) kinds[TABLE_CHUNK_RAW]);
+
+    table_file_close(&tf);
+    return 0;
+}
+
+// contadores do cache em stderr, para não misturar com a tabela
+static void print_cache_stats(result_cache *cache) {
+    cache_stats stats;
+
+    cache_get_stats(cache, &stats);
+    fprintf(stderr, "cache: %llu acertos, %llu falhas nesta execucao; %llu acertos, %llu falhas no total; "
+                    "%llu entradas, %llu bytes\n",
+            (unsigned long long) stats.hits, (unsigned long long) stats.misses,
+            (unsigned long long) stats.total_hits, (unsigned long long) stats.total_misses,
+            (unsigned long long) stats.entries, (unsigned long long) stats.bytes);
+}
+
+// tempos e contadores da execução: texto em stderr ("-") ou JSON no arquivo
+static int report_stats(const char *destination) {
+    stats_report report;
+
+    stats_collect(&report);
+    stats_disable();
+
+    if (strcmp(destination, "-") == 0) {
+        stats_print(&report, stderr);
+        return 1;
+    }
+
+    FILE *out = fopen(destination, "w");
+    if (!out) {
+        fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", destination);
+        return 0;
     }
-    
-    generate_truth_table(expression, 0);
+    stats_write_json(&report, out);
+    return fclose(out) == 0;
+}
+
+// modo em lote: uma expressão por linha, resultados na ordem da entrada
+static int run_batch_mode(const char *path, const table_options *table, int classify, int count) {
+    batch_options options;
+    FILE *in = stdin, *out = stdout;
+
+    init_batch_options(&options);
+    options.threads = table->threads;
+    options.reverse_order = table->reverse_order;
+    options.cache = table->cache;
+    if (classify) options.result = BATCH_CLASSIFY;
+    else if (count) options.result = BATCH_COUNT;
+
+    if (strcmp(path, "-") != 0 && !(in = fopen(path, "r"))) {
+        fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", path);
+        return 1;
+    }
+    if (table->output_path && !(out = fopen(table->output_path, "wb"))) {
+        fprintf(stderr, "Erro: nao foi possivel abrir '%s'\n", table->output_path);
+        if (in != stdin) fclose(in);
+        return 1;
+    }
+
+    long long errors = run_batch(in, out, &options);
+    if (errors < 0) fprintf(stderr, "Erro: falha ao processar o lote\n");
+    else if (errors > 0) fprintf(stderr, "%lld expressoes com erro\n", errors);
+
+    if (in != stdin) fclose(in);
+    if (out != stdout && fclose(out) != 0) errors = -1;
+    return errors != 0;
+}
+
+int main(int argc, char *argv[]) {
+    char *expression;
+    table_options options;
+    int classify = 0; // 1 = apenas classifica a expressão
+    int bdd_summary = 0; // 1 = apenas resume o BDD da expressão
+    int count = 0; // 1 = apenas conta as linhas verdadeiras
+    int minimize = -1; // forma da expressão minimizada (-1 = não minimiza)
+    int relation = -1; // relação verificada entre duas expressões (-1 = uma expressão só)
+    const char *batch_path = NULL; // arquivo de expressões do modo em lote
+    const char *cache_dir = NULL;  // diretório do cache de resultados
+    uint64_t cache_bytes = 0;      // limite do cache (0 = padrão)
+    int cache_report = 0;          // 1 = imprime os contadores do cache no fim
+    const char *stats_path = NULL; // destino das estatísticas ("-" = stderr)
+    int status = 0;
+
+    init_table_options(&options);
+
+    // processa as opções da linha de comando
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threads = atoi(argv[++i]);
+            if (options.threads < 1) {
+                fprintf(stderr, "Erro: numero de threads invalido: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output_path = argv[++i];
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            options.use_mmap = 1;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            options.binary = 1;
+        } else if (strcmp(argv[i], "--inspect") == 0 && i + 1 < argc) {
+            return inspect_table_file(argv[++i]);
+        } else if (strcmp(argv[i], "--gray") == 0) {
+            options.engine = TABLE_ENGINE_GRAY;
+        } else if (strcmp(argv[i], "--bdd") == 0) {
+            options.engine = TABLE_ENGINE_BDD;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            options.engine = TABLE_ENGINE_JIT;
+        } else if (strcmp(argv[i], "--bdd-summary") == 0) {
+            bdd_summary = 1;
+        } else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            options.bdd_order = argv[++i];
+        } else if (strcmp(argv[i], "--fix") == 0 && i + 1 < argc) {
+            options.fixed = argv[++i];
+        } else if (strcmp(argv[i], "--classify") == 0) {
+            classify = 1;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--count") == 0) {
+            count = 1;
+        } else if (strcmp(argv[i], "--minimize") == 0) {
+            minimize = MINIMIZE_SOP;
+        } else if (strcmp(argv[i], "--minimize-pos") == 0) {
+            minimize = MINIMIZE_POS;
+        } else if (strcmp(argv[i], "--equiv") == 0) {
+            relation = RELATION_EQUIVALENT;
+        } else if (strcmp(argv[i], "--implies") == 0) {
+            relation = RELATION_IMPLIES;
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            long long mb = atoll(argv[++i]);
+            if (mb < 1) {
+                fprintf(stderr, "Erro: tamanho de cache invalido: %s\n", argv[i]);
+                return 1;
+            }
+            cache_bytes = (uint64_t) mb << 20;
+        } else if (strcmp(argv[i], "--cache-stats") == 0) {
+            cache_report = 1;
+        } else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            stats_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.binary && batch_path) {
+        fprintf(stderr, "Erro: --binary nao vale no modo em lote (--batch)\n");
+        return 1;
+    }
+
+    if (minimize >= 0 && batch_path) {
+        fprintf(stderr, "Erro: --minimize e --minimize-pos nao valem no modo em lote (--batch)\n");
+        return 1;
+    }
+
+    if (relation >= 0 && batch_path) {
+        fprintf(stderr, "Erro: --equiv e --implies nao valem no modo em lote (--batch)\n");
+        return 1;
+    }
+
+    if (options.binary && !options.output_path) {
+        fprintf(stderr, "Erro: --binary exige --output ARQUIVO\n");
+        return 1;
+    }
+
+    if (options.fixed && (batch_path || relation >= 0 || classify || bdd_summary || count || minimize >= 0)) {
+        fprintf(stderr, "Erro: --fix vale apenas para a tabela verdade\n");
+        return 1;
+    }
+
+    if (stats_path && !stats_enable()) {
+        fprintf(stderr, "Erro: --stats indisponivel (compilado com LOGIC_STATS=0)\n");
+        return 1;
+    }
+
+    if (cache_dir) {
+        error_status error;
+        options.cache = cache_open(cache_dir, cache_bytes, &error);
+        if (!options.cache) {
+            fprintf(stderr, "Erro: %s\n", error.message);
+            return 1;
+        }
+    }
+
+    if (batch_path) {
+        status = run_batch_mode(batch_path, &options, classify, count);
+    } else {
+        printf(relation >= 0 ? "digite a primeira expressao logica (use ~, &, |, ->, <->): "
+                             : "digite uma expressao logica (use ~, &, |, ->, <->): ");
+        expression = read_input_line(stdin);
+        if (!expression) expression = calloc(1, 1); // entrada vazia: reportada como expressão vazia
+        if (!expression) {
+            cache_close(options.cache);
+            return 1;
+        }
+
+        strip_newline(expression);
+
+        if (relation >= 0) {
+            printf("digite a segunda expressao logica: ");
+            char *second = read_input_line(stdin);
+            if (!second) second = calloc(1, 1);
+            if (second) {
+                strip_newline(second);
+                int holds = print_relation(expression, second, (relation_kind) relation, options.threads, NULL);
+                status = holds < 0 ? 2 : !holds;
+                free(second);
+            } else {
+                status = 2;
+            }
+        } else if (classify) {
+            print_classification(expression, options.cache, NULL);
+        } else if (bdd_summary) {
+            print_bdd_summary(expression, options.bdd_order, NULL);
+        } else if (count) {
+            print_model_count(expression, options.threads, NULL);
+        } else if (minimize >= 0) {
+            print_minimized(expression, (minimize_form) minimize, options.threads, NULL);
+        } else {
+            generate_truth_table_with(expression, &options);
+        }
+
+        free(expression);
+    }
+
+    if (options.cache && cache_report) print_cache_stats(options.cache);
+    cache_close(options.cache);
+    if (stats_path && !report_stats(stats_path)) status = 1;
+    return status;
 }
\ No newline at end of file